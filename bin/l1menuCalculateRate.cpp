@@ -1,19 +1,37 @@
 #include <stdexcept>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
 
 #include <TFile.h>
 #include "l1menu/ISample.h"
 #include "l1menu/IMenuRate.h"
+#include "l1menu/ITrigger.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/PartialMenuRate.h"
 #include "l1menu/TriggerMenu.h"
 #include "l1menu/tools/CommandLineParser.h"
 #include "l1menu/tools/stringManipulation.h"
 #include "l1menu/tools/fileIO.h"
+#include "l1menu/tools/miscellaneous.h"
+#include "l1menu/tools/ThreadPool.h"
 
 void printUsage( const std::string& executableName, std::ostream& output=std::cout )
 {
 	output << "Usage:" << "\n"
-			<< "\t" << executableName << " --totalrate <total rate in kHz> [--output <output filename>] [--format <CSV | OLD | XML>] <sample filename> <menu filename>" << "\n"
+			<< "\t" << executableName << " --totalrate <total rate in kHz> [--output <output filename>] [--format <CSV | OLD | XML>] [--overlaps <filename>] [--stream] [--processes <number>] <sample filename> <menu filename>" << "\n"
+			<< "\n"
+			<< "\t" << "--overlaps" << "\n"
+			<< "\t" << "\t" << "also save the rate of events passing each pair of triggers to the given file as CSV. Only for reduced samples." << "\n"
+			<< "\n"
+			<< "\t" << "--stream" << "\n"
+			<< "\t" << "\t" << "read a reduced sample a few blocks of events at a time rather than loading it all into memory. Can't be used with --overlaps." << "\n"
+			<< "\n"
+			<< "\t" << "--processes" << "\n"
+			<< "\t" << "\t" << "split the events between this many processes, each loading the sample itself. The result is exactly the same" << "\n"
+			<< "\t" << "\t" << "as with one process. Can't be used with --overlaps or --stream." << "\n"
 			<< "\n"
 			<< "\t" << executableName << " --help" << "\n"
 			<< "\t" << "\t" << "prints this help message" << "\n"
@@ -25,8 +43,11 @@ int main( int argc, char* argv[] )
 	std::string sampleFilename;
 	std::string menuFilename;
 	std::string outputFilename;
+	std::string overlapsFilename;
 	l1menu::IL1MenuFile::FileFormat fileFormat=l1menu::IL1MenuFile::FileFormat::XML;
 	float totalTriggerRatekHz; // The rate if every single event passed
+	bool streamSample=false;
+	size_t numberOfProcesses=1;
 
 	l1menu::tools::CommandLineParser commandLineParser;
 	try
@@ -34,6 +55,9 @@ int main( int argc, char* argv[] )
 		commandLineParser.addOption( "output", l1menu::tools::CommandLineParser::RequiredArgument );
 		commandLineParser.addOption( "totalrate", l1menu::tools::CommandLineParser::RequiredArgument );
 		commandLineParser.addOption( "format", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "overlaps", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "stream", l1menu::tools::CommandLineParser::NoArgument );
+		commandLineParser.addOption( "processes", l1menu::tools::CommandLineParser::RequiredArgument );
 		commandLineParser.addOption( "help", l1menu::tools::CommandLineParser::NoArgument );
 		commandLineParser.parse( argc, argv );
 
@@ -45,6 +69,18 @@ int main( int argc, char* argv[] )
 
 		if( commandLineParser.nonOptionArguments().size()!=2 ) throw std::runtime_error( "Incorrect number of arguments" );
 		if( commandLineParser.optionHasBeenSet( "output" ) ) outputFilename=commandLineParser.optionArguments("output").back();
+		if( commandLineParser.optionHasBeenSet( "overlaps" ) ) overlapsFilename=commandLineParser.optionArguments("overlaps").back();
+		if( commandLineParser.optionHasBeenSet( "stream" ) ) streamSample=true;
+		if( streamSample && !overlapsFilename.empty() ) throw std::runtime_error( "The overlaps option needs the whole sample in memory, so can't be used with stream" );
+		if( commandLineParser.optionHasBeenSet( "processes" ) )
+		{
+			const std::string& processesArgument=commandLineParser.optionArguments("processes").back();
+			size_t numberOfCharacters;
+			int processes=std::stoi( processesArgument, &numberOfCharacters );
+			if( numberOfCharacters!=processesArgument.size() || processes<1 ) throw std::runtime_error( "The number of processes must be a positive integer" );
+			numberOfProcesses=processes;
+		}
+		if( numberOfProcesses>1 && (streamSample || !overlapsFilename.empty()) ) throw std::runtime_error( "The processes option can't be used with stream or overlaps" );
 		if( commandLineParser.optionHasBeenSet( "format" ) )
 		{
 			std::string formatString=commandLineParser.optionArguments("format").back();
@@ -89,16 +125,55 @@ int main( int argc, char* argv[] )
 
 	try
 	{
-		std::cout << "Loading sample from the file " << sampleFilename << std::endl;
-		std::unique_ptr<l1menu::ISample> pSample=l1menu::tools::loadSample( sampleFilename );
-		pSample->setEventRate( totalTriggerRatekHz );
+		std::unique_ptr<l1menu::ISample> pSample;
+		if( !streamSample && numberOfProcesses==1 )
+		{
+			std::cout << "Loading sample from the file " << sampleFilename << std::endl;
+			pSample=l1menu::tools::loadSample( sampleFilename );
+			pSample->setEventRate( totalTriggerRatekHz );
+		}
 
 		std::cout << "Loading menu from file " << menuFilename << std::endl;
 		std::unique_ptr<l1menu::TriggerMenu> pMenu=l1menu::tools::loadMenu( menuFilename );
 
-		std::cout << "Calculating rates..." << std::endl;
-
-		std::shared_ptr<const l1menu::IMenuRate> pRates=pSample->rate(*pMenu);
+		std::shared_ptr<const l1menu::IMenuRate> pRates;
+		if( numberOfProcesses>1 )
+		{
+			std::cout << "Calculating rates in " << numberOfProcesses << " processes..." << std::endl;
+			// Each process loads the sample and works out the sums for its share of the chunks. Nothing in
+			// this process can have used the ThreadPool before this, see runInChildProcesses.
+			const size_t threadsPerProcess=std::max<size_t>( 1, std::thread::hardware_concurrency()/numberOfProcesses );
+			std::vector<std::string> serialisedSums=l1menu::tools::runInChildProcesses( numberOfProcesses, [&]( size_t processNumber )->std::string
+			{
+				l1menu::tools::ThreadPool::instance().setNumberOfThreads( threadsPerProcess );
+				std::unique_ptr<l1menu::ISample> pProcessSample=l1menu::tools::loadSample( sampleFilename );
+				const size_t numberOfChunks=l1menu::PartialMenuRate::numberOfChunks( *pProcessSample );
+
+				l1menu::PartialMenuRate partialRate( *pMenu );
+				partialRate.addSample( *pProcessSample, numberOfChunks*processNumber/numberOfProcesses, numberOfChunks*(processNumber+1)/numberOfProcesses );
+				std::ostringstream output;
+				partialRate.serialise( output );
+				return output.str();
+			} );
+
+			l1menu::PartialMenuRate totalRate( *pMenu );
+			for( const auto& sums : serialisedSums )
+			{
+				std::istringstream input( sums );
+				totalRate.merge( l1menu::PartialMenuRate( *pMenu, input ) );
+			}
+			pRates=totalRate.rate( totalTriggerRatekHz );
+		}
+		else if( streamSample )
+		{
+			std::cout << "Calculating rates while reading the sample from " << sampleFilename << "..." << std::endl;
+			pRates=l1menu::ReducedSample::rateFromFile( sampleFilename, *pMenu, totalTriggerRatekHz );
+		}
+		else
+		{
+			std::cout << "Calculating rates..." << std::endl;
+			pRates=pSample->rate(*pMenu);
+		}
 
 		if( !outputFilename.empty() )
 		{
@@ -117,6 +192,28 @@ int main( int argc, char* argv[] )
 			l1menu::tools::dumpTriggerRates( std::cout, *pRates, fileFormat );
 		}
 
+		if( !overlapsFilename.empty() )
+		{
+			const l1menu::ReducedSample* pReducedSample=dynamic_cast<const l1menu::ReducedSample*>( pSample.get() );
+			if( pReducedSample==nullptr ) throw std::runtime_error( "Trigger overlaps can only be calculated for reduced samples" );
+
+			std::cout << "Calculating trigger overlaps..." << std::endl;
+			std::vector< std::vector<float> > overlapFractions=pReducedSample->triggerOverlapFractions( *pMenu );
+
+			std::ofstream overlapsFile( overlapsFilename );
+			if( !overlapsFile.is_open() ) throw std::runtime_error( "Unable to open "+overlapsFilename+" to store the trigger overlaps" );
+			// First row and column are the trigger names, the rest is the rate in kHz that pass both triggers
+			for( size_t triggerNumber=0; triggerNumber<pMenu->numberOfTriggers(); ++triggerNumber ) overlapsFile << "," << pMenu->getTrigger(triggerNumber).name();
+			overlapsFile << "\n";
+			for( size_t triggerNumber=0; triggerNumber<pMenu->numberOfTriggers(); ++triggerNumber )
+			{
+				overlapsFile << pMenu->getTrigger(triggerNumber).name();
+				for( const auto& fraction : overlapFractions[triggerNumber] ) overlapsFile << "," << fraction*pSample->eventRate();
+				overlapsFile << "\n";
+			}
+			std::cout << "Trigger overlaps saved to " << overlapsFilename << std::endl;
+		}
+
 	}
 	catch( std::exception& error )
 	{
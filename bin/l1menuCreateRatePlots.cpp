@@ -1,22 +1,32 @@
 #include <stdexcept>
 #include <iostream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
 
 #include <TFile.h>
 #include "l1menu/ISample.h"
+#include "l1menu/FullSample.h"
 #include "l1menu/MenuRatePlots.h"
+#include "l1menu/PartialMenuRate.h"
+#include "l1menu/PartialMenuRatePlots.h"
 #include "l1menu/IMenuRate.h"
 #include "l1menu/TriggerMenu.h"
 #include "l1menu/tools/miscellaneous.h"
 #include "l1menu/tools/fileIO.h"
 #include "l1menu/tools/CommandLineParser.h"
+#include "l1menu/tools/ThreadPool.h"
 
 void printUsage( const std::string& executableName, std::ostream& output=std::cout )
 {
 	output << "Usage:" << "\n"
-			<< "\t" << executableName << " [--output <output filename>] [--original-binning] <sample filename> <menu filename>" << "\n"
+			<< "\t" << executableName << " [--output <output filename>] [--original-binning] [--processes <number>] [--sum-of-weights-cache <directory>] <sample filename> <menu filename>" << "\n"
 			<< "\t" << "\t" << "Creates trigger rate plots using the menu and sample provided. The \"output\" option allows" << "\n"
 			<< "\t" << "\t" << "you to specify the filename for the output (default is \"rateHistograms.root\"). The" << "\n"
-			<< "\t" << "\t" << "\"original-binning\" option will use the binning that was used in the L1Menu2015.C macro." << "\n"
+			<< "\t" << "\t" << "\"original-binning\" option will use the binning that was used in the L1Menu2015.C macro. The" << "\n"
+			<< "\t" << "\t" << "\"processes\" option splits the events between that many processes, each loading the sample itself." << "\n"
+			<< "\t" << "\t" << "If the sample is a full sample of ntuples, the \"sum-of-weights-cache\" option gives a directory" << "\n"
+			<< "\t" << "\t" << "to save the sum of the event weights of each ntuple in, so that they're only added up once." << "\n"
 			<< "\n"
 			<< "\t" << executableName << " --help" << "\n"
 			<< "\t" << "\t" << "prints this help message"
@@ -24,12 +34,20 @@ void printUsage( const std::string& executableName, std::ostream& output=std::co
 			<< std::endl;
 }
 
+/** @brief Passes the directory on to the sample if it's a FullSample, since that's the only one that uses it. */
+void setSumOfWeightsCacheDirectory( l1menu::ISample& sample, const std::string& directory )
+{
+	l1menu::FullSample* pFullSample=dynamic_cast<l1menu::FullSample*>( &sample );
+	if( pFullSample!=nullptr && !directory.empty() ) pFullSample->setSumOfWeightsCacheDirectory( directory );
+}
 
 int main( int argc, char* argv[] )
 {
 	std::string sampleFilename;
 	std::string menuFilename;
 	std::string outputFilename="rateHistograms.root"; // default value if not specified on the command line
+	size_t numberOfProcesses=1;
+	std::string sumOfWeightsCacheDirectory; // empty means don't save the sums of weights
 
 	l1menu::tools::CommandLineParser commandLineParser;
 	try
@@ -37,6 +55,8 @@ int main( int argc, char* argv[] )
 		commandLineParser.addOption( "help", l1menu::tools::CommandLineParser::NoArgument );
 		commandLineParser.addOption( "output", l1menu::tools::CommandLineParser::RequiredArgument );
 		commandLineParser.addOption( "original-binning", l1menu::tools::CommandLineParser::NoArgument );
+		commandLineParser.addOption( "processes", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "sum-of-weights-cache", l1menu::tools::CommandLineParser::RequiredArgument );
 		commandLineParser.parse( argc, argv );
 
 		if( commandLineParser.optionHasBeenSet( "help" ) )
@@ -47,6 +67,15 @@ int main( int argc, char* argv[] )
 
 		if( commandLineParser.optionHasBeenSet( "output" ) ) outputFilename=commandLineParser.optionArguments("output").back();
 		if( commandLineParser.optionHasBeenSet( "original-binning" ) ) l1menu::tools::setBinningToL1Menu2015Values();
+		if( commandLineParser.optionHasBeenSet( "processes" ) )
+		{
+			const std::string& processesArgument=commandLineParser.optionArguments("processes").back();
+			size_t numberOfCharacters;
+			int processes=std::stoi( processesArgument, &numberOfCharacters );
+			if( numberOfCharacters!=processesArgument.size() || processes<1 ) throw std::runtime_error( "The number of processes must be a positive integer" );
+			numberOfProcesses=processes;
+		}
+		if( commandLineParser.optionHasBeenSet( "sum-of-weights-cache" ) ) sumOfWeightsCacheDirectory=commandLineParser.optionArguments("sum-of-weights-cache").back();
 		if( commandLineParser.nonOptionArguments().size()<2 ) throw std::runtime_error( "Not enough command line arguments" );
 
 		const std::vector<std::string>& arguments=commandLineParser.nonOptionArguments();
@@ -72,9 +101,17 @@ int main( int argc, char* argv[] )
 		else throw std::logic_error( "The number of bunches has not been programmed for the bunch spacing selected" );
 
 
-		std::cout << "Loading sample from the file " << sampleFilename << std::endl;
-		std::unique_ptr<l1menu::ISample> pSample=l1menu::tools::loadSample( sampleFilename );
-		pSample->setEventRate( orbitsPerSecond*numberOfBunches*scaleToKiloHz );
+		const float eventRate=orbitsPerSecond*numberOfBunches*scaleToKiloHz;
+
+		// When using several processes each one loads the sample itself
+		std::unique_ptr<l1menu::ISample> pSample;
+		if( numberOfProcesses==1 )
+		{
+			std::cout << "Loading sample from the file " << sampleFilename << std::endl;
+			pSample=l1menu::tools::loadSample( sampleFilename );
+			setSumOfWeightsCacheDirectory( *pSample, sumOfWeightsCacheDirectory );
+			pSample->setEventRate( eventRate );
+		}
 
 		std::cout << "Loading menu from file " << menuFilename << std::endl;
 		std::unique_ptr<l1menu::TriggerMenu> pMenu=l1menu::tools::loadMenu( menuFilename );
@@ -92,8 +129,39 @@ int main( int argc, char* argv[] )
 		rateVersusThresholdPlots.setDirectory( pMyRootFile.get() );
 		rateVersusThresholdPlots.relinquishOwnershipOfPlots();
 
-		std::cout << "Calculating rate plots..." << std::endl;
-		rateVersusThresholdPlots.addSample( *pSample );
+		if( numberOfProcesses==1 )
+		{
+			std::cout << "Calculating rate plots..." << std::endl;
+			rateVersusThresholdPlots.addSample( *pSample );
+		}
+		else
+		{
+			std::cout << "Calculating rate plots in " << numberOfProcesses << " processes..." << std::endl;
+			// Nothing in this process can have used the ThreadPool before this, see runInChildProcesses.
+			const size_t threadsPerProcess=std::max<size_t>( 1, std::thread::hardware_concurrency()/numberOfProcesses );
+			std::vector<std::string> serialisedContents=l1menu::tools::runInChildProcesses( numberOfProcesses, [&]( size_t processNumber )->std::string
+			{
+				l1menu::tools::ThreadPool::instance().setNumberOfThreads( threadsPerProcess );
+				std::unique_ptr<l1menu::ISample> pProcessSample=l1menu::tools::loadSample( sampleFilename );
+				setSumOfWeightsCacheDirectory( *pProcessSample, sumOfWeightsCacheDirectory );
+				pProcessSample->setEventRate( eventRate );
+				const size_t numberOfChunks=l1menu::PartialMenuRate::numberOfChunks( *pProcessSample );
+
+				l1menu::PartialMenuRatePlots partialPlots( rateVersusThresholdPlots );
+				partialPlots.addSample( *pProcessSample, numberOfChunks*processNumber/numberOfProcesses, numberOfChunks*(processNumber+1)/numberOfProcesses );
+				std::ostringstream output;
+				partialPlots.serialise( output );
+				return output.str();
+			} );
+
+			l1menu::PartialMenuRatePlots totalPlots( rateVersusThresholdPlots );
+			for( const auto& contents : serialisedContents )
+			{
+				std::istringstream input( contents );
+				totalPlots.merge( l1menu::PartialMenuRatePlots( rateVersusThresholdPlots, input ) );
+			}
+			totalPlots.addTo( rateVersusThresholdPlots );
+		}
 	}
 	catch( std::exception& error )
 	{
@@ -1,32 +1,94 @@
 #include "l1menu/FullSample.h"
 #include "l1menu/TriggerMenu.h"
 #include "l1menu/ReducedSample.h"
+#include "l1menu/tools/fileIO.h"
+#include "l1menu/tools/CommandLineParser.h"
+#include "l1menu/tools/ThreadPool.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <stdexcept>
 
+void printUsage( const std::string& executableName, std::ostream& output=std::cout )
+{
+	output << "Usage:" << "\n"
+			<< "\t" << executableName << " [--output <output filename>] [--threads <number>] [--format <version>] [--quantise] [--sum-of-weights-cache <directory>] <menu file> <input ntuple 1> [input ntuple 2 [...] ]" << "\n"
+			<< "\t" << "\t" << "Creates an l1menu::ReducedSample in protobuf format from the input files specified on the" << "\n"
+			<< "\t" << "\t" << "command line. The \"output\" option allows you to specify the filename for the output (default" << "\n"
+			<< "\t" << "\t" << "is \"reducedSample.proto\"). The \"threads\" option sets how many threads to use, with the default" << "\n"
+			<< "\t" << "\t" << "of one per core. The output is the same whatever the number of threads. The \"format\" option" << "\n"
+			<< "\t" << "\t" << "sets the file format version: 1 (the default) is gzipped and can be read on any machine but" << "\n"
+			<< "\t" << "\t" << "is slow to load, 2 loads almost instantly because it's memory mapped but is several times" << "\n"
+			<< "\t" << "\t" << "larger, and 3 is compressed in blocks that are decompressed in parallel when loaded. Formats" << "\n"
+			<< "\t" << "\t" << "2 and 3 can only be read on machines with the same byte order as the one that wrote them." << "\n"
+			<< "\t" << "\t" << "The \"quantise\" option, only for format 3, stores thresholds that are exact multiples of a" << "\n"
+			<< "\t" << "\t" << "power of two step (e.g. 0.5 GeV) in 16 bits. The \"sum-of-weights-cache\" option gives a directory" << "\n"
+			<< "\t" << "\t" << "to save the sum of the event weights of each input ntuple in, so that they're only added up once." << "\n"
+			<< "\n"
+			<< "\t" << executableName << " --help" << "\n"
+			<< "\t" << "\t" << "prints this help message"
+			<< "\n"
+			<< std::endl;
+}
 
 int main( int argc, char* argv[] )
 {
 	std::string outputFilename="reducedSample.proto";
+	unsigned int fileFormatVersion=1;
+	bool quantiseThresholds=false;
+	std::string sumOfWeightsCacheDirectory; // empty means don't save the sums of weights
+	std::string menuFilename;
+	std::vector<std::string> inputFilenames;
 
-	if( argc<3 )
+	l1menu::tools::CommandLineParser commandLineParser;
+	try
 	{
-		std::string executableName=argv[0];
-		size_t lastSlashPosition=executableName.find_last_of('/');
-		if( lastSlashPosition!=std::string::npos ) executableName=executableName.substr( lastSlashPosition+1, std::string::npos );
-		std::cerr << "   Usage: " << executableName << " <menu file> <input ntuple 1> [input ntuple 2 [...] ]" << "\n"
-				<< " Creates an l1menu::ReducedSample in protobuf format from the input files specified on the "
-				<< "command line. The output file is called \"" << outputFilename << "\"." << std::endl;
-		return -1;
-	}
+		commandLineParser.addOption( "help", l1menu::tools::CommandLineParser::NoArgument );
+		commandLineParser.addOption( "output", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "threads", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "format", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "quantise", l1menu::tools::CommandLineParser::NoArgument );
+		commandLineParser.addOption( "sum-of-weights-cache", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.parse( argc, argv );
 
-	std::string menuFilename=argv[1];
+		if( commandLineParser.optionHasBeenSet( "help" ) )
+		{
+			printUsage( commandLineParser.executableName() );
+			return 0;
+		}
 
-	std::vector<std::string> inputFilenames;
-	for( int index=2; index<argc; ++index ) inputFilenames.push_back( argv[index] );
+		if( commandLineParser.optionHasBeenSet( "output" ) ) outputFilename=commandLineParser.optionArguments("output").back();
+		if( commandLineParser.optionHasBeenSet( "threads" ) )
+		{
+			const std::string& threadsArgument=commandLineParser.optionArguments("threads").back();
+			size_t numberOfCharacters;
+			int numberOfThreads=std::stoi( threadsArgument, &numberOfCharacters );
+			if( numberOfCharacters!=threadsArgument.size() || numberOfThreads<1 ) throw std::runtime_error( "The number of threads must be a positive integer" );
+			l1menu::tools::ThreadPool::instance().setNumberOfThreads( numberOfThreads );
+		}
+		if( commandLineParser.optionHasBeenSet( "format" ) )
+		{
+			const std::string& formatArgument=commandLineParser.optionArguments("format").back();
+			if( formatArgument=="1" ) fileFormatVersion=1;
+			else if( formatArgument=="2" ) fileFormatVersion=2;
+			else if( formatArgument=="3" ) fileFormatVersion=3;
+			else throw std::runtime_error( "The file format version must be 1, 2 or 3" );
+		}
+		if( commandLineParser.optionHasBeenSet( "quantise" ) ) quantiseThresholds=true;
+		if( commandLineParser.optionHasBeenSet( "sum-of-weights-cache" ) ) sumOfWeightsCacheDirectory=commandLineParser.optionArguments("sum-of-weights-cache").back();
+		if( quantiseThresholds && fileFormatVersion!=3 ) throw std::runtime_error( "The quantise option can only be used with format 3" );
+		if( commandLineParser.nonOptionArguments().size()<2 ) throw std::runtime_error( "Not enough command line arguments" );
 
+		const std::vector<std::string>& arguments=commandLineParser.nonOptionArguments();
+		menuFilename=arguments[0];
+		inputFilenames.assign( arguments.begin()+1, arguments.end() );
+	} // end of try block
+	catch( std::exception& error )
+	{
+		std::cerr << "Error parsing the command line: " << error.what() << std::endl;
+		printUsage( commandLineParser.executableName(), std::cerr );
+		return -1;
+	}
 
 	try
 	{
@@ -35,14 +97,16 @@ int main( int argc, char* argv[] )
 
 		l1menu::ReducedSample outputReducedSample( *pMyMenu );
 
+		std::cout << "Using " << l1menu::tools::ThreadPool::instance().numberOfThreads() << " threads" << std::endl;
 		for( const auto& filename : inputFilenames )
 		{
 			l1menu::FullSample inputSample;
 			inputSample.loadFile(filename);
+			if( !sumOfWeightsCacheDirectory.empty() ) inputSample.setSumOfWeightsCacheDirectory( sumOfWeightsCacheDirectory );
 			outputReducedSample.addSample( inputSample );
 		}
 
-		outputReducedSample.saveToFile( outputFilename );
+		outputReducedSample.saveToFile( outputFilename, fileFormatVersion, quantiseThresholds );
 		std::cout << "Reduced sample saved to " << outputFilename << std::endl;
 	}
 	catch( std::exception& error )
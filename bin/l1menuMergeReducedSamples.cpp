@@ -0,0 +1,146 @@
+#include "l1menu/TriggerMenu.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/tools/CommandLineParser.h"
+#include "l1menu/tools/ThreadPool.h"
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+void printUsage( const std::string& executableName, std::ostream& output=std::cout )
+{
+	output << "Usage:" << "\n"
+			<< "\t" << executableName << " [--output <output filename>] [--shards <number>] [--threads <number>] [--format <version>] [--quantise] <input sample 1> [input sample 2 [...] ]" << "\n"
+			<< "\t" << "\t" << "Merges l1menu::ReducedSample files made separately, e.g. from different parts of a dataset. The" << "\n"
+			<< "\t" << "\t" << "menu is taken from the first file, and every other file must have been made with all of the" << "\n"
+			<< "\t" << "\t" << "triggers in it. Events are kept in the order of the files on the command line. The \"output\"" << "\n"
+			<< "\t" << "\t" << "option allows you to specify the filename for the output (default is \"mergedSample.proto\")." << "\n"
+			<< "\t" << "\t" << "The \"shards\" option splits the merged events into that many files of about the same number" << "\n"
+			<< "\t" << "\t" << "of events, named by adding \"_0\", \"_1\" and so on before the extension of the output filename." << "\n"
+			<< "\t" << "\t" << "Giving a single input file with this option just splits it up. Merging the shards again gives" << "\n"
+			<< "\t" << "\t" << "back exactly the original sample. The \"threads\", \"format\" and \"quantise\" options are the" << "\n"
+			<< "\t" << "\t" << "same as for l1menuCreateReducedSample." << "\n"
+			<< "\n"
+			<< "\t" << executableName << " --help" << "\n"
+			<< "\t" << "\t" << "prints this help message"
+			<< "\n"
+			<< std::endl;
+}
+
+/** @brief Adds "_<shardNumber>" before the extension of the filename, or at the end if there isn't an extension. */
+std::string shardFilename( const std::string& filename, size_t shardNumber )
+{
+	size_t extensionPosition=filename.find_last_of( '.' );
+	size_t lastSlashPosition=filename.find_last_of( '/' );
+	if( extensionPosition==std::string::npos || (lastSlashPosition!=std::string::npos && extensionPosition<lastSlashPosition) ) extensionPosition=filename.size();
+
+	return filename.substr( 0, extensionPosition )+"_"+std::to_string( shardNumber )+filename.substr( extensionPosition );
+}
+
+int main( int argc, char* argv[] )
+{
+	std::string outputFilename="mergedSample.proto";
+	unsigned int fileFormatVersion=1;
+	bool quantiseThresholds=false;
+	size_t numberOfShards=0;
+	std::vector<std::string> inputFilenames;
+
+	l1menu::tools::CommandLineParser commandLineParser;
+	try
+	{
+		commandLineParser.addOption( "help", l1menu::tools::CommandLineParser::NoArgument );
+		commandLineParser.addOption( "output", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "shards", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "threads", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "format", l1menu::tools::CommandLineParser::RequiredArgument );
+		commandLineParser.addOption( "quantise", l1menu::tools::CommandLineParser::NoArgument );
+		commandLineParser.parse( argc, argv );
+
+		if( commandLineParser.optionHasBeenSet( "help" ) )
+		{
+			printUsage( commandLineParser.executableName() );
+			return 0;
+		}
+
+		if( commandLineParser.optionHasBeenSet( "output" ) ) outputFilename=commandLineParser.optionArguments("output").back();
+		if( commandLineParser.optionHasBeenSet( "shards" ) )
+		{
+			const std::string& shardsArgument=commandLineParser.optionArguments("shards").back();
+			size_t numberOfCharacters;
+			int shards=std::stoi( shardsArgument, &numberOfCharacters );
+			if( numberOfCharacters!=shardsArgument.size() || shards<1 ) throw std::runtime_error( "The number of shards must be a positive integer" );
+			numberOfShards=shards;
+		}
+		if( commandLineParser.optionHasBeenSet( "threads" ) )
+		{
+			const std::string& threadsArgument=commandLineParser.optionArguments("threads").back();
+			size_t numberOfCharacters;
+			int numberOfThreads=std::stoi( threadsArgument, &numberOfCharacters );
+			if( numberOfCharacters!=threadsArgument.size() || numberOfThreads<1 ) throw std::runtime_error( "The number of threads must be a positive integer" );
+			l1menu::tools::ThreadPool::instance().setNumberOfThreads( numberOfThreads );
+		}
+		if( commandLineParser.optionHasBeenSet( "format" ) )
+		{
+			const std::string& formatArgument=commandLineParser.optionArguments("format").back();
+			if( formatArgument=="1" ) fileFormatVersion=1;
+			else if( formatArgument=="2" ) fileFormatVersion=2;
+			else if( formatArgument=="3" ) fileFormatVersion=3;
+			else throw std::runtime_error( "The file format version must be 1, 2 or 3" );
+		}
+		if( commandLineParser.optionHasBeenSet( "quantise" ) ) quantiseThresholds=true;
+		if( quantiseThresholds && fileFormatVersion!=3 ) throw std::runtime_error( "The quantise option can only be used with format 3" );
+		if( commandLineParser.nonOptionArguments().empty() ) throw std::runtime_error( "No input files given" );
+
+		inputFilenames=commandLineParser.nonOptionArguments();
+	} // end of try block
+	catch( std::exception& error )
+	{
+		std::cerr << "Error parsing the command line: " << error.what() << std::endl;
+		printUsage( commandLineParser.executableName(), std::cerr );
+		return -1;
+	}
+
+	try
+	{
+		std::cout << "Using " << l1menu::tools::ThreadPool::instance().numberOfThreads() << " threads" << std::endl;
+
+		// The menu of the first file is the one used for the output. Only one input is loaded at a time.
+		std::unique_ptr<l1menu::ReducedSample> pMergedSample;
+		for( const auto& filename : inputFilenames )
+		{
+			std::cout << "Adding events from " << filename << std::endl;
+			l1menu::ReducedSample inputSample( filename );
+			if( pMergedSample==nullptr ) pMergedSample.reset( new l1menu::ReducedSample( inputSample.getTriggerMenu() ) );
+			pMergedSample->addSample( inputSample );
+		}
+		std::cout << "Merged sample has " << pMergedSample->numberOfEvents() << " events" << std::endl;
+
+		if( numberOfShards==0 )
+		{
+			pMergedSample->saveToFile( outputFilename, fileFormatVersion, quantiseThresholds );
+			std::cout << "Merged sample saved to " << outputFilename << std::endl;
+		}
+		else
+		{
+			const size_t numberOfEvents=pMergedSample->numberOfEvents();
+			for( size_t shardNumber=0; shardNumber<numberOfShards; ++shardNumber )
+			{
+				const size_t firstEvent=numberOfEvents*shardNumber/numberOfShards;
+				const size_t lastEvent=numberOfEvents*(shardNumber+1)/numberOfShards;
+
+				l1menu::ReducedSample shardSample( pMergedSample->getTriggerMenu() );
+				shardSample.addSample( *pMergedSample, firstEvent, lastEvent );
+
+				const std::string filename=shardFilename( outputFilename, shardNumber );
+				shardSample.saveToFile( filename, fileFormatVersion, quantiseThresholds );
+				std::cout << "Events " << firstEvent << " to " << lastEvent << " saved to " << filename << std::endl;
+			}
+		}
+	}
+	catch( std::exception& error )
+	{
+		std::cerr << "Exception caught: " << error.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
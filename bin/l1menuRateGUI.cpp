@@ -10,6 +10,7 @@
 #include "l1menu/ITriggerRate.h"
 #include "l1menu/TriggerConstraint.h"
 #include "l1menu/ReducedSample.h"
+#include "l1menu/IncrementalMenuRate.h"
 #include "l1menu/IL1MenuFile.h"
 #include "l1menu/tools/miscellaneous.h"
 
@@ -69,8 +70,12 @@ namespace menuwidgets
 		void calculateRates();
 		void saveMenu();
 	private:
+		/** @brief Passes the current state of the trigger widgets on to pIncrementalRate_ and gets the rates. */
+		std::shared_ptr<const l1menu::IMenuRate> updateRates();
 		l1menu::ReducedSample& sample_;
 		l1menu::TriggerMenu menu_;
+		/// Keeps track of which events pass which triggers, so that only changed triggers need to be recalculated
+		std::unique_ptr<l1menu::IncrementalMenuRate> pIncrementalRate_;
 		std::vector<TriggerWidget*> triggerWidgets_;
 		std::unique_ptr<QDoubleSpinBox> pCollisionRate_;
 		std::unique_ptr<QPushButton> pCalculateRateButton_;
@@ -229,7 +234,8 @@ void menuwidgets::TriggerWidget::thresholdChanged( double value )
 
 }
 
-menuwidgets::MainWidget::MainWidget( l1menu::ReducedSample& sample ) : sample_(sample), menu_(sample.getTriggerMenu())
+menuwidgets::MainWidget::MainWidget( l1menu::ReducedSample& sample )
+	: sample_(sample), menu_(sample.getTriggerMenu()), pIncrementalRate_( new l1menu::IncrementalMenuRate(sample,menu_) )
 {
 	std::unique_ptr<QVBoxLayout> pTriggerListLayout( new QVBoxLayout );
 
@@ -290,15 +296,7 @@ void menuwidgets::MainWidget::calculateRates()
 	// click on it multiple times.
 	pCalculateRateButton_->setDisabled(true);
 
-	// Create a menu by copying just the triggers that are active
-	l1menu::TriggerMenu menuForCalculation;
-	for( const auto& pTriggerWidget : triggerWidgets_ )
-	{
-		if( pTriggerWidget->isEnabled() ) menuForCalculation.addTrigger( pTriggerWidget->trigger() );
-	}
-
-	sample_.setEventRate( pCollisionRate_->value() );
-	std::shared_ptr<const l1menu::IMenuRate> pMenuRate=sample_.rate(menuForCalculation);
+	std::shared_ptr<const l1menu::IMenuRate> pMenuRate=updateRates();
 	pTotalRateLabel_->setText( ("Total rate= "+std::to_string(pMenuRate->totalRate())+" +/- "+std::to_string(pMenuRate->totalRateError())+" kHz").c_str() );
 
 	// The trigger rates should be in the same order as the active trigger widgets
@@ -338,8 +336,7 @@ void menuwidgets::MainWidget::saveMenu()
 		// used if the menu is scaled for a particular bandwidth. To work out what
 		// this is I'll fit the menu again. I could read the rates from the text
 		// boxes but the user could have edited the menu since the last fit.
-		sample_.setEventRate( pCollisionRate_->value() );
-		std::shared_ptr<const l1menu::IMenuRate> pMenuRate=sample_.rate(menuToSave);
+		std::shared_ptr<const l1menu::IMenuRate> pMenuRate=updateRates();
 
 		for( size_t index=0; index<menuToSave.numberOfTriggers(); ++index )
 		{
@@ -353,4 +350,18 @@ void menuwidgets::MainWidget::saveMenu()
 	}
 }
 
+std::shared_ptr<const l1menu::IMenuRate> menuwidgets::MainWidget::updateRates()
+{
+	// The trigger widgets are in the same order as the triggers in the menu. Only
+	// triggers that have actually changed get recalculated.
+	for( size_t index=0; index<triggerWidgets_.size(); ++index )
+	{
+		pIncrementalRate_->setTriggerEnabled( index, triggerWidgets_[index]->isEnabled() );
+		pIncrementalRate_->setTriggerParameters( index, triggerWidgets_[index]->trigger() );
+	}
+
+	sample_.setEventRate( pCollisionRate_->value() );
+	return pIncrementalRate_->rate();
+}
+
 #include "l1menuRateGUI.moc"
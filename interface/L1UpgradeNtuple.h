@@ -18,6 +18,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include "Rtypes.h"
 
 //
@@ -133,18 +134,34 @@ public:
 	virtual Int_t GetEntry( Long64_t entry );
 	virtual Long64_t LoadTree( Long64_t entry );
 	virtual void Init();
+	/** @brief Only read the given branches, through a TTreeCache on each tree that's still read.
+	 *
+	 * Every branch of every tree is switched off except the ones listed, each given as the chain
+	 * (e.g. fChain or ftreeUpgrade) and the name of the top level branch, which is switched on along
+	 * with all of its sub-branches. Data members for branches that are switched off are left as
+	 * they are by GetEntry. Each chain with branches switched on gets a cache of cacheSize bytes,
+	 * with the listed branches added to it whenever a new file is opened so that they're read in
+	 * as few requests as possible. Anything else read in the first cacheLearnEntries entries of a
+	 * file is added to the cache as well.
+	 */
+	void SetReadPlan( const std::vector< std::pair<TChain*,std::string> >& branchesToRead, Long64_t cacheSize, Int_t cacheLearnEntries );
 	//virtual void     Loop();
 	// Don't need these for now
 	//void Test();
 	//void Test2();
 	Long64_t GetEntries();
+	/** @brief The ntuple files in the chains, in order. */
+	const std::vector<std::string>& GetNtupleFilenames() const;
 
 private:
 	bool CheckFirstFile();
 	bool OpenWithoutInit();
 	bool OpenNtupleList( const std::string & fname );
+	/** @brief Adds the branches in readPlan_ to the caches of the trees that have just been opened. */
+	void AddReadPlanToCaches();
 
 	std::vector<std::string> listNtuples;
+	std::vector< std::pair<TChain*,std::string> > readPlan_;
 	Long64_t nentries_;
 	TFile* rf;
 };
@@ -37,9 +37,17 @@ namespace l1menu
 		void loadFile( const std::string& filename );
 		void loadFilesFromList( const std::string& filenameOfList );
 		const l1menu::L1TriggerDPGEvent& getFullEvent( size_t eventNumber ) const;
+		/** @brief Sets a directory to save the sum of the event weights of each ntuple file in, so that they're only added up once.
+		 *
+		 * By default nothing is saved and sumOfWeights() reads the weights of every file each time a sample
+		 * is loaded. The files written are named after the ntuple's UUID and number of entries, so the same
+		 * directory can be shared between samples and jobs.
+		 */
+		void setSumOfWeightsCacheDirectory( const std::string& directory );
 
 		virtual size_t numberOfEvents() const;
 		virtual const l1menu::IEvent& getEvent( size_t eventNumber ) const;
+		virtual std::unique_ptr<l1menu::IEventCursor> createEventCursor() const;
 		virtual std::unique_ptr<l1menu::ICachedTrigger> createCachedTrigger( const l1menu::ITrigger& trigger ) const;
 		virtual float eventRate() const;
 		virtual void setEventRate( float rate );
@@ -0,0 +1,40 @@
+#ifndef l1menu_IEventCursor_h
+#define l1menu_IEventCursor_h
+
+#include <stddef.h> // required for size_t
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	class IEvent;
+}
+
+
+namespace l1menu
+{
+	/** @brief An independent way of reading events from an ISample, so that several threads can read at once.
+	 *
+	 * ISample::getEvent returns a reference to an event object that is shared by everything using
+	 * the sample, so it is overwritten on every call and can't be used from more than one thread.
+	 * Each cursor has its own event object (and whatever else is needed to read events, e.g. its own
+	 * handle on the input files). Create one cursor per thread with ISample::createEventCursor; a
+	 * single cursor is no more thread safe than ISample::getEvent is.
+	 *
+	 * The cursor must not outlive the sample that created it.
+	 */
+	class IEventCursor
+	{
+	public:
+		virtual ~IEventCursor() {}
+		/** @brief Returns the requested event. The reference is valid until the next call on this cursor.
+		 *
+		 * @throw   std::runtime_error if eventNumber is out of range.
+		 */
+		virtual const l1menu::IEvent& getEvent( size_t eventNumber ) = 0;
+	}; // end of class IEventCursor
+
+} // end of namespace l1menu
+
+#endif
@@ -13,6 +13,7 @@ namespace l1menu
 	class IEvent;
 	class ITrigger;
 	class ICachedTrigger;
+	class IEventCursor;
 	class MenuRatePlots;
 }
 
@@ -30,7 +31,14 @@ namespace l1menu
 		virtual ~ISample() {}
 
 		virtual size_t numberOfEvents() const = 0;
+		/** @brief Returns the requested event. Not thread safe, see createEventCursor().
+		 *
+		 * The same event object is reused for every call, so the reference is only valid until
+		 * the next call to getEvent.
+		 */
 		virtual const l1menu::IEvent& getEvent( size_t eventNumber ) const = 0;
+		/** @brief Creates an independent reader for events. Use one of these per thread for concurrent access. */
+		virtual std::unique_ptr<l1menu::IEventCursor> createEventCursor() const = 0;
 
 		virtual std::unique_ptr<l1menu::ICachedTrigger> createCachedTrigger( const l1menu::ITrigger& trigger ) const = 0;
 		/** @brief The rate at which events are occurring. I.e. the trigger rate if every event passed. */
@@ -0,0 +1,41 @@
+#ifndef l1menu_ITightestThresholds_h
+#define l1menu_ITightestThresholds_h
+
+// Forward declarations
+namespace l1menu
+{
+	class L1TriggerDPGEvent;
+}
+
+
+namespace l1menu
+{
+	/** @brief Optional interface for triggers that can work out the tightest thresholds that pass an event directly.
+	 *
+	 * Creating a ReducedSample needs the tightest thresholds each trigger would pass each event with. Without
+	 * this interface l1menu::tools::setTriggerThresholdsAsTightAsPossible finds them by bisection, which means
+	 * around twenty calls to ITrigger::apply for every threshold. Triggers can also inherit from this interface
+	 * if the answer is simple to work out, e.g. for a single object trigger it's just the highest pt of the
+	 * objects that pass all of the other cuts. Triggers that don't implement this still work, just slower.
+	 *
+	 * The thresholds set should be exactly those bisection would converge on with zero tolerance, i.e. the
+	 * event passes with these thresholds but fails if any of them are raised. If the thresholds are correlated
+	 * (see ITrigger::thresholdsAreCorrelated) the ratios between them at the time of the call should be kept.
+	 * Parameters other than the thresholds must not be changed.
+	 */
+	class ITightestThresholds
+	{
+	public:
+		virtual ~ITightestThresholds() {}
+
+		/** @brief Sets the thresholds to the tightest values that would still pass the event.
+		 *
+		 * @return   False if the event fails whatever the thresholds are set to, in which case the thresholds
+		 *           are left in an undefined state. True otherwise.
+		 */
+		virtual bool setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event ) = 0;
+	};
+
+} // end of namespace l1menu
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <stddef.h> // required for size_t
 #include "l1menu/ITriggerDescription.h"
 
 // Forward declarations
@@ -56,6 +57,22 @@ namespace l1menu
 		/** @brief A version of the method from ITriggerEvent that allows the parameter to be changed. */
 		virtual float& parameter( const std::string& parameterName ) = 0;
 
+		/** @brief Returns the position of the named parameter in parameterNames(), for use with parameterAt().
+		 *
+		 * Looking up a parameter by name means comparing strings, so anything that accesses the same
+		 * parameter many times should get the index once and then use parameterAt(). The index is
+		 * the same for every instance of the same trigger and version.
+		 *
+		 * @throw  std::logic_error if the trigger has no parameter with the name.
+		 */
+		virtual size_t parameterIndex( const std::string& parameterName ) const = 0;
+		/** @brief Access to the parameter at the given position in parameterNames(), without any string comparisons.
+		 *
+		 * @throw  std::out_of_range if parameterIndex is not less than the number of parameters.
+		 */
+		virtual float& parameterAt( size_t parameterIndex ) = 0;
+		virtual const float& parameterAt( size_t parameterIndex ) const = 0;
+
 		//
 		// These are the methods from ITriggerDescription that any subclass
 		// needs to implement.
@@ -0,0 +1,71 @@
+#ifndef l1menu_IncrementalMenuRate_h
+#define l1menu_IncrementalMenuRate_h
+
+#include <memory>
+#include <string>
+#include <stddef.h> // required for size_t
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	class ReducedSample;
+	class TriggerMenu;
+	class ITriggerDescription;
+	class IMenuRate;
+	class MenuRatePlots;
+}
+
+
+namespace l1menu
+{
+	/** @brief Keeps track of the rate of a menu on a ReducedSample, recalculating only what's needed when triggers change.
+	 *
+	 * ReducedSample::rate() goes through every event for every trigger, each time it's called. When
+	 * only one trigger changes between calls (e.g. moving one threshold in the GUI, or one step of a
+	 * fit) almost all of that work is repeated needlessly. This class keeps which events pass each
+	 * trigger between calls, so that changing a trigger only requires that trigger to be looked at
+	 * again, and then only the events whose result changed affect the total and pure rates.
+	 *
+	 * The rates returned are exactly the same as ReducedSample::rate() would give for the same
+	 * menu (with disabled triggers removed).
+	 *
+	 * The ReducedSample must exist for the whole lifetime of this object.
+	 */
+	class IncrementalMenuRate
+	{
+	public:
+		IncrementalMenuRate( const l1menu::ReducedSample& sample, const l1menu::TriggerMenu& menu );
+		~IncrementalMenuRate();
+
+		/** @brief The menu including all of the changes made, and including disabled triggers. */
+		const l1menu::TriggerMenu& menu() const;
+
+		/** @brief Changes one parameter of a trigger. The rates are not updated until rate() is called. */
+		void setTriggerParameter( size_t triggerNumber, const std::string& parameterName, float value );
+		/** @brief Copies all of the parameters from the supplied trigger, which should be of the same type. Only
+		 * changed values cause any recalculation. */
+		void setTriggerParameters( size_t triggerNumber, const l1menu::ITriggerDescription& trigger );
+		/** @brief Disabled triggers are treated as if they were not in the menu at all. */
+		void setTriggerEnabled( size_t triggerNumber, bool enabled );
+		bool triggerIsEnabled( size_t triggerNumber ) const;
+
+		/** @brief Brings everything up to date with any changes, and returns the rates for the enabled triggers.
+		 *
+		 * The rate for the whole sample is taken from the sample's eventRate() when this is called.
+		 * @throw  std::runtime_error if a trigger has been changed in a way the sample can't handle, e.g. a
+		 *         non threshold parameter is different to the one the sample was made with.
+		 */
+		std::shared_ptr<const l1menu::IMenuRate> rate();
+		/** @brief Overload that will use the MenuRatePlots supplied to calculate errors on the thresholds. */
+		std::shared_ptr<const l1menu::IMenuRate> rate( const l1menu::MenuRatePlots& ratePlots );
+	private:
+		IncrementalMenuRate( const IncrementalMenuRate& otherIncrementalMenuRate ) = delete;
+		IncrementalMenuRate& operator=( const IncrementalMenuRate& otherIncrementalMenuRate ) = delete;
+		std::unique_ptr<class IncrementalMenuRatePrivateMembers> pImple_;
+	}; // end of class IncrementalMenuRate
+
+} // end of namespace l1menu
+
+#endif
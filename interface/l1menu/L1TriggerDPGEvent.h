@@ -9,18 +9,21 @@ namespace L1Analysis
 {
 	class L1AnalysisDataFormat;
 }
+namespace l1menu
+{
+	struct L1TriggerObjects;
+}
 
 
 namespace l1menu
 {
-	/** @brief Wrapper for the event format. Bundles L1AnalysisDataFormat and the trigger bits into one class.
-	 *
-	 * Currently just wraps L1Analysis::L1AnalysisDataFormat (from UserCode/L1TriggerDPG) and a boolean array
-	 * for the trigger bits into one class so that it can easily be passed around. Also useful because it can
-	 * be passed around and have some operations done on it by code that has no knowledge of L1Analysis package.
+	/** @brief Wrapper for the event format. Bundles the trigger objects and the trigger bits into one class.
 	 *
-	 * Later on I might wrap the L1AnalysisDataFormat more fully so that everything can be done without
-	 * knowledge of L1AnalysisDataFormat, just using this lightweight interface.
+	 * The trigger objects are held in the flat l1menu::L1TriggerObjects layout, which is what the triggers
+	 * read. The older L1Analysis::L1AnalysisDataFormat (from UserCode/L1TriggerDPG) is still available from
+	 * rawEvent(), which converts the objects the first time it's called for each event. Also useful because
+	 * it can be passed around and have some operations done on it by code that has no knowledge of L1Analysis
+	 * package.
 	 *
 	 * @author Mark Grimes (mark.grimes@bristol.ac.uk)
 	 * @date 21/May/2013
@@ -35,7 +38,10 @@ namespace l1menu
 		L1TriggerDPGEvent& operator=( L1TriggerDPGEvent&& otherEvent ) noexcept;
 		virtual ~L1TriggerDPGEvent();
 
-		virtual L1Analysis::L1AnalysisDataFormat& rawEvent();
+		/** @brief The trigger objects for filling. The contents of anything previously returned by rawEvent() are out of date after this is called. */
+		virtual l1menu::L1TriggerObjects& triggerObjects();
+		virtual const l1menu::L1TriggerObjects& triggerObjects() const;
+		/** @brief The trigger objects converted to the old L1AnalysisDataFormat. Slower than triggerObjects(), so not for use in triggers. */
 		virtual const L1Analysis::L1AnalysisDataFormat& rawEvent() const;
 		virtual bool* physicsBits(); ///< @brief A 128 element array of the physics bits
 		virtual const bool* physicsBits() const; ///< @brief Const access to the 128 element array of the physics bits.
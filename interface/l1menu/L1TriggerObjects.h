@@ -0,0 +1,250 @@
+#ifndef l1menu_L1TriggerObjects_h
+#define l1menu_L1TriggerObjects_h
+
+#include <vector>
+
+namespace l1menu
+{
+	/** @brief Flat storage for the L1 trigger objects in one event, for the triggers to read quickly.
+	 *
+	 * Each collection has one array per quantity, along with the number of objects actually filled.
+	 * The arrays are never shrunk, so once they've grown to fit the largest event nothing is allocated
+	 * when an event is read. Triggers should index the arrays directly, only up to the number in the
+	 * collection. Whatever fills the event has to call setCapacity() on a collection before adding more
+	 * objects than its capacity().
+	 *
+	 * The contents are the same as L1Analysis::L1AnalysisDataFormat, which can still be had from
+	 * L1TriggerDPGEvent::rawEvent() for code that needs the old format. Eta and phi of the calorimeter
+	 * objects and the track objects other than muons are the calorimeter region numbers.
+	 */
+	struct L1TriggerObjects
+	{
+		static const int INITIAL_CAPACITY=16; ///< @brief The capacity of each collection when constructed
+
+		L1TriggerObjects();
+
+		struct EGs
+		{
+			int number;
+			std::vector<int> bx;
+			std::vector<float> et;
+			std::vector<float> eta;
+			std::vector<float> phi;
+			std::vector<bool> isolated;
+
+			int capacity() const { return static_cast<int>( bx.size() ); }
+			void setCapacity( int capacity )
+			{
+				bx.resize( capacity );
+				et.resize( capacity );
+				eta.resize( capacity );
+				phi.resize( capacity );
+				isolated.resize( capacity );
+			}
+		};
+
+		/** @brief Central, forward and tau jets all go in the one collection, told apart by the flags. */
+		struct Jets
+		{
+			int number;
+			std::vector<int> bx;
+			std::vector<float> et;
+			std::vector<float> eta;
+			std::vector<float> phi;
+			std::vector<bool> tau;
+			std::vector<bool> isolatedTau;
+			std::vector<bool> forward;
+
+			int capacity() const { return static_cast<int>( bx.size() ); }
+			void setCapacity( int capacity )
+			{
+				bx.resize( capacity );
+				et.resize( capacity );
+				eta.resize( capacity );
+				phi.resize( capacity );
+				tau.resize( capacity );
+				isolatedTau.resize( capacity );
+				forward.resize( capacity );
+			}
+		};
+
+		struct Muons
+		{
+			int number;
+			std::vector<int> bx;
+			std::vector<float> pt;
+			std::vector<float> eta;
+			std::vector<float> phi;
+			std::vector<int> quality;
+			std::vector<bool> isolated;
+
+			int capacity() const { return static_cast<int>( bx.size() ); }
+			void setCapacity( int capacity )
+			{
+				bx.resize( capacity );
+				pt.resize( capacity );
+				eta.resize( capacity );
+				phi.resize( capacity );
+				quality.resize( capacity );
+				isolated.resize( capacity );
+			}
+		};
+
+		/** @brief Used for the track matched electrons and taus. */
+		struct TrackObjects
+		{
+			int number;
+			std::vector<int> bx;
+			std::vector<float> et;
+			std::vector<float> eta;
+			std::vector<float> phi;
+			std::vector<float> zVertex;
+			std::vector<float> trackIsolation;
+			std::vector<bool> isolated;
+
+			int capacity() const { return static_cast<int>( bx.size() ); }
+			void setCapacity( int capacity )
+			{
+				bx.resize( capacity );
+				et.resize( capacity );
+				eta.resize( capacity );
+				phi.resize( capacity );
+				zVertex.resize( capacity );
+				trackIsolation.resize( capacity );
+				isolated.resize( capacity );
+			}
+		};
+
+		struct TrackEMs
+		{
+			int number;
+			std::vector<int> bx;
+			std::vector<float> et;
+			std::vector<float> eta;
+			std::vector<float> phi;
+			std::vector<float> trackIsolation;
+
+			int capacity() const { return static_cast<int>( bx.size() ); }
+			void setCapacity( int capacity )
+			{
+				bx.resize( capacity );
+				et.resize( capacity );
+				eta.resize( capacity );
+				phi.resize( capacity );
+				trackIsolation.resize( capacity );
+			}
+		};
+
+		struct TrackJets
+		{
+			int number;
+			std::vector<int> bx;
+			std::vector<float> et;
+			std::vector<float> eta;
+			std::vector<float> phi;
+			std::vector<float> zVertex;
+
+			int capacity() const { return static_cast<int>( bx.size() ); }
+			void setCapacity( int capacity )
+			{
+				bx.resize( capacity );
+				et.resize( capacity );
+				eta.resize( capacity );
+				phi.resize( capacity );
+				zVertex.resize( capacity );
+			}
+		};
+
+		struct TrackMuons
+		{
+			int number;
+			std::vector<int> bx;
+			std::vector<float> pt;
+			std::vector<float> eta;
+			std::vector<float> phi;
+			std::vector<float> zVertex;
+			std::vector<float> trackIsolation;
+			std::vector<int> quality;
+			std::vector<bool> isolated;
+
+			int capacity() const { return static_cast<int>( bx.size() ); }
+			void setCapacity( int capacity )
+			{
+				bx.resize( capacity );
+				pt.resize( capacity );
+				eta.resize( capacity );
+				phi.resize( capacity );
+				zVertex.resize( capacity );
+				trackIsolation.resize( capacity );
+				quality.resize( capacity );
+				isolated.resize( capacity );
+			}
+		};
+
+		struct EnergySums
+		{
+			float totalEt;
+			float missingEt;
+			float missingEtPhi;
+			float totalHt;
+			float missingHt;
+			float missingHtPhi;
+			int totalEtOverflow;
+			int missingEtOverflow;
+			int totalHtOverflow;
+			int missingHtOverflow;
+			float trackTotalEt;
+			float trackMissingEt;
+			float trackMissingEtPhi;
+			float trackTotalHt;
+			float trackMissingHt;
+			float trackMissingHtPhi;
+		};
+
+		/** @brief Empties every collection. The energy sums and the event numbers are left as they are. */
+		void clear()
+		{
+			eg.number=0;
+			jets.number=0;
+			muons.number=0;
+			trackElectrons.number=0;
+			lowPtTrackElectrons.number=0;
+			trackEMs.number=0;
+			trackTaus.number=0;
+			trackJets.number=0;
+			trackMuons.number=0;
+		}
+
+		long long run;
+		long long lumiSection;
+		long long event;
+
+		EGs eg;
+		Jets jets;
+		Muons muons;
+		TrackObjects trackElectrons;
+		TrackObjects lowPtTrackElectrons; ///< @brief A second collection of track electrons with a lower Pt cut
+		TrackEMs trackEMs;
+		TrackObjects trackTaus;
+		TrackJets trackJets;
+		TrackMuons trackMuons;
+		EnergySums sums;
+	};
+
+	inline L1TriggerObjects::L1TriggerObjects() : run(0), lumiSection(0), event(0), sums()
+	{
+		clear();
+		eg.setCapacity( INITIAL_CAPACITY );
+		jets.setCapacity( INITIAL_CAPACITY );
+		muons.setCapacity( INITIAL_CAPACITY );
+		trackElectrons.setCapacity( INITIAL_CAPACITY );
+		lowPtTrackElectrons.setCapacity( INITIAL_CAPACITY );
+		trackEMs.setCapacity( INITIAL_CAPACITY );
+		trackTaus.setCapacity( INITIAL_CAPACITY );
+		trackJets.setCapacity( INITIAL_CAPACITY );
+		trackMuons.setCapacity( INITIAL_CAPACITY );
+	}
+
+} // end of namespace l1menu
+
+#endif
@@ -47,6 +47,7 @@ namespace l1menu
 
 		void addEvent( const l1menu::IEvent& event );
 
+		/** @brief Adds the sample to every plot. Uses all threads in l1menu::tools::ThreadPool, see TriggerRatePlot::addSample. */
 		void addSample( const l1menu::ISample& sample );
 
 		/** @brief Set the root TDirectory where the histograms will reside. */
@@ -0,0 +1,84 @@
+#ifndef l1menu_PartialMenuRate_h
+#define l1menu_PartialMenuRate_h
+
+#include <memory>
+#include <iosfwd>
+#include <stddef.h> // required for size_t
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	class ISample;
+	class TriggerMenu;
+	class IMenuRate;
+}
+
+
+namespace l1menu
+{
+	/** @brief The sums of event weights for a menu rate over part of a sample, which can be saved and combined with others.
+	 *
+	 * ISample::rate() needs the whole sample in one process. This lets the work be split up between
+	 * processes, or machines, instead. Each works out a PartialMenuRate for a range of chunks of the
+	 * sample (see numberOfChunks()) and serialise()s it, then they're read back in and merge()d in
+	 * chunk order. The sums for every chunk are kept separately and only added up in rate(), in the
+	 * same order as ISample::rate() adds them, so the result is exactly the same however the chunks
+	 * were shared out. Which chunks of the sample have been added is kept and serialised along with
+	 * the sums, so that chunks missing, repeated or merged out of order are caught rather than giving
+	 * the wrong rate.
+	 */
+	class PartialMenuRate
+	{
+	public:
+		/** @brief The number of chunks the sample is split into. For ReducedSample each block of events is a chunk. */
+		static size_t numberOfChunks( const l1menu::ISample& sample );
+
+		/** @brief Creates empty sums for the menu. A copy of the menu is taken. */
+		explicit PartialMenuRate( const l1menu::TriggerMenu& menu );
+		/** @brief Reads sums written by serialise(). The menu should be the same one they were made with.
+		 *
+		 * @throw  std::runtime_error if the input is corrupt or has a different number of triggers to the menu.
+		 */
+		PartialMenuRate( const l1menu::TriggerMenu& menu, std::istream& input );
+		~PartialMenuRate();
+
+		/** @brief Works out the sums for chunks [firstChunk,lastChunk) of the sample and adds them after any already here.
+		 *
+		 * The work is shared out on l1menu::tools::ThreadPool. Every trigger in the menu has to be in the sample,
+		 * the same as for ISample::rate().
+		 * @throw  std::runtime_error if the range isn't inside the sample, or doesn't start where the chunks already
+		 *         here end.
+		 */
+		void addSample( const l1menu::ISample& sample, size_t firstChunk, size_t lastChunk );
+		/** @brief Adds the sums for every chunk of the sample. */
+		void addSample( const l1menu::ISample& sample );
+
+		/** @brief Adds the chunks from the other sums after the ones here.
+		 *
+		 * @throw  std::runtime_error if the number of triggers differs, if the sums are for a sample with a different
+		 *         number of chunks, or if the other chunks don't start where the ones here end.
+		 */
+		void merge( const l1menu::PartialMenuRate& otherPartialMenuRate );
+
+		/** @brief The number of chunks added so far. */
+		size_t numberOfChunks() const;
+
+		/** @brief Writes the sums in a binary format that the istream constructor can read, exactly as they are. */
+		void serialise( std::ostream& output ) const;
+
+		/** @brief The rates from adding up the sums of every chunk, scaled to the rate if every event passed.
+		 *
+		 * @throw  std::runtime_error if not every chunk of the sample has been added.
+		 */
+		std::shared_ptr<const l1menu::IMenuRate> rate( float eventRate ) const;
+	private:
+		PartialMenuRate( const PartialMenuRate& otherPartialMenuRate ) = delete;
+		PartialMenuRate& operator=( const PartialMenuRate& otherPartialMenuRate ) = delete;
+		std::unique_ptr<class PartialMenuRatePrivateMembers> pImple_;
+	}; // end of class PartialMenuRate
+
+} // end of namespace l1menu
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef l1menu_PartialMenuRatePlots_h
+#define l1menu_PartialMenuRatePlots_h
+
+#include <memory>
+#include <iosfwd>
+#include <stddef.h> // required for size_t
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	class ISample;
+	class MenuRatePlots;
+}
+
+
+namespace l1menu
+{
+	/** @brief The raw bin contents for a set of rate plots over part of a sample, which can be saved and combined with others.
+	 *
+	 * The rate plot equivalent of PartialMenuRate. Each process works out the contents for a range of
+	 * chunks of the sample (see PartialMenuRate::numberOfChunks()) and serialise()s them, then they're
+	 * merge()d in chunk order and added to the histograms with addTo(). The contents of each chunk are
+	 * kept separately so the result doesn't depend on how the chunks were shared out. It's exactly what
+	 * MenuRatePlots::addSample() gives.
+	 * Which chunks of the sample have been added is kept and serialised along with the contents, so that
+	 * chunks missing, repeated or merged out of order are caught.
+	 *
+	 * The MenuRatePlots given to the constructor must exist for the whole lifetime of this object.
+	 */
+	class PartialMenuRatePlots
+	{
+	public:
+		/** @brief Creates empty contents for each plot. The plots are only used for their triggers and binning, they aren't changed. */
+		explicit PartialMenuRatePlots( const l1menu::MenuRatePlots& ratePlots );
+		/** @brief Reads contents written by serialise(). The plots should be made from the same menu with the same binning.
+		 *
+		 * @throw  std::runtime_error if the input is corrupt or the number of plots or bins doesn't match.
+		 */
+		PartialMenuRatePlots( const l1menu::MenuRatePlots& ratePlots, std::istream& input );
+		~PartialMenuRatePlots();
+
+		/** @brief Works out the contents for chunks [firstChunk,lastChunk) of the sample and adds them after any already here.
+		 *
+		 * The total weight of the events in each chunk is kept with it, and addTo() scales the contents by the sample's
+		 * eventRate() over the total weight of all the chunks as in MenuRatePlots::addSample(). So nothing about the rest
+		 * of the sample is needed, but every chunk should be added before calling addTo(). The work is shared out on
+		 * l1menu::tools::ThreadPool.
+		 * @throw  std::runtime_error if the range isn't inside the sample or doesn't start where the chunks already here end,
+		 *         or if the event rate is different to chunks already here.
+		 */
+		void addSample( const l1menu::ISample& sample, size_t firstChunk, size_t lastChunk );
+
+		/** @brief Adds the chunks from the other contents after the ones here.
+		 *
+		 * @throw  std::runtime_error if the plots or the event rates are different, if the contents are for a sample with a
+		 *         different number of chunks, or if the other chunks don't start where the ones here end.
+		 */
+		void merge( const l1menu::PartialMenuRatePlots& otherPartialMenuRatePlots );
+
+		/** @brief The number of chunks added so far. */
+		size_t numberOfChunks() const;
+
+		/** @brief Writes the contents in a binary format that the istream constructor can read, exactly as they are. */
+		void serialise( std::ostream& output ) const;
+
+		/** @brief Adds up the contents of every chunk and adds them to the histograms, which should be the ones given to the constructor or identical to them.
+		 *
+		 * @throw  std::runtime_error if not every chunk of the sample has been added.
+		 */
+		void addTo( l1menu::MenuRatePlots& ratePlots ) const;
+	private:
+		PartialMenuRatePlots( const PartialMenuRatePlots& otherPartialMenuRatePlots ) = delete;
+		PartialMenuRatePlots& operator=( const PartialMenuRatePlots& otherPartialMenuRatePlots ) = delete;
+		std::unique_ptr<class PartialMenuRatePlotsPrivateMembers> pImple_;
+	}; // end of class PartialMenuRatePlots
+
+} // end of namespace l1menu
+
+#endif
@@ -11,10 +11,7 @@ namespace l1menu
 {
 	class ITrigger;
 	class ReducedSample;
-}
-namespace l1menuprotobuf
-{
-	class Event;
+	class ReducedEventBlock;
 }
 
 
@@ -42,7 +39,8 @@ namespace l1menu
 		virtual float weight() const;
 		virtual const l1menu::ISample& sample() const;
 	private:
-		l1menuprotobuf::Event* pProtobufEvent_;
+		const l1menu::ReducedEventBlock* pEventBlock_; ///< @brief The block of columns that this event is stored in
+		size_t eventInBlock_; ///< @brief The position of this event in pEventBlock_
 		const l1menu::ReducedSample& sample_; ///< @brief The sample that this event is from
 	};
 
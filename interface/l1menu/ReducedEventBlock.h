@@ -0,0 +1,91 @@
+#ifndef l1menu_ReducedEventBlock_h
+#define l1menu_ReducedEventBlock_h
+
+#include <vector>
+#include <memory>
+#include <stdint.h>
+#include <stddef.h> // required for size_t
+
+namespace l1menu
+{
+	/** @brief A block of consecutive events from a ReducedSample, stored column by column.
+	 *
+	 * Rather than holding each event as a separate object, all of the values for a given
+	 * ReducedEvent::ParameterID are stored in one contiguous array with an entry for each
+	 * event in the block. Loops over events that only need a few of the parameters (i.e.
+	 * every rate calculation) then run through memory sequentially instead of chasing
+	 * pointers from one event to the next.
+	 */
+	class ReducedEventBlock
+	{
+	public:
+		/** @brief Create an empty block with the given number of parameters per event. */
+		explicit ReducedEventBlock( size_t numberOfParameters );
+
+		/** @brief Create a block that uses columns stored somewhere else, e.g. in a memory mapped file.
+		 *
+		 * Nothing is copied, so the memory has to stay valid for as long as this block (or any copy
+		 * of it) is used. If events are added later, the existing events are copied into the block's
+		 * own storage first.
+		 *
+		 * @param[in] numberOfParameters   The number of parameters per event.
+		 * @param[in] numberOfEvents       The number of events.
+		 * @param[in] pParameterColumns    numberOfParameters columns of numberOfEvents values each, one after the other.
+		 * @param[in] pWeights             numberOfEvents event weights.
+		 */
+		ReducedEventBlock( size_t numberOfParameters, size_t numberOfEvents, const float* pParameterColumns, const float* pWeights );
+
+		size_t numberOfEvents() const;
+		size_t numberOfParameters() const;
+
+		/** @brief Pointer to the start of the column for the given parameter, with numberOfEvents() entries.
+		 *
+		 * The ParameterID numbering is the same as returned by ReducedSample::getTriggerParameterIdentifiers.
+		 * No bounds checking is performed.
+		 */
+		const float* parameterValues( size_t parameterNumber ) const;
+
+		/** @brief Pointer to the start of the column of event weights, with numberOfEvents() entries. */
+		const float* weights() const;
+
+		/** @brief The events where the parameter isn't -1, in order, if that's only a small part of the block.
+		 *
+		 * A trigger that can't pass an event at any threshold has -1 stored for all of its parameters, so
+		 * when a trigger's thresholds are all above -1 these are the only events it can pass. Loops can
+		 * then just visit these rather than every event. If more than a quarter of the events are listed
+		 * it's quicker to loop over everything, and nullptr is returned instead.
+		 *
+		 * The list is made the first time it's asked for and kept until events are added. Safe to call
+		 * from several threads at once.
+		 */
+		const std::vector<uint32_t>* candidateEvents( size_t parameterNumber ) const;
+
+		/** @brief Appends an event to the end of the block.
+		 *
+		 * @param[in] pParameterValues   Pointer to numberOfParameters() values, in ParameterID order.
+		 * @param[in] weight             The weight for the event.
+		 */
+		void addEvent( const float* pParameterValues, float weight );
+
+		/** @brief Appends all of the events in the other block, which must have the same number of parameters. */
+		void addEvents( const ReducedEventBlock& otherBlock );
+	private:
+		/// Copies the external columns into parameterColumns_ and weights_ so that they can be added to
+		void copyExternalColumns();
+		/// Throws away any candidateEvents() lists, because the events are about to change
+		void clearCandidateEvents();
+		struct CandidateEventsCache;
+		std::vector< std::vector<float> > parameterColumns_;
+		std::vector<float> weights_;
+		// These are only used if the block was created with external columns
+		bool hasExternalColumns_;
+		size_t numberOfExternalEvents_;
+		const float* pExternalParameterColumns_;
+		const float* pExternalWeights_;
+		/// Shared between copies of the block until one of them is changed, see clearCandidateEvents()
+		mutable std::shared_ptr<CandidateEventsCache> pCandidateEventsCache_;
+	};
+
+} // end of namespace l1menu
+
+#endif
@@ -4,6 +4,7 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 
 #include "l1menu/ReducedEvent.h"
 #include "l1menu/ISample.h"
@@ -14,6 +15,8 @@ namespace l1menu
 	class FullSample;
 	class TriggerMenu;
 	class ITrigger;
+	class ReducedEventBlock;
+	class SortedParameterIndex;
 }
 
 
@@ -27,26 +30,98 @@ namespace l1menu
 	class ReducedSample : public l1menu::ISample
 	{
 	public:
-		/** @brief Load from a file in protobuf format. */
+		/** @brief Load from a file written by saveToFile().
+		 *
+		 * Version 2 files are memory mapped, so this returns almost straight away and the events
+		 * are only read from disk as they're used. Version 3 files are decompressed in parallel on
+		 * l1menu::tools::ThreadPool. Version 1 files are read in and decompressed on one thread.
+		 */
 		explicit ReducedSample( const std::string& filename );
 		explicit ReducedSample( const l1menu::FullSample& originalSample, const l1menu::TriggerMenu& triggerMenu );
 		explicit ReducedSample( const l1menu::TriggerMenu& triggerMenu );
 		virtual ~ReducedSample();
 
+		/** @brief Calculates the rates for the menu straight from a file written by saveToFile(), without loading the whole sample.
+		 *
+		 * Events are read a few blocks at a time (twice the number of l1menu::tools::ThreadPool threads), added to
+		 * the rate sums and then thrown away, so memory use doesn't grow with the size of the file. The result is
+		 * exactly the same as loading the file and calling rate(). Like rate(), every trigger in the menu must have
+		 * been in the menu used to make the sample.
+		 *
+		 * @param[in] eventRate  The rate if every event passed, i.e. what would be set with setEventRate().
+		 */
+		static std::shared_ptr<const l1menu::IMenuRate> rateFromFile( const std::string& filename, const l1menu::TriggerMenu& menu, float eventRate );
+
+		/** @brief Works out the tightest thresholds for every trigger in the menu for each event in the sample, and adds them.
+		 *
+		 * Blocks of events are processed in parallel on l1menu::tools::ThreadPool, each reading from its own
+		 * event cursor, and then added in order. The result is the same whatever the number of threads.
+		 */
 		void addSample( const l1menu::FullSample& originalSample );
 
-		/** @brief Save to a file in protobuf format (protobuf in src/protobuf/l1menu.proto). */
-		void saveToFile( const std::string& filename ) const;
+		/** @brief Adds the events from another ReducedSample, e.g. one made from a different part of the same dataset.
+		 *
+		 * The other sample must contain every trigger in this sample's menu, in the sense of containsTrigger(),
+		 * otherwise a std::runtime_error is thrown. It can have extra triggers or have them in a different order;
+		 * only the thresholds for this menu are copied. Events are added into the same blocks as addSample(FullSample),
+		 * so merging the shards of a sample gives back exactly the same blocks as the original.
+		 */
+		void addSample( const l1menu::ReducedSample& otherSample );
+		/** @brief Adds only the events from firstEvent up to but not including lastEvent of the other sample. Used to split samples into shards. */
+		void addSample( const l1menu::ReducedSample& otherSample, size_t firstEvent, size_t lastEvent );
+
+		/** @brief Save to a file that can be loaded with the ReducedSample(const std::string&) constructor.
+		 *
+		 * @param[in] filename           The file to write. Any existing file is replaced.
+		 * @param[in] fileFormatVersion  Version 1 (the default) is gzipped protobuf (src/protobuf/l1menu.proto),
+		 *                               which is small and can be read on any machine but is slow to load.
+		 *                               Version 2 is uncompressed and can be memory mapped when loaded. Version 3
+		 *                               compresses each event block separately so that they can be decompressed
+		 *                               in parallel. Versions 2 and 3 are stored in the byte order of the machine
+		 *                               that wrote them, so can only be read on machines with the same byte order.
+		 * @param[in] quantiseThresholds Only for version 3. Stores each threshold that lands exactly on a power of two
+		 *                               step (e.g. 0.5 GeV) as a 16 bit step number rather than a float, which makes
+		 *                               the file smaller and quicker to load. Thresholds that don't are left as floats,
+		 *                               so the sample loads back exactly the same either way.
+		 */
+		void saveToFile( const std::string& filename, unsigned int fileFormatVersion=1, bool quantiseThresholds=false ) const;
 
 		const l1menu::TriggerMenu& getTriggerMenu() const;
 		bool containsTrigger( const l1menu::ITrigger& trigger, bool allowOlderVersion=false ) const;
 		const std::map<std::string,ReducedEvent::ParameterID> getTriggerParameterIdentifiers( const l1menu::ITrigger& trigger, bool allowOlderVersion=false ) const;
 
+		/** @brief The number of blocks the events are stored in. See eventBlock(). */
+		size_t numberOfEventBlocks() const;
+		/** @brief Direct access to the column storage of the events, for loops where speed is important.
+		 *
+		 * Events are stored in consecutive blocks, so event zero is the first event of block zero and
+		 * the first event of block one follows on from the last event of block zero. Each block holds
+		 * one contiguous column per ParameterID as given by getTriggerParameterIdentifiers().
+		 */
+		const l1menu::ReducedEventBlock& eventBlock( size_t blockNumber ) const;
+
+		/** @brief Sorted values and cumulative weights for a parameter in each event block, for fast threshold scans. See SortedParameterIndex.
+		 *
+		 * The index is created the first time it's asked for and kept until events are added with addSample(),
+		 * at which point any references previously returned are no longer valid. Safe to call from several
+		 * threads at once.
+		 */
+		const l1menu::SortedParameterIndex& sortedParameterIndex( ReducedEvent::ParameterID parameter ) const;
+
+		/** @brief The fraction of events that pass both trigger i and trigger j, for every pair of triggers in the menu.
+		 *
+		 * The returned matrix is indexed [i][j] with the trigger numbers as in the menu, and is symmetric.
+		 * The diagonal is the fraction that pass each trigger, i.e. the same as ITriggerRate::fraction().
+		 * Multiply by eventRate() to get the rate instead of the fraction.
+		 */
+		std::vector< std::vector<float> > triggerOverlapFractions( const l1menu::TriggerMenu& menu ) const;
+
 		//
 		// Implementations required for the ISample interface
 		//
 		virtual size_t numberOfEvents() const;
 		virtual const l1menu::IEvent& getEvent( size_t eventNumber ) const;
+		virtual std::unique_ptr<l1menu::IEventCursor> createEventCursor() const;
 		virtual std::unique_ptr<l1menu::ICachedTrigger> createCachedTrigger( const l1menu::ITrigger& trigger ) const;
 		virtual float eventRate() const;
 		virtual void setEventRate( float rate );
@@ -55,6 +130,11 @@ namespace l1menu
 		virtual std::shared_ptr<const l1menu::IMenuRate> rate( const l1menu::TriggerMenu& menu, const l1menu::MenuRatePlots& ratePlots ) const;
 
 	private:
+		/** @brief Load from file, but if loadEvents is false only the trigger menu is read and the sample has no events. */
+		ReducedSample( const std::string& filename, bool loadEvents );
+		/** @brief Sets the event up so that it refers to the given event number. Used by getEvent and the event cursors. */
+		void pointEventAt( l1menu::ReducedEvent& event, size_t eventNumber ) const;
+		class EventCursor;
 		std::unique_ptr<class ReducedSamplePrivateMembers> pImple_;
 	}; // end of class ReducedSample
 
@@ -0,0 +1,80 @@
+#ifndef l1menu_SortedParameterIndex_h
+#define l1menu_SortedParameterIndex_h
+
+#include <vector>
+#include <stddef.h> // required for size_t
+#include "l1menu/ReducedEvent.h"
+
+// Forward declarations
+namespace l1menu
+{
+	class ReducedSample;
+}
+
+
+namespace l1menu
+{
+	/** @brief The values of one ReducedSample parameter for every event, sorted, with cumulative sums of the event weights.
+	 *
+	 * An event passes a threshold if its value is not less than the threshold (see ReducedEvent), so
+	 * for a trigger that only depends on one ParameterID the total weight passing any threshold is
+	 * just a binary search into the sorted values. This makes scanning the rate against the threshold
+	 * independent of the number of events.
+	 *
+	 * The values are sorted separately for each ReducedSample event block, which are the chunks in
+	 * MenuRateImplementation::numberOfChunks(). That way the sums for one chunk don't depend on any
+	 * other, and the totals are always added up chunk by chunk in chunk order the same as the event
+	 * loops and PartialMenuRatePlots do.
+	 *
+	 * Get instances with ReducedSample::sortedParameterIndex() rather than creating them directly,
+	 * since they are cached there.
+	 */
+	class SortedParameterIndex
+	{
+	public:
+		SortedParameterIndex( const l1menu::ReducedSample& sample, l1menu::ReducedEvent::ParameterID parameter );
+
+		/** @brief The number of chunks, i.e. ReducedSample::numberOfEventBlocks() when the index was created. */
+		size_t numberOfChunks() const;
+		/** @brief The sum of the weights of the events in the chunk whose value passes the threshold. */
+		double chunkWeightPassing( size_t chunkNumber, float threshold ) const;
+		/** @brief The sum of the weights squared of the events in the chunk whose value passes the threshold. */
+		double chunkWeightSquaredPassing( size_t chunkNumber, float threshold ) const;
+		/** @brief The number of events in the chunk whose value passes the threshold, regardless of weight. */
+		size_t chunkNumberPassing( size_t chunkNumber, float threshold ) const;
+
+		/** @brief The sum of the weights of all events whose value passes the threshold, added up in chunk order. */
+		double weightPassing( float threshold ) const;
+		/** @brief The sum of the weights squared of all events whose value passes the threshold, added up in chunk order. */
+		double weightSquaredPassing( float threshold ) const;
+		/** @brief The number of events whose value passes the threshold, regardless of weight. */
+		size_t numberPassing( float threshold ) const;
+
+		/** @brief The lowest threshold where weightPassing() is no more than the given weight.
+		 *
+		 * Found by bisection over every possible float, so this is exact. Returns -infinity if
+		 * every event passes without going over the weight, and +infinity if even the events
+		 * with NaN, which pass every threshold, go over it.
+		 */
+		float lowestThresholdForWeight( double maximumWeight ) const;
+	private:
+		/** @brief The sorted values and the sums for one event block. */
+		struct Chunk
+		{
+			/** @brief The position in sortedValues of the first value that passes the threshold. */
+			size_t firstPassingPosition( float threshold ) const;
+
+			/// The values for every event in the block that isn't NaN, in ascending order
+			std::vector<float> sortedValues;
+			/// Entry "i" is the sum of weights from position "i" to the end of sortedValues, plus NaN events. Has an extra entry at the end.
+			std::vector<double> weightsFromPosition;
+			std::vector<double> weightsSquaredFromPosition;
+			/// The number of events with a value of NaN, which pass every threshold
+			size_t numberOfNanEvents;
+		};
+		std::vector<Chunk> chunks_;
+	}; // end of class SortedParameterIndex
+
+} // end of namespace l1menu
+
+#endif
@@ -16,6 +16,7 @@ namespace l1menu
 	class ITriggerDescription;
 	class ICachedTrigger;
 	class ISample;
+	class ReducedSample;
 }
 
 
@@ -136,6 +137,9 @@ namespace l1menu
 		 * faster than looping over the provided vector and calling addSample() on each one. FullSample needs
 		 * to do a lot of work to read a new event, so reading each event for each TriggerRatePlot is much
 		 * slower than reading the event once and passing it to each TriggerRatePlot.
+		 *
+		 * The work is shared between the threads of l1menu::tools::ThreadPool. The result is exactly the same
+		 * however many threads are used.
 		 */
 		static void addSample( const l1menu::ISample& sample, std::vector<TriggerRatePlot>& ratePlots );
 	protected:
@@ -152,8 +156,88 @@ namespace l1menu
 		std::vector< std::pair<float*,float> > otherParameterScalings_;
 		/// Flag to say whether the histogram should be deleted when this instance goes out of scope.
 		bool histogramOwnedByMe_;
-		/// The implementation that the public methods delegate to
-		void addEvent( const l1menu::IEvent& event, const std::unique_ptr<l1menu::ICachedTrigger>& pCachedTrigger, float weightPerEvent );
+		/** @brief Sums of weights for each bin, indexed by bin number so entry zero (the underflow) is unused.
+		 *
+		 * Depending on where it's used the sums are either the actual bin contents, or the weights of events
+		 * recorded at the highest bin they pass which makeCumulative() then converts to the bin contents.
+		 * Anything kept for a whole chunk (see ChunkContents) is always the actual bin contents.
+		 */
+		struct BinSums
+		{
+			explicit BinSums( size_t numberOfBins );
+			/// Records an event that passes every bin up to and including binNumber
+			void add( size_t binNumber, double weight );
+			void add( const BinSums& otherBinSums );
+			/// Converts weights recorded at the highest bin passed into bin contents
+			void makeCumulative();
+			/// Multiplies the weights by factor, and so the weights squared by factor squared
+			void scale( double factor );
+			std::vector<double> weights;
+			std::vector<double> weightsSquared;
+			double numberOfFills; ///< The number of times TH1::Fill would have been called
+		};
+		/** @brief A copy of the trigger and the pointers into it needed for the bisection.
+		 *
+		 * The bisection has to change the trigger parameters, so each thread needs its own copy.
+		 */
+		struct TriggerCopy
+		{
+			std::unique_ptr<l1menu::ITrigger> pTrigger;
+			float* pParameter;
+			std::vector< std::pair<float*,float> > otherParameterScalings;
+			std::unique_ptr<l1menu::ICachedTrigger> pCachedTrigger;
+		};
+		/** @brief Copies pTrigger_ and creates a cached trigger for it from the sample. */
+		TriggerCopy copyTrigger( const l1menu::ISample& sample ) const;
+		/** @brief Finds the highest bin where the event passes with the threshold at the bin low edge, by bisection.
+		 *
+		 * Returns zero if the event doesn't even pass at the first bin.
+		 */
+		size_t highestPassingBin( const l1menu::IEvent& event, TriggerCopy& trigger ) const;
+		/** @brief Which ReducedSample columns the plot depends on and what they're compared to, so they don't have to be looked up by name in the loops. */
+		struct ReducedSampleColumns
+		{
+			/// Columns whose threshold changes with the bin, with the scaling from the bin low edge. The versusParameter_ itself is in here with a scaling of one.
+			std::vector< std::pair<size_t,float> > scaledColumns;
+			/// Columns whose threshold is fixed regardless of the bin
+			std::vector< std::pair<size_t,float> > fixedColumns;
+			/// The low edge of each bin as a float, indexed by bin number
+			std::vector<float> binLowEdges;
+		};
+		ReducedSampleColumns reducedSampleColumns( const l1menu::ReducedSample& sample ) const;
+		/// The weights at the highest bin passed (i.e. not yet cumulative) for each block in [firstBlock,lastBlock).
+		std::vector<BinSums> reducedSampleBlockContents( const l1menu::ReducedSample& sample, const ReducedSampleColumns& columns, size_t firstBlock, size_t lastBlock ) const;
+		/** @brief Adds the contents to the histogram, as if TH1::Fill had been called contents.numberOfFills times. */
+		void addToBins( const BinSums& contents );
+		/** @brief The implementation that both addSample methods delegate to.
+		 *
+		 * The bin contents are worked out for a batch of chunks at a time with chunkContents() and added
+		 * to running totals, which are only added to the histograms at the end. The chunks are always
+		 * combined in chunk order so the result doesn't depend on the number of threads, or on whether
+		 * PartialMenuRatePlots was used instead.
+		 *
+		 * The event weights are added up in the same pass and the contents scaled by eventRate()
+		 * over the total at the end, the same as the rates are in MenuRateImplementation, rather than
+		 * calling sample.sumOfWeights() first which for FullSample would mean reading it twice.
+		 */
+		static void addSampleToPlots( const l1menu::ISample& sample, const std::vector<TriggerRatePlot*>& pRatePlots );
+		/** @brief The contents of every plot for one chunk of events, and the total weight of those events. */
+		struct ChunkContents
+		{
+			std::vector<BinSums> plotContents; ///< The bin contents, not scaled, for each plot
+			double sumOfWeights; ///< Of every event in the chunk
+		};
+		/** @brief The contents for each chunk in [firstChunk,lastChunk).
+		 *
+		 * The chunks are the same as MenuRateImplementation::numberOfChunks(). Adding these up in chunk order and scaling
+		 * by eventRate() over the total sumOfWeights gives the contents that addSampleToPlots() adds. For ReducedSample each
+		 * chunk is a block of events and the work is split between every plot and chunk, with plots that only depend on one
+		 * column read from the ReducedSample::sortedParameterIndex() for the block. Otherwise the work is split between the
+		 * chunks.
+		 */
+		static std::vector<ChunkContents> chunkContents( const l1menu::ISample& sample, const std::vector<const TriggerRatePlot*>& pRatePlots, size_t firstChunk, size_t lastChunk );
+		friend class PartialMenuRatePlots;
+		friend class PartialMenuRatePlotsPrivateMembers;
 	};
 }
 #endif
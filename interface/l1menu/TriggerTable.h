@@ -61,9 +61,20 @@ namespace l1menu
 		 */
 		std::vector<l1menu::TriggerTable::TriggerDetails> listTriggers() const;
 
+		/** @brief The names of the parameters that are thresholds, in the order l1menu::tools::getThresholdNames returns them.
+		 *
+		 * These are worked out once for each name and version when the trigger is registered, so
+		 * this is just a lookup. If the trigger isn't registered they are worked out on the fly.
+		 */
+		std::vector<std::string> getThresholdNames( const l1menu::ITriggerDescription& trigger ) const;
+
+		/** @brief The names of the parameters that aren't thresholds. Precomputed in the same way as getThresholdNames. */
+		std::vector<std::string> getNonThresholdParameterNames( const l1menu::ITriggerDescription& trigger ) const;
+
 		/** @brief List the triggers available.
 		 *
 		 * Used by the REGISTER_TRIGGER macro in RegisterTriggerMacro.h to register triggers in the table.
+		 * An instance is created straight away to work out which of the parameters are thresholds.
 		 * @param[in] name                     The name of the trigger.
 		 * @param[in] version                  The version. Higher numbers are considered more recent.
 		 * @param[in] creationFunctionPointer  A function pointer to a function with no parameters that returns an unique_ptr of the new trigger.
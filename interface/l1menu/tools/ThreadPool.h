@@ -0,0 +1,64 @@
+#ifndef l1menu_tools_ThreadPool_h
+#define l1menu_tools_ThreadPool_h
+
+#include <memory>
+#include <functional>
+#include <stddef.h> // required for size_t
+
+namespace l1menu
+{
+	namespace tools
+	{
+		/** @brief A pool of worker threads that loops over events (or anything else) can be split between.
+		 *
+		 * There is only ever one instance, retrieved with the instance() method, so that the threads
+		 * are only started once and reused for every calculation. The number of threads defaults to
+		 * the number of cores on the machine but can be changed with setNumberOfThreads().
+		 *
+		 * The pool doesn't make any promises about which order tasks are run in, so anything that
+		 * needs reproducible results (e.g. floating point sums) should store a result per task and
+		 * combine them in task order afterwards.
+		 */
+		class ThreadPool
+		{
+		public:
+			static ThreadPool& instance();
+			~ThreadPool();
+
+			/** @brief Sets the number of threads used for calls to run(), including the calling thread.
+			 *
+			 * A value of zero means use one thread for each core on the machine. A value of one means
+			 * everything is run serially on the calling thread.
+			 */
+			void setNumberOfThreads( size_t numberOfThreads );
+			size_t numberOfThreads() const;
+
+			/** @brief Whether any worker threads are running at the moment, without creating the instance.
+			 *
+			 * Worker threads are started as soon as instance() is first called (unless there is only one
+			 * core), so this is true if anything in the process has used the pool. A process with running
+			 * worker threads can't safely be forked, see l1menu::tools::runInChildProcesses.
+			 */
+			static bool workersAreRunning();
+
+			/** @brief Calls task(taskNumber) for every taskNumber in [0,numberOfTasks) and waits for them all to finish.
+			 *
+			 * The calling thread also runs tasks while it waits. If this is called from within a task
+			 * (or while another thread is already using the pool) the tasks are just run serially on
+			 * the calling thread.
+			 *
+			 * @throw   If any of the tasks throw an exception, the remaining tasks are still run and then
+			 *          the first exception is rethrown.
+			 */
+			void run( size_t numberOfTasks, const std::function<void(size_t)>& task );
+		private:
+			ThreadPool();
+			ThreadPool( const ThreadPool& otherThreadPool ) = delete;
+			ThreadPool& operator=( const ThreadPool& otherThreadPool ) = delete;
+			std::unique_ptr<class ThreadPoolPrivateMembers> pImple_;
+		};
+
+	} // end of the tools namespace
+} // end of the l1menu namespace
+
+#endif
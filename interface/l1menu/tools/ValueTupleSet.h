@@ -0,0 +1,104 @@
+#ifndef l1menu_tools_ValueTupleSet_h
+#define l1menu_tools_ValueTupleSet_h
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <stdint.h>
+#include <stddef.h> // required for size_t
+
+namespace l1menu
+{
+	namespace tools
+	{
+		/** @brief A set of tuples of numbers, used to find duplicate objects and to match objects between lists in linear time.
+		 *
+		 * Values are compared with == the same as the pairwise loops this replaced in FullSample, so e.g. 0 and -0
+		 * match and NaN never matches anything. The storage is kept when clear() is called, so once it's big enough
+		 * for the largest event nothing else is allocated.
+		 *
+		 * Slots are marked as filled with a generation number that clear() increments, so the table only has to be
+		 * wiped when that wraps around. T_generation is the type of that number, which only needs changing to test
+		 * the wrap around without calling clear() billions of times.
+		 */
+		template<size_t NUMBER_OF_VALUES,class T_generation=unsigned int>
+		class ValueTupleSet
+		{
+		public:
+			typedef std::array<double,NUMBER_OF_VALUES> Tuple;
+
+			ValueTupleSet() : currentGeneration_(0), size_(0), maximumSize_(0) {}
+
+			/** @brief Empties the set, making sure there's room for up to maximumSize tuples. Must be called before anything else. */
+			void clear( size_t maximumSize )
+			{
+				// Keep the table at most half full so that the probe sequences stay short
+				size_t requiredSlots=16;
+				while( requiredSlots<2*maximumSize ) requiredSlots*=2;
+
+				// Slots only count as filled if they have the current generation number, so the table
+				// doesn't have to be wiped unless it's resized or the generation number wraps around.
+				if( requiredSlots>slots_.size() || ++currentGeneration_==0 )
+				{
+					slots_.resize( std::max( requiredSlots, slots_.size() ) );
+					slotGenerations_.assign( slots_.size(), 0 );
+					currentGeneration_=1;
+				}
+				size_=0;
+				maximumSize_=maximumSize;
+			}
+
+			/** @brief Adds the tuple unless there's an equal one already. Returns true if it was added. */
+			bool insert( const Tuple& tuple )
+			{
+				const size_t slot=findSlot( tuple );
+				if( slotGenerations_[slot]==currentGeneration_ ) return false;
+
+				if( size_==maximumSize_ ) throw std::logic_error( "ValueTupleSet - more tuples were added than given to clear()" );
+				slots_[slot]=tuple;
+				slotGenerations_[slot]=currentGeneration_;
+				++size_;
+				return true;
+			}
+
+			bool contains( const Tuple& tuple ) const
+			{
+				return slotGenerations_[findSlot( tuple )]==currentGeneration_;
+			}
+		private:
+			/** @brief The slot holding a tuple equal to the one given, or the empty slot it would go in if there isn't one. */
+			size_t findSlot( const Tuple& tuple ) const
+			{
+				const size_t mask=slots_.size()-1;
+				size_t slot=hash( tuple )&mask;
+				while( slotGenerations_[slot]==currentGeneration_ && slots_[slot]!=tuple ) slot=(slot+1)&mask;
+				return slot;
+			}
+
+			static size_t hash( const Tuple& tuple )
+			{
+				uint64_t result=0;
+				for( double value : tuple )
+				{
+					if( value==0 ) value=0; // -0 has to hash the same as 0 because they compare equal
+					uint64_t bits;
+					std::memcpy( &bits, &value, sizeof(bits) );
+					result=(result^bits)*0x9e3779b97f4a7c15ULL;
+					result^=result>>32;
+				}
+				return static_cast<size_t>( result );
+			}
+
+			std::vector<Tuple> slots_;
+			std::vector<T_generation> slotGenerations_;
+			T_generation currentGeneration_;
+			size_t size_;
+			size_t maximumSize_;
+		};
+
+	} // end of namespace tools
+} // end of namespace l1menu
+
+#endif
@@ -9,6 +9,7 @@
 #include <string>
 #include <memory>
 #include <utility>
+#include <functional>
 #include <iosfwd>
 
 //
@@ -32,6 +33,9 @@ namespace l1menu
 		 * "threshold2" etcetera. Also looks for things of the form "leg1threshold1", "leg2threshold1"
 		 * etcetera for when I get around to implementing the cross triggers.
 		 *
+		 * The result is cached in the TriggerTable when each trigger is registered, so this is
+		 * cheap enough to call inside event loops. See TriggerTable::getThresholdNames.
+		 *
 		 * @param[in] trigger    The trigger to check.
 		 * @return               A std::vector of strings for all of the value parameter names that
 		 *                       refer to thresholds.
@@ -63,6 +67,9 @@ namespace l1menu
 		 *
 		 * If no thresholds can be found that would let the trigger pass the supplied event, a std::runtime_error is thrown.
 		 *
+		 * If the trigger also implements l1menu::ITightestThresholds then that is used to set the thresholds exactly
+		 * and the tolerance is ignored. Otherwise the thresholds are found by bisection.
+		 *
 		 * @param[in]  event      The event to test the trigger on.
 		 * @param[out] trigger    The trigger to check and modify.
 		 * @param[in]  tolerance  The trigger thresholds will be modified to be within this tolerance of thresholds that would
@@ -73,6 +80,13 @@ namespace l1menu
 		 */
 		void setTriggerThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event, l1menu::ITrigger& trigger, float tolerance=0.01 );
 
+		/** @brief The bisection setTriggerThresholdsAsTightAsPossible uses for triggers that don't implement l1menu::ITightestThresholds.
+		 *
+		 * Always bisects, even if the trigger does implement l1menu::ITightestThresholds, so that the two can be compared.
+		 * Parameters and exceptions are the same as for setTriggerThresholdsAsTightAsPossible.
+		 */
+		void setTriggerThresholdsByBisection( const l1menu::L1TriggerDPGEvent& event, l1menu::ITrigger& trigger, float tolerance=0.01 );
+
 		/** @brief Gives the eta bounds of the requested calorimeter region.
 		 *
 		 * @param[in]  calorimeterRegion   The calorimeter region. Must be between 0 and 21 inclusive or a
@@ -120,6 +134,20 @@ namespace l1menu
 		 * @date 08/Jul/2013
 		 */
 		std::pair<double,double> simpleLinearFit( const std::vector< std::pair<double,double> >& dataPoints );
+
+		/** @brief Runs work(processNumber) for each processNumber in [0,numberOfProcesses) in a separate forked process, and returns what each one returned.
+		 *
+		 * For splitting a calculation between processes, e.g. with PartialMenuRate. The strings returned
+		 * are sent back through a pipe and are in processNumber order. Only the calling thread is copied
+		 * into the new processes, so this has to be called before anything has used l1menu::tools::ThreadPool,
+		 * otherwise the pool in each child would have no threads to run its tasks. If one of the processes
+		 * can't be started, the ones already running are killed before the exception is thrown.
+		 *
+		 * @throw  std::logic_error if the ThreadPool already has threads running.
+		 * @throw  std::runtime_error if a process can't be started, or if work throws or the process
+		 *         dies in any of them. The error from work is printed to std::cerr by the child.
+		 */
+		std::vector<std::string> runInChildProcesses( size_t numberOfProcesses, const std::function<std::string(size_t)>& work );
 	} // end of the tools namespace
 } // end of the l1menu namespace
 #endif
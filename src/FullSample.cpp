@@ -2,13 +2,32 @@
 
 #include <stdexcept>
 #include <cmath>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <unistd.h>
 
 #include <TSystem.h>
+#include <TThread.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TUUID.h>
 #include "FWCore/FWLite/interface/AutoLibraryLoader.h"
 
 #include "l1menu/L1TriggerDPGEvent.h"
+#include "l1menu/L1TriggerObjects.h"
 #include "l1menu/ICachedTrigger.h"
+#include "l1menu/IEventCursor.h"
 #include "l1menu/IMenuRate.h"
+#include "l1menu/tools/ValueTupleSet.h"
 #include "./implementation/MenuRateImplementation.h"
 #include "L1UpgradeNtuple.h"
 #include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
@@ -36,6 +55,126 @@ namespace // Use the unnamed namespace for things only used in this file
 	protected:
 		const l1menu::ITrigger& trigger_;
 	}; // end of class CachedTriggerImplementation
+
+	/** @brief Adds up the event weights in one ntuple file, only reading the weights.
+	 *
+	 * If cacheDirectory isn't empty the result is saved in a file in that directory, named after the
+	 * ntuple's UUID and number of entries, and read from there next time. If that file can't be written
+	 * the weights are just added up every time. Nothing is ever written next to the ntuple.
+	 */
+	double sumOfWeightsInFile( const std::string& filename, const std::string& cacheDirectory )
+	{
+		std::unique_ptr<TFile> pFile( TFile::Open( filename.c_str() ) );
+		if( pFile==nullptr || pFile->IsZombie() ) throw std::runtime_error( "FullSample - unable to open "+filename+" to add up the event weights" );
+		TTree* pTree=dynamic_cast<TTree*>( pFile->Get( "l1NtupleProducer/L1Tree" ) );
+		if( pTree==nullptr ) throw std::runtime_error( "FullSample - unable to find the L1Tree in "+filename );
+
+		// The UUID is made when the file is created, so along with the number of entries it
+		// identifies the file whatever it's called or wherever it's been copied to.
+		const std::string cacheFilename=cacheDirectory+"/"+pFile->GetUUID().AsString()+"_"+std::to_string( pTree->GetEntries() )+".sumOfWeights";
+		if( !cacheDirectory.empty() )
+		{
+			std::ifstream cacheFile( cacheFilename.c_str() );
+			double sumOfWeights;
+			if( cacheFile >> sumOfWeights ) return sumOfWeights;
+		}
+
+		// Switch off everything apart from the weight. Depending on how the ntuple was split, that's
+		// either a branch of its own or only readable as part of the whole "Event" branch.
+		std::unique_ptr<L1Analysis::L1AnalysisEventDataFormat> pEvent( new L1Analysis::L1AnalysisEventDataFormat );
+		L1Analysis::L1AnalysisEventDataFormat* pEventAddress=pEvent.get();
+		pTree->SetBranchStatus( "*", 0 );
+		UInt_t numberOfBranchesFound=0;
+		pTree->SetBranchStatus( "*puWeight", 1, &numberOfBranchesFound );
+		if( numberOfBranchesFound==0 ) pTree->SetBranchStatus( "Event*", 1 );
+		pTree->SetBranchAddress( "Event", &pEventAddress );
+
+		double sumOfWeights=0;
+		for( Long64_t entry=0; entry<pTree->GetEntries(); ++entry )
+		{
+			pTree->GetEntry( entry );
+			sumOfWeights+=pEvent->puWeight;
+		}
+		pTree->ResetBranchAddresses();
+
+		if( !cacheDirectory.empty() )
+		{
+			// Write to a temporary file and then rename it, so that other jobs using the same cache
+			// never see a half written file.
+			const std::string temporaryFilename=cacheFilename+"."+std::to_string( ::getpid() );
+			bool written;
+			{
+				std::ofstream cacheFile( temporaryFilename.c_str() );
+				cacheFile << std::setprecision(17) << sumOfWeights << std::endl;
+				written=static_cast<bool>( cacheFile );
+			}
+			if( !written || std::rename( temporaryFilename.c_str(), cacheFilename.c_str() )!=0 ) std::remove( temporaryFilename.c_str() );
+		}
+
+		return sumOfWeights;
+	}
+
+	/** @brief Returns the index to fill for a new object at the end of the collection, making the collection bigger if it's full.
+	 *
+	 * The capacity is doubled each time so that after the first few events the collection is big enough
+	 * for any event and nothing else is allocated.
+	 */
+	template<class T_collection>
+	int addObject( T_collection& collection )
+	{
+		if( collection.number>=collection.capacity() ) collection.setCapacity( std::max( 2*collection.capacity(), static_cast<int>(l1menu::L1TriggerObjects::INITIAL_CAPACITY) ) );
+		return collection.number++;
+	}
+
+	/** @brief The energy sums from an L1AnalysisDataFormat that has just been reset, so that events without them come out the same as before. */
+	l1menu::L1TriggerObjects::EnergySums energySumsAfterReset()
+	{
+		L1Analysis::L1AnalysisDataFormat resetEvent;
+		resetEvent.Reset();
+
+		l1menu::L1TriggerObjects::EnergySums sums;
+		sums.totalEt=resetEvent.ETT;
+		sums.missingEt=resetEvent.ETM;
+		sums.missingEtPhi=resetEvent.PhiETM;
+		sums.totalHt=resetEvent.HTT;
+		sums.missingHt=resetEvent.HTM;
+		sums.missingHtPhi=resetEvent.PhiHTM;
+		sums.totalEtOverflow=resetEvent.OvETT;
+		sums.missingEtOverflow=resetEvent.OvETM;
+		sums.totalHtOverflow=resetEvent.OvHTT;
+		sums.missingHtOverflow=resetEvent.OvHTM;
+		sums.trackTotalEt=resetEvent.TkETT;
+		sums.trackMissingEt=resetEvent.TkETM;
+		sums.trackMissingEtPhi=resetEvent.TkETMPhi;
+		sums.trackTotalHt=resetEvent.TkHTT;
+		sums.trackMissingHt=resetEvent.TkHTM;
+		sums.trackMissingHtPhi=resetEvent.TkHTMPhi;
+		return sums;
+	}
+
+	using l1menu::tools::ValueTupleSet;
+
+	/** @brief How objects are matched to the isolated lists. */
+	ValueTupleSet<2>::Tuple position( double phi, double eta )
+	{
+		ValueTupleSet<2>::Tuple tuple={{ phi, eta }};
+		return tuple;
+	}
+
+	/** @brief Objects with all of these the same are duplicates. */
+	ValueTupleSet<4>::Tuple bxEtAndPosition( double bx, double et, double eta, double phi )
+	{
+		ValueTupleSet<4>::Tuple tuple={{ bx, et, eta, phi }};
+		return tuple;
+	}
+
+	/** @brief Fills the set with the positions of the objects in an isolated list, so that other objects can be looked up in it. */
+	template<class T_vector>
+	void fillPositions( ValueTupleSet<2>& positions, unsigned int numberOfObjects, const T_vector& phi, const T_vector& eta )
+	{
+		positions.clear( numberOfObjects );
+		for( unsigned int i=0; i<numberOfObjects; i++ ) positions.insert( position( phi.at( i ), eta.at( i ) ) );
+	}
 } // end of the unnamed namespace
 
 namespace l1menu
@@ -49,19 +188,36 @@ namespace l1menu
 		static const double ETABIN[];
 
 		static bool libraryLoaderInitiated; ///< @brief Flag to say if libFWCoreFWLite.so has been loaded and the AutoLibraryLoader enabled
+		static const int DATA_INPUT; ///< @brief The input source readEvent() passes to fillDataStructure()
+		static const Long64_t READ_CACHE_SIZE; ///< @brief Size in bytes of the TTreeCache for each tree that's read
+		static const Int_t READ_CACHE_LEARN_ENTRIES;
 
 		double degree( double radian );
 		int phiINjetCoord( double phi );
 		int etaINjetCoord( double eta );
-		double calculateHTT( const L1Analysis::L1AnalysisDataFormat& event );
-		double calculateHTM( const L1Analysis::L1AnalysisDataFormat& event );
+		double calculateHTT( const l1menu::L1TriggerObjects::Jets& jets );
+		double calculateHTM( const l1menu::L1TriggerObjects::Jets& jets );
 	public:
-		FullSamplePrivateMembers( FullSample* pThisObject );
+		FullSamplePrivateMembers( const FullSample* pThisObject );
 		void fillDataStructure( int selectDataInput );
 		void fillL1Bits();
+		/** @brief Switches off all the branches of inputNtuple that fillDataStructure() doesn't need for the given input source. */
+		void setReadPlan( int selectDataInput );
+		/** @brief Loads the requested entry from inputNtuple and converts it into currentEvent. */
+		const l1menu::L1TriggerDPGEvent& readEvent( size_t eventNumber );
+		/** @brief Opens a file (or list of files if the second entry is true) and records it in loadedFiles. */
+		void loadFile( const std::string& filename, bool isListOfFiles );
 		L1UpgradeNtuple inputNtuple;
+		/// Everything passed to loadFile(), in order, so that event cursors can open their own copy of the input
+		std::vector< std::pair<std::string,bool> > loadedFiles;
 		l1menu::L1TriggerDPGEvent currentEvent;
+		/// The energy sums as they are in an L1AnalysisDataFormat after Reset(), for events where they aren't in the ntuple
+		l1menu::L1TriggerObjects::EnergySums emptyEnergySums;
+		/// Scratch space for fillDataStructure(), kept between events so that it doesn't have to be allocated each time
+		ValueTupleSet<4> uniqueObjects;
+		ValueTupleSet<2> isolatedPositions;
 		float sumOfWeights;
+		std::string sumOfWeightsCacheDirectory; ///< Empty if the sums of weights of the files shouldn't be saved
 		float eventRate;
 	};
 }
@@ -71,9 +227,12 @@ const double l1menu::FullSamplePrivateMembers::PHIBIN[]={10,30,50,70,90,110,130,
 const size_t l1menu::FullSamplePrivateMembers::ETABINS=23;
 const double l1menu::FullSamplePrivateMembers::ETABIN[]={-5.,-4.5,-4.,-3.5,-3.,-2.172,-1.74,-1.392,-1.044,-0.696,-0.348,0,0.348,0.696,1.044,1.392,1.74,2.172,3.,3.5,4.,4.5,5.};
 bool l1menu::FullSamplePrivateMembers::libraryLoaderInitiated=false;
+const int l1menu::FullSamplePrivateMembers::DATA_INPUT=22;
+const Long64_t l1menu::FullSamplePrivateMembers::READ_CACHE_SIZE=30*1024*1024;
+const Int_t l1menu::FullSamplePrivateMembers::READ_CACHE_LEARN_ENTRIES=100;
 
-l1menu::FullSamplePrivateMembers::FullSamplePrivateMembers( FullSample* pThisObject )
-	: currentEvent(*pThisObject), sumOfWeights(-1), eventRate(1)
+l1menu::FullSamplePrivateMembers::FullSamplePrivateMembers( const FullSample* pThisObject )
+	: currentEvent(*pThisObject), emptyEnergySums( energySumsAfterReset() ), sumOfWeights(-1), eventRate(1)
 {
 	if( !libraryLoaderInitiated )
 	{
@@ -113,18 +272,18 @@ int l1menu::FullSamplePrivateMembers::etaINjetCoord( double eta )
 	return int( etaIdx );
 }
 
-double l1menu::FullSamplePrivateMembers::calculateHTT( const L1Analysis::L1AnalysisDataFormat& event )
+double l1menu::FullSamplePrivateMembers::calculateHTT( const l1menu::L1TriggerObjects::Jets& jets )
 {
 	double httValue=0.;
 
 	// Calculate our own HT and HTM from the jets that survive the double jet removal.
-	for( int i=0; i<event.Njet; i++ )
+	for( int i=0; i<jets.number; i++ )
 	{
-		if( event.Bxjet.at( i )==0 && !event.Taujet.at(i) )
+		if( jets.bx[i]==0 && !jets.tau[i] )
 		{
-			if( event.Etajet.at( i )>4 && event.Etajet.at( i )<17 && event.Etjet.at(i)>15. )
+			if( jets.eta[i]>4 && jets.eta[i]<17 && jets.et[i]>15. )
 			{
-				httValue+=event.Etjet.at( i );
+				httValue+=jets.et[i];
 			} //in proper eta range
 		} //correct beam crossing
 	} //loop over cleaned jets
@@ -132,24 +291,24 @@ double l1menu::FullSamplePrivateMembers::calculateHTT( const L1Analysis::L1Analy
 	return httValue;
 }
 
-double l1menu::FullSamplePrivateMembers::calculateHTM( const L1Analysis::L1AnalysisDataFormat& event )
+double l1menu::FullSamplePrivateMembers::calculateHTM( const l1menu::L1TriggerObjects::Jets& jets )
 {
 	double htmValue=0.;
 	double htmValueX=0.;
 	double htmValueY=0.;
 
 	// Calculate our own HT and HTM from the jets that survive the double jet removal.
-	for( int i=0; i<event.Njet; i++ )
+	for( int i=0; i<jets.number; i++ )
 	{
-		if( event.Bxjet.at( i )==0 && !event.Taujet.at(i) )
+		if( jets.bx[i]==0 && !jets.tau[i] )
 		{
-			if( event.Etajet.at( i )>4 and event.Etajet.at( i )<17 && event.Etjet.at(i)>15. )
+			if( jets.eta[i]>4 and jets.eta[i]<17 && jets.et[i]>15. )
 			{
 
 				//  Get the phi angle  towers are 0-17 (this is probably not real mapping but OK for just magnitude of HTM
-				float phi=2*M_PI*(event.Phijet.at( i )/18.);
-				htmValueX+=cos( phi )*event.Etjet.at( i );
-				htmValueY+=sin( phi )*event.Etjet.at( i );
+				float phi=2*M_PI*(jets.phi[i]/18.);
+				htmValueX+=cos( phi )*jets.et[i];
+				htmValueY+=sin( phi )*jets.et[i];
 
 			} //in proper eta range
 		} //correct beam crossing
@@ -163,15 +322,16 @@ double l1menu::FullSamplePrivateMembers::calculateHTM( const L1Analysis::L1Analy
 void l1menu::FullSamplePrivateMembers::fillDataStructure( int selectDataInput )
 {
 	// Use a reference for ease of use
-	L1Analysis::L1AnalysisDataFormat& analysisDataFormat=currentEvent.rawEvent();
+	l1menu::L1TriggerObjects& objects=currentEvent.triggerObjects();
 
-	analysisDataFormat.Reset();
+	objects.clear();
+	objects.sums=emptyEnergySums;
 
 	// Grab standard event information
 	currentEvent.setWeight( inputNtuple.event_->puWeight );
-	analysisDataFormat.Run=inputNtuple.event_->run;
-	analysisDataFormat.LS=inputNtuple.event_->lumi;
-	analysisDataFormat.Event=inputNtuple.event_->event;
+	objects.run=inputNtuple.event_->run;
+	objects.lumiSection=inputNtuple.event_->lumi;
+	objects.event=inputNtuple.event_->event;
 
 	/* =======================================================================================================
 	 /    Select the input source information
@@ -187,565 +347,429 @@ void l1menu::FullSamplePrivateMembers::fillDataStructure( int selectDataInput )
 	 /
 	 /    case 21: Use the L1ExtraUpgradeTree (Assuming Stage 1 Quantities filled in tree)
 	 /    case 22: Use the L1ExtraUpgradeTree (Assuming Stage 2 Quantities filled in tree)
+	 /    case 23: Use the L1ExtraUpgradeTree (Assuming Stage 2 Quantities filled in tree) without the tracking information
+	 /
+	 /    Eta and phi are converted to the calorimeter region numbers that the triggers want with etaINjetCoord
+	 /    and phiINjetCoord, apart from for the muons.
 	 / ======================================================================================================= */
-	switch( selectDataInput )
-	{
-		case 22:  //Select from L1ExtraUpgradeTree (Stage 2)
+	if( selectDataInput!=22 && selectDataInput!=23 ) throw std::runtime_error( "---Not a valid input source FULL STOP! " );
 
-			// NOTES:  Stage 1 has EG Relaxed and EG Isolated.  The isolated EG are a subset of the Relaxed.
-			//         so sort through the relaxed list and flag those that also appear in the isolated list.
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nEG; i++ )
-			{
-
-				analysisDataFormat.Bxel.push_back( inputNtuple.l1upgrade_->egBx.at( i ) );
-				analysisDataFormat.Etel.push_back( inputNtuple.l1upgrade_->egEt.at( i ) );
-				analysisDataFormat.Phiel.push_back( phiINjetCoord( inputNtuple.l1upgrade_->egPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				analysisDataFormat.Etael.push_back( etaINjetCoord( inputNtuple.l1upgrade_->egEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-
-				// Check whether this EG is located in the isolation list
-				bool isolated=false;
-				bool fnd=false;
-				unsigned int isoEG=0;
-				while( !fnd && isoEG < inputNtuple.l1upgrade_->nIsoEG )
-				{
-					if( inputNtuple.l1upgrade_->isoEGPhi.at( isoEG )==inputNtuple.l1upgrade_->egPhi.at( i )
-							&& inputNtuple.l1upgrade_->isoEGEta.at( isoEG )==inputNtuple.l1upgrade_->egEta.at( i ) )
-					{
-						isolated=true;
-						fnd=true;
-					}
-					isoEG++;
-				}
-				analysisDataFormat.Isoel.push_back( isolated );
-				analysisDataFormat.Nele++;
-			}
-
-			// Note:  Taus are in the jet list.  Decide what to do with them. For now
-			//  leave them the there as jets (not even flagged..)
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nJets; i++ )
-			{
-
-				// For each jet look for a possible duplicate if so remove it.
-				bool duplicate=false;
-				for( unsigned int j=0; j<i; j++ )
-				{
-					if( inputNtuple.l1upgrade_->jetBx.at( i )==inputNtuple.l1upgrade_->jetBx.at( j )
-							&& inputNtuple.l1upgrade_->jetEt.at( i )==inputNtuple.l1upgrade_->jetEt.at( j )
-							&& inputNtuple.l1upgrade_->jetEta.at( i )==inputNtuple.l1upgrade_->jetEta.at( j )
-							&& inputNtuple.l1upgrade_->jetPhi.at( i )==inputNtuple.l1upgrade_->jetPhi.at( j ) )
-					{
-						duplicate=true;
-						//printf("Duplicate jet found and removed \n");
-					}
-				}
-
-				if( !duplicate )
-				{
-					analysisDataFormat.Bxjet.push_back( inputNtuple.l1upgrade_->jetBx.at( i ) );
-					analysisDataFormat.Etjet.push_back( inputNtuple.l1upgrade_->jetEt.at( i ) );
-					analysisDataFormat.Phijet.push_back( phiINjetCoord( inputNtuple.l1upgrade_->jetPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-					analysisDataFormat.Etajet.push_back( etaINjetCoord( inputNtuple.l1upgrade_->jetEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-					analysisDataFormat.Taujet.push_back( false );
-					analysisDataFormat.isoTaujet.push_back( false );
-					//analysisDataFormat.Fwdjet.push_back(false); //COMMENT OUT IF JET ETA FIX
-
-					//if(fabs(inputNtuple.l1upgrade_->jetEta.at(i))>=3.0) printf("Et %f  Eta  %f  iEta  %f Phi %f  iPhi  %f \n",analysisDataFormat.Etjet.at(analysisDataFormat.Njet),inputNtuple.l1upgrade_->jetEta.at(i),analysisDataFormat.Etajet.at(analysisDataFormat.Njet),inputNtuple.l1upgrade_->jetPhi.at(i),analysisDataFormat.Phijet.at(analysisDataFormat.Njet));
-					//  Eta Jet Fix.  Some Jets with eta>3 has appeared in central jet list.  Move them by hand
-					//  This is a problem in Stage 2 Jet code.
-					(fabs( inputNtuple.l1upgrade_->jetEta.at( i ) )>=3.0) ? analysisDataFormat.Fwdjet.push_back( true ) : analysisDataFormat.Fwdjet.push_back( false );
-
-					analysisDataFormat.Njet++;
-				}
-			}
+	// Cases 22 and 23 are the same for everything apart from the muons, the phi of the missing
+	// HT and the tracking information.
 
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nFwdJets; i++ )
-			{
-
-				analysisDataFormat.Bxjet.push_back( inputNtuple.l1upgrade_->fwdJetBx.at( i ) );
-				analysisDataFormat.Etjet.push_back( inputNtuple.l1upgrade_->fwdJetEt.at( i ) );
-				analysisDataFormat.Phijet.push_back( phiINjetCoord( inputNtuple.l1upgrade_->fwdJetPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				analysisDataFormat.Etajet.push_back( etaINjetCoord( inputNtuple.l1upgrade_->fwdJetEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-				analysisDataFormat.Taujet.push_back( false );
-				analysisDataFormat.isoTaujet.push_back( false );
-				analysisDataFormat.Fwdjet.push_back( true );
-
-				analysisDataFormat.Njet++;
-			}
-
-			// NOTES:  Stage 1 has Tau Relaxed and TauIsolated.  The isolated Tau are a subset of the Relaxed.
-			//         so sort through the relaxed list and flag those that also appear in the isolated list.
-
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTau; i++ )
-			{
-
-				// remove duplicates
-				bool duplicate=false;
-				for( unsigned int j=0; j<i; j++ )
-				{
-					if( inputNtuple.l1upgrade_->tauBx.at( i )==inputNtuple.l1upgrade_->tauBx.at( j )
-							&& inputNtuple.l1upgrade_->tauEt.at( i )==inputNtuple.l1upgrade_->tauEt.at( j )
-							&& inputNtuple.l1upgrade_->tauEta.at( i )==inputNtuple.l1upgrade_->tauEta.at( j )
-							&& inputNtuple.l1upgrade_->tauPhi.at( i )==inputNtuple.l1upgrade_->tauPhi.at( j ) )
-					{
-						duplicate=true;
-						//printf("Duplicate jet found and removed \n");
-					}
-				}
-
-				if( !duplicate )
-				{
-					analysisDataFormat.Bxjet.push_back( inputNtuple.l1upgrade_->tauBx.at( i ) );
-					analysisDataFormat.Etjet.push_back( inputNtuple.l1upgrade_->tauEt.at( i ) );
-					analysisDataFormat.Phijet.push_back( phiINjetCoord( inputNtuple.l1upgrade_->tauPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-					analysisDataFormat.Etajet.push_back( etaINjetCoord( inputNtuple.l1upgrade_->tauEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-					analysisDataFormat.Taujet.push_back( true );
-					analysisDataFormat.Fwdjet.push_back( false );
-
-					bool isolated=false;
-					bool fnd=false;
-					unsigned int isoTau=0;
-					while( !fnd && isoTau < inputNtuple.l1upgrade_->nIsoTau )
-					{
-						if( inputNtuple.l1upgrade_->isoTauPhi.at( isoTau )==inputNtuple.l1upgrade_->tauPhi.at( i )
-								&& inputNtuple.l1upgrade_->isoTauEta.at( isoTau )==inputNtuple.l1upgrade_->tauEta.at( i ) )
-						{
-							isolated=true;
-							fnd=true;
-						}
-						isoTau++;
-					}
-					analysisDataFormat.isoTaujet.push_back( isolated );
-
-					analysisDataFormat.Njet++;
-				} // duplicate check
-			}
-
-			// Fill energy sums  (Are overflow flags accessible in l1extra?)
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nMet; i++ )
-			{
-				//if(inputNtuple.l1upgrade_->metBx.at(i)==0) {
-				analysisDataFormat.ETT=inputNtuple.l1upgrade_->et.at( i );
-				analysisDataFormat.ETM=inputNtuple.l1upgrade_->met.at( i );
-				analysisDataFormat.PhiETM=inputNtuple.l1upgrade_->metPhi.at( i );
-			}
-			analysisDataFormat.OvETT=0; //not available in l1extra
-			analysisDataFormat.OvETM=0; //not available in l1extra
-
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nMht; i++ )
-			{
-				if( inputNtuple.l1upgrade_->mhtBx.at( i )==0 )
-				{
-					analysisDataFormat.HTT=calculateHTT( analysisDataFormat ); // inputNtuple.l1upgrade_->ht.at(i) ; // calculateHTT( analysisDataFormat ); //
-					analysisDataFormat.HTM=calculateHTM( analysisDataFormat ); //inputNtuple.l1upgrade_->mht.at(i) ; // calculateHTM( analysisDataFormat ); //
-					analysisDataFormat.PhiHTM=inputNtuple.l1upgrade_->mhtPhi.at(i) ; //0.; //
-				}
-			}
-			analysisDataFormat.OvHTM=0; //not available in l1extra
-			analysisDataFormat.OvHTT=0; //not available in l1extra
-
-			// Get the muon information  from reEmul GMT
-			for( int i=0; i<inputNtuple.gmt_->N; i++ )
-//			for( int i=0; i<inputNtuple.gmtEmu_->N; i++ )
-			{
-/*
-				analysisDataFormat.Bxmu.push_back( inputNtuple.gmtEmu_->CandBx[i] );
-				analysisDataFormat.Ptmu.push_back( inputNtuple.gmtEmu_->Pt[i] );
-				analysisDataFormat.Phimu.push_back( inputNtuple.gmtEmu_->Phi[i] );
-				analysisDataFormat.Etamu.push_back( inputNtuple.gmtEmu_->Eta[i] );
-				analysisDataFormat.Qualmu.push_back( inputNtuple.gmtEmu_->Qual[i] );
-				analysisDataFormat.Isomu.push_back( false );
-				analysisDataFormat.Nmu++;
-*/
-				analysisDataFormat.Bxmu.push_back( inputNtuple.gmt_->CandBx[i] );
-				analysisDataFormat.Ptmu.push_back( inputNtuple.gmt_->Pt[i] );
-				analysisDataFormat.Phimu.push_back( inputNtuple.gmt_->Phi[i] );
-				analysisDataFormat.Etamu.push_back( inputNtuple.gmt_->Eta[i] );
-				analysisDataFormat.Qualmu.push_back( inputNtuple.gmt_->Qual[i] );
-				analysisDataFormat.Isomu.push_back( false );
-				analysisDataFormat.Nmu++;
-
-
-			}
-
-/*
-     Fill the infomation Associated with L1 Tracking
-*/     
-
-
-
-			// NOTES:  Stage 1 has EG Relaxed and EG Isolated.  The isolated EG are a subset of the Relaxed.
-			//         so sort through the relaxed list and flag those that also appear in the isolated list.
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkEG; i++ )
-			{
-
-				analysisDataFormat.BxTkel.push_back( inputNtuple.l1upgrade_->tkEGBx.at(i) );    
-				analysisDataFormat.zVtxTkel.push_back( inputNtuple.l1upgrade_->tkEGzVtx.at(i) ); 
-				analysisDataFormat.tIsoTkel.push_back( inputNtuple.l1upgrade_->tkEGTrkIso.at(i) );   //track isolation 
-				analysisDataFormat.EtTkel.push_back( inputNtuple.l1upgrade_->tkEGEt.at( i ) );
-				analysisDataFormat.PhiTkel.push_back( phiINjetCoord( inputNtuple.l1upgrade_->tkEGPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				analysisDataFormat.EtaTkel.push_back( etaINjetCoord( inputNtuple.l1upgrade_->tkEGEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-
-				// Check whether this EG is located in the isolation list
-				bool isolated=false;
-				bool fnd=false;
-				unsigned int isoTkEG=0;
-				while( !fnd && isoTkEG < inputNtuple.l1upgrade_->nTkIsoEG )
-				{
-					if( inputNtuple.l1upgrade_->tkIsoEGPhi.at( isoTkEG )==inputNtuple.l1upgrade_->tkEGPhi.at( i )
-					 && inputNtuple.l1upgrade_->tkIsoEGEta.at( isoTkEG )==inputNtuple.l1upgrade_->tkEGEta.at( i ) )
-					{
-						isolated=true;
-						fnd=true;
-					}
-					isoTkEG++;
-				}
-
-				analysisDataFormat.IsoTkel.push_back( isolated );
-				analysisDataFormat.NTkele++;
-			}
-
-                       
-		        // second collection of lower Pt track electrons
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkEG2; i++ )
-			{
+	// NOTES:  Stage 1 has EG Relaxed and EG Isolated.  The isolated EG are a subset of the Relaxed.
+	//         so sort through the relaxed list and flag those that also appear in the isolated list.
+	fillPositions( isolatedPositions, inputNtuple.l1upgrade_->nIsoEG, inputNtuple.l1upgrade_->isoEGPhi, inputNtuple.l1upgrade_->isoEGEta );
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nEG; i++ )
+	{
+		const int index=addObject( objects.eg );
+		objects.eg.bx[index]=inputNtuple.l1upgrade_->egBx.at( i );
+		objects.eg.et[index]=inputNtuple.l1upgrade_->egEt.at( i );
+		objects.eg.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->egPhi.at( i ) );
+		objects.eg.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->egEta.at( i ) );
+		objects.eg.isolated[index]=isolatedPositions.contains( position( inputNtuple.l1upgrade_->egPhi.at( i ), inputNtuple.l1upgrade_->egEta.at( i ) ) );
+	}
 
-				analysisDataFormat.BxTkel2.push_back( inputNtuple.l1upgrade_->tkEG2Bx.at(i) );    
-				analysisDataFormat.zVtxTkel2.push_back( inputNtuple.l1upgrade_->tkEG2zVtx.at(i) ); 
-				analysisDataFormat.tIsoTkel2.push_back( inputNtuple.l1upgrade_->tkEG2TrkIso.at(i) );   //track isolation 
-				analysisDataFormat.EtTkel2.push_back( inputNtuple.l1upgrade_->tkEG2Et.at( i ) );
-				analysisDataFormat.PhiTkel2.push_back( phiINjetCoord( inputNtuple.l1upgrade_->tkEG2Phi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				analysisDataFormat.EtaTkel2.push_back( etaINjetCoord( inputNtuple.l1upgrade_->tkEG2Eta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-
-				// Check whether this EG is located in the isolation list...no isolated list for this Pt cut
-				bool isolated=false;
-/*				bool fnd=false;
-				unsigned int isoTkEG=0;
-				while( !fnd && isoTkEG < inputNtuple.l1upgrade_->nTkIsoEG )
-				{
-					if( inputNtuple.l1upgrade_->tkIsoEGPhi.at( isoTkEG )==inputNtuple.l1upgrade_->tkEGPhi.at( i )
-					 && inputNtuple.l1upgrade_->tkIsoEGEta.at( isoTkEG )==inputNtuple.l1upgrade_->tkEGEta.at( i ) )
-					{
-						isolated=true;
-						fnd=true;
-					}
-					isoTkEG++;
-				}
-*/
-				analysisDataFormat.IsoTkel2.push_back( isolated );
-				analysisDataFormat.NTkele2++;
-			}
-    
+	// Note:  Taus are in the jet list.  Decide what to do with them. For now
+	//  leave them the there as jets (not even flagged..)
+	uniqueObjects.clear( inputNtuple.l1upgrade_->nJets );
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nJets; i++ )
+	{
+		// Remove the jet if an earlier one has exactly the same Bx, Et, eta and phi
+		const bool duplicate=!uniqueObjects.insert( bxEtAndPosition( inputNtuple.l1upgrade_->jetBx.at( i ), inputNtuple.l1upgrade_->jetEt.at( i ),
+				inputNtuple.l1upgrade_->jetEta.at( i ), inputNtuple.l1upgrade_->jetPhi.at( i ) ) );
 
+		if( !duplicate )
+		{
+			const int index=addObject( objects.jets );
+			objects.jets.bx[index]=inputNtuple.l1upgrade_->jetBx.at( i );
+			objects.jets.et[index]=inputNtuple.l1upgrade_->jetEt.at( i );
+			objects.jets.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->jetPhi.at( i ) );
+			objects.jets.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->jetEta.at( i ) );
+			objects.jets.tau[index]=false;
+			objects.jets.isolatedTau[index]=false;
+			//  Eta Jet Fix.  Some Jets with eta>3 has appeared in central jet list.  Move them by hand
+			//  This is a problem in Stage 2 Jet code.
+			objects.jets.forward[index]=( fabs( inputNtuple.l1upgrade_->jetEta.at( i ) )>=3.0 );
+		}
+	}
 
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkEM; i++ )
-			{
-				analysisDataFormat.BxTkem.push_back( inputNtuple.l1upgrade_->tkEMBx.at(i) );    
-				analysisDataFormat.EtTkem.push_back( inputNtuple.l1upgrade_->tkEMEt.at( i ) );
-				analysisDataFormat.tIsoTkem.push_back( inputNtuple.l1upgrade_->tkEMTrkIso.at( i ) );
-				analysisDataFormat.PhiTkem.push_back( phiINjetCoord( inputNtuple.l1upgrade_->tkEMPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				analysisDataFormat.EtaTkem.push_back( etaINjetCoord( inputNtuple.l1upgrade_->tkEMEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-				analysisDataFormat.NTkem++;
-			}
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nFwdJets; i++ )
+	{
+		const int index=addObject( objects.jets );
+		objects.jets.bx[index]=inputNtuple.l1upgrade_->fwdJetBx.at( i );
+		objects.jets.et[index]=inputNtuple.l1upgrade_->fwdJetEt.at( i );
+		objects.jets.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->fwdJetPhi.at( i ) );
+		objects.jets.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->fwdJetEta.at( i ) );
+		objects.jets.tau[index]=false;
+		objects.jets.isolatedTau[index]=false;
+		objects.jets.forward[index]=true;
+	}
 
+	// NOTES:  Stage 1 has Tau Relaxed and TauIsolated.  The isolated Tau are a subset of the Relaxed.
+	//         so sort through the relaxed list and flag those that also appear in the isolated list.
+	fillPositions( isolatedPositions, inputNtuple.l1upgrade_->nIsoTau, inputNtuple.l1upgrade_->isoTauPhi, inputNtuple.l1upgrade_->isoTauEta );
+	uniqueObjects.clear( inputNtuple.l1upgrade_->nTau );
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTau; i++ )
+	{
+		// remove duplicates
+		const bool duplicate=!uniqueObjects.insert( bxEtAndPosition( inputNtuple.l1upgrade_->tauBx.at( i ), inputNtuple.l1upgrade_->tauEt.at( i ),
+				inputNtuple.l1upgrade_->tauEta.at( i ), inputNtuple.l1upgrade_->tauPhi.at( i ) ) );
 
-                        
+		if( !duplicate )
+		{
+			const int index=addObject( objects.jets );
+			objects.jets.bx[index]=inputNtuple.l1upgrade_->tauBx.at( i );
+			objects.jets.et[index]=inputNtuple.l1upgrade_->tauEt.at( i );
+			objects.jets.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->tauPhi.at( i ) );
+			objects.jets.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->tauEta.at( i ) );
+			objects.jets.tau[index]=true;
+			objects.jets.forward[index]=false;
+			objects.jets.isolatedTau[index]=isolatedPositions.contains( position( inputNtuple.l1upgrade_->tauPhi.at( i ), inputNtuple.l1upgrade_->tauEta.at( i ) ) );
+		} // duplicate check
+	}
 
-//  NOTE: Track Taus not yet implemented PLACEHOLDER
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkTau; i++ )
-			{
+	// Fill energy sums  (Are overflow flags accessible in l1extra?)
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nMet; i++ )
+	{
+		objects.sums.totalEt=inputNtuple.l1upgrade_->et.at( i );
+		objects.sums.missingEt=inputNtuple.l1upgrade_->met.at( i );
+		objects.sums.missingEtPhi=inputNtuple.l1upgrade_->metPhi.at( i );
+	}
+	objects.sums.totalEtOverflow=0; //not available in l1extra
+	objects.sums.missingEtOverflow=0; //not available in l1extra
 
-				 analysisDataFormat.BxTktau.push_back( inputNtuple.l1upgrade_->tkTauBx.at(i) );    
-				 analysisDataFormat.zVtxTktau.push_back( inputNtuple.l1upgrade_->tkTauzVtx.at(i) ); 
-				 analysisDataFormat.tIsoTktau.push_back( inputNtuple.l1upgrade_->tkTauTrkIso.at(i) ); 
-				 analysisDataFormat.EtTktau.push_back( inputNtuple.l1upgrade_->tkTauEt.at( i ) );
-				 analysisDataFormat.PhiTktau.push_back( phiINjetCoord( inputNtuple.l1upgrade_->tkTauPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				 analysisDataFormat.EtaTktau.push_back( etaINjetCoord( inputNtuple.l1upgrade_->tkTauEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-
-				 bool isolated=false;
-/*				 bool fnd=false;
-				 unsigned int isoTkTau=0;
-				 while( !fnd && isoTkTau < inputNtuple.l1upgrade_->nTkIsoTau )
-				 {
-					 if( inputNtuple.l1upgrade_->tkIsoTauPhi.at( isoTkTau )==inputNtuple.l1upgrade_->tkTauPhi.at( i )
-					  && inputNtuple.l1upgrade_->tkIsoTauEta.at( isoTkTau )==inputNtuple.l1upgrade_->tkTauEta.at( i ) )
-					 {
-						 isolated=true;
-						 fnd=true;
-					 }
-					 isoTkTau++;
-				 }
-*/
-				 analysisDataFormat.IsoTktau.push_back( isolated );
-
-				 analysisDataFormat.NTktau++;
-			}
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nMht; i++ )
+	{
+		if( inputNtuple.l1upgrade_->mhtBx.at( i )==0 )
+		{
+			// Calculate our own rather than use inputNtuple.l1upgrade_->ht and mht
+			objects.sums.totalHt=calculateHTT( objects.jets );
+			objects.sums.missingHt=calculateHTM( objects.jets );
+			objects.sums.missingHtPhi=( selectDataInput==22 ? inputNtuple.l1upgrade_->mhtPhi.at( i ) : 0. );
+		}
+	}
+	objects.sums.missingHtOverflow=0; //not available in l1extra
+	objects.sums.totalHtOverflow=0; //not available in l1extra
 
+	// Get the muon information from GMT, or the reEmulated GMT if there's no tracking information
+	const L1Analysis::L1AnalysisGMTDataFormat* pGMT=( selectDataInput==22 ? inputNtuple.gmt_ : inputNtuple.gmtEmu_ );
+	for( int i=0; i<pGMT->N; i++ )
+	{
+		const int index=addObject( objects.muons );
+		objects.muons.bx[index]=pGMT->CandBx[i];
+		objects.muons.pt[index]=pGMT->Pt[i];
+		objects.muons.phi[index]=pGMT->Phi[i];
+		objects.muons.eta[index]=pGMT->Eta[i];
+		objects.muons.quality[index]=pGMT->Qual[i];
+		objects.muons.isolated[index]=false;
+	}
 
+	if( selectDataInput==23 ) return;
 
-			//  L1 Track Jets
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkJets; i++ )
-			{
+	/*
+	     Fill the infomation Associated with L1 Tracking
+	*/
 
-			       analysisDataFormat.BxTkjet.push_back( inputNtuple.l1upgrade_->tkJetBx.at(i) ); 
-			       analysisDataFormat.EtTkjet.push_back( inputNtuple.l1upgrade_->tkJetEt.at( i ) );
-			       analysisDataFormat.zVtxTkjet.push_back( inputNtuple.l1upgrade_->tkJetzVtx.at( i ) );
-			       analysisDataFormat.PhiTkjet.push_back(  phiINjetCoord( inputNtuple.l1upgrade_->tkJetPhi.at( i ) ) );
-			       analysisDataFormat.EtaTkjet.push_back(  etaINjetCoord( inputNtuple.l1upgrade_->tkJetEta.at( i ) ) ); 
-			       analysisDataFormat.NTkjet++;
+	// NOTES:  Stage 1 has EG Relaxed and EG Isolated.  The isolated EG are a subset of the Relaxed.
+	//         so sort through the relaxed list and flag those that also appear in the isolated list.
+	fillPositions( isolatedPositions, inputNtuple.l1upgrade_->nTkIsoEG, inputNtuple.l1upgrade_->tkIsoEGPhi, inputNtuple.l1upgrade_->tkIsoEGEta );
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkEG; i++ )
+	{
+		const int index=addObject( objects.trackElectrons );
+		objects.trackElectrons.bx[index]=inputNtuple.l1upgrade_->tkEGBx.at( i );
+		objects.trackElectrons.zVertex[index]=inputNtuple.l1upgrade_->tkEGzVtx.at( i );
+		objects.trackElectrons.trackIsolation[index]=inputNtuple.l1upgrade_->tkEGTrkIso.at( i );
+		objects.trackElectrons.et[index]=inputNtuple.l1upgrade_->tkEGEt.at( i );
+		objects.trackElectrons.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->tkEGPhi.at( i ) );
+		objects.trackElectrons.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->tkEGEta.at( i ) );
+		objects.trackElectrons.isolated[index]=isolatedPositions.contains( position( inputNtuple.l1upgrade_->tkEGPhi.at( i ), inputNtuple.l1upgrade_->tkEGEta.at( i ) ) );
+	}
 
-			}
+	// second collection of lower Pt track electrons. There's no isolated list for this Pt cut.
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkEG2; i++ )
+	{
+		const int index=addObject( objects.lowPtTrackElectrons );
+		objects.lowPtTrackElectrons.bx[index]=inputNtuple.l1upgrade_->tkEG2Bx.at( i );
+		objects.lowPtTrackElectrons.zVertex[index]=inputNtuple.l1upgrade_->tkEG2zVtx.at( i );
+		objects.lowPtTrackElectrons.trackIsolation[index]=inputNtuple.l1upgrade_->tkEG2TrkIso.at( i );
+		objects.lowPtTrackElectrons.et[index]=inputNtuple.l1upgrade_->tkEG2Et.at( i );
+		objects.lowPtTrackElectrons.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->tkEG2Phi.at( i ) );
+		objects.lowPtTrackElectrons.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->tkEG2Eta.at( i ) );
+		objects.lowPtTrackElectrons.isolated[index]=false;
+	}
 
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkEM; i++ )
+	{
+		const int index=addObject( objects.trackEMs );
+		objects.trackEMs.bx[index]=inputNtuple.l1upgrade_->tkEMBx.at( i );
+		objects.trackEMs.et[index]=inputNtuple.l1upgrade_->tkEMEt.at( i );
+		objects.trackEMs.trackIsolation[index]=inputNtuple.l1upgrade_->tkEMTrkIso.at( i );
+		objects.trackEMs.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->tkEMPhi.at( i ) );
+		objects.trackEMs.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->tkEMEta.at( i ) );
+	}
 
-			// Get the muon information  L1 Track Muons
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkMuons; i++ )
-			{
+	//  NOTE: Track Taus not yet implemented PLACEHOLDER. There's no isolated list for them yet.
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkTau; i++ )
+	{
+		const int index=addObject( objects.trackTaus );
+		objects.trackTaus.bx[index]=inputNtuple.l1upgrade_->tkTauBx.at( i );
+		objects.trackTaus.zVertex[index]=inputNtuple.l1upgrade_->tkTauzVtx.at( i );
+		objects.trackTaus.trackIsolation[index]=inputNtuple.l1upgrade_->tkTauTrkIso.at( i );
+		objects.trackTaus.et[index]=inputNtuple.l1upgrade_->tkTauEt.at( i );
+		objects.trackTaus.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->tkTauPhi.at( i ) );
+		objects.trackTaus.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->tkTauEta.at( i ) );
+		objects.trackTaus.isolated[index]=false;
+	}
 
-				analysisDataFormat.BxTkmu.push_back( inputNtuple.l1upgrade_->tkMuonBx.at(i) );   
-				analysisDataFormat.zVtxTkmu.push_back( inputNtuple.l1upgrade_->tkMuonzVtx.at(i) ); 
-				analysisDataFormat.tIsoTkmu.push_back( inputNtuple.l1upgrade_->tkMuonTrkIso.at(i) );  
-				analysisDataFormat.PtTkmu.push_back( inputNtuple.l1upgrade_->tkMuonEt.at( i ) );
-				analysisDataFormat.PhiTkmu.push_back( inputNtuple.l1upgrade_->tkMuonPhi.at( i ) );
-				analysisDataFormat.EtaTkmu.push_back( inputNtuple.l1upgrade_->tkMuonEta.at( i ) );
-				analysisDataFormat.QualTkmu.push_back( inputNtuple.l1upgrade_->tkMuonQuality.at(i));   //;
-				analysisDataFormat.IsoTkmu.push_back( false ); //inputNtuple.l1upgrade_->tkMuonIso.at(i));  //Calo Isolation
-				analysisDataFormat.NTkmu++;
-			}
+	//  L1 Track Jets
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkJets; i++ )
+	{
+		const int index=addObject( objects.trackJets );
+		objects.trackJets.bx[index]=inputNtuple.l1upgrade_->tkJetBx.at( i );
+		objects.trackJets.et[index]=inputNtuple.l1upgrade_->tkJetEt.at( i );
+		objects.trackJets.zVertex[index]=inputNtuple.l1upgrade_->tkJetzVtx.at( i );
+		objects.trackJets.phi[index]=phiINjetCoord( inputNtuple.l1upgrade_->tkJetPhi.at( i ) );
+		objects.trackJets.eta[index]=etaINjetCoord( inputNtuple.l1upgrade_->tkJetEta.at( i ) );
+	}
 
+	// Get the muon information  L1 Track Muons
+	for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkMuons; i++ )
+	{
+		const int index=addObject( objects.trackMuons );
+		objects.trackMuons.bx[index]=inputNtuple.l1upgrade_->tkMuonBx.at( i );
+		objects.trackMuons.zVertex[index]=inputNtuple.l1upgrade_->tkMuonzVtx.at( i );
+		objects.trackMuons.trackIsolation[index]=inputNtuple.l1upgrade_->tkMuonTrkIso.at( i );
+		objects.trackMuons.pt[index]=inputNtuple.l1upgrade_->tkMuonEt.at( i );
+		objects.trackMuons.phi[index]=inputNtuple.l1upgrade_->tkMuonPhi.at( i );
+		objects.trackMuons.eta[index]=inputNtuple.l1upgrade_->tkMuonEta.at( i );
+		objects.trackMuons.quality[index]=inputNtuple.l1upgrade_->tkMuonQuality.at( i );
+		objects.trackMuons.isolated[index]=false; //inputNtuple.l1upgrade_->tkMuonIso.at(i);  //Calo Isolation
+	}
 
+	// Fill energy sums. For now only take the first version.
+	if( inputNtuple.l1upgrade_->nTkMet>0 )
+	{
+		objects.sums.trackTotalEt=inputNtuple.l1upgrade_->tkEt.at( 0 );
+		objects.sums.trackMissingEt=inputNtuple.l1upgrade_->tkMet.at( 0 );
+		objects.sums.trackMissingEtPhi=inputNtuple.l1upgrade_->tkMetPhi.at( 0 );
+	}
+	if( inputNtuple.l1upgrade_->nTkMht>0 )
+	{
+		objects.sums.trackTotalHt=inputNtuple.l1upgrade_->tkHt.at( 0 );
+		objects.sums.trackMissingHt=inputNtuple.l1upgrade_->tkMht.at( 0 );
+		objects.sums.trackMissingHtPhi=inputNtuple.l1upgrade_->tkMhtPhi.at( 0 );
+	}
+}
 
-			// Fill energy sums  (Are overflow flags accessible in l1extra?)
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkMet; i++ )
-			{
-			      //for now only take the first version
-		              if(i==0) {
-				analysisDataFormat.TkETT    =inputNtuple.l1upgrade_->tkEt.at( i );
-				analysisDataFormat.TkETM    =inputNtuple.l1upgrade_->tkMet.at( i );
-				analysisDataFormat.TkETMPhi =inputNtuple.l1upgrade_->tkMetPhi.at( i );
-			      }
-			}
+void l1menu::FullSamplePrivateMembers::fillL1Bits()
+{
+	bool* PhysicsBits=currentEvent.physicsBits();
 
-			// Fill energy sums  (Are overflow flags accessible in l1extra?)
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTkMht; i++ )
+	// I really don't think this if statement is correct. Surely it
+	// should be "if( inputNtuple.gt_ )"? - M. Grimes.
+	if( !inputNtuple.gt_ )
+	{
+		for( Int_t ibit=0; ibit<128; ibit++ )
+		{
+			PhysicsBits[ibit]=0;
+			if( ibit<64 )
 			{
-			      //for now only take the first version
-		              if(i==0) {
-				analysisDataFormat.TkHTT    =inputNtuple.l1upgrade_->tkHt.at( i );
-				analysisDataFormat.TkHTM    =inputNtuple.l1upgrade_->tkMht.at( i );
-				analysisDataFormat.TkHTMPhi =inputNtuple.l1upgrade_->tkMhtPhi.at( i );
-			      }
+				PhysicsBits[ibit]=(inputNtuple.gt_->tw1[2]>>ibit)&1;
 			}
-
-
-
-		break;
-
-		case 23:  //Select from L1ExtraUpgradeTree (Stage 2)  NO Tracking Information
-
-			// NOTES:  Stage 1 has EG Relaxed and EG Isolated.  The isolated EG are a subset of the Relaxed.
-			//         so sort through the relaxed list and flag those that also appear in the isolated list.
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nEG; i++ )
+			else
 			{
-
-				analysisDataFormat.Bxel.push_back( inputNtuple.l1upgrade_->egBx.at( i ) );
-				analysisDataFormat.Etel.push_back( inputNtuple.l1upgrade_->egEt.at( i ) );
-				analysisDataFormat.Phiel.push_back( phiINjetCoord( inputNtuple.l1upgrade_->egPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				analysisDataFormat.Etael.push_back( etaINjetCoord( inputNtuple.l1upgrade_->egEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-
-				// Check whether this EG is located in the isolation list
-				bool isolated=false;
-				bool fnd=false;
-				unsigned int isoEG=0;
-				while( !fnd && isoEG < inputNtuple.l1upgrade_->nIsoEG )
-				{
-					if( inputNtuple.l1upgrade_->isoEGPhi.at( isoEG )==inputNtuple.l1upgrade_->egPhi.at( i )
-							&& inputNtuple.l1upgrade_->isoEGEta.at( isoEG )==inputNtuple.l1upgrade_->egEta.at( i ) )
-					{
-						isolated=true;
-						fnd=true;
-					}
-					isoEG++;
-				}
-				analysisDataFormat.Isoel.push_back( isolated );
-				analysisDataFormat.Nele++;
+				PhysicsBits[ibit]=(inputNtuple.gt_->tw2[2]>>(ibit-64))&1;
 			}
+		}
+	}
+	else
+	{
+		PhysicsBits[0]=1; //set zero bias on if no gt information
+	}
+}
 
-			// Note:  Taus are in the jet list.  Decide what to do with them. For now
-			//  leave them the there as jets (not even flagged..)
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nJets; i++ )
-			{
-
-				// For each jet look for a possible duplicate if so remove it.
-				bool duplicate=false;
-				for( unsigned int j=0; j<i; j++ )
-				{
-					if( inputNtuple.l1upgrade_->jetBx.at( i )==inputNtuple.l1upgrade_->jetBx.at( j )
-							&& inputNtuple.l1upgrade_->jetEt.at( i )==inputNtuple.l1upgrade_->jetEt.at( j )
-							&& inputNtuple.l1upgrade_->jetEta.at( i )==inputNtuple.l1upgrade_->jetEta.at( j )
-							&& inputNtuple.l1upgrade_->jetPhi.at( i )==inputNtuple.l1upgrade_->jetPhi.at( j ) )
-					{
-						duplicate=true;
-						//printf("Duplicate jet found and removed \n");
-					}
-				}
-
-				if( !duplicate )
-				{
-					analysisDataFormat.Bxjet.push_back( inputNtuple.l1upgrade_->jetBx.at( i ) );
-					analysisDataFormat.Etjet.push_back( inputNtuple.l1upgrade_->jetEt.at( i ) );
-					analysisDataFormat.Phijet.push_back( phiINjetCoord( inputNtuple.l1upgrade_->jetPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-					analysisDataFormat.Etajet.push_back( etaINjetCoord( inputNtuple.l1upgrade_->jetEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-					analysisDataFormat.Taujet.push_back( false );
-					analysisDataFormat.isoTaujet.push_back( false );
-					//analysisDataFormat.Fwdjet.push_back(false); //COMMENT OUT IF JET ETA FIX
-
-					//if(fabs(inputNtuple.l1upgrade_->jetEta.at(i))>=3.0) printf("Et %f  Eta  %f  iEta  %f Phi %f  iPhi  %f \n",analysisDataFormat.Etjet.at(analysisDataFormat.Njet),inputNtuple.l1upgrade_->jetEta.at(i),analysisDataFormat.Etajet.at(analysisDataFormat.Njet),inputNtuple.l1upgrade_->jetPhi.at(i),analysisDataFormat.Phijet.at(analysisDataFormat.Njet));
-					//  Eta Jet Fix.  Some Jets with eta>3 has appeared in central jet list.  Move them by hand
-					//  This is a problem in Stage 2 Jet code.
-					(fabs( inputNtuple.l1upgrade_->jetEta.at( i ) )>=3.0) ? analysisDataFormat.Fwdjet.push_back( true ) : analysisDataFormat.Fwdjet.push_back( false );
-
-					analysisDataFormat.Njet++;
-				}
-			}
+const l1menu::L1TriggerDPGEvent& l1menu::FullSamplePrivateMembers::readEvent( size_t eventNumber )
+{
+	// Make sure the event number requested is valid. Use static_cast to get rid
+	// of the "comparison between signed and unsigned" compiler warning.
+	if( eventNumber>static_cast<size_t>(inputNtuple.GetEntries()) ) throw std::runtime_error( "Requested event number is out of range" );
 
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nFwdJets; i++ )
-			{
+	inputNtuple.LoadTree(eventNumber);
+	inputNtuple.GetEntry(eventNumber);
+	// This next call fills currentEvent with the information in inputNtuple
+	fillDataStructure( DATA_INPUT );
+	fillL1Bits();
 
-				analysisDataFormat.Bxjet.push_back( inputNtuple.l1upgrade_->fwdJetBx.at( i ) );
-				analysisDataFormat.Etjet.push_back( inputNtuple.l1upgrade_->fwdJetEt.at( i ) );
-				analysisDataFormat.Phijet.push_back( phiINjetCoord( inputNtuple.l1upgrade_->fwdJetPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-				analysisDataFormat.Etajet.push_back( etaINjetCoord( inputNtuple.l1upgrade_->fwdJetEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-				analysisDataFormat.Taujet.push_back( false );
-				analysisDataFormat.isoTaujet.push_back( false );
-				analysisDataFormat.Fwdjet.push_back( true );
+	return currentEvent;
+}
 
-				analysisDataFormat.Njet++;
-			}
+void l1menu::FullSamplePrivateMembers::setReadPlan( int selectDataInput )
+{
+	// The event information (for the weight) is always needed. fillL1Bits() doesn't need the
+	// GT branch, since gt_ is always set after L1UpgradeNtuple::Init() and it only reads it if not.
+	std::vector< std::pair<TChain*,std::string> > branchesToRead;
+	branchesToRead.push_back( std::make_pair( inputNtuple.fChain, "Event" ) );
 
-			// NOTES:  Stage 1 has Tau Relaxed and TauIsolated.  The isolated Tau are a subset of the Relaxed.
-			//         so sort through the relaxed list and flag those that also appear in the isolated list.
+	switch( selectDataInput )
+	{
+		case 22: // L1ExtraUpgradeTree with muons from the original GMT
+			branchesToRead.push_back( std::make_pair( inputNtuple.fChain, "GMT" ) );
+			branchesToRead.push_back( std::make_pair( inputNtuple.ftreeUpgrade, "L1ExtraUpgrade" ) );
+			break;
+		case 23: // L1ExtraUpgradeTree with muons from the re-emulated GMT
+			branchesToRead.push_back( std::make_pair( inputNtuple.ftreeEmu, "GMT" ) );
+			branchesToRead.push_back( std::make_pair( inputNtuple.ftreeUpgrade, "L1ExtraUpgrade" ) );
+			break;
+		default:
+			throw std::runtime_error( "FullSample::setReadPlan - no read plan for input source "+std::to_string(selectDataInput) );
+	}
 
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nTau; i++ )
-			{
+	inputNtuple.SetReadPlan( branchesToRead, READ_CACHE_SIZE, READ_CACHE_LEARN_ENTRIES );
+}
 
-				// remove duplicates
-				bool duplicate=false;
-				for( unsigned int j=0; j<i; j++ )
-				{
-					if( inputNtuple.l1upgrade_->tauBx.at( i )==inputNtuple.l1upgrade_->tauBx.at( j )
-							&& inputNtuple.l1upgrade_->tauEt.at( i )==inputNtuple.l1upgrade_->tauEt.at( j )
-							&& inputNtuple.l1upgrade_->tauEta.at( i )==inputNtuple.l1upgrade_->tauEta.at( j )
-							&& inputNtuple.l1upgrade_->tauPhi.at( i )==inputNtuple.l1upgrade_->tauPhi.at( j ) )
-					{
-						duplicate=true;
-						//printf("Duplicate jet found and removed \n");
-					}
-				}
-
-				if( !duplicate )
-				{
-					analysisDataFormat.Bxjet.push_back( inputNtuple.l1upgrade_->tauBx.at( i ) );
-					analysisDataFormat.Etjet.push_back( inputNtuple.l1upgrade_->tauEt.at( i ) );
-					analysisDataFormat.Phijet.push_back( phiINjetCoord( inputNtuple.l1upgrade_->tauPhi.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with phiINjetCoord
-					analysisDataFormat.Etajet.push_back( etaINjetCoord( inputNtuple.l1upgrade_->tauEta.at( i ) ) ); //PROBLEM: real value, trigger wants bin convert with etaINjetCoord
-					analysisDataFormat.Taujet.push_back( true );
-					analysisDataFormat.Fwdjet.push_back( false );
-
-					bool isolated=false;
-					bool fnd=false;
-					unsigned int isoTau=0;
-					while( !fnd && isoTau < inputNtuple.l1upgrade_->nIsoTau )
-					{
-						if( inputNtuple.l1upgrade_->isoTauPhi.at( isoTau )==inputNtuple.l1upgrade_->tauPhi.at( i )
-								&& inputNtuple.l1upgrade_->isoTauEta.at( isoTau )==inputNtuple.l1upgrade_->tauEta.at( i ) )
-						{
-							isolated=true;
-							fnd=true;
-						}
-						isoTau++;
-					}
-					analysisDataFormat.isoTaujet.push_back( isolated );
-
-					analysisDataFormat.Njet++;
-				} // duplicate check
-			}
+void l1menu::FullSamplePrivateMembers::loadFile( const std::string& filename, bool isListOfFiles )
+{
+	sumOfWeights=-1;
+	if( isListOfFiles ) inputNtuple.OpenWithList( filename );
+	else inputNtuple.Open( filename );
+	loadedFiles.push_back( std::make_pair( filename, isListOfFiles ) );
+	setReadPlan( DATA_INPUT );
+}
 
-			// Fill energy sums  (Are overflow flags accessible in l1extra?)
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nMet; i++ )
-			{
-				//if(inputNtuple.l1upgrade_->metBx.at(i)==0) {
-				analysisDataFormat.ETT=inputNtuple.l1upgrade_->et.at( i );
-				analysisDataFormat.ETM=inputNtuple.l1upgrade_->met.at( i );
-				analysisDataFormat.PhiETM=inputNtuple.l1upgrade_->metPhi.at( i );
-			}
-			analysisDataFormat.OvETT=0; //not available in l1extra
-			analysisDataFormat.OvETM=0; //not available in l1extra
+namespace l1menu
+{
+	/** @brief Event cursor for FullSample, which opens its own copy of the input ntuples and reads ahead on a background thread.
+	 *
+	 * Reading from ROOT trees changes the state of the tree, so the only way to read from
+	 * several threads at once is for each to have its own TChain etcetera.
+	 *
+	 * Reading and unzipping the ntuple is slow, so the cursor has its own thread that reads the
+	 * events following the last one asked for into a ring of PREFETCH_EVENTS ready events. Events
+	 * asked for in order are then usually ready straight away, and the reading overlaps with
+	 * whatever is done with the events. Asking for any other event throws away what has been read
+	 * ahead and starts again from there, but only reads ahead once the next event is asked for so
+	 * that random access doesn't read lots of events that aren't needed.
+	 */
+	class FullSampleEventCursor : public l1menu::IEventCursor
+	{
+	public:
+		FullSampleEventCursor( const l1menu::FullSample& sample, const std::vector< std::pair<std::string,bool> >& loadedFiles );
+		virtual ~FullSampleEventCursor();
+		virtual const l1menu::IEvent& getEvent( size_t eventNumber );
+	private:
+		static const size_t PREFETCH_EVENTS;
+		/** @brief The loop run on prefetchThread_, which reads events into readyEvents_ until the cursor is destroyed. */
+		void prefetchEvents();
+
+		FullSamplePrivateMembers members_; ///< Only used by prefetchThread_ once it has started
+		size_t numberOfEvents_;
+		std::vector<l1menu::L1TriggerDPGEvent> readyEvents_; ///< Event n is read into element n%PREFETCH_EVENTS
+		std::vector<std::exception_ptr> readErrors_; ///< Anything thrown while reading the event in the same element of readyEvents_
+		// Everything below here is protected by mutex_
+		std::mutex mutex_;
+		std::condition_variable prefetchWakeUp_;
+		std::condition_variable eventRead_;
+		size_t nextEventToRead_; ///< Every event from eventInUse_ up to but not including this is in readyEvents_
+		size_t eventInUse_; ///< The event last given out, which mustn't be overwritten
+		size_t nextEventExpected_;
+		bool readingInOrder_; ///< Whether the last event asked for followed on from the one before
+		bool currentlyReading_;
+		bool finished_;
+		std::thread prefetchThread_;
+	}; // end of class FullSampleEventCursor
+}
 
-			for( unsigned int i=0; i<inputNtuple.l1upgrade_->nMht; i++ )
-			{
-				if( inputNtuple.l1upgrade_->mhtBx.at( i )==0 )
-				{
-					analysisDataFormat.HTT=calculateHTT( analysisDataFormat ); //inputNtuple.l1upgrade_->ht.at(i) ;
-					analysisDataFormat.HTM=calculateHTM( analysisDataFormat ); //inputNtuple.l1upgrade_->mht.at(i) ;
-					analysisDataFormat.PhiHTM=0.; //inputNtuple.l1upgrade_->mhtPhi.at(i) ;
-				}
-			}
-			analysisDataFormat.OvHTM=0; //not available in l1extra
-			analysisDataFormat.OvHTT=0; //not available in l1extra
+const size_t l1menu::FullSampleEventCursor::PREFETCH_EVENTS=64;
 
-			// Get the muon information  from reEmul GMT
-			for( int i=0; i<inputNtuple.gmtEmu_->N; i++ )
-			{
+l1menu::FullSampleEventCursor::FullSampleEventCursor( const l1menu::FullSample& sample, const std::vector< std::pair<std::string,bool> >& loadedFiles )
+	: members_( &sample ), numberOfEvents_(0), readyEvents_( PREFETCH_EVENTS, l1menu::L1TriggerDPGEvent(sample) ), readErrors_( PREFETCH_EVENTS ),
+	  nextEventToRead_(0), eventInUse_(0), nextEventExpected_(0), readingInOrder_(false), currentlyReading_(false), finished_(false)
+{
+	for( const auto& file : loadedFiles ) members_.loadFile( file.first, file.second );
+	numberOfEvents_=static_cast<size_t>( members_.inputNtuple.GetEntries() );
 
-				analysisDataFormat.Bxmu.push_back( inputNtuple.gmtEmu_->CandBx[i] );
-				analysisDataFormat.Ptmu.push_back( inputNtuple.gmtEmu_->Pt[i] );
-				analysisDataFormat.Phimu.push_back( inputNtuple.gmtEmu_->Phi[i] );
-				analysisDataFormat.Etamu.push_back( inputNtuple.gmtEmu_->Eta[i] );
-				analysisDataFormat.Qualmu.push_back( inputNtuple.gmtEmu_->Qual[i] );
-				analysisDataFormat.Isomu.push_back( false );
-				analysisDataFormat.Nmu++;
-			}
+	// Nothing is read until the first event is asked for, since it's not known where that will be
+	nextEventToRead_=numberOfEvents_;
+	nextEventExpected_=numberOfEvents_;
+	prefetchThread_=std::thread( &FullSampleEventCursor::prefetchEvents, this );
+}
 
+l1menu::FullSampleEventCursor::~FullSampleEventCursor()
+{
+	{
+		std::lock_guard<std::mutex> lock( mutex_ );
+		finished_=true;
+	}
+	prefetchWakeUp_.notify_one();
+	prefetchThread_.join();
+}
 
-		break;
+const l1menu::IEvent& l1menu::FullSampleEventCursor::getEvent( size_t eventNumber )
+{
+	if( eventNumber>=numberOfEvents_ ) throw std::runtime_error( "Requested event number is out of range" );
 
+	std::unique_lock<std::mutex> lock( mutex_ );
+	readingInOrder_=(eventNumber==nextEventExpected_);
+	if( !readingInOrder_ )
+	{
+		// Not the next one in order, so start reading again from here. Whatever is being read
+		// at the moment has to finish first because it's going into one of the ring elements.
+		eventRead_.wait( lock, [this]{ return !currentlyReading_; } );
+		nextEventToRead_=eventNumber;
+	}
+	eventInUse_=eventNumber;
+	nextEventExpected_=eventNumber+1;
+	prefetchWakeUp_.notify_one();
 
-		default:
-			throw std::runtime_error( "---Not a valid input source FULL STOP! " );
+	eventRead_.wait( lock, [this,eventNumber]{ return nextEventToRead_>eventNumber; } );
 
-		break;
+	const size_t index=eventNumber%PREFETCH_EVENTS;
+	if( readErrors_[index] )
+	{
+		// Make sure the same event is read again if it's asked for again
+		nextEventExpected_=numberOfEvents_;
+		std::rethrow_exception( readErrors_[index] );
 	}
-
-	return;
+	return readyEvents_[index];
 }
 
-void l1menu::FullSamplePrivateMembers::fillL1Bits()
+void l1menu::FullSampleEventCursor::prefetchEvents()
 {
-	bool* PhysicsBits=currentEvent.physicsBits();
-
-	// I really don't think this if statement is correct. Surely it
-	// should be "if( inputNtuple.gt_ )"? - M. Grimes.
-	if( !inputNtuple.gt_ )
+	std::unique_lock<std::mutex> lock( mutex_ );
+	while( true )
 	{
-		for( Int_t ibit=0; ibit<128; ibit++ )
+		prefetchWakeUp_.wait( lock, [this]{ return finished_ || (nextEventToRead_<numberOfEvents_ && nextEventToRead_<eventInUse_+(readingInOrder_ ? PREFETCH_EVENTS : 1)); } );
+		if( finished_ ) return;
+
+		// The element being read into is outside of the ones getEvent can return, so it's safe
+		// to do the reading without the lock. getEvent waits for this to finish before moving
+		// nextEventToRead_ anywhere else.
+		const size_t eventNumber=nextEventToRead_;
+		const size_t index=eventNumber%PREFETCH_EVENTS;
+		currentlyReading_=true;
+		lock.unlock();
+
+		std::exception_ptr readError;
+		try
 		{
-			PhysicsBits[ibit]=0;
-			if( ibit<64 )
-			{
-				PhysicsBits[ibit]=(inputNtuple.gt_->tw1[2]>>ibit)&1;
-			}
-			else
-			{
-				PhysicsBits[ibit]=(inputNtuple.gt_->tw2[2]>>(ibit-64))&1;
-			}
+			members_.readEvent( eventNumber );
+			// Swap rather than copy, so that the event previously in the ring is reused for the next read
+			std::swap( members_.currentEvent, readyEvents_[index] );
 		}
-	}
-	else
-	{
-		PhysicsBits[0]=1; //set zero bias on if no gt information
+		catch( ... )
+		{
+			readError=std::current_exception();
+		}
+
+		lock.lock();
+		readErrors_[index]=readError;
+		currentlyReading_=false;
+		++nextEventToRead_;
+		eventRead_.notify_all();
 	}
 }
 
-
 l1menu::FullSample::FullSample()
 	: pImple_( new FullSamplePrivateMembers( this ) )
 {
@@ -784,29 +808,17 @@ l1menu::FullSample& l1menu::FullSample::operator=( l1menu::FullSample&& otherFul
 
 void l1menu::FullSample::loadFile( const std::string& filename )
 {
-	pImple_->sumOfWeights=-1;
-	pImple_->inputNtuple.Open( filename );
+	pImple_->loadFile( filename, false );
 }
 
 void l1menu::FullSample::loadFilesFromList( const std::string& filenameOfList )
 {
-	pImple_->sumOfWeights=-1;
-	pImple_->inputNtuple.OpenWithList( filenameOfList );
+	pImple_->loadFile( filenameOfList, true );
 }
 
 const l1menu::L1TriggerDPGEvent& l1menu::FullSample::getFullEvent( size_t eventNumber ) const
 {
-	// Make sure the event number requested is valid. Use static_cast to get rid
-	// of the "comparison between signed and unsigned" compiler warning.
-	if( eventNumber>static_cast<size_t>(pImple_->inputNtuple.GetEntries()) ) throw std::runtime_error( "Requested event number is out of range" );
-
-	pImple_->inputNtuple.LoadTree(eventNumber);
-	pImple_->inputNtuple.GetEntry(eventNumber);
-	// This next call fills pImple_->currentEvent with the information in pImple_->inputNtuple
-	pImple_->fillDataStructure( 22 );
-	pImple_->fillL1Bits();
-
-	return pImple_->currentEvent;
+	return pImple_->readEvent( eventNumber );
 }
 
 size_t l1menu::FullSample::numberOfEvents() const
@@ -820,6 +832,14 @@ const l1menu::IEvent& l1menu::FullSample::getEvent( size_t eventNumber ) const
 	return getFullEvent( eventNumber );
 }
 
+std::unique_ptr<l1menu::IEventCursor> l1menu::FullSample::createEventCursor() const
+{
+	// ROOT needs to be told that it's going to be used from several threads before any
+	// of them start. Doing it more than once is harmless.
+	TThread::Initialize();
+	return std::unique_ptr<l1menu::IEventCursor>( new FullSampleEventCursor( *this, pImple_->loadedFiles ) );
+}
+
 std::unique_ptr<l1menu::ICachedTrigger> l1menu::FullSample::createCachedTrigger( const l1menu::ITrigger& trigger ) const
 {
 	return std::unique_ptr<l1menu::ICachedTrigger>( new CachedTriggerImplementation(trigger) );
@@ -835,17 +855,20 @@ void l1menu::FullSample::setEventRate( float rate )
 	pImple_->eventRate=rate;
 }
 
+void l1menu::FullSample::setSumOfWeightsCacheDirectory( const std::string& directory )
+{
+	pImple_->sumOfWeightsCacheDirectory=directory;
+}
+
 float l1menu::FullSample::sumOfWeights() const
 {
 	if( pImple_->sumOfWeights==-1 )
 	{
-		pImple_->sumOfWeights=0;
-		for( int eventNumber=0; eventNumber<pImple_->inputNtuple.GetEntries(); ++eventNumber )
-		{
-			pImple_->inputNtuple.LoadTree(eventNumber);
-			pImple_->inputNtuple.GetEntry(eventNumber);
-			pImple_->sumOfWeights+=pImple_->inputNtuple.event_->puWeight;
-		}
+		// Go through the files separately rather than the chain, so that only the weights are
+		// read and the saved total can be used for any file that's been done before.
+		double sumOfWeights=0;
+		for( const auto& filename : pImple_->inputNtuple.GetNtupleFilenames() ) sumOfWeights+=sumOfWeightsInFile( filename, pImple_->sumOfWeightsCacheDirectory );
+		pImple_->sumOfWeights=sumOfWeights;
 	}
 
 	return pImple_->sumOfWeights;
@@ -0,0 +1,253 @@
+#include "l1menu/IncrementalMenuRate.h"
+
+#include <vector>
+#include <stdexcept>
+#include "l1menu/ReducedSample.h"
+#include "l1menu/ReducedEventBlock.h"
+#include "l1menu/TriggerMenu.h"
+#include "l1menu/ITrigger.h"
+#include "l1menu/IMenuRate.h"
+#include "l1menu/tools/ThreadPool.h"
+#include "./implementation/MenuRateImplementation.h"
+#include "./implementation/TriggerPassBits.h"
+
+namespace // unnamed namespace
+{
+	typedef l1menu::implementation::TriggerPassBits TriggerPassBits;
+	typedef l1menu::implementation::MenuRateImplementation::WeightSums WeightSums;
+
+	//
+	// These set one of the sums for a block from scratch. They're done in exactly the same
+	// way as in MenuRateImplementation so that the result is identical to a fresh calculation.
+	//
+	void setPassedSums( WeightSums& sums, const TriggerPassBits& passBits, size_t triggerNumber )
+	{
+		sums.weightOfEventsPassed[triggerNumber]=0;
+		sums.weightSquaredOfEventsPassed[triggerNumber]=0;
+		passBits.sumWeights( passBits.triggerBits(triggerNumber), sums.weightOfEventsPassed[triggerNumber], sums.weightSquaredOfEventsPassed[triggerNumber] );
+	}
+
+	void setPureSums( WeightSums& sums, const TriggerPassBits& passBits, size_t triggerNumber )
+	{
+		sums.weightOfEventsPure[triggerNumber]=0;
+		sums.weightSquaredOfEventsPure[triggerNumber]=0;
+		passBits.sumWeightsExcluding( passBits.triggerBits(triggerNumber), passBits.moreThanOneTriggerBits(), sums.weightOfEventsPure[triggerNumber], sums.weightSquaredOfEventsPure[triggerNumber] );
+	}
+
+	void setAnyTriggerSums( WeightSums& sums, const TriggerPassBits& passBits )
+	{
+		sums.weightOfEventsPassingAnyTrigger=0;
+		sums.weightSquaredOfEventsPassingAnyTrigger=0;
+		passBits.sumWeights( passBits.anyTriggerBits(), sums.weightOfEventsPassingAnyTrigger, sums.weightSquaredOfEventsPassingAnyTrigger );
+	}
+} // end of the unnamed namespace
+
+namespace l1menu
+{
+	/** @brief Private members for the IncrementalMenuRate class
+	 */
+	class IncrementalMenuRatePrivateMembers
+	{
+	public:
+		IncrementalMenuRatePrivateMembers( const l1menu::ReducedSample& newSample, const l1menu::TriggerMenu& newMenu );
+		/** @brief Re-evaluates any triggers that have changed since the last call. */
+		void update();
+		/** @brief Adds up the sums for every block, leaving out disabled triggers. */
+		WeightSums totalSums() const;
+		/** @brief A copy of the menu with only the enabled triggers. */
+		l1menu::TriggerMenu enabledMenu() const;
+
+		const l1menu::ReducedSample& sample;
+		l1menu::TriggerMenu menu;
+		std::vector<char> triggerEnabled;
+		std::vector<char> triggerNeedsUpdate;
+		/// Which events pass each trigger, one entry for each block in the sample
+		std::vector< std::unique_ptr<TriggerPassBits> > blockPassBits;
+		/// The sums of weights for each block, for all triggers including disabled ones
+		std::vector<WeightSums> blockSums;
+	};
+}
+
+l1menu::IncrementalMenuRatePrivateMembers::IncrementalMenuRatePrivateMembers( const l1menu::ReducedSample& newSample, const l1menu::TriggerMenu& newMenu )
+	: sample(newSample), menu(newMenu), triggerEnabled(newMenu.numberOfTriggers(),true), triggerNeedsUpdate(newMenu.numberOfTriggers(),false),
+	  blockPassBits(newSample.numberOfEventBlocks()), blockSums(newSample.numberOfEventBlocks(),WeightSums(newMenu.numberOfTriggers()))
+{
+	const auto triggerThresholds=TriggerPassBits::triggerThresholds( menu, sample );
+
+	l1menu::tools::ThreadPool::instance().run( sample.numberOfEventBlocks(), [&]( size_t blockNumber )
+	{
+		const l1menu::ReducedEventBlock& eventBlock=sample.eventBlock( blockNumber );
+		blockPassBits[blockNumber].reset( new TriggerPassBits( triggerThresholds, eventBlock ) );
+		const TriggerPassBits& passBits=*blockPassBits[blockNumber];
+		WeightSums& sums=blockSums[blockNumber];
+
+		const float* pWeights=eventBlock.weights();
+		for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber ) sums.weightOfAllEvents+=pWeights[eventNumber];
+		for( size_t triggerNumber=0; triggerNumber<passBits.numberOfTriggers(); ++triggerNumber )
+		{
+			setPassedSums( sums, passBits, triggerNumber );
+			setPureSums( sums, passBits, triggerNumber );
+		}
+		setAnyTriggerSums( sums, passBits );
+	} );
+}
+
+void l1menu::IncrementalMenuRatePrivateMembers::update()
+{
+	// Look up the thresholds for everything that's changed first, on this thread, because
+	// this is where any exceptions about incompatible triggers will come from.
+	std::vector<size_t> changedTriggers;
+	std::vector<TriggerPassBits::TriggerThresholds> changedThresholds;
+	for( size_t triggerNumber=0; triggerNumber<menu.numberOfTriggers(); ++triggerNumber )
+	{
+		if( !triggerNeedsUpdate[triggerNumber] ) continue;
+
+		TriggerPassBits::TriggerThresholds thresholds;
+		if( triggerEnabled[triggerNumber] )
+		{
+			const l1menu::ITrigger& trigger=menu.getTrigger( triggerNumber );
+			for( const auto& identifier : sample.getTriggerParameterIdentifiers(trigger) )
+			{
+				thresholds.push_back( std::make_pair( identifier.second, trigger.parameter(identifier.first) ) );
+			}
+		}
+		changedTriggers.push_back( triggerNumber );
+		changedThresholds.push_back( std::move(thresholds) );
+	}
+	if( changedTriggers.empty() ) return;
+
+	l1menu::tools::ThreadPool::instance().run( blockPassBits.size(), [&]( size_t blockNumber )
+	{
+		TriggerPassBits& passBits=*blockPassBits[blockNumber];
+		WeightSums& sums=blockSums[blockNumber];
+		std::vector<char> pureEventsChanged( passBits.numberOfTriggers(), false );
+		bool anyBitsChanged=false;
+
+		for( size_t index=0; index<changedTriggers.size(); ++index )
+		{
+			const size_t triggerNumber=changedTriggers[index];
+			bool bitsChanged;
+			if( triggerEnabled[triggerNumber] ) bitsChanged=passBits.changeTrigger( triggerNumber, changedThresholds[index], sample.eventBlock(blockNumber), pureEventsChanged );
+			else bitsChanged=passBits.clearTrigger( triggerNumber, pureEventsChanged );
+
+			if( bitsChanged )
+			{
+				setPassedSums( sums, passBits, triggerNumber );
+				anyBitsChanged=true;
+			}
+		}
+
+		if( !anyBitsChanged ) return;
+		for( size_t triggerNumber=0; triggerNumber<pureEventsChanged.size(); ++triggerNumber )
+		{
+			if( pureEventsChanged[triggerNumber] ) setPureSums( sums, passBits, triggerNumber );
+		}
+		setAnyTriggerSums( sums, passBits );
+	} );
+
+	for( const auto triggerNumber : changedTriggers ) triggerNeedsUpdate[triggerNumber]=false;
+}
+
+WeightSums l1menu::IncrementalMenuRatePrivateMembers::totalSums() const
+{
+	std::vector<size_t> enabledTriggers;
+	for( size_t triggerNumber=0; triggerNumber<menu.numberOfTriggers(); ++triggerNumber )
+	{
+		if( triggerEnabled[triggerNumber] ) enabledTriggers.push_back( triggerNumber );
+	}
+
+	// Add up the blocks in order, the same as MenuRateImplementation does
+	WeightSums returnValue( enabledTriggers.size() );
+	for( const auto& sums : blockSums )
+	{
+		WeightSums enabledSums( enabledTriggers.size() );
+		for( size_t index=0; index<enabledTriggers.size(); ++index )
+		{
+			enabledSums.weightOfEventsPassed[index]=sums.weightOfEventsPassed[enabledTriggers[index]];
+			enabledSums.weightSquaredOfEventsPassed[index]=sums.weightSquaredOfEventsPassed[enabledTriggers[index]];
+			enabledSums.weightOfEventsPure[index]=sums.weightOfEventsPure[enabledTriggers[index]];
+			enabledSums.weightSquaredOfEventsPure[index]=sums.weightSquaredOfEventsPure[enabledTriggers[index]];
+		}
+		enabledSums.weightOfEventsPassingAnyTrigger=sums.weightOfEventsPassingAnyTrigger;
+		enabledSums.weightSquaredOfEventsPassingAnyTrigger=sums.weightSquaredOfEventsPassingAnyTrigger;
+		enabledSums.weightOfAllEvents=sums.weightOfAllEvents;
+		returnValue.add( enabledSums );
+	}
+	return returnValue;
+}
+
+l1menu::TriggerMenu l1menu::IncrementalMenuRatePrivateMembers::enabledMenu() const
+{
+	l1menu::TriggerMenu returnValue;
+	for( size_t triggerNumber=0; triggerNumber<menu.numberOfTriggers(); ++triggerNumber )
+	{
+		if( triggerEnabled[triggerNumber] ) returnValue.addTrigger( menu.getTrigger(triggerNumber) );
+	}
+	return returnValue;
+}
+
+l1menu::IncrementalMenuRate::IncrementalMenuRate( const l1menu::ReducedSample& sample, const l1menu::TriggerMenu& menu )
+	: pImple_( new IncrementalMenuRatePrivateMembers(sample,menu) )
+{
+	// No operation besides the initialiser list
+}
+
+l1menu::IncrementalMenuRate::~IncrementalMenuRate()
+{
+	// No operation. Just need one defined otherwise the default one messes up
+	// the unique_ptr deletion because IncrementalMenuRatePrivateMembers isn't
+	// defined elsewhere.
+}
+
+const l1menu::TriggerMenu& l1menu::IncrementalMenuRate::menu() const
+{
+	return pImple_->menu;
+}
+
+void l1menu::IncrementalMenuRate::setTriggerParameter( size_t triggerNumber, const std::string& parameterName, float value )
+{
+	float& parameter=pImple_->menu.getTrigger( triggerNumber ).parameter( parameterName );
+	if( parameter==value ) return;
+	parameter=value;
+	pImple_->triggerNeedsUpdate[triggerNumber]=true;
+}
+
+void l1menu::IncrementalMenuRate::setTriggerParameters( size_t triggerNumber, const l1menu::ITriggerDescription& trigger )
+{
+	const l1menu::ITrigger& currentTrigger=pImple_->menu.getTrigger( triggerNumber );
+	if( currentTrigger.name()!=trigger.name() || currentTrigger.version()!=trigger.version() )
+	{
+		throw std::runtime_error( "IncrementalMenuRate::setTriggerParameters was given a "+trigger.name()+" trigger to copy into a "+currentTrigger.name() );
+	}
+
+	for( const auto& parameterName : trigger.parameterNames() )
+	{
+		setTriggerParameter( triggerNumber, parameterName, trigger.parameter(parameterName) );
+	}
+}
+
+void l1menu::IncrementalMenuRate::setTriggerEnabled( size_t triggerNumber, bool enabled )
+{
+	if( static_cast<bool>(pImple_->triggerEnabled.at(triggerNumber))==enabled ) return;
+	pImple_->triggerEnabled[triggerNumber]=enabled;
+	pImple_->triggerNeedsUpdate[triggerNumber]=true;
+}
+
+bool l1menu::IncrementalMenuRate::triggerIsEnabled( size_t triggerNumber ) const
+{
+	return pImple_->triggerEnabled.at(triggerNumber);
+}
+
+std::shared_ptr<const l1menu::IMenuRate> l1menu::IncrementalMenuRate::rate()
+{
+	pImple_->update();
+	return std::shared_ptr<const l1menu::IMenuRate>( new l1menu::implementation::MenuRateImplementation( pImple_->enabledMenu(), pImple_->totalSums(), pImple_->sample.eventRate() ) );
+}
+
+std::shared_ptr<const l1menu::IMenuRate> l1menu::IncrementalMenuRate::rate( const l1menu::MenuRatePlots& ratePlots )
+{
+	pImple_->update();
+	std::shared_ptr<l1menu::implementation::MenuRateImplementation> pRate( new l1menu::implementation::MenuRateImplementation( pImple_->enabledMenu(), pImple_->totalSums(), pImple_->sample.eventRate() ) );
+	pRate->setThresholdErrors( ratePlots );
+	return pRate;
+}
@@ -1,6 +1,7 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include "l1menu/ITrigger.h"
+#include "l1menu/L1TriggerObjects.h"
 #include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
 
 namespace l1menu
@@ -8,14 +9,149 @@ namespace l1menu
 	class L1TriggerDPGEventPrivateMembers
 	{
 	public:
-		L1TriggerDPGEventPrivateMembers( const l1menu::ISample* pParentSample ) : pParentSample_(pParentSample) {}
+		L1TriggerDPGEventPrivateMembers( const l1menu::ISample* pParentSample ) : triggerObjects(), rawEventIsCurrent(false), pParentSample_(pParentSample) {}
+		/** @brief Converts triggerObjects into rawEvent. */
+		void fillRawEvent();
+		l1menu::L1TriggerObjects triggerObjects;
 		L1Analysis::L1AnalysisDataFormat rawEvent;
+		bool rawEventIsCurrent; ///< @brief Whether rawEvent has been filled from the current triggerObjects
 		bool physicsBits[128];
 		float weight;
 		const l1menu::ISample* pParentSample_;
 	};
 }
 
+void l1menu::L1TriggerDPGEventPrivateMembers::fillRawEvent()
+{
+	const l1menu::L1TriggerObjects& objects=triggerObjects;
+	rawEvent.Reset();
+
+	rawEvent.Run=objects.run;
+	rawEvent.LS=objects.lumiSection;
+	rawEvent.Event=objects.event;
+
+	for( int index=0; index<objects.eg.number; ++index )
+	{
+		rawEvent.Bxel.push_back( objects.eg.bx[index] );
+		rawEvent.Etel.push_back( objects.eg.et[index] );
+		rawEvent.Phiel.push_back( objects.eg.phi[index] );
+		rawEvent.Etael.push_back( objects.eg.eta[index] );
+		rawEvent.Isoel.push_back( objects.eg.isolated[index] );
+	}
+	rawEvent.Nele=objects.eg.number;
+
+	for( int index=0; index<objects.jets.number; ++index )
+	{
+		rawEvent.Bxjet.push_back( objects.jets.bx[index] );
+		rawEvent.Etjet.push_back( objects.jets.et[index] );
+		rawEvent.Phijet.push_back( objects.jets.phi[index] );
+		rawEvent.Etajet.push_back( objects.jets.eta[index] );
+		rawEvent.Taujet.push_back( objects.jets.tau[index] );
+		rawEvent.isoTaujet.push_back( objects.jets.isolatedTau[index] );
+		rawEvent.Fwdjet.push_back( objects.jets.forward[index] );
+	}
+	rawEvent.Njet=objects.jets.number;
+
+	for( int index=0; index<objects.muons.number; ++index )
+	{
+		rawEvent.Bxmu.push_back( objects.muons.bx[index] );
+		rawEvent.Ptmu.push_back( objects.muons.pt[index] );
+		rawEvent.Phimu.push_back( objects.muons.phi[index] );
+		rawEvent.Etamu.push_back( objects.muons.eta[index] );
+		rawEvent.Qualmu.push_back( objects.muons.quality[index] );
+		rawEvent.Isomu.push_back( objects.muons.isolated[index] );
+	}
+	rawEvent.Nmu=objects.muons.number;
+
+	for( int index=0; index<objects.trackElectrons.number; ++index )
+	{
+		rawEvent.BxTkel.push_back( objects.trackElectrons.bx[index] );
+		rawEvent.zVtxTkel.push_back( objects.trackElectrons.zVertex[index] );
+		rawEvent.tIsoTkel.push_back( objects.trackElectrons.trackIsolation[index] );
+		rawEvent.EtTkel.push_back( objects.trackElectrons.et[index] );
+		rawEvent.PhiTkel.push_back( objects.trackElectrons.phi[index] );
+		rawEvent.EtaTkel.push_back( objects.trackElectrons.eta[index] );
+		rawEvent.IsoTkel.push_back( objects.trackElectrons.isolated[index] );
+	}
+	rawEvent.NTkele=objects.trackElectrons.number;
+
+	for( int index=0; index<objects.lowPtTrackElectrons.number; ++index )
+	{
+		rawEvent.BxTkel2.push_back( objects.lowPtTrackElectrons.bx[index] );
+		rawEvent.zVtxTkel2.push_back( objects.lowPtTrackElectrons.zVertex[index] );
+		rawEvent.tIsoTkel2.push_back( objects.lowPtTrackElectrons.trackIsolation[index] );
+		rawEvent.EtTkel2.push_back( objects.lowPtTrackElectrons.et[index] );
+		rawEvent.PhiTkel2.push_back( objects.lowPtTrackElectrons.phi[index] );
+		rawEvent.EtaTkel2.push_back( objects.lowPtTrackElectrons.eta[index] );
+		rawEvent.IsoTkel2.push_back( objects.lowPtTrackElectrons.isolated[index] );
+	}
+	rawEvent.NTkele2=objects.lowPtTrackElectrons.number;
+
+	for( int index=0; index<objects.trackEMs.number; ++index )
+	{
+		rawEvent.BxTkem.push_back( objects.trackEMs.bx[index] );
+		rawEvent.EtTkem.push_back( objects.trackEMs.et[index] );
+		rawEvent.tIsoTkem.push_back( objects.trackEMs.trackIsolation[index] );
+		rawEvent.PhiTkem.push_back( objects.trackEMs.phi[index] );
+		rawEvent.EtaTkem.push_back( objects.trackEMs.eta[index] );
+	}
+	rawEvent.NTkem=objects.trackEMs.number;
+
+	for( int index=0; index<objects.trackTaus.number; ++index )
+	{
+		rawEvent.BxTktau.push_back( objects.trackTaus.bx[index] );
+		rawEvent.zVtxTktau.push_back( objects.trackTaus.zVertex[index] );
+		rawEvent.tIsoTktau.push_back( objects.trackTaus.trackIsolation[index] );
+		rawEvent.EtTktau.push_back( objects.trackTaus.et[index] );
+		rawEvent.PhiTktau.push_back( objects.trackTaus.phi[index] );
+		rawEvent.EtaTktau.push_back( objects.trackTaus.eta[index] );
+		rawEvent.IsoTktau.push_back( objects.trackTaus.isolated[index] );
+	}
+	rawEvent.NTktau=objects.trackTaus.number;
+
+	for( int index=0; index<objects.trackJets.number; ++index )
+	{
+		rawEvent.BxTkjet.push_back( objects.trackJets.bx[index] );
+		rawEvent.EtTkjet.push_back( objects.trackJets.et[index] );
+		rawEvent.zVtxTkjet.push_back( objects.trackJets.zVertex[index] );
+		rawEvent.PhiTkjet.push_back( objects.trackJets.phi[index] );
+		rawEvent.EtaTkjet.push_back( objects.trackJets.eta[index] );
+	}
+	rawEvent.NTkjet=objects.trackJets.number;
+
+	for( int index=0; index<objects.trackMuons.number; ++index )
+	{
+		rawEvent.BxTkmu.push_back( objects.trackMuons.bx[index] );
+		rawEvent.zVtxTkmu.push_back( objects.trackMuons.zVertex[index] );
+		rawEvent.tIsoTkmu.push_back( objects.trackMuons.trackIsolation[index] );
+		rawEvent.PtTkmu.push_back( objects.trackMuons.pt[index] );
+		rawEvent.PhiTkmu.push_back( objects.trackMuons.phi[index] );
+		rawEvent.EtaTkmu.push_back( objects.trackMuons.eta[index] );
+		rawEvent.QualTkmu.push_back( objects.trackMuons.quality[index] );
+		rawEvent.IsoTkmu.push_back( objects.trackMuons.isolated[index] );
+	}
+	rawEvent.NTkmu=objects.trackMuons.number;
+
+	rawEvent.ETT=objects.sums.totalEt;
+	rawEvent.ETM=objects.sums.missingEt;
+	rawEvent.PhiETM=objects.sums.missingEtPhi;
+	rawEvent.HTT=objects.sums.totalHt;
+	rawEvent.HTM=objects.sums.missingHt;
+	rawEvent.PhiHTM=objects.sums.missingHtPhi;
+	rawEvent.OvETT=objects.sums.totalEtOverflow;
+	rawEvent.OvETM=objects.sums.missingEtOverflow;
+	rawEvent.OvHTT=objects.sums.totalHtOverflow;
+	rawEvent.OvHTM=objects.sums.missingHtOverflow;
+	rawEvent.TkETT=objects.sums.trackTotalEt;
+	rawEvent.TkETM=objects.sums.trackMissingEt;
+	rawEvent.TkETMPhi=objects.sums.trackMissingEtPhi;
+	rawEvent.TkHTT=objects.sums.trackTotalHt;
+	rawEvent.TkHTM=objects.sums.trackMissingHt;
+	rawEvent.TkHTMPhi=objects.sums.trackMissingHtPhi;
+
+	rawEventIsCurrent=true;
+}
+
 
 l1menu::L1TriggerDPGEvent::L1TriggerDPGEvent( const l1menu::ISample& parentSample ) : pImple_( new L1TriggerDPGEventPrivateMembers(&parentSample) )
 {
@@ -49,13 +185,21 @@ l1menu::L1TriggerDPGEvent::~L1TriggerDPGEvent()
 	// No operation
 }
 
-L1Analysis::L1AnalysisDataFormat& l1menu::L1TriggerDPGEvent::rawEvent()
+l1menu::L1TriggerObjects& l1menu::L1TriggerDPGEvent::triggerObjects()
 {
-	return pImple_->rawEvent;
+	// The caller could change anything, so the old format will have to be filled again
+	pImple_->rawEventIsCurrent=false;
+	return pImple_->triggerObjects;
+}
+
+const l1menu::L1TriggerObjects& l1menu::L1TriggerDPGEvent::triggerObjects() const
+{
+	return pImple_->triggerObjects;
 }
 
 const L1Analysis::L1AnalysisDataFormat& l1menu::L1TriggerDPGEvent::rawEvent() const
 {
+	if( !pImple_->rawEventIsCurrent ) pImple_->fillRawEvent();
 	return pImple_->rawEvent;
 }
 
@@ -16,6 +16,9 @@
 #include "l1menu/TriggerRatePlot.h"
 #include "l1menu/TriggerConstraint.h"
 #include "l1menu/MenuRatePlots.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/SortedParameterIndex.h"
+#include "l1menu/IncrementalMenuRate.h"
 #include "l1menu/tools/miscellaneous.h"
 #include "l1menu/tools/fileIO.h"
 #include "l1menu/tools/stringManipulation.h"
@@ -32,8 +35,9 @@ namespace // Use the unnamed namespace for things only used here
 		float bandwidthFraction; ///< The fraction of the total bandwidth requested for this trigger
 		float currentBandwidth;
 		l1menu::TriggerRatePlot ratePlot; ///< The rate plot for this trigger
-		std::string mainThreshold;
-		std::vector< std::pair<std::string,float> > thresholdScalings; ///< The constant to scale each threshold compared to the main threshold
+		size_t mainThreshold; ///< The ITrigger::parameterIndex of the main threshold
+		std::vector< std::pair<size_t,float> > thresholdScalings; ///< The parameter index and constant to scale each threshold compared to the main threshold
+		const l1menu::SortedParameterIndex* pSortedIndex; ///< If the sample is a ReducedSample and the trigger only depends on the main threshold, the index for it. Otherwise null.
 	};
 } // end of the unnamed namespace
 
@@ -81,6 +85,11 @@ namespace l1menu
 		std::vector< ::TriggerScalingDetails > scalableTriggers;
 		std::vector<std::pair<size_t,float> > bandwidthFractions;
 		void addBandwidthConstraint( size_t triggerNumber, float fractionOfTotalBandwidth );
+		/** @brief The main threshold that should give the trigger its currentBandwidth.
+		 *
+		 * Read exactly from the sorted index if there is one, otherwise interpolated from the rate plot.
+		 */
+		float findThreshold( const ::TriggerScalingDetails& triggerScalingDetails ) const;
 		std::stringstream debugLog;
 	};
 
@@ -143,23 +152,30 @@ std::shared_ptr<const l1menu::IMenuRate> l1menu::MenuFitter::fit( float totalRat
 //				<< " to try and get a rate of " << totalRate*triggerScalingDetails.bandwidthFraction
 //				<< ". Plot title is " << triggerScalingDetails.ratePlot.getPlot()->GetTitle() << std::endl;
 
-		float& mainThreshold=trigger.parameter( triggerScalingDetails.mainThreshold );
+		float& mainThreshold=trigger.parameterAt( triggerScalingDetails.mainThreshold );
 		// Figure out what threshold should give the target rate for this particular trigger.
 		// Note this is a reference so this command changes the trigger.
 		triggerScalingDetails.currentBandwidth=totalRate*triggerScalingDetails.bandwidthFraction;
-		mainThreshold=triggerScalingDetails.ratePlot.findThreshold( triggerScalingDetails.currentBandwidth );
+		mainThreshold=pImple_->findThreshold( triggerScalingDetails );
 		// Then scale all of the others off this
-		for( const auto& nameScalePair : triggerScalingDetails.thresholdScalings )
+		for( const auto& indexScalePair : triggerScalingDetails.thresholdScalings )
 		{
-			trigger.parameter( nameScalePair.first )=mainThreshold*nameScalePair.second;
+			trigger.parameterAt( indexScalePair.first )=mainThreshold*indexScalePair.second;
 		}
 
 		pImple_->debugLog << "Initially setting threshold for " << std::setw(20) << trigger.name() << " to " << std::setw(10) << mainThreshold << " to try and get a rate of " << totalRate*triggerScalingDetails.bandwidthFraction << std::endl;
 	}
 
+	// If the sample is a ReducedSample then the rate can be updated incrementally between
+	// iterations, rather than going through every trigger for every event each time.
+	std::unique_ptr<l1menu::IncrementalMenuRate> pIncrementalRate;
+	const l1menu::ReducedSample* pReducedSample=dynamic_cast<const l1menu::ReducedSample*>( &pImple_->sample );
+	if( pReducedSample!=nullptr ) pIncrementalRate.reset( new l1menu::IncrementalMenuRate( *pReducedSample, pImple_->menu ) );
+
 	// Then work out what the total rate is
 	std::shared_ptr<const l1menu::IMenuRate> pMenuRate;
-	pMenuRate=pImple_->sample.rate( pImple_->menu, menuRatePlots() );
+	if( pIncrementalRate ) pMenuRate=pIncrementalRate->rate( menuRatePlots() );
+	else pMenuRate=pImple_->sample.rate( pImple_->menu, menuRatePlots() );
 
 	l1menu::tools::dumpTriggerRates( pImple_->debugLog, *pMenuRate );
 
@@ -178,21 +194,23 @@ std::shared_ptr<const l1menu::IMenuRate> l1menu::MenuFitter::fit( float totalRat
 			l1menu::ITrigger& trigger=pImple_->menu.getTrigger( triggerNumber );
 			const l1menu::ITriggerRate* pTriggerRate=pMenuRate->triggerRates()[triggerNumber];
 
-			float& mainThreshold=trigger.parameter( triggerScalingDetails.mainThreshold );
+			float& mainThreshold=trigger.parameterAt( triggerScalingDetails.mainThreshold );
 			// Figure out what threshold should give the target rate for this particular trigger.
 			triggerScalingDetails.currentBandwidth*=scaleAllBandwidthsBy;
-			mainThreshold=triggerScalingDetails.ratePlot.findThreshold( triggerScalingDetails.currentBandwidth );
+			mainThreshold=pImple_->findThreshold( triggerScalingDetails );
 
 			// Then scale all of the others off this
-			for( const auto& nameScalePair : triggerScalingDetails.thresholdScalings )
+			for( const auto& indexScalePair : triggerScalingDetails.thresholdScalings )
 			{
-				trigger.parameter( nameScalePair.first )=mainThreshold*nameScalePair.second;
+				trigger.parameterAt( indexScalePair.first )=mainThreshold*indexScalePair.second;
 			}
 			pImple_->debugLog << "Changing threshold for " << std::setw(20) << trigger.name() << " to " << std::setw(10) << mainThreshold << " to try and change the rate from " << std::setw(10) << pTriggerRate->rate() << " to " << pTriggerRate->rate()*scaleAllBandwidthsBy << std::endl;
 
+			if( pIncrementalRate ) pIncrementalRate->setTriggerParameters( triggerNumber, trigger );
 		} // end of loop over triggers I'm allowed to change thresholds for
 
-		pMenuRate=pImple_->sample.rate( pImple_->menu, menuRatePlots() );
+		if( pIncrementalRate ) pMenuRate=pIncrementalRate->rate( menuRatePlots() );
+		else pMenuRate=pImple_->sample.rate( pImple_->menu, menuRatePlots() );
 		l1menu::tools::dumpTriggerRates( pImple_->debugLog, *pMenuRate );
 	}
 
@@ -223,13 +241,30 @@ void l1menu::MenuFitterPrivateMembers::addBandwidthConstraint( size_t triggerNum
 	const std::string& mainThreshold=thresholdNames.front();
 
 	// Record the scaling between the main threshold and all of the others, so that
-	// when they get increased/decreased it's all done proportionally.
-	std::vector< std::pair<std::string,float> > thresholdScalings;
-	const float mainThresholdValue=newTrigger.parameter(mainThreshold);
+	// when they get increased/decreased it's all done proportionally. The names are
+	// resolved to parameter indices now so that the fit loop doesn't have to keep
+	// looking them up.
+	const size_t mainThresholdIndex=newTrigger.parameterIndex(mainThreshold);
+	std::vector< std::pair<size_t,float> > thresholdScalings;
+	const float mainThresholdValue=newTrigger.parameterAt(mainThresholdIndex);
 	for( const auto& thresholdName : thresholdNames )
 	{
 		if( thresholdName==mainThreshold ) continue;
-		thresholdScalings.push_back( std::make_pair( thresholdName, newTrigger.parameter(thresholdName)/mainThresholdValue ) );
+		const size_t thresholdIndex=newTrigger.parameterIndex(thresholdName);
+		thresholdScalings.push_back( std::make_pair( thresholdIndex, newTrigger.parameterAt(thresholdIndex)/mainThresholdValue ) );
+	}
+
+	// If the rate only depends on the one column of a ReducedSample, the threshold for any
+	// rate can be read from the sorted index for that column without scanning the events.
+	const l1menu::SortedParameterIndex* pSortedIndex=nullptr;
+	const l1menu::ReducedSample* pReducedSample=dynamic_cast<const l1menu::ReducedSample*>( &sample );
+	if( pReducedSample!=nullptr && thresholdScalings.empty() )
+	{
+		const auto parameterIdentifiers=pReducedSample->getTriggerParameterIdentifiers( newTrigger );
+		if( parameterIdentifiers.size()==1 && parameterIdentifiers.begin()->first==mainThreshold )
+		{
+			pSortedIndex=&pReducedSample->sortedParameterIndex( parameterIdentifiers.begin()->second );
+		}
 	}
 
 	//
@@ -257,7 +292,7 @@ void l1menu::MenuFitterPrivateMembers::addBandwidthConstraint( size_t triggerNum
 		// Bundle all of this information in the helper structure I wrote in
 		// the unnamed namespace.
 		//
-		scalableTriggers.push_back( ::TriggerScalingDetails{triggerNumber,fractionOfTotalBandwidth,0,*pPreviouslyCreatedRatePlot,mainThreshold,std::move(thresholdScalings)} );
+		scalableTriggers.push_back( ::TriggerScalingDetails{triggerNumber,fractionOfTotalBandwidth,0,*pPreviouslyCreatedRatePlot,mainThresholdIndex,std::move(thresholdScalings),pSortedIndex} );
 	}
 	else
 	{
@@ -285,7 +320,24 @@ void l1menu::MenuFitterPrivateMembers::addBandwidthConstraint( size_t triggerNum
 		// Bundle all of this information in the helper structure I wrote in
 		// the unnamed namespace.
 		//
-		scalableTriggers.push_back( ::TriggerScalingDetails{triggerNumber,fractionOfTotalBandwidth,0,std::move(ratePlot),mainThreshold,std::move(thresholdScalings)} );
+		scalableTriggers.push_back( ::TriggerScalingDetails{triggerNumber,fractionOfTotalBandwidth,0,std::move(ratePlot),mainThresholdIndex,std::move(thresholdScalings),pSortedIndex} );
 	} // end of else block where pPreviouslyCreatedRatePlot is null
 
 }
+
+float l1menu::MenuFitterPrivateMembers::findThreshold( const ::TriggerScalingDetails& triggerScalingDetails ) const
+{
+	if( triggerScalingDetails.pSortedIndex!=nullptr )
+	{
+		// The rate is the weight passing scaled by the event rate over the total weight, so
+		// convert the bandwidth to the weight that's allowed to pass.
+		const double maximumWeight=double(triggerScalingDetails.currentBandwidth)*sample.sumOfWeights()/sample.eventRate();
+		const float threshold=triggerScalingDetails.pSortedIndex->lowestThresholdForWeight( maximumWeight );
+		// Same sanity check as TriggerRatePlot::findThreshold. Nothing changes below the lowest value
+		// anyway. If the rate can't be got low enough leave it to the plot to decide what to do.
+		if( threshold<0 ) return 0;
+		else if( !std::isinf(threshold) ) return threshold;
+	}
+
+	return triggerScalingDetails.ratePlot.findThreshold( triggerScalingDetails.currentBandwidth );
+}
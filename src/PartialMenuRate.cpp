@@ -0,0 +1,133 @@
+#include "l1menu/PartialMenuRate.h"
+
+#include <vector>
+#include <stdexcept>
+#include <ostream>
+#include "l1menu/ISample.h"
+#include "l1menu/TriggerMenu.h"
+#include "l1menu/IMenuRate.h"
+#include "./implementation/MenuRateImplementation.h"
+#include "./implementation/BinaryStream.h"
+#include "./implementation/ChunkRange.h"
+
+namespace // unnamed namespace
+{
+	typedef l1menu::implementation::MenuRateImplementation::WeightSums WeightSums;
+
+	/// Written at the start of the serialised sums, so that the wrong input is noticed. The number is the format version.
+	const std::string SERIALISED_IDENTIFIER="l1menu::PartialMenuRate 2";
+} // end of the unnamed namespace
+
+namespace l1menu
+{
+	/** @brief Private members for the PartialMenuRate class
+	 */
+	class PartialMenuRatePrivateMembers
+	{
+	public:
+		PartialMenuRatePrivateMembers( const l1menu::TriggerMenu& newMenu ) : menu(newMenu) {}
+		l1menu::TriggerMenu menu;
+		/// The sums for each chunk, in order
+		std::vector<WeightSums> chunkSums;
+		/// Which chunks of the sample chunkSums are for
+		l1menu::implementation::ChunkRange chunkRange;
+	};
+}
+
+size_t l1menu::PartialMenuRate::numberOfChunks( const l1menu::ISample& sample )
+{
+	return l1menu::implementation::MenuRateImplementation::numberOfChunks( sample );
+}
+
+l1menu::PartialMenuRate::PartialMenuRate( const l1menu::TriggerMenu& menu )
+	: pImple_( new PartialMenuRatePrivateMembers(menu) )
+{
+	// No operation besides the initialiser list
+}
+
+l1menu::PartialMenuRate::PartialMenuRate( const l1menu::TriggerMenu& menu, std::istream& input )
+	: pImple_( new PartialMenuRatePrivateMembers(menu) )
+{
+	l1menu::implementation::BinaryInputStream binaryInput( input, SERIALISED_IDENTIFIER );
+	const size_t numberOfTriggers=binaryInput.readInteger();
+	if( numberOfTriggers!=menu.numberOfTriggers() ) throw std::runtime_error( "PartialMenuRate - the serialised sums are for a menu with a different number of triggers" );
+
+	pImple_->chunkRange=l1menu::implementation::ChunkRange( binaryInput );
+	for( size_t chunkNumber=0; chunkNumber<pImple_->chunkRange.size(); ++chunkNumber )
+	{
+		WeightSums sums( numberOfTriggers );
+		binaryInput.readDoubles( sums.weightOfEventsPassed, numberOfTriggers );
+		binaryInput.readDoubles( sums.weightSquaredOfEventsPassed, numberOfTriggers );
+		binaryInput.readDoubles( sums.weightOfEventsPure, numberOfTriggers );
+		binaryInput.readDoubles( sums.weightSquaredOfEventsPure, numberOfTriggers );
+		sums.weightOfEventsPassingAnyTrigger=binaryInput.readDouble();
+		sums.weightSquaredOfEventsPassingAnyTrigger=binaryInput.readDouble();
+		sums.weightOfAllEvents=binaryInput.readDouble();
+		pImple_->chunkSums.push_back( std::move(sums) );
+	}
+}
+
+l1menu::PartialMenuRate::~PartialMenuRate()
+{
+	// No operation. Just need one defined otherwise the default one messes up
+	// the unique_ptr deletion because PartialMenuRatePrivateMembers isn't
+	// defined elsewhere.
+}
+
+void l1menu::PartialMenuRate::addSample( const l1menu::ISample& sample, size_t firstChunk, size_t lastChunk )
+{
+	// Check the chunks carry on from the ones already here before doing any work
+	l1menu::implementation::ChunkRange newChunkRange=pImple_->chunkRange;
+	newChunkRange.append( l1menu::implementation::ChunkRange( firstChunk, lastChunk, numberOfChunks(sample) ) );
+
+	std::vector<WeightSums> newChunkSums=l1menu::implementation::MenuRateImplementation::chunkSums( pImple_->menu, sample, firstChunk, lastChunk );
+	pImple_->chunkRange=newChunkRange;
+	for( auto& sums : newChunkSums ) pImple_->chunkSums.push_back( std::move(sums) );
+}
+
+void l1menu::PartialMenuRate::addSample( const l1menu::ISample& sample )
+{
+	addSample( sample, 0, numberOfChunks(sample) );
+}
+
+void l1menu::PartialMenuRate::merge( const l1menu::PartialMenuRate& otherPartialMenuRate )
+{
+	if( otherPartialMenuRate.pImple_->menu.numberOfTriggers()!=pImple_->menu.numberOfTriggers() ) throw std::runtime_error( "PartialMenuRate::merge - the other sums are for a menu with a different number of triggers" );
+
+	pImple_->chunkRange.append( otherPartialMenuRate.pImple_->chunkRange );
+	pImple_->chunkSums.insert( pImple_->chunkSums.end(), otherPartialMenuRate.pImple_->chunkSums.begin(), otherPartialMenuRate.pImple_->chunkSums.end() );
+}
+
+size_t l1menu::PartialMenuRate::numberOfChunks() const
+{
+	return pImple_->chunkSums.size();
+}
+
+void l1menu::PartialMenuRate::serialise( std::ostream& output ) const
+{
+	l1menu::implementation::BinaryOutputStream binaryOutput( output, SERIALISED_IDENTIFIER );
+	binaryOutput.writeInteger( pImple_->menu.numberOfTriggers() );
+	pImple_->chunkRange.serialise( binaryOutput );
+	for( const auto& sums : pImple_->chunkSums )
+	{
+		binaryOutput.writeDoubles( sums.weightOfEventsPassed );
+		binaryOutput.writeDoubles( sums.weightSquaredOfEventsPassed );
+		binaryOutput.writeDoubles( sums.weightOfEventsPure );
+		binaryOutput.writeDoubles( sums.weightSquaredOfEventsPure );
+		binaryOutput.writeDouble( sums.weightOfEventsPassingAnyTrigger );
+		binaryOutput.writeDouble( sums.weightSquaredOfEventsPassingAnyTrigger );
+		binaryOutput.writeDouble( sums.weightOfAllEvents );
+	}
+	if( !output ) throw std::runtime_error( "PartialMenuRate::serialise - couldn't write to the output" );
+}
+
+std::shared_ptr<const l1menu::IMenuRate> l1menu::PartialMenuRate::rate( float eventRate ) const
+{
+	pImple_->chunkRange.checkComplete( "PartialMenuRate::rate" );
+
+	// Add up in chunk order, the same as MenuRateImplementation does for a whole sample
+	WeightSums sums( pImple_->menu.numberOfTriggers() );
+	for( const auto& chunkSums : pImple_->chunkSums ) sums.add( chunkSums );
+
+	return std::shared_ptr<const l1menu::IMenuRate>( new l1menu::implementation::MenuRateImplementation( pImple_->menu, sums, eventRate ) );
+}
@@ -0,0 +1,182 @@
+#include "l1menu/PartialMenuRatePlots.h"
+
+#include <vector>
+#include <stdexcept>
+#include <ostream>
+#include "l1menu/ISample.h"
+#include "l1menu/MenuRatePlots.h"
+#include "l1menu/TriggerRatePlot.h"
+#include "l1menu/PartialMenuRate.h"
+#include "./implementation/BinaryStream.h"
+#include "./implementation/ChunkRange.h"
+#include <TH1.h>
+
+namespace // unnamed namespace
+{
+	/// Written at the start of the serialised contents, so that the wrong input is noticed. The number is the format version.
+	const std::string SERIALISED_IDENTIFIER="l1menu::PartialMenuRatePlots 4";
+} // end of the unnamed namespace
+
+namespace l1menu
+{
+	/** @brief Private members for the PartialMenuRatePlots class
+	 */
+	class PartialMenuRatePlotsPrivateMembers
+	{
+	public:
+		typedef l1menu::TriggerRatePlot::BinSums BinSums;
+		typedef l1menu::TriggerRatePlot::ChunkContents ChunkContents;
+		PartialMenuRatePlotsPrivateMembers( const l1menu::MenuRatePlots& newRatePlots );
+		/** @brief Throws a std::runtime_error if the plots don't have the same number of bins as numberOfBins. */
+		void checkBinning( const l1menu::MenuRatePlots& otherRatePlots ) const;
+		/** @brief Chunks can only be combined if they're for the same event rate, so throws a std::runtime_error if this is different to any chunks already here. */
+		void setEventRate( double newEventRate );
+
+		const l1menu::MenuRatePlots& ratePlots;
+		std::vector<size_t> numberOfBins; ///< For each plot
+		double eventRate; ///< The rate if every event passed. Only meaningful if there are chunks.
+		/// The bin contents for each plot, not scaled, and the total weight, for each chunk
+		std::vector<ChunkContents> chunkContents;
+		/// Which chunks of the sample chunkContents are for
+		l1menu::implementation::ChunkRange chunkRange;
+	};
+}
+
+l1menu::PartialMenuRatePlotsPrivateMembers::PartialMenuRatePlotsPrivateMembers( const l1menu::MenuRatePlots& newRatePlots )
+	: ratePlots(newRatePlots), eventRate(0)
+{
+	for( const auto& ratePlot : ratePlots.triggerRatePlots() ) numberOfBins.push_back( ratePlot.getPlot()->GetNbinsX() );
+}
+
+void l1menu::PartialMenuRatePlotsPrivateMembers::checkBinning( const l1menu::MenuRatePlots& otherRatePlots ) const
+{
+	const std::vector<l1menu::TriggerRatePlot>& otherPlots=otherRatePlots.triggerRatePlots();
+	if( otherPlots.size()!=numberOfBins.size() ) throw std::runtime_error( "PartialMenuRatePlots - the rate plots are for a different number of triggers" );
+	for( size_t plotNumber=0; plotNumber<otherPlots.size(); ++plotNumber )
+	{
+		if( static_cast<size_t>(otherPlots[plotNumber].getPlot()->GetNbinsX())!=numberOfBins[plotNumber] ) throw std::runtime_error( "PartialMenuRatePlots - the rate plots have different binning" );
+	}
+}
+
+void l1menu::PartialMenuRatePlotsPrivateMembers::setEventRate( double newEventRate )
+{
+	if( !chunkContents.empty() && newEventRate!=eventRate ) throw std::runtime_error( "PartialMenuRatePlots - can't combine chunks for different event rates. Make sure each sample has the same eventRate()." );
+	eventRate=newEventRate;
+}
+
+l1menu::PartialMenuRatePlots::PartialMenuRatePlots( const l1menu::MenuRatePlots& ratePlots )
+	: pImple_( new PartialMenuRatePlotsPrivateMembers(ratePlots) )
+{
+	// No operation besides the initialiser list
+}
+
+l1menu::PartialMenuRatePlots::PartialMenuRatePlots( const l1menu::MenuRatePlots& ratePlots, std::istream& input )
+	: pImple_( new PartialMenuRatePlotsPrivateMembers(ratePlots) )
+{
+	typedef PartialMenuRatePlotsPrivateMembers::BinSums BinSums;
+
+	l1menu::implementation::BinaryInputStream binaryInput( input, SERIALISED_IDENTIFIER );
+	pImple_->eventRate=binaryInput.readDouble();
+
+	const size_t numberOfPlots=binaryInput.readInteger();
+	if( numberOfPlots!=pImple_->numberOfBins.size() ) throw std::runtime_error( "PartialMenuRatePlots - the serialised contents are for a different number of plots" );
+	for( size_t plotNumber=0; plotNumber<numberOfPlots; ++plotNumber )
+	{
+		if( binaryInput.readInteger()!=pImple_->numberOfBins[plotNumber] ) throw std::runtime_error( "PartialMenuRatePlots - the serialised contents are for plots with different binning" );
+	}
+
+	pImple_->chunkRange=l1menu::implementation::ChunkRange( binaryInput );
+	pImple_->chunkContents.resize( pImple_->chunkRange.size() );
+	for( auto& chunk : pImple_->chunkContents )
+	{
+		chunk.sumOfWeights=binaryInput.readDouble();
+		for( const size_t numberOfBins : pImple_->numberOfBins )
+		{
+			BinSums sums( numberOfBins );
+			binaryInput.readDoubles( sums.weights, numberOfBins+1 );
+			binaryInput.readDoubles( sums.weightsSquared, numberOfBins+1 );
+			sums.numberOfFills=binaryInput.readDouble();
+			chunk.plotContents.push_back( std::move(sums) );
+		}
+	}
+}
+
+l1menu::PartialMenuRatePlots::~PartialMenuRatePlots()
+{
+	// No operation. Just need one defined otherwise the default one messes up
+	// the unique_ptr deletion because PartialMenuRatePlotsPrivateMembers isn't
+	// defined elsewhere.
+}
+
+void l1menu::PartialMenuRatePlots::addSample( const l1menu::ISample& sample, size_t firstChunk, size_t lastChunk )
+{
+	pImple_->setEventRate( sample.eventRate() );
+	// Check the chunks carry on from the ones already here before doing any work
+	l1menu::implementation::ChunkRange newChunkRange=pImple_->chunkRange;
+	newChunkRange.append( l1menu::implementation::ChunkRange( firstChunk, lastChunk, l1menu::PartialMenuRate::numberOfChunks(sample) ) );
+
+	std::vector<const l1menu::TriggerRatePlot*> pRatePlots;
+	for( const auto& ratePlot : pImple_->ratePlots.triggerRatePlots() ) pRatePlots.push_back( &ratePlot );
+
+	auto newChunkContents=l1menu::TriggerRatePlot::chunkContents( sample, pRatePlots, firstChunk, lastChunk );
+	pImple_->chunkRange=newChunkRange;
+	for( auto& chunk : newChunkContents ) pImple_->chunkContents.push_back( std::move(chunk) );
+}
+
+void l1menu::PartialMenuRatePlots::merge( const l1menu::PartialMenuRatePlots& otherPartialMenuRatePlots )
+{
+	pImple_->checkBinning( otherPartialMenuRatePlots.pImple_->ratePlots );
+	if( !otherPartialMenuRatePlots.pImple_->chunkContents.empty() ) pImple_->setEventRate( otherPartialMenuRatePlots.pImple_->eventRate );
+	pImple_->chunkRange.append( otherPartialMenuRatePlots.pImple_->chunkRange );
+
+	const auto& otherChunkContents=otherPartialMenuRatePlots.pImple_->chunkContents;
+	pImple_->chunkContents.insert( pImple_->chunkContents.end(), otherChunkContents.begin(), otherChunkContents.end() );
+}
+
+size_t l1menu::PartialMenuRatePlots::numberOfChunks() const
+{
+	return pImple_->chunkContents.size();
+}
+
+void l1menu::PartialMenuRatePlots::serialise( std::ostream& output ) const
+{
+	l1menu::implementation::BinaryOutputStream binaryOutput( output, SERIALISED_IDENTIFIER );
+	binaryOutput.writeDouble( pImple_->eventRate );
+	binaryOutput.writeInteger( pImple_->numberOfBins.size() );
+	for( const size_t numberOfBins : pImple_->numberOfBins ) binaryOutput.writeInteger( numberOfBins );
+
+	pImple_->chunkRange.serialise( binaryOutput );
+	for( const auto& chunk : pImple_->chunkContents )
+	{
+		binaryOutput.writeDouble( chunk.sumOfWeights );
+		for( const auto& sums : chunk.plotContents )
+		{
+			binaryOutput.writeDoubles( sums.weights );
+			binaryOutput.writeDoubles( sums.weightsSquared );
+			binaryOutput.writeDouble( sums.numberOfFills );
+		}
+	}
+	if( !output ) throw std::runtime_error( "PartialMenuRatePlots::serialise - couldn't write to the output" );
+}
+
+void l1menu::PartialMenuRatePlots::addTo( l1menu::MenuRatePlots& ratePlots ) const
+{
+	typedef PartialMenuRatePlotsPrivateMembers::BinSums BinSums;
+	pImple_->checkBinning( ratePlots );
+	pImple_->chunkRange.checkComplete( "PartialMenuRatePlots::addTo" );
+
+	// Combine the chunks in order and scale by the event rate over the total weight, the
+	// same as TriggerRatePlot::addSampleToPlots
+	double sumOfWeights=0;
+	for( const auto& chunk : pImple_->chunkContents ) sumOfWeights+=chunk.sumOfWeights;
+	const double weightPerEvent=( sumOfWeights==0 ? 0 : pImple_->eventRate/sumOfWeights );
+
+	std::vector<l1menu::TriggerRatePlot>& plots=ratePlots.triggerRatePlots();
+	for( size_t plotNumber=0; plotNumber<plots.size(); ++plotNumber )
+	{
+		BinSums contents( pImple_->numberOfBins[plotNumber] );
+		for( const auto& chunk : pImple_->chunkContents ) contents.add( chunk.plotContents[plotNumber] );
+		contents.scale( weightPerEvent );
+		plots[plotNumber].addToBins( contents );
+	}
+}
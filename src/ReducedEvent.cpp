@@ -2,10 +2,10 @@
 
 #include "l1menu/ITrigger.h"
 #include "l1menu/ReducedSample.h"
-#include "protobuf/l1menu.pb.h"
+#include "l1menu/ReducedEventBlock.h"
 
 l1menu::ReducedEvent::ReducedEvent( const l1menu::ReducedSample& sample )
-	: sample_(sample)
+	: pEventBlock_(nullptr), eventInBlock_(0), sample_(sample)
 {
 	// No operation
 }
@@ -17,7 +17,7 @@ l1menu::ReducedEvent::~ReducedEvent()
 
 float l1menu::ReducedEvent::parameterValue( ParameterID parameterNumber ) const
 {
-	return pProtobufEvent_->threshold(parameterNumber);
+	return pEventBlock_->parameterValues(parameterNumber)[eventInBlock_];
 }
 
 bool l1menu::ReducedEvent::passesTrigger( const l1menu::ITrigger& trigger ) const
@@ -35,8 +35,7 @@ bool l1menu::ReducedEvent::passesTrigger( const l1menu::ITrigger& trigger ) cons
 
 float l1menu::ReducedEvent::weight() const
 {
-	if( pProtobufEvent_->has_weight() ) return pProtobufEvent_->weight();
-	else return 1;
+	return pEventBlock_->weights()[eventInBlock_];
 }
 
 const l1menu::ISample& l1menu::ReducedEvent::sample() const
@@ -0,0 +1,133 @@
+#include "l1menu/ReducedEventBlock.h"
+
+#include <mutex>
+
+/** @brief The candidateEvents() lists for each parameter of a block.
+ */
+struct l1menu::ReducedEventBlock::CandidateEventsCache
+{
+	std::mutex mutex;
+	/// Empty until a list is first asked for, then one entry per parameter
+	std::vector< std::unique_ptr< std::vector<uint32_t> > > candidateEvents;
+	/// Set for each parameter once its list has been looked at, whether it was kept or not
+	std::vector<char> hasBeenChecked;
+};
+
+l1menu::ReducedEventBlock::ReducedEventBlock( size_t numberOfParameters )
+	: parameterColumns_( numberOfParameters ), hasExternalColumns_(false), numberOfExternalEvents_(0),
+	  pExternalParameterColumns_(nullptr), pExternalWeights_(nullptr), pCandidateEventsCache_( std::make_shared<CandidateEventsCache>() )
+{
+	// No operation besides the initialiser list
+}
+
+l1menu::ReducedEventBlock::ReducedEventBlock( size_t numberOfParameters, size_t numberOfEvents, const float* pParameterColumns, const float* pWeights )
+	: parameterColumns_( numberOfParameters ), hasExternalColumns_(true), numberOfExternalEvents_(numberOfEvents),
+	  pExternalParameterColumns_(pParameterColumns), pExternalWeights_(pWeights), pCandidateEventsCache_( std::make_shared<CandidateEventsCache>() )
+{
+	// No operation besides the initialiser list
+}
+
+size_t l1menu::ReducedEventBlock::numberOfEvents() const
+{
+	if( hasExternalColumns_ ) return numberOfExternalEvents_;
+	else return weights_.size();
+}
+
+size_t l1menu::ReducedEventBlock::numberOfParameters() const
+{
+	return parameterColumns_.size();
+}
+
+const float* l1menu::ReducedEventBlock::parameterValues( size_t parameterNumber ) const
+{
+	if( hasExternalColumns_ ) return pExternalParameterColumns_+parameterNumber*numberOfExternalEvents_;
+	else return parameterColumns_[parameterNumber].data();
+}
+
+const float* l1menu::ReducedEventBlock::weights() const
+{
+	if( hasExternalColumns_ ) return pExternalWeights_;
+	else return weights_.data();
+}
+
+const std::vector<uint32_t>* l1menu::ReducedEventBlock::candidateEvents( size_t parameterNumber ) const
+{
+	CandidateEventsCache& cache=*pCandidateEventsCache_;
+	std::lock_guard<std::mutex> lock( cache.mutex );
+	if( cache.hasBeenChecked.empty() )
+	{
+		cache.candidateEvents.resize( numberOfParameters() );
+		cache.hasBeenChecked.resize( numberOfParameters(), false );
+	}
+
+	if( !cache.hasBeenChecked[parameterNumber] )
+	{
+		cache.hasBeenChecked[parameterNumber]=true;
+		const float* pValues=parameterValues(parameterNumber);
+		const size_t maximumCandidates=numberOfEvents()/4;
+		std::unique_ptr< std::vector<uint32_t> > pCandidates( new std::vector<uint32_t> );
+		for( size_t eventNumber=0; eventNumber<numberOfEvents(); ++eventNumber )
+		{
+			if( pValues[eventNumber]==-1 ) continue;
+			// Give up as soon as it's clear the list wouldn't be worth using
+			if( pCandidates->size()==maximumCandidates ) return nullptr;
+			pCandidates->push_back( eventNumber );
+		}
+		cache.candidateEvents[parameterNumber]=std::move(pCandidates);
+	}
+
+	return cache.candidateEvents[parameterNumber].get();
+}
+
+void l1menu::ReducedEventBlock::addEvent( const float* pParameterValues, float weight )
+{
+	if( hasExternalColumns_ ) copyExternalColumns();
+	clearCandidateEvents();
+
+	for( size_t parameterNumber=0; parameterNumber<parameterColumns_.size(); ++parameterNumber )
+	{
+		parameterColumns_[parameterNumber].push_back( pParameterValues[parameterNumber] );
+	}
+	weights_.push_back( weight );
+}
+
+void l1menu::ReducedEventBlock::addEvents( const ReducedEventBlock& otherBlock )
+{
+	if( hasExternalColumns_ ) copyExternalColumns();
+	clearCandidateEvents();
+
+	const size_t otherNumberOfEvents=otherBlock.numberOfEvents();
+	for( size_t parameterNumber=0; parameterNumber<parameterColumns_.size(); ++parameterNumber )
+	{
+		const float* pOtherColumn=otherBlock.parameterValues(parameterNumber);
+		parameterColumns_[parameterNumber].insert( parameterColumns_[parameterNumber].end(), pOtherColumn, pOtherColumn+otherNumberOfEvents );
+	}
+	weights_.insert( weights_.end(), otherBlock.weights(), otherBlock.weights()+otherNumberOfEvents );
+}
+
+void l1menu::ReducedEventBlock::copyExternalColumns()
+{
+	for( size_t parameterNumber=0; parameterNumber<parameterColumns_.size(); ++parameterNumber )
+	{
+		const float* pColumn=parameterValues(parameterNumber);
+		parameterColumns_[parameterNumber].assign( pColumn, pColumn+numberOfExternalEvents_ );
+	}
+	weights_.assign( pExternalWeights_, pExternalWeights_+numberOfExternalEvents_ );
+
+	hasExternalColumns_=false;
+	numberOfExternalEvents_=0;
+	pExternalParameterColumns_=nullptr;
+	pExternalWeights_=nullptr;
+}
+
+void l1menu::ReducedEventBlock::clearCandidateEvents()
+{
+	// Other copies of this block might still be using the lists, so start a new cache
+	// rather than clearing this one (there's no cache at all if this block has been moved
+	// from). Nothing has been cached in most cases though, e.g. when adding one event
+	// after another, so don't allocate a new one every time.
+	if( pCandidateEventsCache_==nullptr || pCandidateEventsCache_.use_count()>1 || !pCandidateEventsCache_->hasBeenChecked.empty() )
+	{
+		pCandidateEventsCache_=std::make_shared<CandidateEventsCache>();
+	}
+}
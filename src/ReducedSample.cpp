@@ -6,17 +6,33 @@
 #include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <mutex>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <functional>
 #include "l1menu/ReducedEvent.h"
+#include "l1menu/ReducedEventBlock.h"
+#include "l1menu/SortedParameterIndex.h"
 #include "l1menu/FullSample.h"
 #include "l1menu/TriggerMenu.h"
 #include "l1menu/ITrigger.h"
+#include "l1menu/ITightestThresholds.h"
+#include "l1menu/TriggerTable.h"
 #include "l1menu/ICachedTrigger.h"
 #include "l1menu/L1TriggerDPGEvent.h"
 #include "l1menu/IEvent.h"
+#include "l1menu/IEventCursor.h"
 #include "l1menu/IMenuRate.h"
 #include "l1menu/ITriggerRate.h"
 #include "l1menu/tools/miscellaneous.h"
 #include "./implementation/MenuRateImplementation.h"
+#include "./implementation/TriggerPassBits.h"
+#include "./implementation/EventCursorPool.h"
+#include "./implementation/MappedFile.h"
+#include "./implementation/ChunkedSampleFile.h"
+#include "l1menu/tools/ThreadPool.h"
 #include "protobuf/l1menu.pb.h"
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/io/gzip_stream.h>
@@ -74,16 +90,143 @@ namespace // unnamed namespace
 		std::vector< std::pair<l1menu::ReducedEvent::ParameterID,const float*> > identifiers_;
 	}; // end of class ReducedSampleCachedTrigger
 
-	float sumWeights( const l1menuprotobuf::Run& run )
+	float sumWeights( const l1menu::ReducedEventBlock& eventBlock )
 	{
 		float returnValue=0;
-		for( const auto& event : run.event() )
+		const float* pWeights=eventBlock.weights();
+		for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber ) returnValue+=pWeights[eventNumber];
+		return returnValue;
+	}
+
+	/** @brief The fixed size part of the header of version 2 files.
+	 *
+	 * Version 2 files are uncompressed and laid out so that they can be memory mapped and the
+	 * columns used where they are. In order, there is:
+	 *  - The magic number and the file format version as a varint, the same as version 1.
+	 *  - This structure, starting VERSION2_ALIGNMENT bytes into the file.
+	 *  - The protobuf SampleHeader describing the trigger menu, menuSize bytes long.
+	 *  - A Version2BlockIndexEntry for each block, starting at the next multiple of VERSION2_ALIGNMENT.
+	 *  - The event blocks, each starting at a multiple of VERSION2_ALIGNMENT. Each block is the
+	 *    column of weights followed by each of the parameter columns, all numberOfEvents floats.
+	 * Numbers are written in the byte order of the machine that wrote the file, byteOrderMark
+	 * is there to check that it matches the reading machine.
+	 */
+	struct Version2Header
+	{
+		uint64_t byteOrderMark;
+		uint64_t numberOfParameters;
+		uint64_t numberOfBlocks;
+		uint64_t menuSize;
+		double sumOfWeights;
+	};
+
+	/** @brief Where each event block is in a version 2 file. See Version2Header. */
+	struct Version2BlockIndexEntry
+	{
+		uint64_t offset; ///< Bytes from the start of the file
+		uint64_t numberOfEvents;
+	};
+
+	const size_t VERSION2_ALIGNMENT=64;
+	const uint64_t VERSION2_BYTE_ORDER_MARK=0x0102030405060708;
+
+	const size_t VERSION2_MENU_OFFSET=VERSION2_ALIGNMENT+sizeof(Version2Header);
+
+	/** @brief Rounds the offset up to the next multiple of VERSION2_ALIGNMENT. */
+	size_t alignedOffset( size_t offset )
+	{
+		return (offset+VERSION2_ALIGNMENT-1)/VERSION2_ALIGNMENT*VERSION2_ALIGNMENT;
+	}
+
+	/** @brief Copies the fixed size header out of a mapped version 2 file, and checks that it and the menu fit in the file. */
+	Version2Header readVersion2Header( const l1menu::implementation::MappedFile& mappedFile )
+	{
+		if( mappedFile.size()<VERSION2_MENU_OFFSET ) throw std::runtime_error( "ReducedSample initialise from file - file is too short to hold the version 2 header" );
+		Version2Header header;
+		std::memcpy( &header, mappedFile.data()+VERSION2_ALIGNMENT, sizeof(header) );
+		if( header.byteOrderMark!=VERSION2_BYTE_ORDER_MARK ) throw std::runtime_error( "ReducedSample initialise from file - file was written on a machine with a different byte order" );
+		if( VERSION2_MENU_OFFSET+header.menuSize>mappedFile.size() ) throw std::runtime_error( "ReducedSample initialise from file - file is truncated (trigger menu)" );
+		return header;
+	}
+
+	/** @brief Creates event blocks that point straight into a mapped version 2 file, checking that each one fits in the file. */
+	std::vector<l1menu::ReducedEventBlock> mapVersion2EventBlocks( const l1menu::implementation::MappedFile& mappedFile, const Version2Header& header )
+	{
+		const char* pFileStart=mappedFile.data();
+		const size_t fileSize=mappedFile.size();
+
+		const size_t indexOffset=alignedOffset( VERSION2_MENU_OFFSET+header.menuSize );
+		if( indexOffset+header.numberOfBlocks*sizeof(Version2BlockIndexEntry)>fileSize ) throw std::runtime_error( "ReducedSample initialise from file - file is truncated (block index)" );
+		const Version2BlockIndexEntry* pBlockIndex=reinterpret_cast<const Version2BlockIndexEntry*>( pFileStart+indexOffset );
+
+		std::vector<l1menu::ReducedEventBlock> eventBlocks;
+		for( size_t blockNumber=0; blockNumber<header.numberOfBlocks; ++blockNumber )
 		{
-			if( event.has_weight() ) returnValue+=event.weight();
-			else returnValue+=1;
+			const Version2BlockIndexEntry& indexEntry=pBlockIndex[blockNumber];
+			if( indexEntry.offset%VERSION2_ALIGNMENT!=0 || indexEntry.offset+(header.numberOfParameters+1)*indexEntry.numberOfEvents*sizeof(float)>fileSize )
+			{
+				throw std::runtime_error( "ReducedSample initialise from file - file is truncated or corrupt (event block "+std::to_string(blockNumber)+")" );
+			}
+
+			// The weights come first, followed by each of the parameter columns
+			const float* pWeights=reinterpret_cast<const float*>( pFileStart+indexEntry.offset );
+			eventBlocks.push_back( l1menu::ReducedEventBlock( header.numberOfParameters, indexEntry.numberOfEvents, pWeights+indexEntry.numberOfEvents, pWeights ) );
 		}
-		return returnValue;
+		return eventBlocks;
 	}
+
+	/** @brief Works out the tightest thresholds that a trigger would pass each event with.
+	 *
+	 * Takes a copy of the trigger once, and then just puts the thresholds back to the menu
+	 * values before each event rather than copying the whole trigger again. Each thread
+	 * needs its own instance because the thresholds are changed.
+	 */
+	class TriggerThresholdFinder
+	{
+	public:
+		TriggerThresholdFinder( const l1menu::ITriggerDescription& trigger )
+			: pTrigger_( l1menu::TriggerTable::instance().copyTrigger(trigger) ),
+			  pTightestThresholds_( dynamic_cast<l1menu::ITightestThresholds*>(pTrigger_.get()) )
+		{
+			for( const auto& thresholdName : l1menu::tools::getThresholdNames(*pTrigger_) )
+			{
+				pThresholds_.push_back( &pTrigger_->parameter(thresholdName) );
+				originalThresholds_.push_back( pTrigger_->parameter(thresholdName) );
+			}
+		}
+		/** @brief Appends the tightest thresholds for the event to the vector, or -1 for each if they can't be found. */
+		void addTightestThresholds( const l1menu::L1TriggerDPGEvent& event, std::vector<float>& thresholds )
+		{
+			for( size_t index=0; index<pThresholds_.size(); ++index ) *pThresholds_[index]=originalThresholds_[index];
+
+			// If the trigger can work out the thresholds itself, ask it directly rather than going
+			// through setTriggerThresholdsAsTightAsPossible(), which would throw for every event
+			// that can't pass.
+			if( pTightestThresholds_!=nullptr )
+			{
+				const bool canPass=pTightestThresholds_->setThresholdsAsTightAsPossible( event );
+				for( const auto pThreshold : pThresholds_ ) thresholds.push_back( canPass ? *pThreshold : -1 );
+				return;
+			}
+
+			try
+			{
+				l1menu::tools::setTriggerThresholdsAsTightAsPossible( event, *pTrigger_, 0.001 );
+				for( const auto pThreshold : pThresholds_ ) thresholds.push_back( *pThreshold );
+			}
+			catch( std::exception& error )
+			{
+				// setTriggerThresholdsAsTightAsPossible() couldn't find thresholds so record
+				// -1 for everything.
+				thresholds.insert( thresholds.end(), pThresholds_.size(), -1 );
+			}
+		}
+	private:
+		std::unique_ptr<l1menu::ITrigger> pTrigger_;
+		l1menu::ITightestThresholds* pTightestThresholds_; ///< Null if the trigger doesn't implement ITightestThresholds
+		std::vector<float*> pThresholds_;
+		std::vector<float> originalThresholds_;
+	}; // end of class TriggerThresholdFinder
 }
 
 namespace l1menu
@@ -99,15 +242,50 @@ namespace l1menu
 		l1menu::TriggerMenu mutableTriggerMenu_;
 	public:
 		ReducedSamplePrivateMembers( const l1menu::ReducedSample& thisObject, const l1menu::TriggerMenu& newTriggerMenu );
-		ReducedSamplePrivateMembers( const l1menu::ReducedSample& thisObject, const std::string& filename );
+		/// If loadEvents is false only the trigger menu is read, and the sample has no events
+		ReducedSamplePrivateMembers( const l1menu::ReducedSample& thisObject, const std::string& filename, bool loadEvents );
+		/// Checks the magic number at the start of the file and returns the file format version that follows it
+		static google::protobuf::uint32 readFileFormatVersion( google::protobuf::io::ZeroCopyInputStream& fileInput );
+		/// Reads everything after the file format version from a version 1 (gzipped protobuf) file
+		void loadVersion1( google::protobuf::io::ZeroCopyInputStream& fileInput, bool loadEvents );
+		/// Converts each protobuf Run left in a version 1 file into an event block, and passes it to addBlock
+		void readVersion1Runs( google::protobuf::io::GzipInputStream& gzipInput, google::protobuf::io::CodedInputStream& codedInput, size_t totalBytesLimit, const std::function<void(l1menu::ReducedEventBlock&&)>& addBlock ) const;
+		/// Maps a version 2 file into memory, see Version2Header for the layout
+		void loadVersion2( const std::string& filename, bool loadEvents );
+		/// Decompresses all of the chunks of a version 3 file in parallel, see ChunkIndexEntry for the layout
+		void loadVersion3( const std::string& filename, bool loadEvents );
+		/** Reads the events in the file a few blocks at a time, passing each batch of blocks to processBlocks and then
+		 * throwing them away. The file must have the same trigger menu as this sample. */
+		void streamEventBlocks( const std::string& filename, size_t blocksPerBatch, const std::function<void(const std::vector<l1menu::ReducedEventBlock>&)>& processBlocks ) const;
+		/** Adds numberOfNewEvents events to the end of the sample, split into blocks that are filled in parallel. fillBlock
+		 * is called from the ThreadPool with the range of new events [firstEvent,lastEvent), counting from zero, and adds
+		 * them to the given empty block. */
+		void appendEvents( size_t numberOfNewEvents, const std::function<void(size_t,size_t,l1menu::ReducedEventBlock&)>& fillBlock );
+		void saveVersion1( const std::string& filename ) const;
+		void saveVersion2( const std::string& filename ) const;
+		/// If quantiseThresholds is true, parameters that fit exactly in 16 bit steps are stored that way, see ParameterQuantisation
+		void saveVersion3( const std::string& filename, bool quantiseThresholds ) const;
 		//void copyMenuToProtobufSample();
 		l1menu::ReducedEvent event;
 		const l1menu::TriggerMenu& triggerMenu; // External const access to mutableTriggerMenu_
 		float eventRate;
 		float sumOfWeights;
 		l1menuprotobuf::SampleHeader protobufSampleHeader;
-		// Protobuf doesn't implement move semantics so I'll use pointers
-		std::vector<std::unique_ptr<l1menuprotobuf::Run> > protobufRuns;
+		/// The total number of thresholds recorded for each event, i.e. the number of ParameterIDs
+		size_t numberOfParameters;
+		/// Only set for samples loaded from version 2 files, where the event blocks point into the file
+		std::unique_ptr<l1menu::implementation::MappedFile> pMappedFile;
+		/// Only set for samples loaded from version 3 files. The decompressed chunks that the event blocks point into.
+		std::vector< std::vector<float> > decompressedChunks;
+		/// The events, stored as columns of thresholds. Each block corresponds to a protobuf Run in the file.
+		std::vector<l1menu::ReducedEventBlock> eventBlocks;
+		/// The event number of the first event in each block, so that getEvent() can find the block quickly
+		std::vector<size_t> eventBlockOffsets;
+		/// The total number of events in all blocks. Kept up to date whenever events are added.
+		size_t numberOfEvents;
+		/// Sorted indices for each ParameterID, only created when first asked for. Cleared when events are added.
+		std::vector< std::unique_ptr<l1menu::SortedParameterIndex> > sortedParameterIndices;
+		std::mutex sortedParameterIndicesMutex;
 		const static int EVENTS_PER_RUN;
 		const static char PROTOBUF_MESSAGE_DELIMETER;
 		const static std::string FILE_FORMAT_MAGIC_NUMBER;
@@ -118,8 +296,24 @@ namespace l1menu
 	const std::string ReducedSamplePrivateMembers::FILE_FORMAT_MAGIC_NUMBER="l1menuReducedSample";
 }
 
+/** @brief Event cursor for ReducedSample. Just has its own ReducedEvent that is pointed at the column storage.
+ */
+class l1menu::ReducedSample::EventCursor : public l1menu::IEventCursor
+{
+public:
+	EventCursor( const l1menu::ReducedSample& sample ) : sample_(sample), event_(sample) {}
+	virtual const l1menu::IEvent& getEvent( size_t eventNumber )
+	{
+		sample_.pointEventAt( event_, eventNumber );
+		return event_;
+	}
+private:
+	const l1menu::ReducedSample& sample_;
+	l1menu::ReducedEvent event_;
+}; // end of class l1menu::ReducedSample::EventCursor
+
 l1menu::ReducedSamplePrivateMembers::ReducedSamplePrivateMembers( const l1menu::ReducedSample& thisObject, const l1menu::TriggerMenu& newTriggerMenu )
-	: mutableTriggerMenu_( newTriggerMenu ), event(thisObject), triggerMenu( mutableTriggerMenu_ ), eventRate(1), sumOfWeights(0)
+	: mutableTriggerMenu_( newTriggerMenu ), event(thisObject), triggerMenu( mutableTriggerMenu_ ), eventRate(1), sumOfWeights(0), numberOfParameters(0), numberOfEvents(0)
 {
 	GOOGLE_PROTOBUF_VERIFY_VERSION;
 
@@ -149,46 +343,73 @@ l1menu::ReducedSamplePrivateMembers::ReducedSamplePrivateMembers( const l1menu::
 		// I'm just recording the parameters that refer to the thresholds.
 		const auto thresholdNames=l1menu::tools::getThresholdNames(trigger);
 		for( const auto& thresholdName : thresholdNames ) pProtobufTrigger->add_varying_parameter(thresholdName);
+		numberOfParameters+=thresholdNames.size();
 
 	} // end of loop over triggers
-
-	// Always make sure there is at least one Run ready to be added to
-	std::unique_ptr<l1menuprotobuf::Run> pNewRun( new l1menuprotobuf::Run );
-	protobufRuns.push_back( std::move( pNewRun ) );
-
 }
 
-l1menu::ReducedSamplePrivateMembers::ReducedSamplePrivateMembers( const l1menu::ReducedSample& thisObject, const std::string& filename )
-	: event(thisObject), triggerMenu(mutableTriggerMenu_), eventRate(1), sumOfWeights(0)
+l1menu::ReducedSamplePrivateMembers::ReducedSamplePrivateMembers( const l1menu::ReducedSample& thisObject, const std::string& filename, bool loadEvents )
+	: event(thisObject), triggerMenu(mutableTriggerMenu_), eventRate(1), sumOfWeights(0), numberOfParameters(0), numberOfEvents(0)
 {
 	GOOGLE_PROTOBUF_VERIFY_VERSION;
 
 	// Open the file with read ability
 	int fileDescriptor = open( filename.c_str(), O_RDONLY );
-	if( fileDescriptor==0 ) throw std::runtime_error( "ReducedSample initialise from file - couldn't open file" );
+	if( fileDescriptor<0 ) throw std::runtime_error( "ReducedSample initialise from file - couldn't open file" );
 	::UnixFileSentry fileSentry( fileDescriptor ); // Use this as an exception safe way of closing the input file
 	google::protobuf::io::FileInputStream fileInput( fileDescriptor );
 
-	// First read the magic number at the start of the file and make sure it
-	// matches what I expect. This is uncompressed so I'll wrap it in a block
-	// to make sure the CodedInputStream is destructed before creating a new
-	// one with gzip input.
-	{
-		google::protobuf::io::CodedInputStream codedInput( &fileInput );
-
-		// As a read buffer, I'll create a string the correct size (filled with an arbitrary
-		// character) and read straight into that.
-		std::string readMagicNumber;
-		if( !codedInput.ReadString( &readMagicNumber, FILE_FORMAT_MAGIC_NUMBER.size() ) ) throw std::runtime_error( "ReducedSample initialise from file - error reading magic number" );
-		if( readMagicNumber!=FILE_FORMAT_MAGIC_NUMBER ) throw std::runtime_error( "ReducedSample - tried to initialise with a file that is not the correct format" );
-
-		google::protobuf::uint32 fileformatVersion;
-		if( !codedInput.ReadVarint32( &fileformatVersion ) ) throw std::runtime_error( "ReducedSample initialise from file - error reading file format version" );
-		// So far I only have (and ever expect to have) one version of the file
-		// format, imaginatively versioned "1". You never know though...
-		if( fileformatVersion>1 ) std::cerr << "Warning: Attempting to read a ReducedSample with version " << fileformatVersion << " with code that only knows up to version 1." << std::endl;
+	google::protobuf::uint32 fileformatVersion=readFileFormatVersion( fileInput );
+
+	if( fileformatVersion<=1 ) loadVersion1( fileInput, loadEvents );
+	else if( fileformatVersion==2 ) loadVersion2( filename, loadEvents );
+	else if( fileformatVersion==3 ) loadVersion3( filename, loadEvents );
+	else throw std::runtime_error( "ReducedSample initialise from file - file format version "+std::to_string(fileformatVersion)+" is newer than this code knows how to read" );
+
+	// I have all of the information in the protobuf members, but I also need the trigger information
+	// in the form of l1menu::TriggerMenu. Copy out the required information.
+	for( int triggerNumber=0; triggerNumber<protobufSampleHeader.trigger_size(); ++triggerNumber )
+	{
+		const l1menuprotobuf::Trigger& inputTrigger=protobufSampleHeader.trigger(triggerNumber);
+
+		mutableTriggerMenu_.addTrigger( inputTrigger.name(), inputTrigger.version() );
+		// Get a reference to the trigger I just created
+		l1menu::ITrigger& trigger=mutableTriggerMenu_.getTrigger(triggerNumber);
+
+		// Run through all of the parameters and set them to what they were
+		// when the sample was made.
+		for( int parameterNumber=0; parameterNumber<inputTrigger.parameter_size(); ++parameterNumber )
+		{
+			const auto& inputParameter=inputTrigger.parameter(parameterNumber);
+			trigger.parameter(inputParameter.name())=inputParameter.value();
+		}
+
+		// I should probably check the threshold names exist. I'll do it another time.
 	}
 
+}
+
+google::protobuf::uint32 l1menu::ReducedSamplePrivateMembers::readFileFormatVersion( google::protobuf::io::ZeroCopyInputStream& fileInput )
+{
+	// First read the magic number at the start of the file and make sure it
+	// matches what I expect. This is uncompressed so the CodedInputStream has
+	// to be destructed before the caller creates a new one with gzip input,
+	// which happens when this function returns.
+	google::protobuf::io::CodedInputStream codedInput( &fileInput );
+
+	// As a read buffer, I'll create a string the correct size (filled with an arbitrary
+	// character) and read straight into that.
+	std::string readMagicNumber;
+	if( !codedInput.ReadString( &readMagicNumber, FILE_FORMAT_MAGIC_NUMBER.size() ) ) throw std::runtime_error( "ReducedSample initialise from file - error reading magic number" );
+	if( readMagicNumber!=FILE_FORMAT_MAGIC_NUMBER ) throw std::runtime_error( "ReducedSample - tried to initialise with a file that is not the correct format" );
+
+	google::protobuf::uint32 fileformatVersion;
+	if( !codedInput.ReadVarint32( &fileformatVersion ) ) throw std::runtime_error( "ReducedSample initialise from file - error reading file format version" );
+	return fileformatVersion;
+}
+
+void l1menu::ReducedSamplePrivateMembers::loadVersion1( google::protobuf::io::ZeroCopyInputStream& fileInput, bool loadEvents )
+{
 	google::protobuf::io::GzipInputStream gzipInput( &fileInput );
 	google::protobuf::io::CodedInputStream codedInput( &gzipInput );
 
@@ -206,10 +427,31 @@ l1menu::ReducedSamplePrivateMembers::ReducedSamplePrivateMembers( const l1menu::
 	if( !protobufSampleHeader.ParseFromCodedStream( &codedInput ) ) throw std::runtime_error( "ReducedSample initialise from file - some unknown error while reading header" );
 	codedInput.PopLimit(readLimit);
 
+	for( const auto& protobufTrigger : protobufSampleHeader.trigger() ) numberOfParameters+=protobufTrigger.varying_parameter_size();
+	if( !loadEvents ) return;
+
+	readVersion1Runs( gzipInput, codedInput, totalBytesLimit, [this]( l1menu::ReducedEventBlock&& newBlock )
+	{
+		eventBlockOffsets.push_back( numberOfEvents );
+		numberOfEvents+=newBlock.numberOfEvents();
+		eventBlocks.push_back( std::move(newBlock) );
+	} );
+
+	// Count up the sum of the weights of all events
+	for( const auto& eventBlock : eventBlocks )
+	{
+		sumOfWeights+=sumWeights( eventBlock );
+	}
+}
+
+void l1menu::ReducedSamplePrivateMembers::readVersion1Runs( google::protobuf::io::GzipInputStream& gzipInput, google::protobuf::io::CodedInputStream& codedInput, size_t totalBytesLimit, const std::function<void(l1menu::ReducedEventBlock&&)>& addBlock ) const
+{
+	google::protobuf::uint64 messageSize;
+
 	// Keep looping until there is nothing more to be read from the file.
 	while( codedInput.ReadVarint64( &messageSize ) )
 	{
-		readLimit=codedInput.PushLimit(messageSize);
+		google::protobuf::io::CodedInputStream::Limit readLimit=codedInput.PushLimit(messageSize);
 
 		// Make sure the CodedInputStream doesn't refuse to read the message because it's
 		// read too much already. I'll also add an arbitrary 50 on to always make sure
@@ -219,49 +461,156 @@ l1menu::ReducedSamplePrivateMembers::ReducedSamplePrivateMembers( const l1menu::
 			totalBytesLimit+=messageSize*5; // Might as well set it a little higher than necessary while I'm at it.
 			codedInput.SetTotalBytesLimit( totalBytesLimit, -1 );
 		}
-		std::unique_ptr<l1menuprotobuf::Run> pNewRun( new l1menuprotobuf::Run );
-		if( !pNewRun->ParseFromCodedStream( &codedInput ) ) throw std::runtime_error( "ReducedSample initialise from file - some unknown error while reading run" );
-		protobufRuns.push_back( std::move( pNewRun ) );
+		l1menuprotobuf::Run protobufRun;
+		if( !protobufRun.ParseFromCodedStream( &codedInput ) ) throw std::runtime_error( "ReducedSample initialise from file - some unknown error while reading run" );
+
+		// Copy the run into column storage. The protobuf version isn't kept because
+		// it's far too slow to loop over.
+		l1menu::ReducedEventBlock newBlock( numberOfParameters );
+		for( const auto& protobufEvent : protobufRun.event() )
+		{
+			if( static_cast<size_t>(protobufEvent.threshold_size())!=numberOfParameters ) throw std::runtime_error( "ReducedSample initialise from file - an event has the wrong number of thresholds for the menu in the header" );
+			newBlock.addEvent( protobufEvent.threshold().data(), protobufEvent.has_weight() ? protobufEvent.weight() : 1 );
+		}
+		addBlock( std::move(newBlock) );
 
 		codedInput.PopLimit(readLimit);
 	}
+}
 
+void l1menu::ReducedSamplePrivateMembers::loadVersion2( const std::string& filename, bool loadEvents )
+{
+	// Map the whole file. The event blocks point straight into the mapping rather than
+	// copying anything, so nothing is actually read until it's used.
+	pMappedFile.reset( new l1menu::implementation::MappedFile( filename ) );
+	const ::Version2Header header=::readVersion2Header( *pMappedFile );
 
-	// Always make sure there is at least one Run ready to be added to. Later
-	// code assumes there is already a run there.
-	if( protobufRuns.empty() )
+	if( !protobufSampleHeader.ParseFromArray( pMappedFile->data()+VERSION2_MENU_OFFSET, header.menuSize ) ) throw std::runtime_error( "ReducedSample initialise from file - some unknown error while reading header" );
+
+	for( const auto& protobufTrigger : protobufSampleHeader.trigger() ) numberOfParameters+=protobufTrigger.varying_parameter_size();
+	if( numberOfParameters!=header.numberOfParameters ) throw std::runtime_error( "ReducedSample initialise from file - the number of parameters doesn't match the menu in the header" );
+	if( !loadEvents )
 	{
-		std::unique_ptr<l1menuprotobuf::Run> pNewRun( new l1menuprotobuf::Run );
-		protobufRuns.push_back( std::move( pNewRun ) );
+		pMappedFile.reset();
+		return;
 	}
 
-	// Count up the sum of the weights of all events
-	for( const auto& pRun : protobufRuns )
+	eventBlocks=::mapVersion2EventBlocks( *pMappedFile, header );
+	for( const auto& eventBlock : eventBlocks )
 	{
-		sumOfWeights+=sumWeights( *pRun );
+		eventBlockOffsets.push_back( numberOfEvents );
+		numberOfEvents+=eventBlock.numberOfEvents();
 	}
 
-	// I have all of the information in the protobuf members, but I also need the trigger information
-	// in the form of l1menu::TriggerMenu. Copy out the required information.
-	for( int triggerNumber=0; triggerNumber<protobufSampleHeader.trigger_size(); ++triggerNumber )
+	// Stored so that the weights don't all have to be read in to add them up
+	sumOfWeights=header.sumOfWeights;
+}
+
+void l1menu::ReducedSamplePrivateMembers::loadVersion3( const std::string& filename, bool loadEvents )
+{
+	l1menu::implementation::ChunkedSampleFileReader reader( filename );
+
+	if( !protobufSampleHeader.ParseFromString( reader.serialisedMenu() ) ) throw std::runtime_error( "ReducedSample initialise from file - some unknown error while reading header" );
+	for( const auto& protobufTrigger : protobufSampleHeader.trigger() ) numberOfParameters+=protobufTrigger.varying_parameter_size();
+	if( numberOfParameters!=reader.numberOfParameters() ) throw std::runtime_error( "ReducedSample initialise from file - the number of parameters doesn't match the menu in the header" );
+	if( !loadEvents ) return;
+
+	// Each chunk was compressed on its own, so they can all be decompressed at the same time.
+	// The event blocks then just point at the decompressed columns rather than copying them.
+	decompressedChunks.resize( reader.numberOfChunks() );
+	l1menu::tools::ThreadPool::instance().run( reader.numberOfChunks(), [&]( size_t chunkNumber )
 	{
-		const l1menuprotobuf::Trigger& inputTrigger=protobufSampleHeader.trigger(triggerNumber);
+		reader.readChunk( chunkNumber, decompressedChunks[chunkNumber] );
+	} );
 
-		mutableTriggerMenu_.addTrigger( inputTrigger.name(), inputTrigger.version() );
-		// Get a reference to the trigger I just created
-		l1menu::ITrigger& trigger=mutableTriggerMenu_.getTrigger(triggerNumber);
+	for( size_t chunkNumber=0; chunkNumber<reader.numberOfChunks(); ++chunkNumber )
+	{
+		const size_t chunkNumberOfEvents=reader.chunkNumberOfEvents(chunkNumber);
+		const float* pWeights=decompressedChunks[chunkNumber].data();
+		eventBlockOffsets.push_back( numberOfEvents );
+		numberOfEvents+=chunkNumberOfEvents;
+		eventBlocks.push_back( l1menu::ReducedEventBlock( numberOfParameters, chunkNumberOfEvents, pWeights+chunkNumberOfEvents, pWeights ) );
+	}
 
-		// Run through all of the parameters and set them to what they were
-		// when the sample was made.
-		for( int parameterNumber=0; parameterNumber<inputTrigger.parameter_size(); ++parameterNumber )
+	sumOfWeights=reader.sumOfWeights();
+}
+
+void l1menu::ReducedSamplePrivateMembers::streamEventBlocks( const std::string& filename, size_t blocksPerBatch, const std::function<void(const std::vector<l1menu::ReducedEventBlock>&)>& processBlocks ) const
+{
+	int fileDescriptor = open( filename.c_str(), O_RDONLY );
+	if( fileDescriptor<0 ) throw std::runtime_error( "ReducedSample read events from file - couldn't open file" );
+	::UnixFileSentry fileSentry( fileDescriptor ); // Use this as an exception safe way of closing the input file
+	google::protobuf::io::FileInputStream fileInput( fileDescriptor );
+
+	google::protobuf::uint32 fileformatVersion=readFileFormatVersion( fileInput );
+	std::vector<l1menu::ReducedEventBlock> batch;
+
+	if( fileformatVersion<=1 )
+	{
+		google::protobuf::io::GzipInputStream gzipInput( &fileInput );
+		google::protobuf::io::CodedInputStream codedInput( &gzipInput );
+		size_t totalBytesLimit=67108864;
+		codedInput.SetTotalBytesLimit( totalBytesLimit, -1 );
+
+		// The menu has already been read, so skip over the header
+		google::protobuf::uint64 messageSize;
+		if( !codedInput.ReadVarint64( &messageSize ) || !codedInput.Skip(messageSize) ) throw std::runtime_error( "ReducedSample read events from file - error skipping the header" );
+
+		readVersion1Runs( gzipInput, codedInput, totalBytesLimit, [&]( l1menu::ReducedEventBlock&& newBlock )
 		{
-			const auto& inputParameter=inputTrigger.parameter(parameterNumber);
-			trigger.parameter(inputParameter.name())=inputParameter.value();
-		}
+			batch.push_back( std::move(newBlock) );
+			if( batch.size()<blocksPerBatch ) return;
+			processBlocks( batch );
+			batch.clear();
+		} );
+		if( !batch.empty() ) processBlocks( batch );
+	}
+	else if( fileformatVersion==2 )
+	{
+		l1menu::implementation::MappedFile mappedFile( filename );
+		const ::Version2Header header=::readVersion2Header( mappedFile );
+		if( header.numberOfParameters!=numberOfParameters ) throw std::runtime_error( "ReducedSample read events from file - the number of parameters doesn't match the menu in the header" );
+		const std::vector<l1menu::ReducedEventBlock> allBlocks=::mapVersion2EventBlocks( mappedFile, header );
 
-		// I should probably check the threshold names exist. I'll do it another time.
+		for( size_t firstBlock=0; firstBlock<allBlocks.size(); firstBlock+=blocksPerBatch )
+		{
+			batch.assign( allBlocks.begin()+firstBlock, allBlocks.begin()+std::min( firstBlock+blocksPerBatch, allBlocks.size() ) );
+			processBlocks( batch );
+
+			// The blocks aren't needed again, so stop the pages they were read into building up
+			for( const auto& block : batch )
+			{
+				const size_t offset=reinterpret_cast<const char*>(block.weights())-mappedFile.data();
+				mappedFile.releaseMemory( offset, (numberOfParameters+1)*block.numberOfEvents()*sizeof(float) );
+			}
+		}
 	}
+	else if( fileformatVersion==3 )
+	{
+		l1menu::implementation::ChunkedSampleFileReader reader( filename );
+		if( reader.numberOfParameters()!=numberOfParameters ) throw std::runtime_error( "ReducedSample read events from file - the number of parameters doesn't match the menu in the header" );
 
+		// Only one batch of chunks is decompressed at a time. The buffers are reused for each batch.
+		std::vector< std::vector<float> > chunks( blocksPerBatch );
+		for( size_t firstChunk=0; firstChunk<reader.numberOfChunks(); firstChunk+=blocksPerBatch )
+		{
+			const size_t chunksInBatch=std::min( blocksPerBatch, reader.numberOfChunks()-firstChunk );
+			l1menu::tools::ThreadPool::instance().run( chunksInBatch, [&]( size_t chunkInBatch )
+			{
+				reader.readChunk( firstChunk+chunkInBatch, chunks[chunkInBatch] );
+			} );
+
+			batch.clear();
+			for( size_t chunkInBatch=0; chunkInBatch<chunksInBatch; ++chunkInBatch )
+			{
+				const size_t chunkNumberOfEvents=reader.chunkNumberOfEvents(firstChunk+chunkInBatch);
+				const float* pWeights=chunks[chunkInBatch].data();
+				batch.push_back( l1menu::ReducedEventBlock( numberOfParameters, chunkNumberOfEvents, pWeights+chunkNumberOfEvents, pWeights ) );
+			}
+			processBlocks( batch );
+		}
+	}
+	else throw std::runtime_error( "ReducedSample read events from file - file format version "+std::to_string(fileformatVersion)+" is newer than this code knows how to read" );
 }
 
 l1menu::ReducedSample::ReducedSample( const l1menu::FullSample& originalSample, const l1menu::TriggerMenu& triggerMenu )
@@ -278,7 +627,13 @@ l1menu::ReducedSample::ReducedSample( const l1menu::TriggerMenu& triggerMenu )
 }
 
 l1menu::ReducedSample::ReducedSample( const std::string& filename )
-	: pImple_( new l1menu::ReducedSamplePrivateMembers( *this, filename ) )
+	: pImple_( new l1menu::ReducedSamplePrivateMembers( *this, filename, true ) )
+{
+	// No operation except the initialiser list
+}
+
+l1menu::ReducedSample::ReducedSample( const std::string& filename, bool loadEvents )
+	: pImple_( new l1menu::ReducedSamplePrivateMembers( *this, filename, loadEvents ) )
 {
 	// No operation except the initialiser list
 }
@@ -292,60 +647,176 @@ l1menu::ReducedSample::~ReducedSample()
 
 void l1menu::ReducedSample::addSample( const l1menu::FullSample& originalSample )
 {
-	l1menuprotobuf::Run* pCurrentRun=pImple_->protobufRuns.back().get();
+	l1menu::implementation::EventCursorPool cursorPool( originalSample );
 
-	for( size_t eventNumber=0; eventNumber<originalSample.numberOfEvents(); ++eventNumber )
+	pImple_->appendEvents( originalSample.numberOfEvents(), [&]( size_t firstEvent, size_t lastEvent, l1menu::ReducedEventBlock& newBlock )
 	{
-		if(eventNumber%100==0)  std::cout<<"Event Number..." << eventNumber << "\r" << std::flush; 
-		// Split the events up into groups in arbitrary numbers. This is to get around
-		// a protobuf aversion to long messages.
-		if( pCurrentRun->event_size() >= pImple_->EVENTS_PER_RUN )
+		l1menu::implementation::EventCursorPool::Sentry cursorSentry( cursorPool );
+		std::vector<TriggerThresholdFinder> thresholdFinders;
+		for( size_t triggerNumber=0; triggerNumber<pImple_->triggerMenu.numberOfTriggers(); ++triggerNumber )
 		{
-			// Gone over the arbitrary limit, so create a new protobuf Run and start
-			// using that instead.
-			std::unique_ptr<l1menuprotobuf::Run> pNewRun( new l1menuprotobuf::Run );
-			pImple_->protobufRuns.push_back( std::move( pNewRun ) );
-			pCurrentRun=pImple_->protobufRuns.back().get();
+			thresholdFinders.push_back( TriggerThresholdFinder( pImple_->triggerMenu.getTrigger(triggerNumber) ) );
 		}
 
-		const l1menu::L1TriggerDPGEvent& event=originalSample.getFullEvent( eventNumber );
-		l1menuprotobuf::Event* pProtobufEvent=pCurrentRun->add_event();
-		if( event.weight()!=1 ) pProtobufEvent->set_weight( event.weight() );
+		// Buffer to hold the thresholds for the current event before they're copied into the columns
+		std::vector<float> eventThresholds;
+		eventThresholds.reserve( pImple_->numberOfParameters );
 
-		// Loop over all of the triggers
-		for( size_t triggerNumber=0; triggerNumber<pImple_->triggerMenu.numberOfTriggers(); ++triggerNumber )
+		for( size_t eventNumber=firstEvent; eventNumber<lastEvent; ++eventNumber )
 		{
-			std::unique_ptr<l1menu::ITrigger> pTrigger=pImple_->triggerMenu.getTriggerCopy(triggerNumber);
-			std::vector<std::string> thresholdNames=l1menu::tools::getThresholdNames(*pTrigger);
+			// Not happy using a static_cast, but the cursor from a FullSample always returns
+			// an L1TriggerDPGEvent and this is called for every event.
+			const l1menu::L1TriggerDPGEvent& event=static_cast<const l1menu::L1TriggerDPGEvent&>( cursorSentry.cursor().getEvent(eventNumber) );
+			eventThresholds.clear();
+			for( auto& thresholdFinder : thresholdFinders ) thresholdFinder.addTightestThresholds( event, eventThresholds );
+			newBlock.addEvent( eventThresholds.data(), event.weight() );
+		} // end of loop over events
+	} );
+}
 
-			try
+void l1menu::ReducedSample::addSample( const l1menu::ReducedSample& otherSample )
+{
+	addSample( otherSample, 0, otherSample.numberOfEvents() );
+}
+
+void l1menu::ReducedSample::addSample( const l1menu::ReducedSample& otherSample, size_t firstEvent, size_t lastEvent )
+{
+	if( &otherSample==this ) throw std::logic_error( "ReducedSample::addSample - can't add a sample to itself" );
+	if( firstEvent>lastEvent || lastEvent>otherSample.numberOfEvents() ) throw std::runtime_error( "ReducedSample::addSample - the range of events to add isn't inside the other sample" );
+
+	// Work out which of the other sample's columns each of this sample's parameters comes from. The
+	// other menu can be in a different order or have extra triggers, but it has to have every trigger
+	// in this menu with the same non threshold parameters, otherwise the thresholds would mean
+	// something different.
+	std::vector<l1menu::ReducedEvent::ParameterID> sourceColumns( pImple_->numberOfParameters );
+	for( size_t triggerNumber=0; triggerNumber<pImple_->triggerMenu.numberOfTriggers(); ++triggerNumber )
+	{
+		const l1menu::ITrigger& trigger=pImple_->triggerMenu.getTrigger(triggerNumber);
+		if( !otherSample.containsTrigger( trigger ) ) throw std::runtime_error( "ReducedSample::addSample - the other sample wasn't made with "+trigger.name()+", or was made with different non threshold parameters for it" );
+
+		const auto otherIdentifiers=otherSample.getTriggerParameterIdentifiers( trigger );
+		for( const auto& identifier : getTriggerParameterIdentifiers( trigger ) ) sourceColumns[identifier.second]=otherIdentifiers.at( identifier.first );
+	}
+
+	const std::vector<size_t>& otherOffsets=otherSample.pImple_->eventBlockOffsets;
+	const std::vector<l1menu::ReducedEventBlock>& otherBlocks=otherSample.pImple_->eventBlocks;
+
+	pImple_->appendEvents( lastEvent-firstEvent, [&]( size_t firstNewEvent, size_t lastNewEvent, l1menu::ReducedEventBlock& newBlock )
+	{
+		std::vector<float> eventValues( sourceColumns.size() );
+		// The last block that starts at or before the first event
+		size_t blockNumber=std::upper_bound( otherOffsets.begin(), otherOffsets.end(), firstEvent+firstNewEvent )-otherOffsets.begin()-1;
+
+		for( size_t eventNumber=firstEvent+firstNewEvent; eventNumber<firstEvent+lastNewEvent; ++eventNumber )
+		{
+			while( eventNumber>=otherOffsets[blockNumber]+otherBlocks[blockNumber].numberOfEvents() ) ++blockNumber;
+			const l1menu::ReducedEventBlock& otherBlock=otherBlocks[blockNumber];
+			const size_t eventInBlock=eventNumber-otherOffsets[blockNumber];
+
+			for( size_t parameterNumber=0; parameterNumber<sourceColumns.size(); ++parameterNumber )
 			{
-				l1menu::tools::setTriggerThresholdsAsTightAsPossible( event, *pTrigger, 0.001 );
-				// Set all of the parameters to match the thresholds in the trigger
-				for( const auto& thresholdName : thresholdNames )
-				{
-					pProtobufEvent->add_threshold( pTrigger->parameter(thresholdName) );
-				}
+				eventValues[parameterNumber]=otherBlock.parameterValues( sourceColumns[parameterNumber] )[eventInBlock];
 			}
-			catch( std::exception& error )
-			{
-				// setTriggerThresholdsAsTightAsPossible() couldn't find thresholds so record
-				// -1 for everything.
-				// Range based for loop gives me a warning because I don't use the thresholdName.
-				for( size_t index=0; index<thresholdNames.size(); ++index ) pProtobufEvent->add_threshold(-1);
-			} // end of try block that sets the trigger thresholds
+			newBlock.addEvent( eventValues.data(), otherBlock.weights()[eventInBlock] );
+		}
+	} );
+}
+
+void l1menu::ReducedSamplePrivateMembers::appendEvents( size_t numberOfNewEvents, const std::function<void(size_t,size_t,l1menu::ReducedEventBlock&)>& fillBlock )
+{
+	// Any sorted indices will be out of date once events are added
+	{ // Block to limit the scope of the lock
+		std::lock_guard<std::mutex> lock( sortedParameterIndicesMutex );
+		sortedParameterIndices.clear();
+	}
+
+	//
+	// The events are split up into blocks of EVENTS_PER_RUN (to get around a protobuf aversion to
+	// long messages when the blocks are saved as Runs). Each block is a task for the thread pool,
+	// and the blocks are then appended in order, so the result is the same however many threads
+	// are used. If the last block already here isn't full, the first task makes the events to top
+	// it up. This also means that adding samples one after the other always gives the same blocks
+	// as adding all of the events in one go.
+	//
+	const size_t eventsPerRun=EVENTS_PER_RUN;
+	size_t eventsInFirstTask=eventsPerRun;
+	if( !eventBlocks.empty() && eventBlocks.back().numberOfEvents()<eventsPerRun )
+	{
+		eventsInFirstTask=eventsPerRun-eventBlocks.back().numberOfEvents();
+	}
+
+	size_t numberOfTasks=0;
+	if( numberOfNewEvents>0 ) numberOfTasks=1+(std::max(numberOfNewEvents,eventsInFirstTask)-eventsInFirstTask+eventsPerRun-1)/eventsPerRun;
 
-		} // end of loop over triggers
+	std::vector<l1menu::ReducedEventBlock> newBlocks( numberOfTasks, l1menu::ReducedEventBlock(numberOfParameters) );
+	std::mutex outputMutex;
+	size_t numberOfTasksFinished=0;
 
-		pImple_->sumOfWeights+=event.weight();
-	} // end of loop over events
+	l1menu::tools::ThreadPool::instance().run( numberOfTasks, [&]( size_t taskNumber )
+	{
+		size_t firstEvent=0;
+		if( taskNumber>0 ) firstEvent=eventsInFirstTask+(taskNumber-1)*eventsPerRun;
+		const size_t lastEvent=std::min( numberOfNewEvents, (taskNumber==0 ? eventsInFirstTask : firstEvent+eventsPerRun) );
+
+		fillBlock( firstEvent, lastEvent, newBlocks[taskNumber] );
+
+		std::lock_guard<std::mutex> lock( outputMutex );
+		++numberOfTasksFinished;
+		std::cout << "Finished block " << numberOfTasksFinished << " of " << numberOfTasks << "\r" << std::flush;
+	} );
+	if( numberOfTasks>0 ) std::cout << std::endl;
+
+	//
+	// Now add the new events in order
+	//
+	for( size_t taskNumber=0; taskNumber<newBlocks.size(); ++taskNumber )
+	{
+		const l1menu::ReducedEventBlock& newBlock=newBlocks[taskNumber];
+		if( taskNumber==0 && !eventBlocks.empty() && eventBlocks.back().numberOfEvents()<eventsPerRun )
+		{
+			eventBlocks.back().addEvents( newBlock );
+		}
+		else
+		{
+			eventBlocks.push_back( newBlock );
+			eventBlockOffsets.push_back( numberOfEvents );
+		}
+		numberOfEvents+=newBlock.numberOfEvents();
+
+		// Add the weights one at a time, in the same order they'd be added if done serially
+		const float* pWeights=newBlock.weights();
+		for( size_t eventNumber=0; eventNumber<newBlock.numberOfEvents(); ++eventNumber ) sumOfWeights+=pWeights[eventNumber];
+	}
+}
+
+void l1menu::ReducedSample::saveToFile( const std::string& filename, unsigned int fileFormatVersion, bool quantiseThresholds ) const
+{
+	if( fileFormatVersion<1 || fileFormatVersion>3 ) throw std::runtime_error( "ReducedSample::saveToFile - can't write file format version "+std::to_string(fileFormatVersion) );
+	if( quantiseThresholds && fileFormatVersion!=3 ) throw std::runtime_error( "ReducedSample::saveToFile - thresholds can only be quantised in file format version 3" );
+
+	// Write to a temporary file and then move it into place. If this sample was loaded from a
+	// version 2 file with the same name, the events are mapped from that file and overwriting
+	// it in place would pull them out from underneath me.
+	const std::string temporaryFilename=filename+".partial";
+	try
+	{
+		if( fileFormatVersion==1 ) pImple_->saveVersion1( temporaryFilename );
+		else if( fileFormatVersion==2 ) pImple_->saveVersion2( temporaryFilename );
+		else pImple_->saveVersion3( temporaryFilename, quantiseThresholds );
+	}
+	catch( ... )
+	{
+		std::remove( temporaryFilename.c_str() );
+		throw;
+	}
+	if( std::rename( temporaryFilename.c_str(), filename.c_str() )!=0 ) throw std::runtime_error( "ReducedSample::saveToFile - couldn't move the temporary file to \""+filename+"\"" );
 }
 
-void l1menu::ReducedSample::saveToFile( const std::string& filename ) const
+void l1menu::ReducedSamplePrivateMembers::saveVersion1( const std::string& filename ) const
 {
-	// Open the file. Parameters are filename, write ability and create, rw-r--r-- permissions.
-	int fileDescriptor = open( filename.c_str(), O_WRONLY | O_CREAT, 0644 );
-	if( fileDescriptor==0 ) throw std::runtime_error( "ReducedSample save to file - couldn't open file" );
+	// Open the file. Parameters are filename, write ability, create and truncate, rw-r--r-- permissions.
+	int fileDescriptor = open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	if( fileDescriptor<0 ) throw std::runtime_error( "ReducedSample save to file - couldn't open file" );
 	::UnixFileSentry fileSentry( fileDescriptor ); // Use this as an exception safe way of closing the output file
 
 	// Setup the protobuf file handlers
@@ -357,10 +828,8 @@ void l1menu::ReducedSample::saveToFile( const std::string& filename ) const
 		google::protobuf::io::CodedOutputStream codedOutput( &fileOutput );
 
 		// Write a magic number at the start of all files
-		codedOutput.WriteString( pImple_->FILE_FORMAT_MAGIC_NUMBER );
-		// Write an integer that specifies what version of the file format I'm using. I
-		// have no intention of changing the format but I might as well keep the option
-		// open.
+		codedOutput.WriteString( FILE_FORMAT_MAGIC_NUMBER );
+		// Write an integer that specifies what version of the file format I'm using.
 		codedOutput.WriteVarint32( 1 );
 	}
 
@@ -368,24 +837,177 @@ void l1menu::ReducedSample::saveToFile( const std::string& filename ) const
 	google::protobuf::io::CodedOutputStream codedOutput( &gzipOutput );
 
 	// Write the size of the header message into the file...
-	codedOutput.WriteVarint64( pImple_->protobufSampleHeader.ByteSize() );
+	codedOutput.WriteVarint64( protobufSampleHeader.ByteSize() );
 	// ...and then write the header
-	pImple_->protobufSampleHeader.SerializeToCodedStream( &codedOutput );
+	protobufSampleHeader.SerializeToCodedStream( &codedOutput );
 
-	// Now go through each of the runs and do the same for those
-	for( const auto& pRun : pImple_->protobufRuns )
+	// Now go through each of the blocks, convert to a protobuf Run and do the same
+	// for those. Only one Run is held at a time so that memory use stays down.
+	for( const auto& eventBlock : eventBlocks )
 	{
-		codedOutput.WriteVarint64( pRun->ByteSize() );
-		pRun->SerializeToCodedStream( &codedOutput );
+		l1menuprotobuf::Run protobufRun;
+		const float* pWeights=eventBlock.weights();
+		for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber )
+		{
+			l1menuprotobuf::Event* pProtobufEvent=protobufRun.add_event();
+			if( pWeights[eventNumber]!=1 ) pProtobufEvent->set_weight( pWeights[eventNumber] );
+			for( size_t parameterNumber=0; parameterNumber<eventBlock.numberOfParameters(); ++parameterNumber )
+			{
+				pProtobufEvent->add_threshold( eventBlock.parameterValues(parameterNumber)[eventNumber] );
+			}
+		}
+
+		codedOutput.WriteVarint64( protobufRun.ByteSize() );
+		protobufRun.SerializeToCodedStream( &codedOutput );
 	}
 
 }
 
+void l1menu::ReducedSamplePrivateMembers::saveVersion2( const std::string& filename ) const
+{
+	std::string serialisedMenu;
+	if( !protobufSampleHeader.SerializeToString( &serialisedMenu ) ) throw std::runtime_error( "ReducedSample save to file - couldn't serialise the trigger menu" );
+
+	::Version2Header header{ VERSION2_BYTE_ORDER_MARK, numberOfParameters, eventBlocks.size(), serialisedMenu.size(), sumOfWeights };
+
+	// Work out where everything goes before writing anything, because the block index
+	// is written before the blocks.
+	const size_t menuOffset=VERSION2_ALIGNMENT+sizeof(::Version2Header);
+	const size_t indexOffset=::alignedOffset( menuOffset+serialisedMenu.size() );
+	std::vector< ::Version2BlockIndexEntry > blockIndex;
+	size_t nextOffset=::alignedOffset( indexOffset+eventBlocks.size()*sizeof(::Version2BlockIndexEntry) );
+	for( const auto& eventBlock : eventBlocks )
+	{
+		blockIndex.push_back( ::Version2BlockIndexEntry{ nextOffset, eventBlock.numberOfEvents() } );
+		nextOffset=::alignedOffset( nextOffset+(numberOfParameters+1)*eventBlock.numberOfEvents()*sizeof(float) );
+	}
+
+	std::ofstream outputFile( filename, std::ios::binary );
+	if( !outputFile.is_open() ) throw std::runtime_error( "ReducedSample save to file - couldn't open file" );
+	// Pads with zeros up to the given offset
+	auto padTo=[&outputFile]( size_t offset ){ while( static_cast<size_t>(outputFile.tellp())<offset ) outputFile.put(0); };
+
+	// The magic number and version are the same as the start of a version 1 file. A varint
+	// of 2 is just the single byte 2.
+	outputFile.write( FILE_FORMAT_MAGIC_NUMBER.data(), FILE_FORMAT_MAGIC_NUMBER.size() );
+	outputFile.put( 2 );
+
+	padTo( VERSION2_ALIGNMENT );
+	outputFile.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+	outputFile.write( serialisedMenu.data(), serialisedMenu.size() );
+
+	padTo( indexOffset );
+	outputFile.write( reinterpret_cast<const char*>(blockIndex.data()), blockIndex.size()*sizeof(::Version2BlockIndexEntry) );
+
+	for( size_t blockNumber=0; blockNumber<eventBlocks.size(); ++blockNumber )
+	{
+		const l1menu::ReducedEventBlock& eventBlock=eventBlocks[blockNumber];
+		const size_t columnSize=eventBlock.numberOfEvents()*sizeof(float);
+
+		padTo( blockIndex[blockNumber].offset );
+		outputFile.write( reinterpret_cast<const char*>(eventBlock.weights()), columnSize );
+		for( size_t parameterNumber=0; parameterNumber<numberOfParameters; ++parameterNumber )
+		{
+			outputFile.write( reinterpret_cast<const char*>(eventBlock.parameterValues(parameterNumber)), columnSize );
+		}
+	}
+
+	outputFile.close();
+	if( !outputFile ) throw std::runtime_error( "ReducedSample save to file - error while writing the file" );
+}
+
+void l1menu::ReducedSamplePrivateMembers::saveVersion3( const std::string& filename, bool quantiseThresholds ) const
+{
+	std::string serialisedMenu;
+	if( !protobufSampleHeader.SerializeToString( &serialisedMenu ) ) throw std::runtime_error( "ReducedSample save to file - couldn't serialise the trigger menu" );
+
+	// The magic number and version are the same as the start of a version 1 file. A varint
+	// of 3 is just the single byte 3. Each event block becomes one compressed chunk.
+	std::vector<l1menu::implementation::ParameterQuantisation> quantisations;
+	if( quantiseThresholds ) quantisations=l1menu::implementation::findParameterQuantisations( eventBlocks, numberOfParameters );
+	l1menu::implementation::ChunkedSampleFileWriter writer( filename, FILE_FORMAT_MAGIC_NUMBER+char(3), numberOfParameters, quantisations );
+	writer.addChunks( eventBlocks );
+	writer.close( serialisedMenu, sumOfWeights );
+}
+
 size_t l1menu::ReducedSample::numberOfEvents() const
 {
-	size_t numberOfEvents=0;
-	for( const auto& pRun : pImple_->protobufRuns ) numberOfEvents+=pRun->event_size();
-	return numberOfEvents;
+	return pImple_->numberOfEvents;
+}
+
+size_t l1menu::ReducedSample::numberOfEventBlocks() const
+{
+	return pImple_->eventBlocks.size();
+}
+
+const l1menu::ReducedEventBlock& l1menu::ReducedSample::eventBlock( size_t blockNumber ) const
+{
+	return pImple_->eventBlocks[blockNumber];
+}
+
+const l1menu::SortedParameterIndex& l1menu::ReducedSample::sortedParameterIndex( ReducedEvent::ParameterID parameter ) const
+{
+	if( parameter>=pImple_->numberOfParameters ) throw std::runtime_error( "ReducedSample::sortedParameterIndex was asked for an invalid ParameterID" );
+
+	// Holding the lock while the index is built means other threads asking for a
+	// different parameter have to wait, but it's simple and only happens once.
+	std::lock_guard<std::mutex> lock( pImple_->sortedParameterIndicesMutex );
+	if( pImple_->sortedParameterIndices.size()!=pImple_->numberOfParameters ) pImple_->sortedParameterIndices.resize( pImple_->numberOfParameters );
+
+	std::unique_ptr<l1menu::SortedParameterIndex>& pIndex=pImple_->sortedParameterIndices[parameter];
+	if( !pIndex ) pIndex.reset( new l1menu::SortedParameterIndex( *this, parameter ) );
+	return *pIndex;
+}
+
+std::vector< std::vector<float> > l1menu::ReducedSample::triggerOverlapFractions( const l1menu::TriggerMenu& menu ) const
+{
+	typedef l1menu::implementation::TriggerPassBits TriggerPassBits;
+	const size_t numberOfTriggers=menu.numberOfTriggers();
+	const auto triggerThresholds=TriggerPassBits::triggerThresholds( menu, *this );
+
+	// Only the upper triangle (including the diagonal) is calculated, stored as a flat
+	// array for each block. Blocks are added together in order afterwards so that the
+	// result doesn't depend on the number of threads.
+	const size_t numberOfPairs=numberOfTriggers*(numberOfTriggers+1)/2;
+	std::vector< std::vector<double> > blockOverlaps( pImple_->eventBlocks.size(), std::vector<double>(numberOfPairs,0) );
+	std::vector<double> blockTotals( pImple_->eventBlocks.size(), 0 );
+	l1menu::tools::ThreadPool::instance().run( pImple_->eventBlocks.size(), [&]( size_t blockNumber )
+	{
+		const l1menu::ReducedEventBlock& block=pImple_->eventBlocks[blockNumber];
+		TriggerPassBits passBits( triggerThresholds, block );
+		std::vector<double>& overlaps=blockOverlaps[blockNumber];
+		double unusedSumOfSquares=0;
+		size_t pairNumber=0;
+		for( size_t triggerNumber=0; triggerNumber<numberOfTriggers; ++triggerNumber )
+		{
+			for( size_t otherTriggerNumber=triggerNumber; otherTriggerNumber<numberOfTriggers; ++otherTriggerNumber, ++pairNumber )
+			{
+				passBits.sumWeightsOfBoth( passBits.triggerBits(triggerNumber), passBits.triggerBits(otherTriggerNumber), overlaps[pairNumber], unusedSumOfSquares );
+			}
+		}
+		for( size_t eventNumber=0; eventNumber<block.numberOfEvents(); ++eventNumber ) blockTotals[blockNumber]+=block.weights()[eventNumber];
+	} );
+
+	std::vector<double> overlaps( numberOfPairs, 0 );
+	double totalWeight=0;
+	for( size_t blockNumber=0; blockNumber<blockOverlaps.size(); ++blockNumber )
+	{
+		for( size_t pairNumber=0; pairNumber<numberOfPairs; ++pairNumber ) overlaps[pairNumber]+=blockOverlaps[blockNumber][pairNumber];
+		totalWeight+=blockTotals[blockNumber];
+	}
+
+	std::vector< std::vector<float> > returnValue( numberOfTriggers, std::vector<float>(numberOfTriggers,0) );
+	if( totalWeight==0 ) return returnValue;
+	size_t pairNumber=0;
+	for( size_t triggerNumber=0; triggerNumber<numberOfTriggers; ++triggerNumber )
+	{
+		for( size_t otherTriggerNumber=triggerNumber; otherTriggerNumber<numberOfTriggers; ++otherTriggerNumber, ++pairNumber )
+		{
+			returnValue[triggerNumber][otherTriggerNumber]=overlaps[pairNumber]/totalWeight;
+			returnValue[otherTriggerNumber][triggerNumber]=returnValue[triggerNumber][otherTriggerNumber];
+		}
+	}
+	return returnValue;
 }
 
 const l1menu::TriggerMenu& l1menu::ReducedSample::getTriggerMenu() const
@@ -493,21 +1115,31 @@ const std::map<std::string,size_t> l1menu::ReducedSample::getTriggerParameterIde
 
 const l1menu::IEvent& l1menu::ReducedSample::getEvent( size_t eventNumber ) const
 {
-	for( const auto& pRun : pImple_->protobufRuns )
+	pointEventAt( pImple_->event, eventNumber );
+	return pImple_->event;
+}
+
+std::unique_ptr<l1menu::IEventCursor> l1menu::ReducedSample::createEventCursor() const
+{
+	return std::unique_ptr<l1menu::IEventCursor>( new EventCursor(*this) );
+}
+
+void l1menu::ReducedSample::pointEventAt( l1menu::ReducedEvent& event, size_t eventNumber ) const
+{
+	if( eventNumber>=pImple_->numberOfEvents ) throw std::runtime_error( "ReducedSample::getEvent(eventNumber) was asked for an invalid eventNumber" );
+
+	// Blocks are almost always full, so first guess that the event is where it would be if
+	// they all were. Only if that's wrong fall back to a binary search on the block offsets
+	// for the last block that starts at or before the requested event.
+	const std::vector<size_t>& offsets=pImple_->eventBlockOffsets;
+	size_t blockNumber=eventNumber/pImple_->EVENTS_PER_RUN;
+	if( blockNumber>=offsets.size() || offsets[blockNumber]>eventNumber || ( blockNumber+1<offsets.size() && offsets[blockNumber+1]<=eventNumber ) )
 	{
-		if( eventNumber<static_cast<size_t>(pRun->event_size()) )
-		{
-			pImple_->event.pProtobufEvent_=pRun->mutable_event(eventNumber);
-			return pImple_->event;
-		}
-		// Event must be in a later run, so reduce the number by how many events
-		// were in this run and look again.
-		eventNumber-=pRun->event_size();
+		blockNumber=std::upper_bound( offsets.begin(), offsets.end(), eventNumber )-offsets.begin()-1;
 	}
 
-	// Should always find the event before getting to this point, so throw an
-	// exception if this happens.
-	throw std::runtime_error( "ReducedSample::getEvent(eventNumber) was asked for an invalid eventNumber" );
+	event.pEventBlock_=&pImple_->eventBlocks[blockNumber];
+	event.eventInBlock_=eventNumber-offsets[blockNumber];
 }
 
 std::unique_ptr<l1menu::ICachedTrigger> l1menu::ReducedSample::createCachedTrigger( const l1menu::ITrigger& trigger ) const
@@ -541,3 +1173,29 @@ std::shared_ptr<const l1menu::IMenuRate> l1menu::ReducedSample::rate( const l1me
 	// TODO make sure the TriggerMenu is valid for this sample
 	return std::shared_ptr<const l1menu::IMenuRate>( new l1menu::implementation::MenuRateImplementation( menu, *this, ratePlots ) );
 }
+
+std::shared_ptr<const l1menu::IMenuRate> l1menu::ReducedSample::rateFromFile( const std::string& filename, const l1menu::TriggerMenu& menu, float eventRate )
+{
+	typedef l1menu::implementation::MenuRateImplementation MenuRateImplementation;
+
+	// Only the trigger menu is read to begin with, which is enough to work out
+	// which columns each trigger needs.
+	const l1menu::ReducedSample menuOnlySample( filename, false );
+	const auto triggerThresholds=l1menu::implementation::TriggerPassBits::triggerThresholds( menu, menuOnlySample );
+
+	// Each batch of blocks is spread over the threads, and the partial sums added in block
+	// order. This is the same order rate() adds them in, so the result is identical.
+	l1menu::tools::ThreadPool& threadPool=l1menu::tools::ThreadPool::instance();
+	MenuRateImplementation::WeightSums sums( menu.numberOfTriggers() );
+	menuOnlySample.pImple_->streamEventBlocks( filename, 2*threadPool.numberOfThreads(), [&]( const std::vector<l1menu::ReducedEventBlock>& blocks )
+	{
+		std::vector<MenuRateImplementation::WeightSums> blockSums( blocks.size(), MenuRateImplementation::WeightSums(menu.numberOfTriggers()) );
+		threadPool.run( blocks.size(), [&]( size_t blockNumber )
+		{
+			MenuRateImplementation::addEventBlock( blockSums[blockNumber], triggerThresholds, blocks[blockNumber] );
+		} );
+		for( const auto& blockSum : blockSums ) sums.add( blockSum );
+	} );
+
+	return std::shared_ptr<const l1menu::IMenuRate>( new MenuRateImplementation( menu, sums, eventRate ) );
+}
@@ -0,0 +1,152 @@
+#include "l1menu/SortedParameterIndex.h"
+
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+#include "l1menu/ReducedSample.h"
+#include "l1menu/ReducedEventBlock.h"
+#include "l1menu/tools/ThreadPool.h"
+
+namespace // Use the unnamed namespace for things only used in this file
+{
+	/** @brief Maps floats onto unsigned integers in the same order, so that bisection can be done over every float in between two. */
+	uint32_t orderedKey( float value )
+	{
+		uint32_t bits;
+		std::memcpy( &bits, &value, sizeof(bits) );
+		if( bits & 0x80000000u ) return ~bits;
+		else return bits | 0x80000000u;
+	}
+
+	/** @brief The inverse of orderedKey. */
+	float fromOrderedKey( uint32_t key )
+	{
+		uint32_t bits;
+		if( key & 0x80000000u ) bits=key & ~0x80000000u;
+		else bits=~key;
+		float value;
+		std::memcpy( &value, &bits, sizeof(value) );
+		return value;
+	}
+} // end of the unnamed namespace
+
+l1menu::SortedParameterIndex::SortedParameterIndex( const l1menu::ReducedSample& sample, l1menu::ReducedEvent::ParameterID parameter )
+	: chunks_( sample.numberOfEventBlocks() )
+{
+	// Each block is sorted independently, so they can be done at the same time.
+	l1menu::tools::ThreadPool::instance().run( chunks_.size(), [&]( size_t blockNumber )
+	{
+		const l1menu::ReducedEventBlock& eventBlock=sample.eventBlock(blockNumber);
+		const float* pValues=eventBlock.parameterValues( parameter );
+		const float* pWeights=eventBlock.weights();
+		Chunk& chunk=chunks_[blockNumber];
+
+		// NaN can't be sorted, but it never fails a "value < threshold" test so
+		// events with NaN pass every threshold. Just add their weights to everything.
+		double nanWeight=0;
+		double nanWeightSquared=0;
+		chunk.numberOfNanEvents=0;
+
+		std::vector< std::pair<float,float> > valueWeightPairs;
+		valueWeightPairs.reserve( eventBlock.numberOfEvents() );
+		for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber )
+		{
+			if( std::isnan(pValues[eventNumber]) )
+			{
+				nanWeight+=pWeights[eventNumber];
+				nanWeightSquared+=double(pWeights[eventNumber])*pWeights[eventNumber];
+				++chunk.numberOfNanEvents;
+			}
+			else valueWeightPairs.push_back( std::make_pair( pValues[eventNumber], pWeights[eventNumber] ) );
+		}
+		std::sort( valueWeightPairs.begin(), valueWeightPairs.end() );
+
+		chunk.sortedValues.resize( valueWeightPairs.size() );
+		chunk.weightsFromPosition.resize( valueWeightPairs.size()+1 );
+		chunk.weightsSquaredFromPosition.resize( valueWeightPairs.size()+1 );
+		chunk.weightsFromPosition.back()=nanWeight;
+		chunk.weightsSquaredFromPosition.back()=nanWeightSquared;
+		for( size_t position=valueWeightPairs.size(); position>0; --position )
+		{
+			const double weight=valueWeightPairs[position-1].second;
+			chunk.sortedValues[position-1]=valueWeightPairs[position-1].first;
+			chunk.weightsFromPosition[position-1]=chunk.weightsFromPosition[position]+weight;
+			chunk.weightsSquaredFromPosition[position-1]=chunk.weightsSquaredFromPosition[position]+weight*weight;
+		}
+	} );
+}
+
+size_t l1menu::SortedParameterIndex::Chunk::firstPassingPosition( float threshold ) const
+{
+	// lower_bound gives the first value that is not less than the threshold, which is exactly the
+	// pass condition. If the threshold is NaN nothing is less than it so everything passes, same
+	// as a direct comparison would give.
+	return std::lower_bound( sortedValues.begin(), sortedValues.end(), threshold )-sortedValues.begin();
+}
+
+size_t l1menu::SortedParameterIndex::numberOfChunks() const
+{
+	return chunks_.size();
+}
+
+double l1menu::SortedParameterIndex::chunkWeightPassing( size_t chunkNumber, float threshold ) const
+{
+	const Chunk& chunk=chunks_[chunkNumber];
+	return chunk.weightsFromPosition[chunk.firstPassingPosition(threshold)];
+}
+
+double l1menu::SortedParameterIndex::chunkWeightSquaredPassing( size_t chunkNumber, float threshold ) const
+{
+	const Chunk& chunk=chunks_[chunkNumber];
+	return chunk.weightsSquaredFromPosition[chunk.firstPassingPosition(threshold)];
+}
+
+size_t l1menu::SortedParameterIndex::chunkNumberPassing( size_t chunkNumber, float threshold ) const
+{
+	const Chunk& chunk=chunks_[chunkNumber];
+	return chunk.sortedValues.size()-chunk.firstPassingPosition(threshold)+chunk.numberOfNanEvents;
+}
+
+double l1menu::SortedParameterIndex::weightPassing( float threshold ) const
+{
+	double weight=0;
+	for( size_t chunkNumber=0; chunkNumber<chunks_.size(); ++chunkNumber ) weight+=chunkWeightPassing( chunkNumber, threshold );
+	return weight;
+}
+
+double l1menu::SortedParameterIndex::weightSquaredPassing( float threshold ) const
+{
+	double weightSquared=0;
+	for( size_t chunkNumber=0; chunkNumber<chunks_.size(); ++chunkNumber ) weightSquared+=chunkWeightSquaredPassing( chunkNumber, threshold );
+	return weightSquared;
+}
+
+size_t l1menu::SortedParameterIndex::numberPassing( float threshold ) const
+{
+	size_t number=0;
+	for( size_t chunkNumber=0; chunkNumber<chunks_.size(); ++chunkNumber ) number+=chunkNumberPassing( chunkNumber, threshold );
+	return number;
+}
+
+float l1menu::SortedParameterIndex::lowestThresholdForWeight( double maximumWeight ) const
+{
+	const float infinity=std::numeric_limits<float>::infinity();
+	if( weightPassing(-infinity)<=maximumWeight ) return -infinity;
+	if( weightPassing(infinity)>maximumWeight ) return infinity;
+
+	// The weight only ever goes down as the threshold goes up, since the sum for each chunk
+	// does and they're always added in the same order. So bisect between a threshold that's
+	// known to be too low and one that's known to be high enough.
+	uint32_t lowKey=orderedKey(-infinity);
+	uint32_t highKey=orderedKey(infinity);
+	while( highKey-lowKey>1 )
+	{
+		const uint32_t middleKey=lowKey+(highKey-lowKey)/2;
+		if( weightPassing( fromOrderedKey(middleKey) )<=maximumWeight ) highKey=middleKey;
+		else lowKey=middleKey;
+	}
+	return fromOrderedKey(highKey);
+}
@@ -4,15 +4,37 @@
 #include "l1menu/ICachedTrigger.h"
 #include "l1menu/L1TriggerDPGEvent.h"
 #include "l1menu/IEvent.h"
+#include "l1menu/IEventCursor.h"
 #include "l1menu/ISample.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/ReducedEventBlock.h"
+#include "l1menu/SortedParameterIndex.h"
 #include "l1menu/TriggerTable.h"
 #include "l1menu/tools/miscellaneous.h"
 #include "l1menu/tools/stringManipulation.h"
+#include "l1menu/tools/ThreadPool.h"
+#include "implementation/EventCursorPool.h"
+#include "implementation/MenuRateImplementation.h"
 #include <TH1F.h>
 #include <sstream>
 #include <algorithm>
 #include <stdexcept>
 
+namespace // Use the unnamed namespace for things only used in this file
+{
+	/** @brief The total weight of the events in the block, added up in order so that it's always exactly the same. */
+	double blockSumOfWeights( const l1menu::ReducedEventBlock& eventBlock )
+	{
+		double sumOfWeights=0;
+		const float* pWeights=eventBlock.weights();
+		for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber ) sumOfWeights+=pWeights[eventNumber];
+		return sumOfWeights;
+	}
+
+	/// How many chunks per thread addSampleToPlots() works out at a time. Enough to keep the threads busy without keeping the contents of the whole sample.
+	const size_t CHUNKS_PER_THREAD_IN_BATCH=4;
+} // end of the unnamed namespace
+
 l1menu::TriggerRatePlot::TriggerRatePlot( const l1menu::ITriggerDescription& trigger, std::unique_ptr<TH1> pHistogram, const std::string& versusParameter, const std::vector<std::string> scaledParameters )
 	: pHistogram_( std::move(pHistogram) ), versusParameter_(versusParameter), histogramOwnedByMe_(true)
 {
@@ -210,31 +232,52 @@ void l1menu::TriggerRatePlot::addEvent( const l1menu::IEvent& event )
 	float weightPerEvent=sample.eventRate()/sample.sumOfWeights();
 
 	// For some implementations of ISample, it is significantly faster to
-	// create ICachedTriggers and then loop over those. The addEvent overload
-	// I'm about to delegate to loops over the histogram bins, so even for
-	// one event this trigger can be called multiple times.
-	std::unique_ptr<l1menu::ICachedTrigger> pCachedTrigger=sample.createCachedTrigger( *pTrigger_ );
+	// create ICachedTriggers and then loop over those. The bisection loops
+	// over the histogram bins, so even for one event this trigger can be
+	// called multiple times.
+	TriggerCopy trigger=copyTrigger( sample );
+	const size_t highestBin=highestPassingBin( event, trigger );
 
-	addEvent( event, pCachedTrigger, weightPerEvent );
+	//
+	// Now I know which bins need filling, loop over them and fill.
+	//
+	for( size_t binNumber=1; binNumber<=highestBin; ++binNumber )
+	{
+		pHistogram_->Fill( pHistogram_->GetBinCenter(binNumber), event.weight()*weightPerEvent );
+	}
 }
 
 void l1menu::TriggerRatePlot::addSample( const l1menu::ISample& sample )
 {
-	float weightPerEvent=sample.eventRate()/sample.sumOfWeights();
-
-	// Create a cached trigger, which depending on the concrete type of the ISample
-	// may or may not significantly increase the speed at which this next loop happens.
-	std::unique_ptr<l1menu::ICachedTrigger> pCachedTrigger=sample.createCachedTrigger( *pTrigger_ );
+	addSampleToPlots( sample, std::vector<TriggerRatePlot*>( 1, this ) );
+}
 
-	for( size_t eventNumber=0; eventNumber<sample.numberOfEvents(); ++eventNumber )
+l1menu::TriggerRatePlot::TriggerCopy l1menu::TriggerRatePlot::copyTrigger( const l1menu::ISample& sample ) const
+{
+	TriggerCopy trigger;
+	trigger.pTrigger=l1menu::TriggerTable::instance().copyTrigger( *pTrigger_ );
+	trigger.pParameter=&trigger.pTrigger->parameter(versusParameter_);
+	for( size_t index=0; index<otherScaledParameters_.size(); ++index )
 	{
-		addEvent( sample.getEvent(eventNumber), pCachedTrigger, weightPerEvent );
-	} // end of loop over events
-
+		trigger.otherParameterScalings.push_back( std::make_pair( &trigger.pTrigger->parameter(otherScaledParameters_[index]), otherParameterScalings_[index].second ) );
+	}
+	trigger.pCachedTrigger=sample.createCachedTrigger( *trigger.pTrigger );
+	return trigger;
 }
 
-void l1menu::TriggerRatePlot::addEvent( const l1menu::IEvent& event, const std::unique_ptr<l1menu::ICachedTrigger>& pCachedTrigger, float weightPerEvent )
+size_t l1menu::TriggerRatePlot::highestPassingBin( const l1menu::IEvent& event, TriggerCopy& trigger ) const
 {
+	// Sets the versus parameter to the low edge of the given bin and checks if the event passes.
+	// Any other parameters that should be scaled are scaled accordingly. Remember that in
+	// parameterScalingPair, 'first' is a pointer to the threshold to be changed and 'second'
+	// is the ratio of the main threshold it should be.
+	auto passes=[&]( size_t binNumber )->bool
+	{
+		(*trigger.pParameter)=pHistogram_->GetBinLowEdge(binNumber);
+		for( const auto& parameterScalingPair : trigger.otherParameterScalings ) *(parameterScalingPair.first)=parameterScalingPair.second*(*trigger.pParameter);
+		return trigger.pCachedTrigger->apply(event);
+	};
+
 	//
 	// Use bisection to find the bin that passes the trigger and the one
 	// immediately after it that fails.
@@ -246,43 +289,236 @@ void l1menu::TriggerRatePlot::addEvent( const l1menu::IEvent& event, const std::
 	// First need to perform a check that the first bin passes. If it doesn't then
 	// the histogram doesn't need filling at all and I can return.
 	//
-	(*pParameter_)=pHistogram_->GetBinLowEdge(lowBin);
-	// Scale accordingly any other parameters that should be scaled. Remember that
-	// in parameterScalingPair, 'first' is a pointer to the threshold to be changed
-	// and 'second' is the ratio of the first threshold it should be.
-	for( const auto& parameterScalingPair : otherParameterScalings_ ) *(parameterScalingPair.first)=parameterScalingPair.second*(*pParameter_);
-	if( !pCachedTrigger->apply(event) ) return;
+	if( !passes(lowBin) ) return 0;
 
 	//
 	// Also check the highest bin. If that passes then I just fill every bin,
 	// otherwise I need to find the point at which the trigger fails.
 	//
-	(*pParameter_)=pHistogram_->GetBinLowEdge(highBin);
-	for( const auto& parameterScalingPair : otherParameterScalings_ ) *(parameterScalingPair.first)=parameterScalingPair.second*(*pParameter_);
+	if( passes(highBin) ) return highBin;
 
-	if( pCachedTrigger->apply(event) ) lowBin=highBin;
-	else
+	while( highBin-lowBin>1 ) // Loop until I find two bins next to each other
+	{
+		size_t middleBin=(highBin+lowBin)/2;
+		if( passes(middleBin) ) lowBin=middleBin;
+		else highBin=middleBin;
+	}
+
+	return lowBin;
+}
+
+l1menu::TriggerRatePlot::ReducedSampleColumns l1menu::TriggerRatePlot::reducedSampleColumns( const l1menu::ReducedSample& sample ) const
+{
+	//
+	// This does exactly the same as the addEvent bisection above, but rather than setting
+	// the trigger parameters and asking the cached trigger whether the event passes, the
+	// thresholds are compared to the columns directly. First figure out which columns are
+	// needed and how the threshold for each one depends on the bin being tested.
+	//
+	ReducedSampleColumns columns;
+
+	for( const auto& identifier : sample.getTriggerParameterIdentifiers(*pTrigger_) )
 	{
-		while( highBin-lowBin>1 ) // Loop until I find two bins next to each other
+		float* pParameter=&pTrigger_->parameter(identifier.first);
+		if( pParameter==pParameter_ )
+		{
+			columns.scaledColumns.push_back( std::make_pair( identifier.second, 1.0f ) );
+			continue;
+		}
+
+		bool isScaled=false;
+		for( const auto& parameterScalingPair : otherParameterScalings_ )
 		{
-			size_t middleBin=(highBin+lowBin)/2;
+			if( parameterScalingPair.first==pParameter )
+			{
+				columns.scaledColumns.push_back( std::make_pair( identifier.second, parameterScalingPair.second ) );
+				isScaled=true;
+				break;
+			}
+		}
+		if( !isScaled ) columns.fixedColumns.push_back( std::make_pair( identifier.second, *pParameter ) );
+	}
 
-			(*pParameter_)=pHistogram_->GetBinLowEdge(middleBin);
-			for( const auto& parameterScalingPair : otherParameterScalings_ ) *(parameterScalingPair.first)=parameterScalingPair.second*(*pParameter_);
+	// The parameter values are floats, so the bin edges need to be converted in the same
+	// way they would be when setting the parameter.
+	const size_t numberOfBins=pHistogram_->GetNbinsX();
+	columns.binLowEdges.resize( numberOfBins+1 );
+	for( size_t binNumber=1; binNumber<=numberOfBins; ++binNumber ) columns.binLowEdges[binNumber]=pHistogram_->GetBinLowEdge(binNumber);
 
-			if( pCachedTrigger->apply(event) ) lowBin=middleBin;
-			else highBin=middleBin;
+	return columns;
+}
+
+std::vector<l1menu::TriggerRatePlot::BinSums> l1menu::TriggerRatePlot::reducedSampleBlockContents( const l1menu::ReducedSample& sample, const ReducedSampleColumns& columns, size_t firstBlock, size_t lastBlock ) const
+{
+	const auto& scaledColumns=columns.scaledColumns;
+	const auto& fixedColumns=columns.fixedColumns;
+	const auto& binLowEdges=columns.binLowEdges;
+	const size_t numberOfBins=pHistogram_->GetNbinsX();
+
+	// Pointers to the start of each column in the current block, in the same order as above
+	std::vector<const float*> scaledValues( scaledColumns.size() );
+	std::vector<const float*> fixedValues( fixedColumns.size() );
+
+	// Events the trigger can never pass have -1 in every column. If one of the columns has a
+	// threshold above that in the first bin, any event with -1 there doesn't fill the histogram
+	// at all, so only the candidateEvents() for that column need looking at. Either way exactly
+	// the same events are counted.
+	l1menu::ReducedEvent::ParameterID candidatesColumn=0;
+	bool useCandidateEvents=false;
+	for( const auto& columnThresholdPair : fixedColumns )
+	{
+		if( columnThresholdPair.second>-1 )
+		{
+			candidatesColumn=columnThresholdPair.first;
+			useCandidateEvents=true;
+			break;
+		}
+	}
+	for( size_t index=0; index<scaledColumns.size() && !useCandidateEvents && numberOfBins>0; ++index )
+	{
+		if( scaledColumns[index].second*binLowEdges[1]>-1 )
+		{
+			candidatesColumn=scaledColumns[index].first;
+			useCandidateEvents=true;
 		}
 	}
 
-	//
-	// Now I know which bins need filling, loop over them and fill.
-	//
-	for( size_t binNumber=1; binNumber<=lowBin; ++binNumber )
+	// Weight of the events at the highest bin they pass, for each block. Converted to the
+	// cumulative histogram at the end rather than filling every bin for every event.
+	std::vector<BinSums> blockContents( lastBlock-firstBlock, BinSums(numberOfBins) );
+
+	for( size_t blockNumber=firstBlock; blockNumber<lastBlock; ++blockNumber )
 	{
-		pHistogram_->Fill( pHistogram_->GetBinCenter(binNumber), event.weight()*weightPerEvent );
+		const l1menu::ReducedEventBlock& eventBlock=sample.eventBlock(blockNumber);
+		BinSums& contents=blockContents[blockNumber-firstBlock];
+		for( size_t index=0; index<scaledColumns.size(); ++index ) scaledValues[index]=eventBlock.parameterValues( scaledColumns[index].first );
+		for( size_t index=0; index<fixedColumns.size(); ++index ) fixedValues[index]=eventBlock.parameterValues( fixedColumns[index].first );
+		const float* pWeights=eventBlock.weights();
+
+		auto addEvent=[&]( size_t eventNumber )
+		{
+			// Test whether the event passes with the main threshold at the low edge of the given bin
+			auto passes=[&]( size_t binNumber )->bool
+			{
+				for( size_t index=0; index<fixedColumns.size(); ++index )
+				{
+					if( fixedValues[index][eventNumber]<fixedColumns[index].second ) return false;
+				}
+				for( size_t index=0; index<scaledColumns.size(); ++index )
+				{
+					if( scaledValues[index][eventNumber]<scaledColumns[index].second*binLowEdges[binNumber] ) return false;
+				}
+				return true;
+			};
+
+			size_t lowBin=1;
+			size_t highBin=numberOfBins;
+
+			// If the first bin doesn't pass then the histogram doesn't need filling at all
+			if( !passes(lowBin) ) return;
+
+			if( passes(highBin) ) lowBin=highBin;
+			else
+			{
+				while( highBin-lowBin>1 ) // Loop until I find two bins next to each other
+				{
+					size_t middleBin=(highBin+lowBin)/2;
+					if( passes(middleBin) ) lowBin=middleBin;
+					else highBin=middleBin;
+				}
+			}
+
+			contents.add( lowBin, pWeights[eventNumber] );
+		};
+
+		const std::vector<uint32_t>* pCandidateEvents=nullptr;
+		if( useCandidateEvents ) pCandidateEvents=eventBlock.candidateEvents( candidatesColumn );
+
+		if( pCandidateEvents!=nullptr )
+		{
+			for( const uint32_t eventNumber : *pCandidateEvents ) addEvent( eventNumber );
+		}
+		else
+		{
+			for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber ) addEvent( eventNumber );
+		}
+	} // end of loop over event blocks
+
+	return blockContents;
+}
+
+l1menu::TriggerRatePlot::BinSums::BinSums( size_t numberOfBins )
+	: weights( numberOfBins+1, 0 ), weightsSquared( numberOfBins+1, 0 ), numberOfFills(0)
+{
+	// No operation besides the initialiser list
+}
+
+void l1menu::TriggerRatePlot::BinSums::add( size_t binNumber, double weight )
+{
+	weights[binNumber]+=weight;
+	weightsSquared[binNumber]+=weight*weight;
+	numberOfFills+=binNumber;
+}
+
+void l1menu::TriggerRatePlot::BinSums::add( const BinSums& otherBinSums )
+{
+	for( size_t binNumber=0; binNumber<weights.size(); ++binNumber )
+	{
+		weights[binNumber]+=otherBinSums.weights[binNumber];
+		weightsSquared[binNumber]+=otherBinSums.weightsSquared[binNumber];
+	}
+	numberOfFills+=otherBinSums.numberOfFills;
+}
+
+void l1menu::TriggerRatePlot::BinSums::makeCumulative()
+{
+	// Every bin up to and including the one an event was recorded at should get its weight, so
+	// a running sum from the top bin down gives the contents.
+	for( size_t binNumber=weights.size()-1; binNumber>1; --binNumber )
+	{
+		weights[binNumber-1]+=weights[binNumber];
+		weightsSquared[binNumber-1]+=weightsSquared[binNumber];
+	}
+}
+
+void l1menu::TriggerRatePlot::BinSums::scale( double factor )
+{
+	for( auto& weight : weights ) weight*=factor;
+	for( auto& weightSquared : weightsSquared ) weightSquared*=factor*factor;
+}
+
+void l1menu::TriggerRatePlot::addToBins( const BinSums& contents )
+{
+	const std::vector<double>& binWeights=contents.weights;
+	const std::vector<double>& binWeightsSquared=contents.weightsSquared;
+	const size_t numberOfBins=pHistogram_->GetNbinsX();
+
+	// TH1::Fill starts storing the sum of weights squared the first time it's given a weight
+	// other than one, so do the same here if the weights aren't all one.
+	if( pHistogram_->GetSumw2N()==0 )
+	{
+		for( size_t binNumber=1; binNumber<=numberOfBins; ++binNumber )
+		{
+			if( binWeightsSquared[binNumber]!=binWeights[binNumber] )
+			{
+				pHistogram_->Sumw2();
+				break;
+			}
+		}
 	}
 
+	for( size_t binNumber=1; binNumber<=numberOfBins; ++binNumber )
+	{
+		if( binWeights[binNumber]==0 && binWeightsSquared[binNumber]==0 ) continue;
+		pHistogram_->AddBinContent( binNumber, binWeights[binNumber] );
+		if( pHistogram_->GetSumw2N()!=0 ) (*pHistogram_->GetSumw2())[binNumber]+=binWeightsSquared[binNumber];
+	}
+
+	// The statistics (mean etcetera) now need working out from the bin contents, and the
+	// number of entries needs to be what it would have been if Fill had been used.
+	const double previousEntries=pHistogram_->GetEntries();
+	pHistogram_->ResetStats();
+	pHistogram_->SetEntries( previousEntries+contents.numberOfFills );
 }
 
 const l1menu::ITriggerDescription& l1menu::TriggerRatePlot::getTrigger() const
@@ -555,28 +791,141 @@ TH1* l1menu::TriggerRatePlot::relinquishOwnershipOfPlot()
 
 void l1menu::TriggerRatePlot::addSample( const l1menu::ISample& sample, std::vector<TriggerRatePlot>& ratePlots )
 {
-	float weightPerEvent=sample.eventRate()/sample.sumOfWeights();
+	std::vector<TriggerRatePlot*> pRatePlots;
+	for( auto& ratePlot : ratePlots ) pRatePlots.push_back( &ratePlot );
+	addSampleToPlots( sample, pRatePlots );
+}
+
+std::vector<l1menu::TriggerRatePlot::ChunkContents> l1menu::TriggerRatePlot::chunkContents( const l1menu::ISample& sample, const std::vector<const TriggerRatePlot*>& pRatePlots, size_t firstChunk, size_t lastChunk )
+{
+	if( firstChunk>lastChunk || lastChunk>l1menu::implementation::MenuRateImplementation::numberOfChunks(sample) ) throw std::runtime_error( "TriggerRatePlot::chunkContents - the range of chunks isn't inside the sample" );
+
+	l1menu::tools::ThreadPool& threadPool=l1menu::tools::ThreadPool::instance();
+	std::vector<ChunkContents> contents( lastChunk-firstChunk );
+	for( auto& chunk : contents )
+	{
+		for( const auto pRatePlot : pRatePlots ) chunk.plotContents.push_back( BinSums( pRatePlot->pHistogram_->GetNbinsX() ) );
+		chunk.sumOfWeights=0;
+	}
+
+	// For ReducedSample each chunk is a block of events. Each plot is done separately using the
+	// columns directly, since there's no overhead in reading the events to share between plots.
+	const l1menu::ReducedSample* pReducedSample=dynamic_cast<const l1menu::ReducedSample*>(&sample);
+	if( pReducedSample!=nullptr )
+	{
+		// If a plot only depends on the one column then every event that passes the threshold for a
+		// bin is counted in that bin, so the contents for each chunk can be read straight from the
+		// sorted index without looking at any events. The indices are asked for here rather than
+		// in the tasks so that creating them can use the thread pool.
+		std::vector<ReducedSampleColumns> columns;
+		std::vector<const l1menu::SortedParameterIndex*> pSortedIndices;
+		for( const auto pRatePlot : pRatePlots )
+		{
+			columns.push_back( pRatePlot->reducedSampleColumns(*pReducedSample) );
+			if( columns.back().fixedColumns.empty() && columns.back().scaledColumns.size()==1 )
+			{
+				pSortedIndices.push_back( &pReducedSample->sortedParameterIndex( columns.back().scaledColumns.front().first ) );
+			}
+			else pSortedIndices.push_back( nullptr );
+		}
 
-	// Create cached triggers for each of the rate plots, which depending on the concrete type
-	// of the ISample may or may not significantly increase the speed at which this next loop happens.
-	std::vector< std::unique_ptr<l1menu::ICachedTrigger> > cachedTriggers;
-	for( const auto& ratePlot : ratePlots ) cachedTriggers.push_back( sample.createCachedTrigger( *ratePlot.pTrigger_ ) );
+		threadPool.run( pRatePlots.size()*contents.size(), [&]( size_t taskNumber )
+		{
+			const size_t plotNumber=taskNumber%pRatePlots.size();
+			const size_t chunkNumber=firstChunk+taskNumber/pRatePlots.size();
+			const ReducedSampleColumns& plotColumns=columns[plotNumber];
+			BinSums& plotContents=contents[chunkNumber-firstChunk].plotContents[plotNumber];
+
+			if( pSortedIndices[plotNumber]!=nullptr )
+			{
+				const l1menu::SortedParameterIndex& sortedIndex=*pSortedIndices[plotNumber];
+				for( size_t binNumber=1; binNumber<plotContents.weights.size(); ++binNumber )
+				{
+					const float threshold=plotColumns.scaledColumns.front().second*plotColumns.binLowEdges[binNumber];
+					plotContents.weights[binNumber]=sortedIndex.chunkWeightPassing( chunkNumber, threshold );
+					plotContents.weightsSquared[binNumber]=sortedIndex.chunkWeightSquaredPassing( chunkNumber, threshold );
+					plotContents.numberOfFills+=sortedIndex.chunkNumberPassing( chunkNumber, threshold );
+				}
+			}
+			else
+			{
+				plotContents=std::move( pRatePlots[plotNumber]->reducedSampleBlockContents( *pReducedSample, plotColumns, chunkNumber, chunkNumber+1 ).front() );
+				plotContents.makeCumulative();
+			}
+		} );
+		for( size_t index=0; index<contents.size(); ++index ) contents[index].sumOfWeights=blockSumOfWeights( pReducedSample->eventBlock(firstChunk+index) );
+		return contents;
+	}
 
-	// Now instead of calling addSample() for each TriggerRatePlot individually, get each IEvent from the sample
+	// Instead of looping over the events for each TriggerRatePlot individually, get each IEvent from the sample
 	// and pass that to each rate plot. This is because (depending on the ISample concrete type) getting the
-	// IEvent can be computationally expensive.
-	std::vector< std::unique_ptr<l1menu::ICachedTrigger> >::const_iterator iTrigger;
-	std::vector<TriggerRatePlot>::iterator iRatePlot;
-	for( size_t eventNumber=0; eventNumber<sample.numberOfEvents(); ++eventNumber )
+	// IEvent can be computationally expensive. The events are split into chunks of a fixed size so that the
+	// order the sums are added up in (and hence the result) is the same regardless of the number of threads.
+	const size_t eventsPerChunk=l1menu::implementation::MenuRateImplementation::EVENTS_PER_CHUNK;
+	const size_t numberOfEvents=sample.numberOfEvents();
+	l1menu::implementation::EventCursorPool cursorPool( sample );
+
+	threadPool.run( contents.size(), [&]( size_t taskNumber )
 	{
-		const l1menu::IEvent& event=sample.getEvent(eventNumber);
+		// The bisection changes the trigger parameters, so each chunk needs its own copy of
+		// every trigger. Create cached triggers while at it, which depending on the concrete
+		// type of the ISample may or may not significantly increase the speed of the loop.
+		std::vector<TriggerCopy> triggers;
+		ChunkContents& chunk=contents[taskNumber];
+		for( const auto pRatePlot : pRatePlots ) triggers.push_back( pRatePlot->copyTrigger( sample ) );
+
+		l1menu::implementation::EventCursorPool::Sentry cursorSentry( cursorPool );
+		const size_t chunkNumber=firstChunk+taskNumber;
+		const size_t lastEvent=std::min( numberOfEvents, (chunkNumber+1)*eventsPerChunk );
+		for( size_t eventNumber=chunkNumber*eventsPerChunk; eventNumber<lastEvent; ++eventNumber )
+		{
+			const l1menu::IEvent& event=cursorSentry.cursor().getEvent(eventNumber);
+			const double weight=event.weight();
+			chunk.sumOfWeights+=weight;
+
+			for( size_t plotNumber=0; plotNumber<pRatePlots.size(); ++plotNumber )
+			{
+				const size_t highestBin=pRatePlots[plotNumber]->highestPassingBin( event, triggers[plotNumber] );
+				if( highestBin!=0 ) chunk.plotContents[plotNumber].add( highestBin, weight );
+			}
+		} // end of loop over events
 
-		for( iTrigger=cachedTriggers.begin(), iRatePlot=ratePlots.begin();
-			iTrigger!=cachedTriggers.end() && iRatePlot!=ratePlots.end();
-			++iTrigger, ++iRatePlot )
+		for( auto& plotContents : chunk.plotContents ) plotContents.makeCumulative();
+	} );
+
+	return contents;
+}
+
+void l1menu::TriggerRatePlot::addSampleToPlots( const l1menu::ISample& sample, const std::vector<TriggerRatePlot*>& pRatePlots )
+{
+	// The bin contents are all worked out on the thread pool first and then added to the histograms
+	// afterwards on this thread, so that the threads never touch anything in ROOT. This goes through
+	// exactly the same per chunk contents as PartialMenuRatePlots, so that splitting the chunks
+	// between processes gives the same plots. Only a batch of chunks is worked out at a time so
+	// that the memory doesn't grow with the size of the sample, with each batch added to running
+	// totals in chunk order.
+	const std::vector<const TriggerRatePlot*> pConstRatePlots( pRatePlots.begin(), pRatePlots.end() );
+	const size_t numberOfChunks=l1menu::implementation::MenuRateImplementation::numberOfChunks(sample);
+	const size_t chunksPerBatch=CHUNKS_PER_THREAD_IN_BATCH*std::max<size_t>( 1, l1menu::tools::ThreadPool::instance().numberOfThreads() );
+
+	std::vector<BinSums> contents;
+	for( const auto pRatePlot : pRatePlots ) contents.push_back( BinSums( pRatePlot->pHistogram_->GetNbinsX() ) );
+	double sumOfWeights=0;
+
+	for( size_t firstChunk=0; firstChunk<numberOfChunks; firstChunk+=chunksPerBatch )
+	{
+		const std::vector<ChunkContents> chunks=chunkContents( sample, pConstRatePlots, firstChunk, std::min( numberOfChunks, firstChunk+chunksPerBatch ) );
+		for( const auto& chunk : chunks )
 		{
-			iRatePlot->addEvent( event, *iTrigger, weightPerEvent );
+			sumOfWeights+=chunk.sumOfWeights;
+			for( size_t plotNumber=0; plotNumber<pRatePlots.size(); ++plotNumber ) contents[plotNumber].add( chunk.plotContents[plotNumber] );
 		}
-	} // end of loop over events
+	}
 
+	const double weightPerEvent=( sumOfWeights==0 ? 0 : sample.eventRate()/sumOfWeights );
+	for( size_t plotNumber=0; plotNumber<pRatePlots.size(); ++plotNumber )
+	{
+		contents[plotNumber].scale( weightPerEvent );
+		pRatePlots[plotNumber]->addToBins( contents[plotNumber] );
+	}
 }
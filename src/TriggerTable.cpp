@@ -4,6 +4,54 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
+
+namespace // Use the unnamed namespace for things only used in this file
+{
+	/** @brief Works out which of the trigger's parameters are thresholds.
+	 *
+	 * Thresholds are named "threshold1", "threshold2" etcetera, or "leg1threshold1", "leg2threshold1"
+	 * etcetera for cross triggers. This only checks against parameterNames() so no exceptions
+	 * are thrown.
+	 */
+	std::vector<std::string> findThresholdNames( const l1menu::ITriggerDescription& trigger )
+	{
+		std::vector<std::string> returnValue;
+
+		const std::vector<std::string> parameterNames=trigger.parameterNames();
+		auto hasParameter=[&parameterNames]( const std::string& name ){ return std::find( parameterNames.begin(), parameterNames.end(), name )!=parameterNames.end(); };
+
+		// Cross triggers have "leg1threshold1", "leg2threshold1" etcetera, so loop over those possible
+		// prefixes. For triggers with only one leg I don't want to prefix anything.
+		for( size_t legNumber=0; true; ++legNumber )
+		{
+			const std::string prefix=( legNumber==0 ? "" : "leg"+std::to_string(legNumber) );
+
+			size_t thresholdNumber;
+			for( thresholdNumber=1; hasParameter( prefix+"threshold"+std::to_string(thresholdNumber) ); ++thresholdNumber )
+			{
+				returnValue.push_back( prefix+"threshold"+std::to_string(thresholdNumber) );
+			}
+
+			// If there wasn't even a first threshold then the prefix (e.g. "leg1") does not exist, so I know
+			// I've finished. If there was then there could be other prefixes (e.g. "leg2") that have thresholds.
+			if( thresholdNumber==1 && legNumber!=0 ) break;
+		}
+
+		return returnValue;
+	}
+
+	/** @brief Everything in parameterNames() that isn't in the list of threshold names. */
+	std::vector<std::string> findNonThresholdParameterNames( const l1menu::ITriggerDescription& trigger, const std::vector<std::string>& thresholdNames )
+	{
+		std::vector<std::string> returnValue;
+		for( const auto& parameterName : trigger.parameterNames() )
+		{
+			if( std::find( thresholdNames.begin(), thresholdNames.end(), parameterName )==thresholdNames.end() ) returnValue.push_back(parameterName);
+		}
+		return returnValue;
+	}
+}
 
 //
 // Declare the pimple class
@@ -17,6 +65,8 @@ namespace l1menu
 		{
 			l1menu::TriggerTable::TriggerDetails details;
 			std::unique_ptr<l1menu::ITrigger> (*creationFunctionPointer)();
+			std::vector<std::string> thresholdNames; ///< Worked out when the trigger is registered so that it's not repeated
+			std::vector<std::string> nonThresholdParameterNames;
 		};
 		struct SuggestedBinning
 		{
@@ -25,6 +75,10 @@ namespace l1menu
 			float upperEdge;
 		};
 		std::vector<TriggerRegistryEntry> registeredTriggers;
+		/// Position in registeredTriggers for each name and version, so that entries can be found without a linear search
+		std::map< std::pair<std::string,unsigned int>, size_t > registeredTriggerIndices;
+		/// Returns the registry entry for the trigger with the given name and version, or nullptr if there isn't one
+		const TriggerRegistryEntry* findRegistryEntry( const std::string& name, unsigned int version ) const;
 		std::map<std::string,std::map<std::string,SuggestedBinning> > suggestedBinning_;
 		const SuggestedBinning& getSuggestedBinning( const std::string& triggerName, const std::string& parameterName );
 	};
@@ -48,6 +102,13 @@ const l1menu::TriggerTablePrivateMembers::SuggestedBinning& l1menu::TriggerTable
 	return iParameterFindResult->second;
 }
 
+const l1menu::TriggerTablePrivateMembers::TriggerRegistryEntry* l1menu::TriggerTablePrivateMembers::findRegistryEntry( const std::string& name, unsigned int version ) const
+{
+	const auto& iFindResult=registeredTriggerIndices.find( std::make_pair(name,version) );
+	if( iFindResult==registeredTriggerIndices.end() ) return nullptr;
+	else return &registeredTriggers[iFindResult->second];
+}
+
 l1menu::TriggerTable& l1menu::TriggerTable::instance()
 {
 	static TriggerTable onlyInstance;
@@ -100,13 +161,8 @@ std::unique_ptr<l1menu::ITrigger> l1menu::TriggerTable::getTrigger( const Trigge
 {
 //	std::cout << "Looking for version " << details.version << " of " << details.name << std::endl;
 
-	for( std::vector<TriggerTablePrivateMembers::TriggerRegistryEntry>::const_iterator iRegistryEntry=pImple_->registeredTriggers.begin(); iRegistryEntry!=pImple_->registeredTriggers.end(); ++iRegistryEntry )
-	{
-		if( iRegistryEntry->details==details )
-		{
-			return (*iRegistryEntry->creationFunctionPointer)();
-		}
-	}
+	const TriggerTablePrivateMembers::TriggerRegistryEntry* pRegistryEntry=pImple_->findRegistryEntry( details.name, details.version );
+	if( pRegistryEntry!=nullptr ) return (*pRegistryEntry->creationFunctionPointer)();
 
 	// If program flow has reached this point then there are no triggers registered that
 	// match the criteria. Return an empty pointer.
@@ -147,24 +203,42 @@ std::vector<l1menu::TriggerTable::TriggerDetails> l1menu::TriggerTable::listTrig
 	return returnValue;
 }
 
+std::vector<std::string> l1menu::TriggerTable::getThresholdNames( const l1menu::ITriggerDescription& trigger ) const
+{
+	const TriggerTablePrivateMembers::TriggerRegistryEntry* pRegistryEntry=pImple_->findRegistryEntry( trigger.name(), trigger.version() );
+	if( pRegistryEntry!=nullptr ) return pRegistryEntry->thresholdNames;
+	else return ::findThresholdNames( trigger );
+}
+
+std::vector<std::string> l1menu::TriggerTable::getNonThresholdParameterNames( const l1menu::ITriggerDescription& trigger ) const
+{
+	const TriggerTablePrivateMembers::TriggerRegistryEntry* pRegistryEntry=pImple_->findRegistryEntry( trigger.name(), trigger.version() );
+	if( pRegistryEntry!=nullptr ) return pRegistryEntry->nonThresholdParameterNames;
+	else return ::findNonThresholdParameterNames( trigger, ::findThresholdNames( trigger ) );
+}
+
 void l1menu::TriggerTable::registerTrigger( const std::string& name, unsigned int version, std::unique_ptr<l1menu::ITrigger> (*creationFunctionPointer)() )
 {
 	TriggerDetails newTriggerDetails{ name, version };
 
 	// First make sure there is not a trigger with the same name and version already registered
-	for( std::vector<TriggerTablePrivateMembers::TriggerRegistryEntry>::const_iterator iRegistryEntry=pImple_->registeredTriggers.begin(); iRegistryEntry!=pImple_->registeredTriggers.end(); ++iRegistryEntry )
+	if( pImple_->findRegistryEntry( name, version )!=nullptr )
 	{
-		if( iRegistryEntry->details==newTriggerDetails )
-		{
-			std::stringstream errorMessage;
-			errorMessage << "A trigger called \"" << newTriggerDetails.name << "\" with version " << newTriggerDetails.version << " has already been registered in the trigger table.";
-			throw std::logic_error( errorMessage.str() );
-		}
+		std::stringstream errorMessage;
+		errorMessage << "A trigger called \"" << newTriggerDetails.name << "\" with version " << newTriggerDetails.version << " has already been registered in the trigger table.";
+		throw std::logic_error( errorMessage.str() );
 	}
 
 	// If program flow has reached this point then there are no triggers with the same name
-	// and version already registered, so it's okay to add the trigger as requested.
-	pImple_->registeredTriggers.push_back( TriggerTablePrivateMembers::TriggerRegistryEntry{newTriggerDetails,creationFunctionPointer} );
+	// and version already registered, so it's okay to add the trigger as requested. The
+	// parameter names are the same for every instance, so work out which are thresholds now
+	// rather than every time somebody asks.
+	std::unique_ptr<l1menu::ITrigger> pTemporaryInstance=(*creationFunctionPointer)();
+	std::vector<std::string> thresholdNames=::findThresholdNames( *pTemporaryInstance );
+	std::vector<std::string> nonThresholdParameterNames=::findNonThresholdParameterNames( *pTemporaryInstance, thresholdNames );
+
+	pImple_->registeredTriggerIndices[std::make_pair(name,version)]=pImple_->registeredTriggers.size();
+	pImple_->registeredTriggers.push_back( TriggerTablePrivateMembers::TriggerRegistryEntry{newTriggerDetails,creationFunctionPointer,std::move(thresholdNames),std::move(nonThresholdParameterNames)} );
 }
 
 void l1menu::TriggerTable::registerSuggestedBinning( const std::string& triggerName, const std::string& parameterName, unsigned int numberOfBins, float lowerEdge, float upperEdge )
@@ -0,0 +1,67 @@
+#include "BinaryStream.h"
+
+#include <stdexcept>
+#include <istream>
+#include <ostream>
+
+namespace // unnamed namespace
+{
+	const uint64_t BYTE_ORDER_MARK=0x0102030405060708;
+}
+
+l1menu::implementation::BinaryOutputStream::BinaryOutputStream( std::ostream& output, const std::string& identifier )
+	: output_(output)
+{
+	output_.write( identifier.data(), identifier.size() );
+	writeInteger( BYTE_ORDER_MARK );
+}
+
+void l1menu::implementation::BinaryOutputStream::writeInteger( uint64_t value )
+{
+	output_.write( reinterpret_cast<const char*>(&value), sizeof(value) );
+}
+
+void l1menu::implementation::BinaryOutputStream::writeDouble( double value )
+{
+	output_.write( reinterpret_cast<const char*>(&value), sizeof(value) );
+}
+
+void l1menu::implementation::BinaryOutputStream::writeDoubles( const std::vector<double>& values )
+{
+	if( !values.empty() ) output_.write( reinterpret_cast<const char*>(values.data()), values.size()*sizeof(double) );
+}
+
+l1menu::implementation::BinaryInputStream::BinaryInputStream( std::istream& input, const std::string& identifier )
+	: input_(input), identifier_(identifier)
+{
+	std::string fileIdentifier( identifier.size(), ' ' );
+	read( &fileIdentifier[0], fileIdentifier.size() );
+	if( fileIdentifier!=identifier ) throw std::runtime_error( "BinaryInputStream - the input isn't a "+identifier );
+	if( readInteger()!=BYTE_ORDER_MARK ) throw std::runtime_error( "BinaryInputStream - the "+identifier+" input is corrupt or was written on a machine with a different byte order" );
+}
+
+uint64_t l1menu::implementation::BinaryInputStream::readInteger()
+{
+	uint64_t value;
+	read( reinterpret_cast<char*>(&value), sizeof(value) );
+	return value;
+}
+
+double l1menu::implementation::BinaryInputStream::readDouble()
+{
+	double value;
+	read( reinterpret_cast<char*>(&value), sizeof(value) );
+	return value;
+}
+
+void l1menu::implementation::BinaryInputStream::readDoubles( std::vector<double>& values, size_t numberOfValues )
+{
+	values.resize( numberOfValues );
+	if( numberOfValues>0 ) read( reinterpret_cast<char*>(values.data()), numberOfValues*sizeof(double) );
+}
+
+void l1menu::implementation::BinaryInputStream::read( char* pOutput, size_t size )
+{
+	input_.read( pOutput, size );
+	if( static_cast<size_t>(input_.gcount())!=size ) throw std::runtime_error( "BinaryInputStream - the "+identifier_+" input finished early" );
+}
@@ -0,0 +1,49 @@
+#ifndef l1menu_implementation_BinaryStream_h
+#define l1menu_implementation_BinaryStream_h
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <stdint.h>
+#include <stddef.h> // required for size_t
+
+namespace l1menu
+{
+	namespace implementation
+	{
+		/** @brief Writes numbers to a std::ostream as raw bytes, so that they can be read back exactly by BinaryInputStream.
+		 *
+		 * Starts with the given identifying string and a byte order mark. Numbers are stored in the byte
+		 * order of the machine that wrote them, the same as ChunkedSampleFileWriter does.
+		 */
+		class BinaryOutputStream
+		{
+		public:
+			BinaryOutputStream( std::ostream& output, const std::string& identifier );
+			void writeInteger( uint64_t value );
+			void writeDouble( double value );
+			void writeDoubles( const std::vector<double>& values );
+		private:
+			std::ostream& output_;
+		};
+
+		/** @brief Reads what was written by BinaryOutputStream. Throws a std::runtime_error if anything doesn't match or the input runs out. */
+		class BinaryInputStream
+		{
+		public:
+			/** @brief Checks the input starts with the identifier and the byte order mark. */
+			BinaryInputStream( std::istream& input, const std::string& identifier );
+			uint64_t readInteger();
+			double readDouble();
+			/** @brief Reads numberOfValues doubles into values, replacing anything already there. */
+			void readDoubles( std::vector<double>& values, size_t numberOfValues );
+		private:
+			void read( char* pOutput, size_t size );
+			std::istream& input_;
+			std::string identifier_;
+		};
+
+	} // end of namespace implementation
+} // end of namespace l1menu
+
+#endif
@@ -0,0 +1,90 @@
+#include "ChunkRange.h"
+
+#include <stdexcept>
+#include <sstream>
+#include "BinaryStream.h"
+
+l1menu::implementation::ChunkRange::ChunkRange()
+	: firstChunk_(0), lastChunk_(0), numberOfChunksInSample_(0)
+{
+	// No operation besides the initialiser list
+}
+
+l1menu::implementation::ChunkRange::ChunkRange( size_t firstChunk, size_t lastChunk, size_t numberOfChunksInSample )
+	: firstChunk_(firstChunk), lastChunk_(lastChunk), numberOfChunksInSample_(numberOfChunksInSample)
+{
+	if( firstChunk_>lastChunk_ || lastChunk_>numberOfChunksInSample_ ) throw std::runtime_error( "ChunkRange - the range of chunks isn't inside the sample" );
+}
+
+l1menu::implementation::ChunkRange::ChunkRange( l1menu::implementation::BinaryInputStream& input )
+	: firstChunk_( input.readInteger() ), lastChunk_( input.readInteger() ), numberOfChunksInSample_( input.readInteger() )
+{
+	if( firstChunk_>lastChunk_ || lastChunk_>numberOfChunksInSample_ ) throw std::runtime_error( "ChunkRange - the serialised range of chunks is corrupt" );
+}
+
+size_t l1menu::implementation::ChunkRange::firstChunk() const
+{
+	return firstChunk_;
+}
+
+size_t l1menu::implementation::ChunkRange::lastChunk() const
+{
+	return lastChunk_;
+}
+
+size_t l1menu::implementation::ChunkRange::numberOfChunksInSample() const
+{
+	return numberOfChunksInSample_;
+}
+
+size_t l1menu::implementation::ChunkRange::size() const
+{
+	return lastChunk_-firstChunk_;
+}
+
+void l1menu::implementation::ChunkRange::append( const ChunkRange& otherRange )
+{
+	if( size()==0 )
+	{
+		// Keep the number of chunks in the sample if there's nothing new, so that checkComplete() still fails
+		if( otherRange.size()!=0 || numberOfChunksInSample_==0 ) *this=otherRange;
+		return;
+	}
+	if( otherRange.size()==0 ) return;
+
+	if( otherRange.numberOfChunksInSample_!=numberOfChunksInSample_ ) throw std::runtime_error( "ChunkRange - can't combine chunks from samples with a different number of chunks" );
+	if( otherRange.firstChunk_<lastChunk_ )
+	{
+		std::stringstream message;
+		message << "ChunkRange - can't add chunks [" << otherRange.firstChunk_ << "," << otherRange.lastChunk_ << ") to ["
+				<< firstChunk_ << "," << lastChunk_ << ") because they overlap or are out of order";
+		throw std::runtime_error( message.str() );
+	}
+	if( otherRange.firstChunk_>lastChunk_ )
+	{
+		std::stringstream message;
+		message << "ChunkRange - can't add chunks [" << otherRange.firstChunk_ << "," << otherRange.lastChunk_ << ") to ["
+				<< firstChunk_ << "," << lastChunk_ << ") because it would leave a gap";
+		throw std::runtime_error( message.str() );
+	}
+
+	lastChunk_=otherRange.lastChunk_;
+}
+
+void l1menu::implementation::ChunkRange::checkComplete( const std::string& caller ) const
+{
+	if( firstChunk_!=0 || lastChunk_!=numberOfChunksInSample_ )
+	{
+		std::stringstream message;
+		message << caller << " - only chunks [" << firstChunk_ << "," << lastChunk_ << ") of the " << numberOfChunksInSample_
+				<< " in the sample have been added";
+		throw std::runtime_error( message.str() );
+	}
+}
+
+void l1menu::implementation::ChunkRange::serialise( l1menu::implementation::BinaryOutputStream& output ) const
+{
+	output.writeInteger( firstChunk_ );
+	output.writeInteger( lastChunk_ );
+	output.writeInteger( numberOfChunksInSample_ );
+}
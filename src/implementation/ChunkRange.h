@@ -0,0 +1,69 @@
+#ifndef l1menu_implementation_ChunkRange_h
+#define l1menu_implementation_ChunkRange_h
+
+#include <string>
+#include <stddef.h> // required for size_t
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	namespace implementation
+	{
+		class BinaryOutputStream;
+		class BinaryInputStream;
+	}
+}
+
+namespace l1menu
+{
+	namespace implementation
+	{
+		/** @brief The range of chunks of a sample that some partial results cover, so that combining them can be checked.
+		 *
+		 * PartialMenuRate and PartialMenuRatePlots only give the same answer as the whole sample if every
+		 * chunk is added exactly once and in order. This keeps the range [firstChunk,lastChunk) covered so
+		 * far and the number of chunks in the sample, and throws if anything would leave a gap or overlap.
+		 */
+		class ChunkRange
+		{
+		public:
+			/** @brief An empty range, for a sample with no chunks. */
+			ChunkRange();
+			/** @brief Chunks [firstChunk,lastChunk) of a sample with numberOfChunksInSample chunks. */
+			ChunkRange( size_t firstChunk, size_t lastChunk, size_t numberOfChunksInSample );
+			/** @brief Reads a range written by serialise().
+			 * @throw  std::runtime_error if the range isn't inside the sample.
+			 */
+			explicit ChunkRange( l1menu::implementation::BinaryInputStream& input );
+
+			size_t firstChunk() const;
+			size_t lastChunk() const;
+			size_t numberOfChunksInSample() const;
+			/** @brief The number of chunks in the range, i.e. lastChunk()-firstChunk(). */
+			size_t size() const;
+
+			/** @brief Extends the range to include the other one, which has to carry on from where this one ends.
+			 *
+			 * An empty range can be appended to anything without changing it, and anything can be appended to an
+			 * empty range. Nothing is changed if an exception is thrown.
+			 * @throw  std::runtime_error if the ranges are for samples with a different number of chunks, or if
+			 *         there would be a gap or an overlap between them.
+			 */
+			void append( const ChunkRange& otherRange );
+
+			/** @brief Throws a std::runtime_error, starting with the caller's name, unless every chunk of the sample is in the range. */
+			void checkComplete( const std::string& caller ) const;
+
+			void serialise( l1menu::implementation::BinaryOutputStream& output ) const;
+		private:
+			size_t firstChunk_;
+			size_t lastChunk_;
+			size_t numberOfChunksInSample_;
+		};
+
+	} // end of namespace implementation
+} // end of namespace l1menu
+
+#endif
@@ -0,0 +1,359 @@
+#include "ChunkedSampleFile.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <zlib.h>
+#include "MappedFile.h"
+#include "l1menu/ReducedEventBlock.h"
+#include "l1menu/tools/ThreadPool.h"
+
+namespace // unnamed namespace
+{
+	const uint64_t BYTE_ORDER_MARK=0x0102030405060708;
+	/// The range of power of two steps that findParameterQuantisations() tries, i.e. 16 down to 1/256
+	const int MAXIMUM_STEP_EXPONENT=4;
+	const int MINIMUM_STEP_EXPONENT=-8;
+
+	/** @brief Regroups the bytes so that all of the first bytes of each value come first, then all of the second bytes etcetera.
+	 *
+	 * Thresholds in neighbouring events have similar exponents and often identical values, so
+	 * this gives zlib long runs of similar bytes to work with and it compresses much better.
+	 */
+	void shuffleBytes( const unsigned char* pInput, size_t numberOfValues, size_t valueSize, unsigned char* pOutput )
+	{
+		for( size_t byteNumber=0; byteNumber<valueSize; ++byteNumber )
+		{
+			unsigned char* pOutputBytes=pOutput+byteNumber*numberOfValues;
+			for( size_t valueNumber=0; valueNumber<numberOfValues; ++valueNumber ) pOutputBytes[valueNumber]=pInput[valueNumber*valueSize+byteNumber];
+		}
+	}
+
+	/** @brief Undoes shuffleBytes. */
+	void unshuffleBytes( const unsigned char* pInput, size_t numberOfValues, size_t valueSize, unsigned char* pOutput )
+	{
+		for( size_t byteNumber=0; byteNumber<valueSize; ++byteNumber )
+		{
+			const unsigned char* pInputBytes=pInput+byteNumber*numberOfValues;
+			for( size_t valueNumber=0; valueNumber<numberOfValues; ++valueNumber ) pOutput[valueNumber*valueSize+byteNumber]=pInputBytes[valueNumber];
+		}
+	}
+
+	size_t numberOfQuantisedParameters( const std::vector<l1menu::implementation::ParameterQuantisation>& quantisations )
+	{
+		return std::count_if( quantisations.begin(), quantisations.end(), []( const l1menu::implementation::ParameterQuantisation& quantisation ){ return quantisation.isQuantised(); } );
+	}
+
+	/** @brief Compresses the block as the weights and float parameter columns followed by the quantised columns, with the bytes shuffled. */
+	std::vector<unsigned char> compressBlock( const l1menu::ReducedEventBlock& block, const std::vector<l1menu::implementation::ParameterQuantisation>& quantisations )
+	{
+		const size_t numberOfEvents=block.numberOfEvents();
+		std::vector<float> floatColumns;
+		std::vector<uint16_t> quantisedColumns;
+		floatColumns.reserve( (block.numberOfParameters()+1)*numberOfEvents );
+		floatColumns.insert( floatColumns.end(), block.weights(), block.weights()+numberOfEvents );
+		for( size_t parameterNumber=0; parameterNumber<block.numberOfParameters(); ++parameterNumber )
+		{
+			const float* pColumn=block.parameterValues(parameterNumber);
+			if( !quantisations.empty() && quantisations[parameterNumber].isQuantised() )
+			{
+				for( size_t eventNumber=0; eventNumber<numberOfEvents; ++eventNumber ) quantisedColumns.push_back( quantisations[parameterNumber].quantise(pColumn[eventNumber]) );
+			}
+			else floatColumns.insert( floatColumns.end(), pColumn, pColumn+numberOfEvents );
+		}
+
+		const size_t floatBytes=floatColumns.size()*sizeof(float);
+		std::vector<unsigned char> shuffled( floatBytes+quantisedColumns.size()*sizeof(uint16_t) );
+		::shuffleBytes( reinterpret_cast<const unsigned char*>(floatColumns.data()), floatColumns.size(), sizeof(float), shuffled.data() );
+		::shuffleBytes( reinterpret_cast<const unsigned char*>(quantisedColumns.data()), quantisedColumns.size(), sizeof(uint16_t), shuffled.data()+floatBytes );
+
+		uLongf compressedSize=compressBound( shuffled.size() );
+		std::vector<unsigned char> compressed( compressedSize );
+		// Speed matters a lot more than size here, so use the fastest level
+		int result=compress2( compressed.data(), &compressedSize, shuffled.data(), shuffled.size(), Z_BEST_SPEED );
+		if( result!=Z_OK ) throw std::runtime_error( "ChunkedSampleFileWriter - zlib error while compressing a chunk" );
+		compressed.resize( compressedSize );
+		return compressed;
+	}
+
+	/** @brief Tries each power of two step from the coarsest down, and returns the first that gets every value of the parameter back exactly. */
+	l1menu::implementation::ParameterQuantisation findQuantisation( const std::vector<l1menu::ReducedEventBlock>& eventBlocks, size_t parameterNumber )
+	{
+		typedef l1menu::implementation::ParameterQuantisation ParameterQuantisation;
+		const ParameterQuantisation notQuantised{ 0, 0 };
+
+		// -1 is stored as NEVER_PASSES, so it doesn't count towards the range
+		float minimum=std::numeric_limits<float>::max();
+		float maximum=std::numeric_limits<float>::lowest();
+		bool anyValues=false;
+		for( const auto& eventBlock : eventBlocks )
+		{
+			const float* pColumn=eventBlock.parameterValues(parameterNumber);
+			for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber )
+			{
+				const float value=pColumn[eventNumber];
+				if( value==-1 ) continue;
+				if( value!=value ) return notQuantised; // NaN
+				anyValues=true;
+				minimum=std::min( minimum, value );
+				maximum=std::max( maximum, value );
+			}
+		}
+		if( !anyValues ) return ParameterQuantisation{ 1, 0 };
+
+		for( int exponent=MAXIMUM_STEP_EXPONENT; exponent>=MINIMUM_STEP_EXPONENT; --exponent )
+		{
+			const ParameterQuantisation candidate{ std::ldexp( 1.0f, exponent ), minimum };
+			// Finer steps would need even more values, so there's no point carrying on
+			if( (static_cast<double>(maximum)-minimum)/candidate.scale>=ParameterQuantisation::NEVER_PASSES ) break;
+
+			bool allValuesExact=true;
+			for( auto iBlock=eventBlocks.begin(); iBlock!=eventBlocks.end() && allValuesExact; ++iBlock )
+			{
+				const float* pColumn=iBlock->parameterValues(parameterNumber);
+				for( size_t eventNumber=0; eventNumber<iBlock->numberOfEvents(); ++eventNumber )
+				{
+					if( candidate.dequantise( candidate.quantise(pColumn[eventNumber]) )!=pColumn[eventNumber] )
+					{
+						allValuesExact=false;
+						break;
+					}
+				}
+			}
+			if( allValuesExact ) return candidate;
+		}
+
+		return notQuantised;
+	}
+}
+
+const uint16_t l1menu::implementation::ParameterQuantisation::NEVER_PASSES;
+
+uint16_t l1menu::implementation::ParameterQuantisation::quantise( float value ) const
+{
+	if( value==-1 ) return NEVER_PASSES;
+	return static_cast<uint16_t>( std::lround( (static_cast<double>(value)-offset)/scale ) );
+}
+
+float l1menu::implementation::ParameterQuantisation::dequantise( uint16_t quantisedValue ) const
+{
+	if( quantisedValue==NEVER_PASSES ) return -1;
+	return offset+static_cast<float>(quantisedValue)*scale;
+}
+
+std::vector<l1menu::implementation::ParameterQuantisation> l1menu::implementation::findParameterQuantisations( const std::vector<l1menu::ReducedEventBlock>& eventBlocks, size_t numberOfParameters )
+{
+	std::vector<ParameterQuantisation> returnValue( numberOfParameters );
+	l1menu::tools::ThreadPool::instance().run( numberOfParameters, [&]( size_t parameterNumber )
+	{
+		returnValue[parameterNumber]=::findQuantisation( eventBlocks, parameterNumber );
+	} );
+	return returnValue;
+}
+
+l1menu::implementation::ChunkedSampleFileReader::ChunkedSampleFileReader( const std::string& filename )
+	: pMappedFile_( new l1menu::implementation::MappedFile( filename ) )
+{
+	const char* pFileStart=pMappedFile_->data();
+	const size_t fileSize=pMappedFile_->size();
+
+	if( fileSize<sizeof(ChunkedFileTrailer) ) throw std::runtime_error( "ChunkedSampleFileReader - file is too short to hold the trailer" );
+	std::memcpy( &trailer_, pFileStart+fileSize-sizeof(ChunkedFileTrailer), sizeof(ChunkedFileTrailer) );
+	if( trailer_.byteOrderMark!=BYTE_ORDER_MARK ) throw std::runtime_error( "ChunkedSampleFileReader - file is corrupt or was written on a machine with a different byte order" );
+
+	const size_t trailerOffset=fileSize-sizeof(ChunkedFileTrailer);
+	if( trailer_.menuOffset+trailer_.menuSize>trailerOffset || trailer_.indexOffset+trailer_.numberOfChunks*sizeof(ChunkIndexEntry)>trailerOffset )
+	{
+		throw std::runtime_error( "ChunkedSampleFileReader - file is truncated or corrupt (trailer)" );
+	}
+
+	// Anything between the menu and the index is the table of how each parameter is quantised
+	const size_t quantisationsOffset=trailer_.menuOffset+trailer_.menuSize;
+	if( trailer_.indexOffset<quantisationsOffset ) throw std::runtime_error( "ChunkedSampleFileReader - file is corrupt (index overlaps the menu)" );
+	const size_t quantisationsSize=trailer_.indexOffset-quantisationsOffset;
+	if( quantisationsSize!=0 )
+	{
+		if( quantisationsSize!=trailer_.numberOfParameters*sizeof(ParameterQuantisation) ) throw std::runtime_error( "ChunkedSampleFileReader - file is corrupt (parameter quantisations)" );
+		quantisations_.resize( trailer_.numberOfParameters );
+		std::memcpy( quantisations_.data(), pFileStart+quantisationsOffset, quantisationsSize );
+	}
+
+	// The index entries might not be aligned, so copy them out rather than pointing at them
+	index_.resize( trailer_.numberOfChunks );
+	std::memcpy( index_.data(), pFileStart+trailer_.indexOffset, trailer_.numberOfChunks*sizeof(ChunkIndexEntry) );
+
+	size_t numberOfEvents=0;
+	for( const auto& indexEntry : index_ )
+	{
+		if( indexEntry.offset+indexEntry.compressedSize>trailer_.menuOffset ) throw std::runtime_error( "ChunkedSampleFileReader - file is truncated or corrupt (chunk index)" );
+		chunkFirstEvents_.push_back( numberOfEvents );
+		numberOfEvents+=indexEntry.numberOfEvents;
+	}
+	// Put the total on the end so that chunkContainingEvent() can do a simple search
+	chunkFirstEvents_.push_back( numberOfEvents );
+}
+
+l1menu::implementation::ChunkedSampleFileReader::~ChunkedSampleFileReader()
+{
+	// No operation. Just need one defined otherwise the default one messes up
+	// the unique_ptr deletion because MappedFile isn't defined in the header.
+}
+
+std::string l1menu::implementation::ChunkedSampleFileReader::serialisedMenu() const
+{
+	return std::string( pMappedFile_->data()+trailer_.menuOffset, trailer_.menuSize );
+}
+
+size_t l1menu::implementation::ChunkedSampleFileReader::numberOfParameters() const
+{
+	return trailer_.numberOfParameters;
+}
+
+const std::vector<l1menu::implementation::ParameterQuantisation>& l1menu::implementation::ChunkedSampleFileReader::parameterQuantisations() const
+{
+	return quantisations_;
+}
+
+size_t l1menu::implementation::ChunkedSampleFileReader::numberOfEvents() const
+{
+	return chunkFirstEvents_.back();
+}
+
+double l1menu::implementation::ChunkedSampleFileReader::sumOfWeights() const
+{
+	return trailer_.sumOfWeights;
+}
+
+size_t l1menu::implementation::ChunkedSampleFileReader::numberOfChunks() const
+{
+	return index_.size();
+}
+
+size_t l1menu::implementation::ChunkedSampleFileReader::chunkNumberOfEvents( size_t chunkNumber ) const
+{
+	return index_.at(chunkNumber).numberOfEvents;
+}
+
+size_t l1menu::implementation::ChunkedSampleFileReader::chunkFirstEvent( size_t chunkNumber ) const
+{
+	return chunkFirstEvents_.at(chunkNumber);
+}
+
+size_t l1menu::implementation::ChunkedSampleFileReader::chunkContainingEvent( size_t eventNumber ) const
+{
+	if( eventNumber>=numberOfEvents() ) throw std::out_of_range( "ChunkedSampleFileReader::chunkContainingEvent - event number is past the end of the file" );
+	// The first entry greater than eventNumber is the start of the next chunk
+	const auto iNextChunk=std::upper_bound( chunkFirstEvents_.begin(), chunkFirstEvents_.end(), eventNumber );
+	return (iNextChunk-chunkFirstEvents_.begin())-1;
+}
+
+void l1menu::implementation::ChunkedSampleFileReader::readChunk( size_t chunkNumber, std::vector<float>& output ) const
+{
+	const ChunkIndexEntry& indexEntry=index_.at(chunkNumber);
+	const size_t numberOfEvents=indexEntry.numberOfEvents;
+	const size_t numberOfQuantised=::numberOfQuantisedParameters( quantisations_ );
+	const size_t numberOfFloats=(trailer_.numberOfParameters+1-numberOfQuantised)*numberOfEvents;
+	const size_t numberOfQuantisedValues=numberOfQuantised*numberOfEvents;
+	output.resize( (trailer_.numberOfParameters+1)*numberOfEvents );
+
+	std::vector<unsigned char> shuffled( numberOfFloats*sizeof(float)+numberOfQuantisedValues*sizeof(uint16_t) );
+	uLongf uncompressedSize=shuffled.size();
+	const Bytef* pCompressed=reinterpret_cast<const Bytef*>( pMappedFile_->data()+indexEntry.offset );
+	int result=uncompress( shuffled.data(), &uncompressedSize, pCompressed, indexEntry.compressedSize );
+	if( result!=Z_OK || uncompressedSize!=shuffled.size() ) throw std::runtime_error( "ChunkedSampleFileReader - chunk "+std::to_string(chunkNumber)+" is corrupt" );
+
+	// If nothing is quantised the columns are already in the right order
+	if( numberOfQuantised==0 )
+	{
+		::unshuffleBytes( shuffled.data(), numberOfFloats, sizeof(float), reinterpret_cast<unsigned char*>(output.data()) );
+		return;
+	}
+
+	std::vector<float> floatColumns( numberOfFloats );
+	std::vector<uint16_t> quantisedColumns( numberOfQuantisedValues );
+	::unshuffleBytes( shuffled.data(), numberOfFloats, sizeof(float), reinterpret_cast<unsigned char*>(floatColumns.data()) );
+	::unshuffleBytes( shuffled.data()+numberOfFloats*sizeof(float), numberOfQuantisedValues, sizeof(uint16_t), reinterpret_cast<unsigned char*>(quantisedColumns.data()) );
+
+	// Put the columns back in parameter order, with the weights first
+	const float* pNextFloatColumn=floatColumns.data();
+	const uint16_t* pNextQuantisedColumn=quantisedColumns.data();
+	std::copy( pNextFloatColumn, pNextFloatColumn+numberOfEvents, output.begin() );
+	pNextFloatColumn+=numberOfEvents;
+	for( size_t parameterNumber=0; parameterNumber<trailer_.numberOfParameters; ++parameterNumber )
+	{
+		float* pOutputColumn=&output[(parameterNumber+1)*numberOfEvents];
+		const ParameterQuantisation& quantisation=quantisations_[parameterNumber];
+		if( quantisation.isQuantised() )
+		{
+			for( size_t eventNumber=0; eventNumber<numberOfEvents; ++eventNumber ) pOutputColumn[eventNumber]=quantisation.dequantise( pNextQuantisedColumn[eventNumber] );
+			pNextQuantisedColumn+=numberOfEvents;
+		}
+		else
+		{
+			std::copy( pNextFloatColumn, pNextFloatColumn+numberOfEvents, pOutputColumn );
+			pNextFloatColumn+=numberOfEvents;
+		}
+	}
+}
+
+l1menu::implementation::ChunkedSampleFileWriter::ChunkedSampleFileWriter( const std::string& filename, const std::string& fileHeader, size_t numberOfParameters, const std::vector<ParameterQuantisation>& quantisations )
+	: outputFile_( filename, std::ios::binary ), numberOfParameters_(numberOfParameters), quantisations_(quantisations)
+{
+	if( !quantisations_.empty() && quantisations_.size()!=numberOfParameters_ ) throw std::logic_error( "ChunkedSampleFileWriter - there must be a quantisation for every parameter or none at all" );
+	// If nothing is actually quantised leave the table out altogether
+	if( ::numberOfQuantisedParameters( quantisations_ )==0 ) quantisations_.clear();
+
+	if( !outputFile_.is_open() ) throw std::runtime_error( "ChunkedSampleFileWriter - couldn't open file \""+filename+"\"" );
+	outputFile_.write( fileHeader.data(), fileHeader.size() );
+}
+
+void l1menu::implementation::ChunkedSampleFileWriter::addChunks( const std::vector<l1menu::ReducedEventBlock>& blocks )
+{
+	// Only compress a few blocks more than there are threads at a time, so that the whole
+	// compressed sample doesn't have to be held in memory before it's written.
+	l1menu::tools::ThreadPool& threadPool=l1menu::tools::ThreadPool::instance();
+	const size_t blocksPerBatch=2*threadPool.numberOfThreads();
+	std::vector< std::vector<unsigned char> > compressedBlocks;
+
+	for( size_t firstBlock=0; firstBlock<blocks.size(); firstBlock+=blocksPerBatch )
+	{
+		const size_t blocksInBatch=std::min( blocksPerBatch, blocks.size()-firstBlock );
+		compressedBlocks.assign( blocksInBatch, std::vector<unsigned char>() );
+		threadPool.run( blocksInBatch, [&]( size_t taskNumber )
+		{
+			compressedBlocks[taskNumber]=::compressBlock( blocks[firstBlock+taskNumber], quantisations_ );
+		} );
+
+		for( size_t blockNumber=0; blockNumber<blocksInBatch; ++blockNumber )
+		{
+			const std::vector<unsigned char>& compressedBlock=compressedBlocks[blockNumber];
+			const uint64_t offset=outputFile_.tellp();
+			index_.push_back( ChunkIndexEntry{ offset, compressedBlock.size(), blocks[firstBlock+blockNumber].numberOfEvents() } );
+			outputFile_.write( reinterpret_cast<const char*>(compressedBlock.data()), compressedBlock.size() );
+		}
+	}
+	if( !outputFile_ ) throw std::runtime_error( "ChunkedSampleFileWriter - error while writing chunks" );
+}
+
+void l1menu::implementation::ChunkedSampleFileWriter::close( const std::string& serialisedMenu, double sumOfWeights )
+{
+	ChunkedFileTrailer trailer;
+	trailer.byteOrderMark=BYTE_ORDER_MARK;
+	trailer.numberOfParameters=numberOfParameters_;
+	trailer.numberOfChunks=index_.size();
+	trailer.menuOffset=outputFile_.tellp();
+	trailer.menuSize=serialisedMenu.size();
+	outputFile_.write( serialisedMenu.data(), serialisedMenu.size() );
+	outputFile_.write( reinterpret_cast<const char*>(quantisations_.data()), quantisations_.size()*sizeof(ParameterQuantisation) );
+
+	trailer.indexOffset=outputFile_.tellp();
+	outputFile_.write( reinterpret_cast<const char*>(index_.data()), index_.size()*sizeof(ChunkIndexEntry) );
+
+	trailer.sumOfWeights=sumOfWeights;
+	outputFile_.write( reinterpret_cast<const char*>(&trailer), sizeof(trailer) );
+
+	outputFile_.close();
+	if( !outputFile_ ) throw std::runtime_error( "ChunkedSampleFileWriter - error while writing the file" );
+}
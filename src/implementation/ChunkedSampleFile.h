@@ -0,0 +1,158 @@
+#ifndef l1menu_implementation_ChunkedSampleFile_h
+#define l1menu_implementation_ChunkedSampleFile_h
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <stdint.h>
+#include <stddef.h> // required for size_t
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	class ReducedEventBlock;
+	namespace implementation
+	{
+		class MappedFile;
+	}
+}
+
+
+namespace l1menu
+{
+	namespace implementation
+	{
+		/** @brief Describes where one chunk is in a chunked ReducedSample file.
+		 *
+		 * The layout of a chunked file (ReducedSample file format version 3) is:
+		 *  - Whatever header the caller gave to ChunkedSampleFileWriter (the magic number and version).
+		 *  - Each chunk, compressed on its own with zlib. Uncompressed, a chunk is the column of event
+		 *    weights followed by each of the parameter columns that aren't quantised, all numberOfEvents
+		 *    floats long, and then each of the quantised parameter columns as uint16_t. Before compression
+		 *    the bytes of the float part are shuffled so that the first byte of every float comes first,
+		 *    then the second byte of every float and so on, which makes it compress a lot better. The
+		 *    quantised part is shuffled the same way.
+		 *  - The serialised trigger menu.
+		 *  - Optionally, a ParameterQuantisation for every parameter. Files without any quantised
+		 *    parameters leave this out, so the index follows straight on from the menu.
+		 *  - A ChunkIndexEntry for each chunk.
+		 *  - A ChunkedFileTrailer, right at the end of the file.
+		 * Because the index is at the end, the file can be written in one pass without knowing how
+		 * many chunks there'll be. Numbers are stored in the byte order of the machine that wrote
+		 * the file.
+		 */
+		struct ChunkIndexEntry
+		{
+			uint64_t offset; ///< Bytes from the start of the file
+			uint64_t compressedSize;
+			uint64_t numberOfEvents;
+		};
+
+		/** @brief How a parameter is stored in a chunked ReducedSample file, either as a float or as a 16 bit step number.
+		 *
+		 * Quantised values are stored as (value-offset)/scale, except for -1 (the event can never pass)
+		 * which is stored as NEVER_PASSES. The scale is always a power of two, and a parameter is only
+		 * quantised if every value comes back exactly the same, so the rates don't change at all.
+		 */
+		struct ParameterQuantisation
+		{
+			static const uint16_t NEVER_PASSES=0xffff;
+			float scale; ///< Zero if the parameter isn't quantised and is stored as a float
+			float offset;
+
+			bool isQuantised() const { return scale!=0; }
+			uint16_t quantise( float value ) const;
+			float dequantise( uint16_t quantisedValue ) const;
+		};
+
+		/** @brief Finds the coarsest step for each parameter that stores every value exactly in 16 bits.
+		 *
+		 * Parameters where no power of two step between 1/256 and 16 works are left as floats. The
+		 * parameters are looked at in parallel on l1menu::tools::ThreadPool.
+		 */
+		std::vector<ParameterQuantisation> findParameterQuantisations( const std::vector<l1menu::ReducedEventBlock>& eventBlocks, size_t numberOfParameters );
+
+		/** @brief The fixed size trailer at the end of a chunked ReducedSample file. See ChunkIndexEntry for the layout. */
+		struct ChunkedFileTrailer
+		{
+			uint64_t byteOrderMark;
+			uint64_t numberOfParameters;
+			uint64_t numberOfChunks;
+			uint64_t menuOffset;
+			uint64_t menuSize;
+			uint64_t indexOffset;
+			double sumOfWeights;
+		};
+
+		/** @brief Reads a chunked ReducedSample file, decompressing any chunk on request.
+		 *
+		 * The file is memory mapped and only the trailer and index are read when it's opened, so
+		 * a range of events can be read by just decompressing the chunks that hold them. readChunk()
+		 * can be called from several threads at once.
+		 */
+		class ChunkedSampleFileReader
+		{
+		public:
+			/** @brief Opens the file and reads the index. Throws a std::runtime_error if the file is corrupt. */
+			explicit ChunkedSampleFileReader( const std::string& filename );
+			~ChunkedSampleFileReader();
+
+			/** @brief The trigger menu as a serialised protobuf SampleHeader. */
+			std::string serialisedMenu() const;
+			size_t numberOfParameters() const;
+			/** @brief Empty if none of the parameters are quantised, otherwise one entry per parameter. */
+			const std::vector<ParameterQuantisation>& parameterQuantisations() const;
+			size_t numberOfEvents() const;
+			double sumOfWeights() const;
+
+			size_t numberOfChunks() const;
+			size_t chunkNumberOfEvents( size_t chunkNumber ) const;
+			/** @brief The event number, counting from the start of the file, of the first event in the chunk. */
+			size_t chunkFirstEvent( size_t chunkNumber ) const;
+			/** @brief The chunk holding the given event. Throws a std::out_of_range if there aren't that many events. */
+			size_t chunkContainingEvent( size_t eventNumber ) const;
+
+			/** @brief Decompresses the chunk into output, as the weights column followed by each parameter column. Quantised parameters are converted back to floats. */
+			void readChunk( size_t chunkNumber, std::vector<float>& output ) const;
+		private:
+			std::unique_ptr<l1menu::implementation::MappedFile> pMappedFile_;
+			ChunkedFileTrailer trailer_;
+			std::vector<ParameterQuantisation> quantisations_;
+			std::vector<ChunkIndexEntry> index_;
+			std::vector<size_t> chunkFirstEvents_;
+		};
+
+		/** @brief Writes a chunked ReducedSample file. See ChunkIndexEntry for the layout.
+		 *
+		 * Chunks are written as they're added so only the index is kept in memory. Nothing is valid
+		 * until close() has been called to write the trailer.
+		 */
+		class ChunkedSampleFileWriter
+		{
+		public:
+			/** @brief Opens the file and writes the supplied header bytes at the start.
+			 *
+			 * @param[in] quantisations  Either empty to store every parameter as a float, or one entry per
+			 *                           parameter, e.g. from findParameterQuantisations().
+			 */
+			ChunkedSampleFileWriter( const std::string& filename, const std::string& fileHeader, size_t numberOfParameters, const std::vector<ParameterQuantisation>& quantisations=std::vector<ParameterQuantisation>() );
+
+			/** @brief Compresses the blocks in parallel on the ThreadPool and writes them in order, one chunk per block. */
+			void addChunks( const std::vector<l1menu::ReducedEventBlock>& blocks );
+
+			/** @brief Writes the menu, the index and the trailer, and closes the file. */
+			void close( const std::string& serialisedMenu, double sumOfWeights );
+		private:
+			std::ofstream outputFile_;
+			size_t numberOfParameters_;
+			std::vector<ParameterQuantisation> quantisations_;
+			std::vector<ChunkIndexEntry> index_;
+		};
+
+	} // end of namespace implementation
+} // end of namespace l1menu
+
+#endif
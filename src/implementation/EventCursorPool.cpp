@@ -0,0 +1,42 @@
+#include "EventCursorPool.h"
+
+#include "l1menu/ISample.h"
+#include "l1menu/IEventCursor.h"
+
+l1menu::implementation::EventCursorPool::Sentry::Sentry( EventCursorPool& pool )
+	: pool_(pool)
+{
+	{ // Block to limit the scope of the lock
+		std::lock_guard<std::mutex> lock( pool_.mutex_ );
+		if( !pool_.freeCursors_.empty() )
+		{
+			pCursor_=std::move( pool_.freeCursors_.back() );
+			pool_.freeCursors_.pop_back();
+		}
+	}
+	// Create a new one outside of the lock because it can take a while
+	if( !pCursor_ ) pCursor_=pool_.sample_.createEventCursor();
+}
+
+l1menu::implementation::EventCursorPool::Sentry::~Sentry()
+{
+	std::lock_guard<std::mutex> lock( pool_.mutex_ );
+	pool_.freeCursors_.push_back( std::move(pCursor_) );
+}
+
+l1menu::IEventCursor& l1menu::implementation::EventCursorPool::Sentry::cursor()
+{
+	return *pCursor_;
+}
+
+l1menu::implementation::EventCursorPool::EventCursorPool( const l1menu::ISample& sample )
+	: sample_(sample)
+{
+	// No operation besides the initialiser list
+}
+
+l1menu::implementation::EventCursorPool::~EventCursorPool()
+{
+	// No operation. Just need one defined otherwise the default one messes up
+	// the unique_ptr deletion because IEventCursor is only forward declared.
+}
@@ -0,0 +1,54 @@
+#ifndef l1menu_implementation_EventCursorPool_h
+#define l1menu_implementation_EventCursorPool_h
+
+#include <vector>
+#include <memory>
+#include <mutex>
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	class ISample;
+	class IEventCursor;
+}
+
+
+namespace l1menu
+{
+	namespace implementation
+	{
+		/** @brief Hands out event cursors to tasks running on the ThreadPool, reusing them between tasks.
+		 *
+		 * Creating a cursor can be expensive (for FullSample it means opening all of the input files
+		 * again) so cursors are returned to the pool when a task has finished with them. At most one
+		 * cursor per thread is ever created.
+		 */
+		class EventCursorPool
+		{
+		public:
+			/** @brief Holds a cursor from the pool and gives it back when it goes out of scope. */
+			class Sentry
+			{
+			public:
+				Sentry( EventCursorPool& pool );
+				~Sentry();
+				l1menu::IEventCursor& cursor();
+			private:
+				EventCursorPool& pool_;
+				std::unique_ptr<l1menu::IEventCursor> pCursor_;
+			};
+		public:
+			EventCursorPool( const l1menu::ISample& sample );
+			~EventCursorPool();
+		private:
+			const l1menu::ISample& sample_;
+			std::mutex mutex_;
+			std::vector< std::unique_ptr<l1menu::IEventCursor> > freeCursors_;
+		}; // end of class EventCursorPool
+
+	} // end of namespace implementation
+} // end of namespace l1menu
+
+#endif
@@ -0,0 +1,67 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+l1menu::implementation::MappedFile::MappedFile( const std::string& filename )
+	: pData_(nullptr), size_(0)
+{
+	int fileDescriptor=open( filename.c_str(), O_RDONLY );
+	if( fileDescriptor<0 ) throw std::runtime_error( "MappedFile - couldn't open file \""+filename+"\"" );
+
+	struct stat fileStatus;
+	if( fstat( fileDescriptor, &fileStatus )!=0 )
+	{
+		close( fileDescriptor );
+		throw std::runtime_error( "MappedFile - couldn't get the size of file \""+filename+"\"" );
+	}
+	size_=fileStatus.st_size;
+
+	// mmap refuses zero length mappings, so leave pData_ null for empty files
+	if( size_>0 )
+	{
+		void* pMapping=mmap( nullptr, size_, PROT_READ, MAP_SHARED, fileDescriptor, 0 );
+		if( pMapping==MAP_FAILED )
+		{
+			close( fileDescriptor );
+			throw std::runtime_error( "MappedFile - couldn't map file \""+filename+"\" into memory" );
+		}
+		pData_=static_cast<const char*>( pMapping );
+	}
+
+	// The mapping stays valid after the file is closed
+	close( fileDescriptor );
+}
+
+l1menu::implementation::MappedFile::~MappedFile()
+{
+	if( pData_!=nullptr ) munmap( const_cast<char*>(pData_), size_ );
+}
+
+const char* l1menu::implementation::MappedFile::data() const
+{
+	return pData_;
+}
+
+size_t l1menu::implementation::MappedFile::size() const
+{
+	return size_;
+}
+
+void l1menu::implementation::MappedFile::releaseMemory( size_t offset, size_t size ) const
+{
+	if( pData_==nullptr || offset>=size_ ) return;
+	if( size>size_-offset ) size=size_-offset;
+
+	// madvise needs a page aligned start, so round the start up and the end down to page boundaries
+	const size_t pageSize=sysconf( _SC_PAGESIZE );
+	const size_t firstPage=(offset+pageSize-1)/pageSize*pageSize;
+	const size_t endOfLastPage=(offset+size)/pageSize*pageSize;
+	if( endOfLastPage<=firstPage ) return;
+
+	// This is only advice, so there's nothing useful to do if it fails
+	madvise( const_cast<char*>(pData_)+firstPage, endOfLastPage-firstPage, MADV_DONTNEED );
+}
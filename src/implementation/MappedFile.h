@@ -0,0 +1,42 @@
+#ifndef l1menu_implementation_MappedFile_h
+#define l1menu_implementation_MappedFile_h
+
+#include <string>
+#include <stddef.h> // required for size_t
+
+namespace l1menu
+{
+	namespace implementation
+	{
+		/** @brief Maps a whole file into memory read only, and unmaps it when destroyed.
+		 *
+		 * Nothing is actually read until the memory is accessed, and the pages are shared with
+		 * anything else that has the same file mapped (or in the page cache), so this is a cheap
+		 * way of getting at large files.
+		 */
+		class MappedFile
+		{
+		public:
+			/** @brief Maps the file. Throws a std::runtime_error if the file can't be opened or mapped. */
+			explicit MappedFile( const std::string& filename );
+			~MappedFile();
+
+			const char* data() const;
+			size_t size() const;
+			/** @brief Tells the kernel the given range won't be needed again soon, so it no longer counts towards this process's memory.
+			 *
+			 * Only whole pages inside the range are released. The data can still be read afterwards, it
+			 * just has to come back from the page cache or the disk.
+			 */
+			void releaseMemory( size_t offset, size_t size ) const;
+		private:
+			MappedFile( const MappedFile& otherMappedFile ) = delete;
+			MappedFile& operator=( const MappedFile& otherMappedFile ) = delete;
+			const char* pData_;
+			size_t size_;
+		};
+
+	} // end of namespace implementation
+} // end of namespace l1menu
+
+#endif
@@ -6,89 +6,182 @@
 #include <stdexcept>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
 #include "l1menu/ITrigger.h"
 #include "l1menu/ICachedTrigger.h"
 #include "l1menu/ITriggerRate.h"
 #include "l1menu/TriggerMenu.h"
 #include "l1menu/ISample.h"
 #include "l1menu/IEvent.h"
+#include "l1menu/IEventCursor.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/ReducedEventBlock.h"
 #include "l1menu/TriggerRatePlot.h"
 #include "l1menu/MenuRatePlots.h"
 #include "TriggerRateImplementation.h"
 #include "TriggerDescriptionWithErrorsFromXML.h"
+#include "EventCursorPool.h"
+#include "TriggerPassBits.h"
 #include "l1menu/tools/XMLFile.h"
 #include "l1menu/tools/XMLElement.h"
 #include "l1menu/tools/fileIO.h"
+#include "l1menu/tools/ThreadPool.h"
 
-
-void l1menu::implementation::MenuRateImplementation::commonConstruction( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample )
+namespace // unnamed namespace
 {
+	typedef l1menu::implementation::MenuRateImplementation::WeightSums WeightSums;
 
-	// The sum of event weights that pass each trigger
-	std::vector<float> weightOfEventsPassed( menu.numberOfTriggers() );
-	// The sume of weights squared that pass each trigger. Used to calculate the error.
-	std::vector<float> weightSquaredOfEventsPassed( menu.numberOfTriggers() );
+	/** @brief Adds the weights for events in the range [firstEvent,lastEvent), using the general IEvent interface. */
+	void addEventRange( WeightSums& sums, std::vector< std::unique_ptr<l1menu::ICachedTrigger> >& cachedTriggers, l1menu::IEventCursor& cursor, size_t firstEvent, size_t lastEvent )
+	{
+		size_t numberOfLastPassedTrigger=0; // This is just so I can work out the pure rate
 
-	// The number of events that only pass the given trigger
-	std::vector<float> weightOfEventsPure( menu.numberOfTriggers() );
-	std::vector<float> weightSquaredOfEventsPure( menu.numberOfTriggers() );
+		for( size_t eventNumber=firstEvent; eventNumber<lastEvent; ++eventNumber )
+		{
+			const l1menu::IEvent& event=cursor.getEvent(eventNumber);
+			double weight=event.weight();
+			sums.weightOfAllEvents+=weight;
 
-	float weightOfEventsPassingAnyTrigger=0;
-	float weightSquaredOfEventsPassingAnyTrigger=0;
-	float weightOfAllEvents=0;
+			size_t numberOfTriggersPassed=0;
 
-	// Using cached triggers significantly increases speed for ReducedSample
-	// because it cuts out expensive string comparisons when querying the trigger
-	// parameters.
-	std::vector< std::unique_ptr<l1menu::ICachedTrigger> > cachedTriggers;
-	for( size_t triggerNumber=0; triggerNumber<menu.numberOfTriggers(); ++triggerNumber )
-	{
-		cachedTriggers.push_back( sample.createCachedTrigger( menu.getTrigger( triggerNumber ) ) );
-	}
+			for( size_t triggerNumber=0; triggerNumber<cachedTriggers.size(); ++triggerNumber )
+			{
+				if( cachedTriggers[triggerNumber]->apply(event) )
+				{
+					// If the event passes the trigger, increment the counters
+					++numberOfTriggersPassed;
+					sums.weightOfEventsPassed[triggerNumber]+=weight;
+					sums.weightSquaredOfEventsPassed[triggerNumber]+=(weight*weight);
+					numberOfLastPassedTrigger=triggerNumber; // If only one event passes, this is used to increment the pure counter
+				}
+			}
 
-	size_t numberOfLastPassedTrigger=0; // This is just so I can work out the pure rate
+			// See if I should increment any of the pure or total counters
+			if( numberOfTriggersPassed==1 )
+			{
+				sums.weightOfEventsPure[numberOfLastPassedTrigger]+=weight;
+				sums.weightSquaredOfEventsPure[numberOfLastPassedTrigger]+=(weight*weight);
+			}
+			if( numberOfTriggersPassed>0 )
+			{
+				sums.weightOfEventsPassingAnyTrigger+=weight;
+				sums.weightSquaredOfEventsPassingAnyTrigger+=(weight*weight);
+			}
+		}
+	}
 
-	for( size_t eventNumber=0; eventNumber<sample.numberOfEvents(); ++eventNumber )
+	/** @brief The sums for each chunk of events in [firstChunk,lastChunk), using the general IEvent interface.
+	 *
+	 * Each chunk is EVENTS_PER_CHUNK events, and the chunks are shared out between threads, each
+	 * reading through its own event cursor. The chunk size doesn't depend on the number of threads,
+	 * so as long as the sums are combined in chunk order the result is the same however many threads
+	 * are used.
+	 */
+	std::vector<WeightSums> chunkSumsForEvents( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample, size_t firstChunk, size_t lastChunk )
 	{
-		const l1menu::IEvent& event=sample.getEvent(eventNumber);
-		float weight=event.weight();
-		weightOfAllEvents+=weight;
-
-		size_t numberOfTriggersPassed=0;
+		const size_t eventsPerChunk=l1menu::implementation::MenuRateImplementation::EVENTS_PER_CHUNK;
 
-		for( size_t triggerNumber=0; triggerNumber<cachedTriggers.size(); ++triggerNumber )
+		l1menu::implementation::EventCursorPool cursorPool( sample );
+		std::vector<WeightSums> chunkSums( lastChunk-firstChunk, WeightSums(menu.numberOfTriggers()) );
+		l1menu::tools::ThreadPool::instance().run( chunkSums.size(), [&]( size_t taskNumber )
 		{
-			if( cachedTriggers[triggerNumber]->apply(event) )
+			// Using cached triggers significantly increases speed for ReducedSample
+			// because it cuts out expensive string comparisons when querying the trigger
+			// parameters. They're cheap to create so just make a new set for each chunk.
+			std::vector< std::unique_ptr<l1menu::ICachedTrigger> > cachedTriggers;
+			for( size_t triggerNumber=0; triggerNumber<menu.numberOfTriggers(); ++triggerNumber )
 			{
-				// If the event passes the trigger, increment the counters
-				++numberOfTriggersPassed;
-				weightOfEventsPassed[triggerNumber]+=weight;
-				weightSquaredOfEventsPassed[triggerNumber]+=(weight*weight);
-				numberOfLastPassedTrigger=triggerNumber; // If only one event passes, this is used to increment the pure counter
+				cachedTriggers.push_back( sample.createCachedTrigger( menu.getTrigger( triggerNumber ) ) );
 			}
-		}
 
-		// See if I should increment any of the pure or total counters
-		if( numberOfTriggersPassed==1 )
-		{
-			weightOfEventsPure[numberOfLastPassedTrigger]+=weight;
-			weightSquaredOfEventsPure[numberOfLastPassedTrigger]+=(weight*weight);
-		}
-		if( numberOfTriggersPassed>0 )
+			l1menu::implementation::EventCursorPool::Sentry cursorSentry( cursorPool );
+			const size_t firstEvent=(firstChunk+taskNumber)*eventsPerChunk;
+			const size_t lastEvent=std::min( firstEvent+eventsPerChunk, sample.numberOfEvents() );
+			addEventRange( chunkSums[taskNumber], cachedTriggers, cursorSentry.cursor(), firstEvent, lastEvent );
+		} );
+
+		return chunkSums;
+	}
+
+	/** @brief Version of chunkSumsForEvents for ReducedSample where each chunk is one block of events.
+	 *
+	 * The blocks are split between threads, and each block gets its own partial sums. The
+	 * columns are read directly rather than going through the IEvent interface.
+	 */
+	std::vector<WeightSums> chunkSumsForEvents( const l1menu::TriggerMenu& menu, const l1menu::ReducedSample& sample, size_t firstBlock, size_t lastBlock )
+	{
+		// For each trigger, make a note of which columns need to be checked and what the
+		// threshold for each one is. This avoids any string comparisons in the loops.
+		const auto triggerThresholds=l1menu::implementation::TriggerPassBits::triggerThresholds( menu, sample );
+
+		std::vector<WeightSums> blockSums( lastBlock-firstBlock, WeightSums(menu.numberOfTriggers()) );
+		l1menu::tools::ThreadPool::instance().run( blockSums.size(), [&]( size_t taskNumber )
 		{
-			weightOfEventsPassingAnyTrigger+=weight;
-			weightSquaredOfEventsPassingAnyTrigger+=(weight*weight);
-		}
+			l1menu::implementation::MenuRateImplementation::addEventBlock( blockSums[taskNumber], triggerThresholds, sample.eventBlock(firstBlock+taskNumber) );
+		} );
+
+		return blockSums;
 	}
 
-	float scaling=sample.eventRate();
+} // end of the unnamed namespace
 
-	for( size_t triggerNumber=0; triggerNumber<cachedTriggers.size(); ++triggerNumber )
+/*
+ * Rather than going event by event through the IEvent interface, each trigger is applied to the
+ * whole block at once to get a bit per event, and the pure and total rates come from combining
+ * those bits a word at a time.
+ */
+void l1menu::implementation::MenuRateImplementation::addEventBlock( WeightSums& sums, const std::vector<TriggerPassBits::TriggerThresholds>& triggerThresholds, const l1menu::ReducedEventBlock& eventBlock )
+{
+	const float* pWeights=eventBlock.weights();
+	for( size_t eventNumber=0; eventNumber<eventBlock.numberOfEvents(); ++eventNumber ) sums.weightOfAllEvents+=pWeights[eventNumber];
+
+	l1menu::implementation::TriggerPassBits passBits( triggerThresholds, eventBlock );
+	for( size_t triggerNumber=0; triggerNumber<passBits.numberOfTriggers(); ++triggerNumber )
+	{
+		passBits.sumWeights( passBits.triggerBits(triggerNumber), sums.weightOfEventsPassed[triggerNumber], sums.weightSquaredOfEventsPassed[triggerNumber] );
+		// Pure means passes this trigger and no others
+		passBits.sumWeightsExcluding( passBits.triggerBits(triggerNumber), passBits.moreThanOneTriggerBits(), sums.weightOfEventsPure[triggerNumber], sums.weightSquaredOfEventsPure[triggerNumber] );
+	}
+	passBits.sumWeights( passBits.anyTriggerBits(), sums.weightOfEventsPassingAnyTrigger, sums.weightSquaredOfEventsPassingAnyTrigger );
+}
+
+const size_t l1menu::implementation::MenuRateImplementation::EVENTS_PER_CHUNK=20000;
+
+size_t l1menu::implementation::MenuRateImplementation::numberOfChunks( const l1menu::ISample& sample )
+{
+	const l1menu::ReducedSample* pReducedSample=dynamic_cast<const l1menu::ReducedSample*>(&sample);
+	if( pReducedSample!=nullptr ) return pReducedSample->numberOfEventBlocks();
+	else return (sample.numberOfEvents()+EVENTS_PER_CHUNK-1)/EVENTS_PER_CHUNK;
+}
+
+std::vector<l1menu::implementation::MenuRateImplementation::WeightSums> l1menu::implementation::MenuRateImplementation::chunkSums( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample, size_t firstChunk, size_t lastChunk )
+{
+	if( firstChunk>lastChunk || lastChunk>numberOfChunks(sample) ) throw std::runtime_error( "MenuRateImplementation::chunkSums - the range of chunks isn't inside the sample" );
+
+	// ReducedSample stores its events in columns, which are much faster to loop
+	// over directly than going through the IEvent interface.
+	const l1menu::ReducedSample* pReducedSample=dynamic_cast<const l1menu::ReducedSample*>(&sample);
+	if( pReducedSample!=nullptr ) return chunkSumsForEvents( menu, *pReducedSample, firstChunk, lastChunk );
+	else return chunkSumsForEvents( menu, sample, firstChunk, lastChunk );
+}
+
+void l1menu::implementation::MenuRateImplementation::commonConstruction( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample )
+{
+	// Combine the partial sums in chunk order, so the result doesn't depend on the number of threads
+	WeightSums sums( menu.numberOfTriggers() );
+	for( const auto& chunkSum : chunkSums( menu, sample, 0, numberOfChunks(sample) ) ) sums.add( chunkSum );
+
+	setRatesFromSums( menu, sums, sample.eventRate() );
+}
+
+void l1menu::implementation::MenuRateImplementation::setRatesFromSums( const l1menu::TriggerMenu& menu, const WeightSums& sums, float scaling )
+{
+	for( size_t triggerNumber=0; triggerNumber<menu.numberOfTriggers(); ++triggerNumber )
 	{
-		float fraction=weightOfEventsPassed[triggerNumber]/weightOfAllEvents;
-		float fractionError=std::sqrt(weightSquaredOfEventsPassed[triggerNumber])/weightOfAllEvents;
-		float pureFraction=weightOfEventsPure[triggerNumber]/weightOfAllEvents;
-		float pureFractionError=std::sqrt(weightSquaredOfEventsPure[triggerNumber])/weightOfAllEvents;
+		float fraction=sums.weightOfEventsPassed[triggerNumber]/sums.weightOfAllEvents;
+		float fractionError=std::sqrt(sums.weightSquaredOfEventsPassed[triggerNumber])/sums.weightOfAllEvents;
+		float pureFraction=sums.weightOfEventsPure[triggerNumber]/sums.weightOfAllEvents;
+		float pureFractionError=std::sqrt(sums.weightSquaredOfEventsPure[triggerNumber])/sums.weightOfAllEvents;
 		triggerRates_.push_back( std::move(TriggerRateImplementation(menu.getTrigger(triggerNumber),fraction,fractionError,fraction*scaling,fractionError*scaling,pureFraction,pureFractionError,pureFraction*scaling,pureFractionError*scaling) ) );
 		//triggerRates_.push_back( std::move(TriggerRateImplementation(menu.getTrigger(triggerNumber),weightOfEventsPassed[triggerNumber],weightSquaredOfEventsPassed[triggerNumber],weightOfEventsPure[triggerNumber],weightSquaredOfEventsPure[triggerNumber],*this)) );
 	}
@@ -96,8 +189,8 @@ void l1menu::implementation::MenuRateImplementation::commonConstruction( const l
 	//
 	// Now I have everything I need to calculate all of the values required by the interface
 	//
-	totalFraction_=weightOfEventsPassingAnyTrigger/weightOfAllEvents;
-	totalFractionError_=std::sqrt(weightSquaredOfEventsPassingAnyTrigger)/weightOfAllEvents;
+	totalFraction_=sums.weightOfEventsPassingAnyTrigger/sums.weightOfAllEvents;
+	totalFractionError_=std::sqrt(sums.weightSquaredOfEventsPassingAnyTrigger)/sums.weightOfAllEvents;
 	totalRate_=totalFraction_*scaling;
 	totalRateError_=totalFractionError_*scaling;
 }
@@ -110,6 +203,16 @@ l1menu::implementation::MenuRateImplementation::MenuRateImplementation( const l1
 l1menu::implementation::MenuRateImplementation::MenuRateImplementation( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample, const l1menu::MenuRatePlots& menuRatePlots )
 {
 	commonConstruction( menu, sample );
+	setThresholdErrors( menuRatePlots );
+}
+
+l1menu::implementation::MenuRateImplementation::MenuRateImplementation( const l1menu::TriggerMenu& menu, const WeightSums& sums, float eventRate )
+{
+	setRatesFromSums( menu, sums, eventRate );
+}
+
+void l1menu::implementation::MenuRateImplementation::setThresholdErrors( const l1menu::MenuRatePlots& menuRatePlots )
+{
 	// Loop over each of the trigger rates and try to set their threshold errors
 	// from the information in the rate plots.
 	for( auto& triggerRate : triggerRates_ )
@@ -4,6 +4,7 @@
 #include "l1menu/IMenuRate.h"
 #include <vector>
 #include "TriggerRateImplementation.h"
+#include "TriggerPassBits.h"
 
 //
 // Forward declarations
@@ -14,6 +15,7 @@ namespace l1menu
 	class ITriggerRate;
 	class TriggerMenu;
 	class ISample;
+	class ReducedEventBlock;
 	class MenuRatePlots;
 	namespace tools
 	{
@@ -33,18 +35,83 @@ namespace l1menu
 		 */
 		class MenuRateImplementation : public l1menu::IMenuRate
 		{
+		public:
+			/** @brief The sums of event weights required to calculate the rates, grouped together so they can be passed around.
+			 *
+			 * Sums are kept in double precision because there can be tens of millions of events, and the
+			 * partial sums from different blocks of events are added together at the end.
+			 */
+			struct WeightSums
+			{
+				explicit WeightSums( size_t numberOfTriggers )
+					: weightOfEventsPassed(numberOfTriggers), weightSquaredOfEventsPassed(numberOfTriggers),
+					  weightOfEventsPure(numberOfTriggers), weightSquaredOfEventsPure(numberOfTriggers),
+					  weightOfEventsPassingAnyTrigger(0), weightSquaredOfEventsPassingAnyTrigger(0), weightOfAllEvents(0) {}
+				/** @brief Adds the sums from another instance, e.g. the partial sums from a different block of events. */
+				void add( const WeightSums& other )
+				{
+					for( size_t index=0; index<weightOfEventsPassed.size(); ++index )
+					{
+						weightOfEventsPassed[index]+=other.weightOfEventsPassed[index];
+						weightSquaredOfEventsPassed[index]+=other.weightSquaredOfEventsPassed[index];
+						weightOfEventsPure[index]+=other.weightOfEventsPure[index];
+						weightSquaredOfEventsPure[index]+=other.weightSquaredOfEventsPure[index];
+					}
+					weightOfEventsPassingAnyTrigger+=other.weightOfEventsPassingAnyTrigger;
+					weightSquaredOfEventsPassingAnyTrigger+=other.weightSquaredOfEventsPassingAnyTrigger;
+					weightOfAllEvents+=other.weightOfAllEvents;
+				}
+				// The sum of event weights that pass each trigger
+				std::vector<double> weightOfEventsPassed;
+				// The sume of weights squared that pass each trigger. Used to calculate the error.
+				std::vector<double> weightSquaredOfEventsPassed;
+				// The number of events that only pass the given trigger
+				std::vector<double> weightOfEventsPure;
+				std::vector<double> weightSquaredOfEventsPure;
+				double weightOfEventsPassingAnyTrigger;
+				double weightSquaredOfEventsPassingAnyTrigger;
+				double weightOfAllEvents;
+			};
 		public:
 			MenuRateImplementation();
 			MenuRateImplementation( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample );
 			MenuRateImplementation( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample, const l1menu::MenuRatePlots& menuRatePlots );
+			/** @brief Create from sums that have already been calculated, e.g. by IncrementalMenuRate. */
+			MenuRateImplementation( const l1menu::TriggerMenu& menu, const WeightSums& sums, float eventRate );
 			MenuRateImplementation( const l1menu::tools::XMLElement& xmlDescription );
 
+			/** @brief The size of the chunks used for samples other than ReducedSample, see numberOfChunks(). */
+			static const size_t EVENTS_PER_CHUNK;
+
+			/** @brief The number of chunks the sample is split into to share the work out, see chunkSums().
+			 *
+			 * For ReducedSample each block of events is a chunk, otherwise it's every EVENTS_PER_CHUNK events.
+			 */
+			static size_t numberOfChunks( const l1menu::ISample& sample );
+
+			/** @brief The sums for each chunk in [firstChunk,lastChunk), worked out in parallel on l1menu::tools::ThreadPool.
+			 *
+			 * Adding these to an empty WeightSums in chunk order gives exactly the sums that the ISample
+			 * constructors use, which is what lets PartialMenuRate split the work between processes.
+			 * @throw  std::runtime_error if the range isn't inside the sample.
+			 */
+			static std::vector<WeightSums> chunkSums( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample, size_t firstChunk, size_t lastChunk );
+
+			/** @brief Adds the weights for one block of ReducedSample events to the sums.
+			 *
+			 * Works directly on the threshold columns. Public so that the sums can be built up one block at
+			 * a time while a file is read, see ReducedSample::rateFromFile().
+			 */
+			static void addEventBlock( WeightSums& sums, const std::vector<TriggerPassBits::TriggerThresholds>& triggerThresholds, const l1menu::ReducedEventBlock& eventBlock );
+
 			// Methods to allow modification of the underlying data
 			void setTotalFraction( float totalFraction );
 			void setTotalFractionError( float totalFractionError );
 			void setTotalRate( float totalRate );
 			void setTotalRateError( float totalRateError );
 			void addTriggerRate( l1menu::implementation::TriggerRateImplementation&& triggerRate );
+			/** @brief Uses the rate plots to set the errors on the main threshold of each trigger, where a matching plot can be found. */
+			void setThresholdErrors( const l1menu::MenuRatePlots& menuRatePlots );
 
 			// Methods required by the l1menu::IMenuRate interface
 			virtual float totalFraction() const;
@@ -60,6 +127,7 @@ namespace l1menu
 			std::vector<TriggerRateImplementation> triggerRates_;
 		private:
 			void commonConstruction( const l1menu::TriggerMenu& menu, const l1menu::ISample& sample );
+			void setRatesFromSums( const l1menu::TriggerMenu& menu, const WeightSums& sums, float scaling );
 			mutable std::vector<const l1menu::ITriggerRate*> baseClassPointers_; ///< Vector to return for calls to triggerRates()
 		};
 
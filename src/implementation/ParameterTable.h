@@ -0,0 +1,60 @@
+#ifndef l1menu_implementation_ParameterTable_h
+#define l1menu_implementation_ParameterTable_h
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <stddef.h> // required for size_t
+
+namespace l1menu
+{
+	namespace implementation
+	{
+		/** @brief Static description of the parameters of an ITrigger implementation, so that they can be looked up by index.
+		 *
+		 * Holds the parameter names and a pointer to the member variable for each one. The trigger
+		 * classes each have a single static instance, so that a name only has to be compared once
+		 * to get an index (see ITrigger::parameterIndex) and after that the parameter can be
+		 * accessed directly.
+		 */
+		template<class T>
+		class ParameterTable
+		{
+		public:
+			typedef float T::*MemberPointer;
+
+			/** @brief Takes the parameter names and the member variables they refer to, in the order they should be listed. */
+			ParameterTable( std::initializer_list< std::pair<std::string,MemberPointer> > parameters )
+			{
+				for( const auto& parameter : parameters )
+				{
+					names_.push_back( parameter.first );
+					members_.push_back( parameter.second );
+				}
+			}
+
+			const std::vector<std::string>& names() const { return names_; }
+
+			/** @brief The position of the named parameter in names(). Throws a std::logic_error if there isn't one. */
+			size_t index( const std::string& parameterName ) const
+			{
+				for( size_t index=0; index<names_.size(); ++index )
+				{
+					if( names_[index]==parameterName ) return index;
+				}
+				throw std::logic_error( "Not a valid parameter name" );
+			}
+
+			float& parameter( T& object, size_t index ) const { return object.*members_.at(index); }
+			const float& parameter( const T& object, size_t index ) const { return object.*members_.at(index); }
+		private:
+			std::vector<std::string> names_;
+			std::vector<MemberPointer> members_;
+		};
+
+	} // end of namespace implementation
+} // end of namespace l1menu
+
+#endif
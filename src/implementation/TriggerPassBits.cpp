@@ -0,0 +1,225 @@
+#include "TriggerPassBits.h"
+
+#include <algorithm>
+#include "l1menu/TriggerMenu.h"
+#include "l1menu/ITrigger.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/ReducedEventBlock.h"
+
+const size_t l1menu::implementation::TriggerPassBits::BITS_PER_WORD;
+
+std::vector<l1menu::implementation::TriggerPassBits::TriggerThresholds> l1menu::implementation::TriggerPassBits::triggerThresholds( const l1menu::TriggerMenu& menu, const l1menu::ReducedSample& sample )
+{
+	std::vector<TriggerThresholds> returnValue( menu.numberOfTriggers() );
+	for( size_t triggerNumber=0; triggerNumber<menu.numberOfTriggers(); ++triggerNumber )
+	{
+		const l1menu::ITrigger& trigger=menu.getTrigger( triggerNumber );
+		for( const auto& identifier : sample.getTriggerParameterIdentifiers(trigger) )
+		{
+			returnValue[triggerNumber].push_back( std::make_pair( identifier.second, trigger.parameter(identifier.first) ) );
+		}
+	}
+	return returnValue;
+}
+
+l1menu::implementation::TriggerPassBits::TriggerPassBits( const std::vector<TriggerThresholds>& triggerThresholds, const l1menu::ReducedEventBlock& eventBlock )
+	: numberOfTriggers_( triggerThresholds.size() ),
+	  numberOfWords_( (eventBlock.numberOfEvents()+BITS_PER_WORD-1)/BITS_PER_WORD ),
+	  numberOfEvents_( eventBlock.numberOfEvents() ),
+	  pWeights_( eventBlock.weights() ),
+	  weightsAreUniform_( true ),
+	  bits_( (numberOfTriggers_+2)*numberOfWords_, 0 )
+{
+	for( size_t eventNumber=1; eventNumber<numberOfEvents_ && weightsAreUniform_; ++eventNumber )
+	{
+		if( pWeights_[eventNumber]!=pWeights_[0] ) weightsAreUniform_=false;
+	}
+
+	Word* pAnyBits=&bits_[numberOfTriggers_*numberOfWords_];
+	Word* pMoreThanOneBits=&bits_[(numberOfTriggers_+1)*numberOfWords_];
+
+	for( size_t triggerNumber=0; triggerNumber<numberOfTriggers_; ++triggerNumber )
+	{
+		Word* pTriggerBits=&bits_[triggerNumber*numberOfWords_];
+		evaluateTrigger( triggerThresholds[triggerNumber], eventBlock, pTriggerBits );
+
+		for( size_t wordNumber=0; wordNumber<numberOfWords_; ++wordNumber )
+		{
+			pMoreThanOneBits[wordNumber]|=( pAnyBits[wordNumber] & pTriggerBits[wordNumber] );
+			pAnyBits[wordNumber]|=pTriggerBits[wordNumber];
+		}
+	}
+}
+
+void l1menu::implementation::TriggerPassBits::evaluateTrigger( const TriggerThresholds& thresholds, const l1menu::ReducedEventBlock& eventBlock, Word* pBits ) const
+{
+	// Events the trigger can never pass have -1 in every column. If all the thresholds are above
+	// that, only the events listed by candidateEvents() can pass, so if there aren't many of
+	// them just test those.
+	const bool allThresholdsAboveNeverPasses=std::all_of( thresholds.begin(), thresholds.end(), []( const std::pair<l1menu::ReducedEvent::ParameterID,float>& columnThresholdPair ){ return columnThresholdPair.second>-1; } );
+	const std::vector<uint32_t>* pCandidateEvents=nullptr;
+	if( !thresholds.empty() && allThresholdsAboveNeverPasses ) pCandidateEvents=eventBlock.candidateEvents( thresholds.front().first );
+	if( pCandidateEvents!=nullptr )
+	{
+		std::fill( pBits, pBits+numberOfWords_, 0 );
+		for( const uint32_t eventNumber : *pCandidateEvents )
+		{
+			bool passes=true;
+			for( const auto& columnThresholdPair : thresholds )
+			{
+				if( eventBlock.parameterValues( columnThresholdPair.first )[eventNumber]<columnThresholdPair.second )
+				{
+					passes=false;
+					break;
+				}
+			}
+			if( passes ) pBits[eventNumber/BITS_PER_WORD]|=Word(1)<<(eventNumber%BITS_PER_WORD);
+		}
+		return;
+	}
+
+	// Start by assuming every event passes, then knock out any that fail one of the
+	// thresholds. Note the comparison is written so that it gives exactly the same
+	// answer as the "value < threshold" check in ReducedEvent, including for NaNs.
+	// The bits past the end of the block in the last word are cleared.
+	std::fill( pBits, pBits+numberOfWords_, ~Word(0) );
+	if( numberOfEvents_%BITS_PER_WORD!=0 ) pBits[numberOfWords_-1]=(Word(1)<<(numberOfEvents_%BITS_PER_WORD))-1;
+
+	for( const auto& columnThresholdPair : thresholds )
+	{
+		const float* pValues=eventBlock.parameterValues( columnThresholdPair.first );
+		const float threshold=columnThresholdPair.second;
+		for( size_t wordNumber=0; wordNumber<numberOfWords_; ++wordNumber )
+		{
+			const size_t firstEvent=wordNumber*BITS_PER_WORD;
+			const size_t eventsInWord=std::min( BITS_PER_WORD, numberOfEvents_-firstEvent );
+			Word passMask=0;
+			for( size_t bit=0; bit<eventsInWord; ++bit ) passMask|=Word( !(pValues[firstEvent+bit]<threshold) )<<bit;
+			pBits[wordNumber]&=passMask;
+		}
+	}
+}
+
+bool l1menu::implementation::TriggerPassBits::changeTrigger( size_t triggerNumber, const TriggerThresholds& thresholds, const l1menu::ReducedEventBlock& eventBlock, std::vector<char>& pureEventsChanged )
+{
+	std::vector<Word> newBits( numberOfWords_ );
+	evaluateTrigger( thresholds, eventBlock, newBits.data() );
+	return setTriggerBits( triggerNumber, newBits.data(), pureEventsChanged );
+}
+
+bool l1menu::implementation::TriggerPassBits::clearTrigger( size_t triggerNumber, std::vector<char>& pureEventsChanged )
+{
+	std::vector<Word> newBits( numberOfWords_, 0 );
+	return setTriggerBits( triggerNumber, newBits.data(), pureEventsChanged );
+}
+
+bool l1menu::implementation::TriggerPassBits::setTriggerBits( size_t triggerNumber, const Word* pNewBits, std::vector<char>& pureEventsChanged )
+{
+	Word* pTriggerBits=&bits_[triggerNumber*numberOfWords_];
+	Word* pAnyBits=&bits_[numberOfTriggers_*numberOfWords_];
+	Word* pMoreThanOneBits=&bits_[(numberOfTriggers_+1)*numberOfWords_];
+
+	bool bitsChanged=false;
+	for( size_t wordNumber=0; wordNumber<numberOfWords_; ++wordNumber )
+	{
+		if( pTriggerBits[wordNumber]==pNewBits[wordNumber] ) continue;
+		bitsChanged=true;
+		pTriggerBits[wordNumber]=pNewBits[wordNumber];
+
+		// Work out the combined bits for this word again from scratch
+		const Word oldExactlyOne=pAnyBits[wordNumber] & ~pMoreThanOneBits[wordNumber];
+		Word anyBits=0;
+		Word moreThanOneBits=0;
+		for( size_t otherTrigger=0; otherTrigger<numberOfTriggers_; ++otherTrigger )
+		{
+			const Word otherBits=bits_[otherTrigger*numberOfWords_+wordNumber];
+			moreThanOneBits|=( anyBits & otherBits );
+			anyBits|=otherBits;
+		}
+		pAnyBits[wordNumber]=anyBits;
+		pMoreThanOneBits[wordNumber]=moreThanOneBits;
+
+		// Any trigger that passes an event which has gone from passing exactly one trigger
+		// to not, or the other way around, needs its pure sum recalculating.
+		const Word changedExactlyOne=oldExactlyOne ^ ( anyBits & ~moreThanOneBits );
+		if( changedExactlyOne==0 ) continue;
+		for( size_t otherTrigger=0; otherTrigger<numberOfTriggers_; ++otherTrigger )
+		{
+			if( bits_[otherTrigger*numberOfWords_+wordNumber] & changedExactlyOne ) pureEventsChanged[otherTrigger]=true;
+		}
+	}
+	// The trigger's own pure events change whenever its bits do
+	if( bitsChanged ) pureEventsChanged[triggerNumber]=true;
+
+	return bitsChanged;
+}
+
+size_t l1menu::implementation::TriggerPassBits::numberOfTriggers() const
+{
+	return numberOfTriggers_;
+}
+
+size_t l1menu::implementation::TriggerPassBits::numberOfWords() const
+{
+	return numberOfWords_;
+}
+
+const l1menu::implementation::TriggerPassBits::Word* l1menu::implementation::TriggerPassBits::triggerBits( size_t triggerNumber ) const
+{
+	return &bits_[triggerNumber*numberOfWords_];
+}
+
+const l1menu::implementation::TriggerPassBits::Word* l1menu::implementation::TriggerPassBits::anyTriggerBits() const
+{
+	return &bits_[numberOfTriggers_*numberOfWords_];
+}
+
+const l1menu::implementation::TriggerPassBits::Word* l1menu::implementation::TriggerPassBits::moreThanOneTriggerBits() const
+{
+	return &bits_[(numberOfTriggers_+1)*numberOfWords_];
+}
+
+template<class T_WordFunction>
+void l1menu::implementation::TriggerPassBits::sumWeights( T_WordFunction wordFunction, double& sum, double& sumOfSquares ) const
+{
+	if( weightsAreUniform_ )
+	{
+		size_t numberOfEventsSet=0;
+		for( size_t wordNumber=0; wordNumber<numberOfWords_; ++wordNumber ) numberOfEventsSet+=__builtin_popcountll( wordFunction(wordNumber) );
+		if( numberOfEventsSet==0 ) return;
+		const double weight=pWeights_[0];
+		sum+=numberOfEventsSet*weight;
+		sumOfSquares+=numberOfEventsSet*(weight*weight);
+		return;
+	}
+
+	// Weights differ, so have to go through each set bit. Lowest bit first so that the
+	// events are added in the same order as a plain loop over events would.
+	for( size_t wordNumber=0; wordNumber<numberOfWords_; ++wordNumber )
+	{
+		Word word=wordFunction(wordNumber);
+		while( word!=0 )
+		{
+			const size_t bit=__builtin_ctzll( word );
+			const double weight=pWeights_[wordNumber*BITS_PER_WORD+bit];
+			sum+=weight;
+			sumOfSquares+=(weight*weight);
+			word&=(word-1); // clear the lowest set bit
+		}
+	}
+}
+
+void l1menu::implementation::TriggerPassBits::sumWeights( const Word* pBits, double& sum, double& sumOfSquares ) const
+{
+	sumWeights( [pBits]( size_t wordNumber ){ return pBits[wordNumber]; }, sum, sumOfSquares );
+}
+
+void l1menu::implementation::TriggerPassBits::sumWeightsOfBoth( const Word* pBits, const Word* pOtherBits, double& sum, double& sumOfSquares ) const
+{
+	sumWeights( [pBits,pOtherBits]( size_t wordNumber ){ return pBits[wordNumber] & pOtherBits[wordNumber]; }, sum, sumOfSquares );
+}
+
+void l1menu::implementation::TriggerPassBits::sumWeightsExcluding( const Word* pBits, const Word* pVetoBits, double& sum, double& sumOfSquares ) const
+{
+	sumWeights( [pBits,pVetoBits]( size_t wordNumber ){ return pBits[wordNumber] & ~pVetoBits[wordNumber]; }, sum, sumOfSquares );
+}
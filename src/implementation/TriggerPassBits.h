@@ -0,0 +1,96 @@
+#ifndef l1menu_implementation_TriggerPassBits_h
+#define l1menu_implementation_TriggerPassBits_h
+
+#include <vector>
+#include <utility>
+#include <stdint.h>
+#include <stddef.h> // required for size_t
+#include "l1menu/ReducedEvent.h"
+
+//
+// Forward declarations
+//
+namespace l1menu
+{
+	class TriggerMenu;
+	class ReducedSample;
+	class ReducedEventBlock;
+}
+
+
+namespace l1menu
+{
+	namespace implementation
+	{
+		/** @brief Which events in a ReducedEventBlock pass each trigger in a menu, packed into bit vectors.
+		 *
+		 * Each trigger is applied to the whole block at once, one threshold column at a time, and the
+		 * result stored as one bit per event. Rates are then worked out with whole word operations,
+		 * e.g. the events that pass only trigger "i" are triggerBits(i) & ~moreThanOneTriggerBits(),
+		 * and the events that pass both "i" and "j" are triggerBits(i) & triggerBits(j).
+		 *
+		 * Event "n" of the block is bit (n % BITS_PER_WORD) of word (n / BITS_PER_WORD). Any bits
+		 * past the end of the block in the last word are always zero.
+		 */
+		class TriggerPassBits
+		{
+		public:
+			typedef uint64_t Word;
+			static const size_t BITS_PER_WORD=64;
+			/// The ParameterIDs a trigger needs to check, and the threshold for each one
+			typedef std::vector< std::pair<l1menu::ReducedEvent::ParameterID,float> > TriggerThresholds;
+
+			/** @brief Looks up the columns and thresholds for every trigger in the menu, to avoid string comparisons in loops. */
+			static std::vector<TriggerThresholds> triggerThresholds( const l1menu::TriggerMenu& menu, const l1menu::ReducedSample& sample );
+		public:
+			TriggerPassBits( const std::vector<TriggerThresholds>& triggerThresholds, const l1menu::ReducedEventBlock& eventBlock );
+
+			size_t numberOfTriggers() const;
+			size_t numberOfWords() const;
+
+			const Word* triggerBits( size_t triggerNumber ) const;
+			/** @brief Events that pass at least one trigger. */
+			const Word* anyTriggerBits() const;
+			/** @brief Events that pass two or more triggers. */
+			const Word* moreThanOneTriggerBits() const;
+
+			/** @brief Re-applies one trigger with new thresholds, and updates the "any" and "more than one" bits to match.
+			 *
+			 * Only the words where the trigger's bits change are looked at again, so this is much quicker
+			 * than re-evaluating the whole menu when a threshold only moves a little.
+			 *
+			 * @param[out] pureEventsChanged   Must have numberOfTriggers() entries. Set to true for every trigger whose
+			 *                                 pure events (triggerBits & ~moreThanOneTriggerBits) might have changed.
+			 *                                 Entries are never set to false.
+			 * @return  Whether any of the bits for the trigger changed.
+			 */
+			bool changeTrigger( size_t triggerNumber, const TriggerThresholds& thresholds, const l1menu::ReducedEventBlock& eventBlock, std::vector<char>& pureEventsChanged );
+			/** @brief Sets a trigger as passing no events at all, e.g. if it has been disabled. Otherwise the same as changeTrigger. */
+			bool clearTrigger( size_t triggerNumber, std::vector<char>& pureEventsChanged );
+
+			/** @brief Sum of weights, and weights squared, of the events set in bits. */
+			void sumWeights( const Word* pBits, double& sum, double& sumOfSquares ) const;
+			/** @brief Sum of weights, and weights squared, of the events set in both bits and otherBits. */
+			void sumWeightsOfBoth( const Word* pBits, const Word* pOtherBits, double& sum, double& sumOfSquares ) const;
+			/** @brief Sum of weights, and weights squared, of the events set in bits but not in vetoBits. */
+			void sumWeightsExcluding( const Word* pBits, const Word* pVetoBits, double& sum, double& sumOfSquares ) const;
+		private:
+			/** @brief Applies the thresholds to every event in the block, and puts the result in pBits. */
+			void evaluateTrigger( const TriggerThresholds& thresholds, const l1menu::ReducedEventBlock& eventBlock, Word* pBits ) const;
+			bool setTriggerBits( size_t triggerNumber, const Word* pNewBits, std::vector<char>& pureEventsChanged );
+			template<class T_WordFunction> void sumWeights( T_WordFunction wordFunction, double& sum, double& sumOfSquares ) const;
+
+			size_t numberOfTriggers_;
+			size_t numberOfWords_;
+			size_t numberOfEvents_;
+			const float* pWeights_;
+			/// Set if every event in the block has the same weight, in which case sums are just a popcount
+			bool weightsAreUniform_;
+			/// The bits for each trigger one after the other, then the "any" and "more than one" bits.
+			std::vector<Word> bits_;
+		}; // end of class TriggerPassBits
+
+	} // end of namespace implementation
+} // end of namespace l1menu
+
+#endif
@@ -0,0 +1,220 @@
+#include "l1menu/tools/ThreadPool.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+namespace // unnamed namespace
+{
+	/// Set for any thread that is running tasks, so that nested calls to run() can be spotted and done serially.
+	thread_local bool isRunningTasks=false;
+
+	/// The number of worker threads running in any pool, so that it can be checked before forking.
+	std::atomic<size_t> numberOfRunningWorkers(0);
+
+	/** @brief Calls the task for every number in the range on the calling thread. */
+	void runSerially( size_t numberOfTasks, const std::function<void(size_t)>& task )
+	{
+		std::exception_ptr pFirstException;
+		for( size_t taskNumber=0; taskNumber<numberOfTasks; ++taskNumber )
+		{
+			try{ task(taskNumber); }
+			catch(...) { if( !pFirstException ) pFirstException=std::current_exception(); }
+		}
+		if( pFirstException ) std::rethrow_exception( pFirstException );
+	}
+}
+
+//
+// Declare the pimple class
+//
+namespace l1menu
+{
+	namespace tools
+	{
+		class ThreadPoolPrivateMembers
+		{
+		public:
+			ThreadPoolPrivateMembers();
+			~ThreadPoolPrivateMembers();
+			void startWorkers( size_t numberOfWorkers );
+			void stopWorkers();
+			void workerLoop();
+			/// Takes tasks from the current job and runs them until there are none left
+			void processTasks();
+
+			/// Atomic so that numberOfThreads() can be read without waiting for a job to finish
+			std::atomic<size_t> numberOfThreads;
+			/// Protected by runMutex, since setNumberOfThreads() changes it
+			std::vector<std::thread> workers;
+			/// Only one job can use the workers at a time. Anyone else runs their tasks serially.
+			std::mutex runMutex;
+
+			// Everything below is protected by jobMutex
+			std::mutex jobMutex;
+			std::condition_variable jobAvailable;
+			std::condition_variable jobFinished;
+			bool stopRequested;
+			size_t jobNumber; ///< Incremented for every new job so that the workers can tell there's a new one
+			const std::function<void(size_t)>* pTask;
+			size_t numberOfTasks;
+			size_t numberOfTasksFinished;
+			size_t nextTask;
+			std::exception_ptr pFirstException;
+		};
+	} // end of the tools namespace
+} // end of the l1menu namespace
+
+l1menu::tools::ThreadPoolPrivateMembers::ThreadPoolPrivateMembers()
+	: numberOfThreads(0), stopRequested(false), jobNumber(0), pTask(nullptr), numberOfTasks(0), numberOfTasksFinished(0), nextTask(0)
+{
+	// No operation besides the initialiser list
+}
+
+l1menu::tools::ThreadPoolPrivateMembers::~ThreadPoolPrivateMembers()
+{
+	stopWorkers();
+}
+
+void l1menu::tools::ThreadPoolPrivateMembers::startWorkers( size_t numberOfWorkers )
+{
+	stopRequested=false;
+	for( size_t index=0; index<numberOfWorkers; ++index )
+	{
+		workers.push_back( std::thread( &ThreadPoolPrivateMembers::workerLoop, this ) );
+		++numberOfRunningWorkers;
+	}
+}
+
+void l1menu::tools::ThreadPoolPrivateMembers::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		stopRequested=true;
+	}
+	jobAvailable.notify_all();
+	for( auto& worker : workers ) worker.join();
+	numberOfRunningWorkers-=workers.size();
+	workers.clear();
+}
+
+void l1menu::tools::ThreadPoolPrivateMembers::workerLoop()
+{
+	isRunningTasks=true;
+	size_t lastJobNumber=0;
+
+	std::unique_lock<std::mutex> lock(jobMutex);
+	while( true )
+	{
+		jobAvailable.wait( lock, [&]{ return stopRequested || jobNumber!=lastJobNumber; } );
+		if( stopRequested ) return;
+		lastJobNumber=jobNumber;
+
+		lock.unlock();
+		processTasks();
+		lock.lock();
+	}
+}
+
+void l1menu::tools::ThreadPoolPrivateMembers::processTasks()
+{
+	// Tasks are expected to be fairly large (e.g. a block of events) so taking the
+	// lock for each one doesn't cost anything noticeable, and it means a worker that
+	// is late waking up can't get confused between two different jobs.
+	std::unique_lock<std::mutex> lock(jobMutex);
+	while( nextTask<numberOfTasks )
+	{
+		const size_t taskNumber=nextTask++;
+		const std::function<void(size_t)>& task=*pTask;
+		lock.unlock();
+
+		std::exception_ptr pException;
+		try{ task(taskNumber); }
+		catch(...) { pException=std::current_exception(); }
+
+		lock.lock();
+		if( pException && !pFirstException ) pFirstException=pException;
+		++numberOfTasksFinished;
+		if( numberOfTasksFinished==numberOfTasks ) jobFinished.notify_all();
+	}
+}
+
+l1menu::tools::ThreadPool& l1menu::tools::ThreadPool::instance()
+{
+	static ThreadPool onlyInstance;
+	return onlyInstance;
+}
+
+l1menu::tools::ThreadPool::ThreadPool() : pImple_( new l1menu::tools::ThreadPoolPrivateMembers )
+{
+	setNumberOfThreads( 0 );
+}
+
+l1menu::tools::ThreadPool::~ThreadPool()
+{
+	// No operation. Just need one defined otherwise the default one messes up
+	// the unique_ptr deletion because ThreadPoolPrivateMembers isn't defined
+	// elsewhere.
+}
+
+void l1menu::tools::ThreadPool::setNumberOfThreads( size_t numberOfThreads )
+{
+	if( numberOfThreads==0 ) numberOfThreads=std::thread::hardware_concurrency();
+	// hardware_concurrency() is allowed to return zero if it can't tell
+	if( numberOfThreads==0 ) numberOfThreads=1;
+
+	std::lock_guard<std::mutex> runLock( pImple_->runMutex );
+	if( numberOfThreads==pImple_->numberOfThreads ) return;
+
+	pImple_->stopWorkers();
+	pImple_->numberOfThreads=numberOfThreads;
+	// The calling thread also processes tasks, so one fewer worker is needed
+	pImple_->startWorkers( numberOfThreads-1 );
+}
+
+size_t l1menu::tools::ThreadPool::numberOfThreads() const
+{
+	return pImple_->numberOfThreads;
+}
+
+bool l1menu::tools::ThreadPool::workersAreRunning()
+{
+	return numberOfRunningWorkers!=0;
+}
+
+void l1menu::tools::ThreadPool::run( size_t numberOfTasks, const std::function<void(size_t)>& task )
+{
+	if( numberOfTasks==0 ) return;
+	if( isRunningTasks || numberOfTasks==1 ) return runSerially( numberOfTasks, task );
+
+	// The workers can only be looked at once the lock is held, otherwise setNumberOfThreads()
+	// could be changing them at the same time.
+	std::unique_lock<std::mutex> runLock( pImple_->runMutex, std::try_to_lock );
+	if( !runLock.owns_lock() || pImple_->workers.empty() ) return runSerially( numberOfTasks, task );
+
+	{ // Block to limit the scope of the lock
+		std::lock_guard<std::mutex> lock( pImple_->jobMutex );
+		pImple_->pTask=&task;
+		pImple_->numberOfTasks=numberOfTasks;
+		pImple_->numberOfTasksFinished=0;
+		pImple_->pFirstException=nullptr;
+		pImple_->nextTask=0;
+		++pImple_->jobNumber;
+	}
+	pImple_->jobAvailable.notify_all();
+
+	// Help out rather than sitting idle
+	isRunningTasks=true;
+	pImple_->processTasks();
+	isRunningTasks=false;
+
+	std::unique_lock<std::mutex> lock( pImple_->jobMutex );
+	pImple_->jobFinished.wait( lock, [&]{ return pImple_->numberOfTasksFinished==numberOfTasks; } );
+	pImple_->pTask=nullptr;
+	pImple_->numberOfTasks=0;
+
+	if( pImple_->pFirstException ) std::rethrow_exception( pImple_->pFirstException );
+}
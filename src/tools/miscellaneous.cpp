@@ -8,7 +8,13 @@
 #include <ostream>
 #include <fstream>
 #include <iomanip>
+#include <iostream>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
 #include "l1menu/ITrigger.h"
+#include "l1menu/ITightestThresholds.h"
 #include "l1menu/L1TriggerDPGEvent.h"
 #include "l1menu/TriggerTable.h"
 #include "l1menu/TriggerMenu.h"
@@ -16,74 +22,32 @@
 #include "l1menu/ITriggerRate.h"
 #include "l1menu/FullSample.h"
 #include "l1menu/ReducedSample.h"
+#include "l1menu/tools/ThreadPool.h"
 
 
 std::vector<std::string> l1menu::tools::getThresholdNames( const l1menu::ITriggerDescription& trigger )
 {
-	std::vector<std::string> returnValue;
-
-	//
-	// I don't know how many thresholds there are, so I'll try and get every possible one and catch
-	// the exception when I eventually hit a threshold that doesn't exist.
-	//
-
-	std::stringstream stringConverter;
-	// I plan in the future to implement cross triggers with "leg1threshold1", "leg2threshold1" etcetera,
-	// so I'll loop over those possible prefixes.
-	for( size_t legNumber=0; true; ++legNumber ) // Loop continuously until the exception handler calls "break"
-	{
-		size_t thresholdNumber;
-		try
-		{
-			// Loop over all possible numbers of thresholds
-			for( thresholdNumber=1; true; ++thresholdNumber ) // Loop continuously until I hit an exception
-			{
-				stringConverter.str("");
-				if( legNumber!=0 ) stringConverter << "leg" << legNumber; // For triggers with only one leg I don't want to prefix anything.
-
-				stringConverter << "threshold" << thresholdNumber;
-
-				trigger.parameter(stringConverter.str());
-				// If the threshold doesn't exist the statement above will throw an exception, so
-				// I've reached this far then the threshold name must exist.
-				returnValue.push_back( stringConverter.str() );
-			}
-
-		}
-		catch( std::exception& error )
-		{
-			// If this exception is from the first threshold tried then the prefix (e.g. "leg1") does not
-			// exist, so I know I've finished. If it isn't from the first threshold then there could be
-			// other prefixes (e.g. "leg2") that have thresholds that can be modified, in which case I
-			// need to continue.
-			if( thresholdNumber==1 && legNumber!=0 ) break;
-		}
-	}
-
-	return returnValue;
+	// The trigger table works these out once when each trigger is registered
+	return l1menu::TriggerTable::instance().getThresholdNames( trigger );
 }
 
 std::vector<std::string> l1menu::tools::getNonThresholdParameterNames( const l1menu::ITriggerDescription& trigger )
 {
-	std::vector<std::string> returnValue;
-
-	// It'll be easier to get the threshold names and then copy
-	// everything that's not in there to the return value.
-	std::vector<std::string> allParameterNames=trigger.parameterNames();
-	std::vector<std::string> thresholdNames=getThresholdNames(trigger);
+	return l1menu::TriggerTable::instance().getNonThresholdParameterNames( trigger );
+}
 
-	for( const auto& parameterName : allParameterNames )
+void l1menu::tools::setTriggerThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event, l1menu::ITrigger& trigger, float tolerance )
+{
+	// If the trigger can work out the thresholds directly then that's much quicker than bisection
+	l1menu::ITightestThresholds* pTightestThresholds=dynamic_cast<l1menu::ITightestThresholds*>(&trigger);
+	if( pTightestThresholds!=nullptr )
 	{
-		const auto& iFindResult=std::find( thresholdNames.begin(), thresholdNames.end(), parameterName );
-		// If the current parameter name isn't one of the thresholds add
-		// it the vector which I'm going to return.
-		if( iFindResult==thresholdNames.end() ) returnValue.push_back(parameterName);
+		if( !pTightestThresholds->setThresholdsAsTightAsPossible( event ) ) throw std::runtime_error( "l1menu::tools::setTriggerThresholdsAsTightAsPossible() - couldn't find a set of thresholds to pass the given event.");
 	}
-
-	return returnValue;
+	else setTriggerThresholdsByBisection( event, trigger, tolerance );
 }
 
-void l1menu::tools::setTriggerThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event, l1menu::ITrigger& trigger, float tolerance )
+void l1menu::tools::setTriggerThresholdsByBisection( const l1menu::L1TriggerDPGEvent& event, l1menu::ITrigger& trigger, float tolerance )
 {
 	std::vector<std::string> thresholdNames=l1menu::tools::getThresholdNames( trigger );
 	std::map<std::string,float> tightestPossibleThresholds;
@@ -291,3 +255,116 @@ std::pair<double,double> l1menu::tools::simpleLinearFit( const std::vector< std:
 
 	return std::make_pair( slope, intercept );
 }
+
+namespace // Use the unnamed namespace for things only used in this file
+{
+	/** @brief Kills and reaps the child processes started so far, and closes their pipes. Used when runInChildProcesses can't start them all. */
+	void stopChildProcesses( const std::vector<pid_t>& processIDs, const std::vector<int>& pipeReadEnds )
+	{
+		for( const int readEnd : pipeReadEnds ) close( readEnd );
+		for( const pid_t processID : processIDs ) kill( processID, SIGKILL );
+		for( const pid_t processID : processIDs )
+		{
+			while( waitpid( processID, nullptr, 0 )<0 && errno==EINTR ) continue;
+		}
+	}
+}
+
+std::vector<std::string> l1menu::tools::runInChildProcesses( size_t numberOfProcesses, const std::function<std::string(size_t)>& work )
+{
+	// Only the calling thread is copied by fork, so the pool in the child would be left waiting on
+	// threads that don't exist (and possibly on mutexes they were holding).
+	if( l1menu::tools::ThreadPool::workersAreRunning() ) throw std::logic_error( "l1menu::tools::runInChildProcesses() - can't be called after the ThreadPool has started its threads" );
+
+	// Anything still buffered would be copied into each child and written out again when it exits
+	std::cout.flush();
+	std::cerr.flush();
+
+	std::vector<pid_t> processIDs;
+	std::vector<int> pipeReadEnds;
+
+	for( size_t processNumber=0; processNumber<numberOfProcesses; ++processNumber )
+	{
+		int pipeEnds[2];
+		if( pipe( pipeEnds )!=0 )
+		{
+			stopChildProcesses( processIDs, pipeReadEnds );
+			throw std::runtime_error( "l1menu::tools::runInChildProcesses() - couldn't create a pipe" );
+		}
+
+		pid_t processID=fork();
+		if( processID<0 )
+		{
+			close( pipeEnds[0] );
+			close( pipeEnds[1] );
+			stopChildProcesses( processIDs, pipeReadEnds );
+			throw std::runtime_error( "l1menu::tools::runInChildProcesses() - couldn't start a new process" );
+		}
+		if( processID==0 )
+		{
+			// This is the child. Only the write end of its own pipe is needed.
+			close( pipeEnds[0] );
+			for( const int readEnd : pipeReadEnds ) close( readEnd );
+
+			int exitStatus=0;
+			try
+			{
+				const std::string result=work( processNumber );
+				for( size_t bytesWritten=0; bytesWritten<result.size(); )
+				{
+					ssize_t writeResult=write( pipeEnds[1], result.data()+bytesWritten, result.size()-bytesWritten );
+					if( writeResult<0 && errno==EINTR ) continue;
+					if( writeResult<=0 ) throw std::runtime_error( "couldn't send the result back to the parent process" );
+					bytesWritten+=writeResult;
+				}
+			}
+			catch( std::exception& error )
+			{
+				std::cerr << "Exception caught in process " << processNumber << ": " << error.what() << std::endl;
+				exitStatus=1;
+			}
+			catch( ... )
+			{
+				std::cerr << "Unknown exception caught in process " << processNumber << std::endl;
+				exitStatus=1;
+			}
+			close( pipeEnds[1] );
+			// Skip the static destructors, the parent process still owns everything copied from it
+			std::cout.flush();
+			_exit( exitStatus );
+		}
+
+		close( pipeEnds[1] );
+		processIDs.push_back( processID );
+		pipeReadEnds.push_back( pipeEnds[0] );
+	}
+
+	// Read everything from each pipe in order. Any child that's finished before its turn just
+	// waits with its output in the pipe until it's read.
+	std::vector<std::string> results( numberOfProcesses );
+	bool allSucceeded=true;
+	for( size_t processNumber=0; processNumber<numberOfProcesses; ++processNumber )
+	{
+		char buffer[65536];
+		ssize_t readResult;
+		while( (readResult=read( pipeReadEnds[processNumber], buffer, sizeof(buffer) ))!=0 )
+		{
+			if( readResult<0 )
+			{
+				if( errno==EINTR ) continue;
+				allSucceeded=false;
+				break;
+			}
+			results[processNumber].append( buffer, readResult );
+		}
+		close( pipeReadEnds[processNumber] );
+
+		int status=0;
+		pid_t waitResult;
+		do { waitResult=waitpid( processIDs[processNumber], &status, 0 ); } while( waitResult<0 && errno==EINTR );
+		if( waitResult<0 || !WIFEXITED(status) || WEXITSTATUS(status)!=0 ) allSucceeded=false;
+	}
+
+	if( !allSucceeded ) throw std::runtime_error( "l1menu::tools::runInChildProcesses() - at least one of the processes failed" );
+	return results;
+}
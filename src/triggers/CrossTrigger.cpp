@@ -5,13 +5,13 @@
 l1menu::triggers::CrossTrigger::CrossTrigger( std::unique_ptr<l1menu::ITrigger> pLeg1, std::unique_ptr<l1menu::ITrigger> pLeg2 )
 : pLeg1_( std::move(pLeg1) ), pLeg2_( std::move(pLeg2) )
 {
-	// No operation besides the initialiser list
+	initialiseParameterNames();
 }
 
 l1menu::triggers::CrossTrigger::CrossTrigger( l1menu::ITrigger* pLeg1, l1menu::ITrigger* pLeg2 )
 : pLeg1_( pLeg1 ), pLeg2_( pLeg2 )
 {
-	// No operation besides the initialiser list
+	initialiseParameterNames();
 }
 
 l1menu::triggers::CrossTrigger::~CrossTrigger()
@@ -19,37 +19,52 @@ l1menu::triggers::CrossTrigger::~CrossTrigger()
 	// No operation
 }
 
-const std::vector<std::string> l1menu::triggers::CrossTrigger::parameterNames() const
+void l1menu::triggers::CrossTrigger::initialiseParameterNames()
 {
-	std::vector<std::string> returnValue;
-
 	std::vector<std::string> legParameterNames=pLeg1_->parameterNames();
-	for( const auto& parameterName : legParameterNames ) returnValue.push_back( "leg1"+parameterName );
+	for( const auto& parameterName : legParameterNames ) parameterNames_.push_back( "leg1"+parameterName );
+	numberOfLeg1Parameters_=parameterNames_.size();
 
 	legParameterNames=pLeg2_->parameterNames();
-	for( const auto& parameterName : legParameterNames ) returnValue.push_back( "leg2"+parameterName );
+	for( const auto& parameterName : legParameterNames ) parameterNames_.push_back( "leg2"+parameterName );
+}
 
-	return returnValue;
+const std::vector<std::string> l1menu::triggers::CrossTrigger::parameterNames() const
+{
+	return parameterNames_;
 }
 
-float& l1menu::triggers::CrossTrigger::parameter( const std::string& parameterName )
+size_t l1menu::triggers::CrossTrigger::parameterIndex( const std::string& parameterName ) const
 {
-	std::string firstFourCharacters=parameterName.substr(0,4);
-	std::string everythingElse=parameterName.substr(4);
+	// The leg triggers need the name without the prefix, so it's quicker to check against the
+	// full names here than to split the string.
+	for( size_t index=0; index<parameterNames_.size(); ++index )
+	{
+		if( parameterNames_[index]==parameterName ) return index;
+	}
+	throw std::logic_error( "Not a valid parameter name (\""+parameterName+"\")" );
+}
 
-	if( firstFourCharacters=="leg1" ) return pLeg1_->parameter(everythingElse);
-	else if( firstFourCharacters=="leg2" ) return pLeg2_->parameter(everythingElse);
-	else throw std::logic_error( "Not a valid parameter name (\""+parameterName+"\")" );
+float& l1menu::triggers::CrossTrigger::parameter( const std::string& parameterName )
+{
+	return parameterAt( parameterIndex(parameterName) );
 }
 
 const float& l1menu::triggers::CrossTrigger::parameter( const std::string& parameterName ) const
 {
-	std::string firstFourCharacters=parameterName.substr(0,4);
-	std::string everythingElse=parameterName.substr(4);
+	return parameterAt( parameterIndex(parameterName) );
+}
 
-	if( firstFourCharacters=="leg1" ) return pLeg1_->parameter(everythingElse);
-	else if( firstFourCharacters=="leg2" ) return pLeg2_->parameter(everythingElse);
-	else throw std::logic_error( "Not a valid parameter name (\""+parameterName+"\")" );
+float& l1menu::triggers::CrossTrigger::parameterAt( size_t parameterIndex )
+{
+	if( parameterIndex<numberOfLeg1Parameters_ ) return pLeg1_->parameterAt( parameterIndex );
+	else return pLeg2_->parameterAt( parameterIndex-numberOfLeg1Parameters_ );
+}
+
+const float& l1menu::triggers::CrossTrigger::parameterAt( size_t parameterIndex ) const
+{
+	if( parameterIndex<numberOfLeg1Parameters_ ) return pLeg1_->parameterAt( parameterIndex );
+	else return pLeg2_->parameterAt( parameterIndex-numberOfLeg1Parameters_ );
 }
 
 bool l1menu::triggers::CrossTrigger::apply( const l1menu::L1TriggerDPGEvent& event ) const
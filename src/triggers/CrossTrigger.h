@@ -27,13 +27,22 @@ namespace l1menu
 			CrossTrigger( l1menu::ITrigger* pLeg1Trigger, l1menu::ITrigger* pLeg2Trigger );
 			virtual ~CrossTrigger();
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 			virtual bool apply( const l1menu::L1TriggerDPGEvent& event ) const;
 			virtual bool thresholdsAreCorrelated() const;
 		protected:
 			std::unique_ptr<l1menu::ITrigger> pLeg1_;
 			std::unique_ptr<l1menu::ITrigger> pLeg2_;
+		private:
+			/// Sets parameterNames_ from the legs. Only needs doing once because the leg triggers never change.
+			void initialiseParameterNames();
+			/// The leg parameter names with "leg1" or "leg2" prepended, leg1 first
+			std::vector<std::string> parameterNames_;
+			size_t numberOfLeg1Parameters_;
 		};
 
 	} // end of namespace triggers
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +30,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<DoubleEG>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float regionCut_;
@@ -85,7 +91,7 @@ namespace l1menu
 
 bool l1menu::triggers::DoubleEG_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -93,13 +99,13 @@ bool l1menu::triggers::DoubleEG_v0::apply( const l1menu::L1TriggerDPGEvent& even
 
 	int n1=0;
 	int n2=0;
-	int Nele = analysisDataFormat.Nele;
+	int Nele = objects.eg.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.Bxel[ue];
+		int bx = objects.eg.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.Etael[ue];
+		float eta = objects.eg.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.Etel[ue];    // the rank of the electron
+		float rank = objects.eg.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) n1++;
 		if (pt >= leg2threshold1_) n2++;
@@ -131,27 +137,42 @@ const std::string l1menu::triggers::DoubleEG::name() const
 	return "L1_DoubleEG";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleEG>& l1menu::triggers::DoubleEG::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<DoubleEG> table={
+		{ "leg1threshold1", &DoubleEG::leg1threshold1_ },
+		{ "leg2threshold1", &DoubleEG::leg2threshold1_ },
+		{ "regionCut", &DoubleEG::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::DoubleEG::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::DoubleEG::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleEG::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleEG::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleEG::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleEG::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
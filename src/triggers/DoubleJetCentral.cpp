@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +30,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<DoubleJetCentral>& parameterTable();
 			float threshold1_;
 			float threshold2_;
 			float regionCut_;
@@ -85,7 +91,7 @@ namespace l1menu
 
 bool l1menu::triggers::DoubleJetCentral_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -93,21 +99,21 @@ bool l1menu::triggers::DoubleJetCentral_v0::apply( const l1menu::L1TriggerDPGEve
 
 	int n1=0;
 	int n2=0;
-	int Nj=analysisDataFormat.Njet;
+	int Nj=objects.jets.number;
 	for( int ue=0; ue<Nj; ue++ )
 	{
-		int bx=analysisDataFormat.Bxjet[ue];
+		int bx=objects.jets.bx[ue];
 		if( bx!=0 ) continue;
-		bool isFwdJet=analysisDataFormat.Fwdjet[ue];
+		bool isFwdJet=objects.jets.forward[ue];
 		if( isFwdJet ) continue;
-		bool isTauJet=analysisDataFormat.Taujet[ue];
+		bool isTauJet=objects.jets.tau[ue];
 		if( isTauJet ) continue;
 
-		float eta = analysisDataFormat.Etajet[ue];
+		float eta = objects.jets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;
 
-		float rank=analysisDataFormat.Etjet[ue];
-		float pt=rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
+		float rank=objects.jets.et[ue];
+		float pt=rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
 		if( pt>=threshold1_ ) n1++;
 		if( pt>=threshold2_ ) n2++;
 	}
@@ -137,27 +143,42 @@ const std::string l1menu::triggers::DoubleJetCentral::name() const
 	return "L1_DoubleJet";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleJetCentral>& l1menu::triggers::DoubleJetCentral::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<DoubleJetCentral> table={
+		{ "threshold1", &DoubleJetCentral::threshold1_ },
+		{ "threshold2", &DoubleJetCentral::threshold2_ },
+		{ "regionCut", &DoubleJetCentral::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::DoubleJetCentral::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("threshold2");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::DoubleJetCentral::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleJetCentral::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleJetCentral::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleJetCentral::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleJetCentral::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -1,9 +1,13 @@
 #include "DoubleMu.h"
 
 #include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -34,34 +38,120 @@ namespace l1menu
 } // end of namespace l1menu
 
 
-bool l1menu::triggers::DoubleMu_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+namespace // Use the unnamed namespace for things only used in this file
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	/** @brief Maps a float (other than NaN) onto an unsigned integer so that the order is kept and neighbouring floats differ by one. */
+	uint32_t orderedBits( float value )
+	{
+		uint32_t bits;
+		std::memcpy( &bits, &value, sizeof(bits) );
+		return ( bits & 0x80000000 ) ? ~bits : ( bits | 0x80000000 );
+	}
+
+	/** @brief The inverse of orderedBits. */
+	float fromOrderedBits( uint32_t bits )
+	{
+		bits=( bits & 0x80000000 ) ? ( bits & 0x7fffffff ) : ~bits;
+		float value;
+		std::memcpy( &value, &bits, sizeof(value) );
+		return value;
+	}
+} // end of the unnamed namespace
+
+bool l1menu::triggers::DoubleMu_v0::twoHighestSelectedPts( const l1menu::L1TriggerDPGEvent& event, float& highestPt, float& secondHighestPt ) const
+{
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
 	if( !raw ) return false;
 
-	int n1=0;
-	int n2=0;
-	int Nmu=analysisDataFormat.Nmu;
+	highestPt=-std::numeric_limits<float>::infinity();
+	secondHighestPt=-std::numeric_limits<float>::infinity();
+	int numberFound=0;
+	int Nmu=objects.muons.number;
 	for( int imu=0; imu<Nmu; imu++ )
 	{
-		int bx=analysisDataFormat.Bxmu.at( imu );
+		int bx=objects.muons.bx[ imu ];
 		if( bx!=0 ) continue;
-		float pt=analysisDataFormat.Ptmu.at( imu );
-		//float eta=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
-		int qual=analysisDataFormat.Qualmu.at( imu );
+		float pt=objects.muons.pt[ imu ];
+		//float eta=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
+		int qual=objects.muons.quality[ imu ];
 		if( qual<muonQuality_ ) continue;
 
-		if( pt>=threshold1_ ) n1++;
-		if( pt>=threshold2_ ) n2++;
+		if( pt>=highestPt )
+		{
+			secondHighestPt=highestPt;
+			highestPt=pt;
+			++numberFound;
+		}
+		else if( pt>=secondHighestPt )
+		{
+			secondHighestPt=pt;
+			++numberFound;
+		}
 	}
 
-	bool ok=( n1>=1 && n2>=2 );
+	return numberFound>=2;
+}
+
+bool l1menu::triggers::DoubleMu_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float highestPt;
+	float secondHighestPt;
+	if( !twoHighestSelectedPts( event, highestPt, secondHighestPt ) ) return false;
+
+	// At least one muon passing threshold1_ and at least two passing threshold2_
+	bool ok=( highestPt>=threshold1_ && secondHighestPt>=threshold2_ );
 	return ok;
 }
 
+bool l1menu::triggers::DoubleMu_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	float highestPt;
+	float secondHighestPt;
+	if( !twoHighestSelectedPts( event, highestPt, secondHighestPt ) ) return false;
+
+	// The thresholds are correlated, so threshold2_ has to keep the same ratio to threshold1_. The
+	// event passes if the highest pt muon passes threshold1_ and the second highest passes threshold2_.
+	const float scaling=threshold2_/threshold1_;
+	if( !(scaling>=0) || scaling==std::numeric_limits<float>::infinity() ) return false;
+	auto passes=[&]( float threshold ){ return highestPt>=threshold && secondHighestPt>=scaling*threshold; };
+
+	float threshold=highestPt;
+	if( scaling>0 && secondHighestPt/scaling<threshold ) threshold=secondHighestPt/scaling;
+
+	// Rounding in the scaled threshold can leave that a fraction either side of the tightest threshold.
+	// Both conditions only get easier as the threshold goes down, so if it's not exactly right bisect
+	// through every float in between for the highest threshold that passes.
+	const float infinity=std::numeric_limits<float>::infinity();
+	if( !passes(threshold) || ( threshold<infinity && passes( std::nextafter(threshold,infinity) ) ) )
+	{
+		float passingThreshold=( passes(threshold) ? threshold : std::numeric_limits<float>::lowest() );
+		float failingThreshold=( passes(threshold) ? infinity : threshold );
+		if( !passes(passingThreshold) ) return false;
+
+		if( passes(failingThreshold) ) passingThreshold=failingThreshold;
+		else
+		{
+			uint32_t passingBits=orderedBits( passingThreshold );
+			uint32_t failingBits=orderedBits( failingThreshold );
+			while( failingBits-passingBits>1 )
+			{
+				const uint32_t middleBits=passingBits+(failingBits-passingBits)/2;
+				if( passes( fromOrderedBits(middleBits) ) ) passingBits=middleBits;
+				else failingBits=middleBits;
+			}
+			passingThreshold=fromOrderedBits( passingBits );
+		}
+		threshold=passingThreshold;
+	}
+
+	threshold1_=threshold;
+	threshold2_=scaling*threshold;
+	return true;
+}
+
 bool l1menu::triggers::DoubleMu_v0::thresholdsAreCorrelated() const
 {
 	return true;
@@ -83,27 +173,42 @@ const std::string l1menu::triggers::DoubleMu::name() const
 	return "L1_DoubleMu";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleMu>& l1menu::triggers::DoubleMu::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<DoubleMu> table={
+		{ "threshold1", &DoubleMu::threshold1_ },
+		{ "threshold2", &DoubleMu::threshold2_ },
+		{ "muonQuality", &DoubleMu::muonQuality_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::DoubleMu::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("threshold2");
-	returnValue.push_back("muonQuality");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::DoubleMu::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleMu::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleMu::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleMu::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleMu::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
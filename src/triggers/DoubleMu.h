@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
+#include "l1menu/ITightestThresholds.h"
 
 //
 // Forward declarations
@@ -34,9 +36,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<DoubleMu>& parameterTable();
 			float threshold1_;
 			float threshold2_;
 			float muonQuality_;
@@ -47,12 +54,16 @@ namespace l1menu
 		 * @author probably Brian Winer
 		 * @date sometime
 		 */
-		class DoubleMu_v0 : public DoubleMu
+		class DoubleMu_v0 : public DoubleMu, public l1menu::ITightestThresholds
 		{
 		public:
 			virtual unsigned int version() const;
 			virtual bool apply( const l1menu::L1TriggerDPGEvent& event ) const;
 			virtual bool thresholdsAreCorrelated() const;
+			virtual bool setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event );
+		private:
+			/** @brief Applies every cut in apply() except the thresholds, and sets the pts of the two highest pt muons that pass. Returns false if fewer than two do. */
+			bool twoHighestSelectedPts( const l1menu::L1TriggerDPGEvent& event, float& highestPt, float& secondHighestPt ) const;
 		}; // end of version 0 class
 
 	} // end of namespace triggers
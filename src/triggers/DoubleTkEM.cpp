@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +30,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<DoubleTkEM>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float regionCut_;
@@ -86,7 +92,7 @@ namespace l1menu
 
 bool l1menu::triggers::DoubleTkEM_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -94,14 +100,14 @@ bool l1menu::triggers::DoubleTkEM_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	int n1=0;
 	int n2=0;
-	int Nem = analysisDataFormat.NTkem;
+	int Nem = objects.trackEMs.number;
 	for (int ue=0; ue < Nem; ue++) {
-		int bx = analysisDataFormat.BxTkem[ue];
+		int bx = objects.trackEMs.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkem[ue];
+		float eta = objects.trackEMs.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float pt = analysisDataFormat.EtTkem[ue];    // the rank of the electron
-		float tkI= analysisDataFormat.tIsoTkem[ue];
+		float pt = objects.trackEMs.et[ue];    // the rank of the electron
+		float tkI= objects.trackEMs.trackIsolation[ue];
 		if (pt >= leg1threshold1_ && tkI<tkIsoCut_) n1++;
 		if (pt >= leg2threshold1_ && tkI<tkIsoCut_) n2++;
 	}  // end loop over EM objects
@@ -132,30 +138,43 @@ const std::string l1menu::triggers::DoubleTkEM::name() const
 	return "L1_DoubleTkEM";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleTkEM>& l1menu::triggers::DoubleTkEM::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<DoubleTkEM> table={
+		{ "leg1threshold1", &DoubleTkEM::leg1threshold1_ },
+		{ "leg2threshold1", &DoubleTkEM::leg2threshold1_ },
+		{ "regionCut", &DoubleTkEM::regionCut_ },
+		{ "trkIsolCut", &DoubleTkEM::tkIsoCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::DoubleTkEM::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("regionCut");
-	returnValue.push_back("trkIsolCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::DoubleTkEM::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleTkEM::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="trkIsolCut" ) return tkIsoCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleTkEM::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="trkIsolCut" ) return tkIsoCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleTkEM::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleTkEM::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -30,9 +31,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<DoubleTkEle>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float regionCut_;
@@ -131,7 +137,7 @@ bool l1menu::triggers::DoubleTkEle_v0::apply( const l1menu::L1TriggerDPGEvent& e
 {
 
 
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0]; // ZeroBias
@@ -139,14 +145,14 @@ bool l1menu::triggers::DoubleTkEle_v0::apply( const l1menu::L1TriggerDPGEvent& e
 
 	int n1=0;
 	int n2=0;
-	int Nele = analysisDataFormat.NTkele;
+	int Nele = objects.trackElectrons.number;
 
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue; // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel[ue]; // the rank of the electron
+		float rank = objects.trackElectrons.et[ue]; // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) n1++;
 		if (pt >= leg2threshold1_) n2++;
@@ -172,7 +178,7 @@ bool l1menu::triggers::DoubleTkEle_v1::apply( const l1menu::L1TriggerDPGEvent& e
 {
 
 
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0]; // ZeroBias
@@ -180,14 +186,14 @@ bool l1menu::triggers::DoubleTkEle_v1::apply( const l1menu::L1TriggerDPGEvent& e
 
 	int n1=0;
 	int n2=0;
-	int Nele = analysisDataFormat.NTkele2;
+	int Nele = objects.lowPtTrackElectrons.number;
 
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.BxTkel2[ue];
+		int bx = objects.lowPtTrackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel2[ue];
+		float eta = objects.lowPtTrackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue; // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel2[ue]; // the rank of the electron
+		float rank = objects.lowPtTrackElectrons.et[ue]; // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) n1++;
 		if (pt >= leg2threshold1_) n2++;
@@ -214,7 +220,7 @@ unsigned int l1menu::triggers::DoubleTkEle_v1::version() const
 bool l1menu::triggers::DoubleTkEle_v2::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
 
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -222,24 +228,24 @@ bool l1menu::triggers::DoubleTkEle_v2::apply( const l1menu::L1TriggerDPGEvent& e
 
         bool ok = false;
 	
-	int Nele = analysisDataFormat.NTkele;
+	int Nele = objects.trackElectrons.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel[ue];    // the rank of the electron
+		float rank = objects.trackElectrons.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) {
 		
-		      float eleZvtx = analysisDataFormat.zVtxTkel[ue];
+		      float eleZvtx = objects.trackElectrons.zVertex[ue];
 		      for(int ue2=0; ue2< Nele; ue2++) {
 		          if( (ue2 != ue) &&
-			      (fabs(eleZvtx - analysisDataFormat.zVtxTkel[ue2]) < zVtxCut_) )  {
-			      if (analysisDataFormat.BxTkel[ue2]!= 0) continue;
-			      float eta2 = analysisDataFormat.EtaTkel[ue2];
+			      (fabs(eleZvtx - objects.trackElectrons.zVertex[ue2]) < zVtxCut_) )  {
+			      if (objects.trackElectrons.bx[ue2]!= 0) continue;
+			      float eta2 = objects.trackElectrons.eta[ue2];
 			      if (eta2 < regionCut_ || eta2 > 21.-regionCut_) continue;  // eta = 5 - 16
-			      float pt2 = analysisDataFormat.EtTkel[ue2];     
+			      float pt2 = objects.trackElectrons.et[ue2];     
 		              if (pt2 >= leg2threshold1_ ) ok=true;
 			   }//end if vtx compatability  
 		      }	//end loop over second object
@@ -262,30 +268,30 @@ unsigned int l1menu::triggers::DoubleTkEle_v2::version() const
 
 bool l1menu::triggers::DoubleTkEle_v3::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
 	bool ok =false;
-	int Nele = analysisDataFormat.NTkele2;
+	int Nele = objects.lowPtTrackElectrons.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.BxTkel2[ue];
+		int bx = objects.lowPtTrackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel2[ue];
+		float eta = objects.lowPtTrackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel2[ue];    // the rank of the electron
+		float rank = objects.lowPtTrackElectrons.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) {
 		
-		      float eleZvtx = analysisDataFormat.zVtxTkel2[ue];
+		      float eleZvtx = objects.lowPtTrackElectrons.zVertex[ue];
 		      for(int ue2=0; ue2< Nele; ue2++) {
-		          if( (ue2 != ue) && fabs(eleZvtx - analysisDataFormat.zVtxTkel2[ue2]) < zVtxCut_)  {
-			     if (analysisDataFormat.BxTkel2[ue2]!= 0) continue;
-			     float eta2 = analysisDataFormat.EtaTkel2[ue2];
+		          if( (ue2 != ue) && fabs(eleZvtx - objects.lowPtTrackElectrons.zVertex[ue2]) < zVtxCut_)  {
+			     if (objects.lowPtTrackElectrons.bx[ue2]!= 0) continue;
+			     float eta2 = objects.lowPtTrackElectrons.eta[ue2];
 			     if (eta2 < regionCut_ || eta2 > 21.-regionCut_) continue;  // eta = 5 - 16
-			     float pt2 = analysisDataFormat.EtTkel2[ue2];     
+			     float pt2 = objects.lowPtTrackElectrons.et[ue2];     
 		             if (pt2 >= leg2threshold1_ ) ok=true;
 			   }//end if vtx compatability  
 		      }	//end loop over second object
@@ -318,30 +324,43 @@ const std::string l1menu::triggers::DoubleTkEle::name() const
 	return "L1_DoubleTkEle";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleTkEle>& l1menu::triggers::DoubleTkEle::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<DoubleTkEle> table={
+		{ "leg1threshold1", &DoubleTkEle::leg1threshold1_ },
+		{ "leg2threshold1", &DoubleTkEle::leg2threshold1_ },
+		{ "regionCut", &DoubleTkEle::regionCut_ },
+		{ "zVtxCut", &DoubleTkEle::zVtxCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::DoubleTkEle::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("regionCut");
-	returnValue.push_back("zVtxCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::DoubleTkEle::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleTkEle::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleTkEle::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;	
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleTkEle::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleTkEle::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
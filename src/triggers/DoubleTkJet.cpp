@@ -1,7 +1,6 @@
 #include "MultiTkJet.h"
 
 #include <stdexcept>
-#include <algorithm>
 #include "../implementation/RegisterTriggerMacro.h"
 
 
@@ -26,8 +25,14 @@ namespace l1menu
 			// These implementations are just to remove the option of changing the
 			// numberOfJets parameter.
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
+		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<DoubleTkJet_v0>& parameterTable();
 		}; // end of version 0 class
 
 		/* The REGISTER_TRIGGER macro will make sure that the given trigger is registered in the
@@ -66,25 +71,45 @@ unsigned int l1menu::triggers::DoubleTkJet_v0::version() const
 	return 0;
 }
 
-const std::vector<std::string> l1menu::triggers::DoubleTkJet_v0::parameterNames() const
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleTkJet_v0>& l1menu::triggers::DoubleTkJet_v0::parameterTable()
 {
-	std::vector<std::string> returnValue=MultiTkJet::parameterNames();
+	static const l1menu::implementation::ParameterTable<DoubleTkJet_v0> table={
+		{ "threshold1", &DoubleTkJet_v0::threshold1_ },
+		{ "threshold2", &DoubleTkJet_v0::threshold2_ },
+		{ "threshold3", &DoubleTkJet_v0::threshold3_ },
+		{ "threshold4", &DoubleTkJet_v0::threshold4_ },
+		{ "regionCut", &DoubleTkJet_v0::regionCut_ },
+		{ "zVtxCut", &DoubleTkJet_v0::zVtxCut_ }
+	};
+	return table;
+}
 
-	// Remove the numberOfJets parameter from the list
-	const auto& iFindResult=std::find( returnValue.begin(), returnValue.end(), "numberOfJets" );
-	returnValue.erase( iFindResult );
+const std::vector<std::string> l1menu::triggers::DoubleTkJet_v0::parameterNames() const
+{
+	return parameterTable().names();
+}
 
-	return returnValue;
+size_t l1menu::triggers::DoubleTkJet_v0::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleTkJet_v0::parameter( const std::string& parameterName )
 {
-	if( parameterName!="numberOfJets" ) return MultiTkJet::parameter(parameterName);
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleTkJet_v0::parameter( const std::string& parameterName ) const
 {
-	if( parameterName!="numberOfJets" ) return MultiTkJet::parameter(parameterName);
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleTkJet_v0::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleTkJet_v0::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -38,7 +38,7 @@ namespace l1menu
 
 bool l1menu::triggers::DoubleTkMu_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -46,14 +46,14 @@ bool l1menu::triggers::DoubleTkMu_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	int n1=0;
 	int n2=0;
-	int Nmu=analysisDataFormat.NTkmu;
+	int Nmu=objects.trackMuons.number;
 	for( int imu=0; imu<Nmu; imu++ )
 	{
-		int bx=analysisDataFormat.BxTkmu.at( imu );
+		int bx=objects.trackMuons.bx[ imu ];
 		if( bx!=0 ) continue;
-		float pt=analysisDataFormat.PtTkmu.at( imu );
-		//float eta=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
-		int qual=analysisDataFormat.QualTkmu.at( imu );
+		float pt=objects.trackMuons.pt[ imu ];
+		//float eta=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
+		int qual=objects.trackMuons.quality[ imu ];
 		if( qual<muonQuality_ ) continue;
 
 		if( pt>=threshold1_ ) n1++;
@@ -76,7 +76,7 @@ unsigned int l1menu::triggers::DoubleTkMu_v0::version() const
 
 bool l1menu::triggers::DoubleTkMu_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -84,27 +84,27 @@ bool l1menu::triggers::DoubleTkMu_v1::apply( const l1menu::L1TriggerDPGEvent& ev
  
         bool ok = false;
 
-	int Nmu=analysisDataFormat.NTkmu;
+	int Nmu=objects.trackMuons.number;
 	for( int imu=0; imu<Nmu; imu++ )
 	{
-		int bx=analysisDataFormat.BxTkmu.at( imu );
+		int bx=objects.trackMuons.bx[ imu ];
 		if( bx!=0 ) continue;
-		float pt=analysisDataFormat.PtTkmu.at( imu );
-		//float eta=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
-		int qual=analysisDataFormat.QualTkmu.at( imu );
+		float pt=objects.trackMuons.pt[ imu ];
+		//float eta=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
+		int qual=objects.trackMuons.quality[ imu ];
 		if( qual<muonQuality_ ) continue;
 
 		if( pt>=threshold1_ ) {
 		     
-		     float muZvtx = analysisDataFormat.zVtxTkmu[imu];
+		     float muZvtx = objects.trackMuons.zVertex[imu];
 		     for(int imu2=0; imu2<Nmu; imu2++) {
 		        if( (imu != imu2) && 
-			    fabs(muZvtx - analysisDataFormat.zVtxTkmu[imu2]) < zVtxCut_ ) {
+			    fabs(muZvtx - objects.trackMuons.zVertex[imu2]) < zVtxCut_ ) {
 
-			    if( analysisDataFormat.BxTkmu.at( imu2 )!=0 ) continue;
-			    int qual2=analysisDataFormat.QualTkmu.at( imu2);
+			    if( objects.trackMuons.bx[ imu2 ]!=0 ) continue;
+			    int qual2=objects.trackMuons.quality[ imu2];
 			    if( qual2<muonQuality_ ) continue;
-			    float pt2=analysisDataFormat.PtTkmu.at( imu2 );
+			    float pt2=objects.trackMuons.pt[ imu2 ];
                             if(pt2 >= threshold2_) ok = true;
 			    
 			}//end if over delta z-vtx    
@@ -137,30 +137,43 @@ const std::string l1menu::triggers::DoubleTkMu::name() const
 	return "L1_DoubleTkMu";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleTkMu>& l1menu::triggers::DoubleTkMu::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<DoubleTkMu> table={
+		{ "threshold1", &DoubleTkMu::threshold1_ },
+		{ "threshold2", &DoubleTkMu::threshold2_ },
+		{ "muonQuality", &DoubleTkMu::muonQuality_ },
+		{ "zVtxCut", &DoubleTkMu::zVtxCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::DoubleTkMu::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("threshold2");
-	returnValue.push_back("muonQuality");
-	returnValue.push_back("zVtxCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::DoubleTkMu::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleTkMu::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleTkMu::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleTkMu::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleTkMu::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -30,9 +31,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<DoubleTkTau>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float regionCut_;
@@ -101,7 +107,7 @@ namespace l1menu
 
 bool l1menu::triggers::DoubleTkTau_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -110,13 +116,13 @@ bool l1menu::triggers::DoubleTkTau_v0::apply( const l1menu::L1TriggerDPGEvent& e
         bool ok = false;
 	int n1=0;
 	int n2=0;
-	int Ntau = analysisDataFormat.NTktau;
+	int Ntau = objects.trackTaus.number;
 	for (int ue=0; ue < Ntau; ue++) {
-		int bx = analysisDataFormat.BxTktau[ue];
+		int bx = objects.trackTaus.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTktau[ue];
+		float eta = objects.trackTaus.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTktau[ue];    // the rank of the electron
+		float rank = objects.trackTaus.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) n1++;
 		if (pt >= leg2threshold1_) n2++;
@@ -139,7 +145,7 @@ unsigned int l1menu::triggers::DoubleTkTau_v0::version() const
 
 bool l1menu::triggers::DoubleTkTau_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -147,25 +153,25 @@ bool l1menu::triggers::DoubleTkTau_v1::apply( const l1menu::L1TriggerDPGEvent& e
 
         bool ok = false;
 
-	int Ntau = analysisDataFormat.NTktau;
+	int Ntau = objects.trackTaus.number;
 	for (int ue=0; ue < Ntau; ue++) {
-		int bx = analysisDataFormat.BxTktau[ue];
+		int bx = objects.trackTaus.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTktau[ue];
+		float eta = objects.trackTaus.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTktau[ue];    // the rank of the electron
+		float rank = objects.trackTaus.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) {
 		
-		      float tauZvtx = analysisDataFormat.zVtxTktau[ue];
+		      float tauZvtx = objects.trackTaus.zVertex[ue];
 		      for(int ue2=0; ue2< Ntau; ue2++) {
 		          if( (ue2 != ue) 
-			     && fabs(tauZvtx - analysisDataFormat.zVtxTktau[ue2]) < zVtxCut_ 
+			     && fabs(tauZvtx - objects.trackTaus.zVertex[ue2]) < zVtxCut_ 
 			     )  {
-			      if (analysisDataFormat.BxTktau[ue2]!= 0) continue;
-			      float eta2 = analysisDataFormat.EtaTktau[ue2];
+			      if (objects.trackTaus.bx[ue2]!= 0) continue;
+			      float eta2 = objects.trackTaus.eta[ue2];
 			      if (eta2 < regionCut_ || eta2 > 21.-regionCut_) continue;  // eta = 5 - 16
-			      float pt2 = analysisDataFormat.EtTktau[ue2];     
+			      float pt2 = objects.trackTaus.et[ue2];     
 		              if (pt2 >= leg2threshold1_ ) ok=true;
 			   }//end if vtx compatability  
 		      }	//end loop over second object
@@ -200,30 +206,43 @@ const std::string l1menu::triggers::DoubleTkTau::name() const
 	return "L1_DoubleTkTau";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::DoubleTkTau>& l1menu::triggers::DoubleTkTau::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<DoubleTkTau> table={
+		{ "leg1threshold1", &DoubleTkTau::leg1threshold1_ },
+		{ "leg2threshold1", &DoubleTkTau::leg2threshold1_ },
+		{ "regionCut", &DoubleTkTau::regionCut_ },
+		{ "zVtxCut", &DoubleTkTau::zVtxCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::DoubleTkTau::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("regionCut");
-	returnValue.push_back("zVtxCut");	
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::DoubleTkTau::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::DoubleTkTau::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;	
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::DoubleTkTau::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;	
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::DoubleTkTau::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::DoubleTkTau::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +30,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<EG_Tau>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float leg1regionCut_;
@@ -86,7 +92,7 @@ namespace l1menu
 
 bool l1menu::triggers::EG_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];    // ZeroBias
@@ -96,29 +102,29 @@ bool l1menu::triggers::EG_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& event
 	bool ok =false;
 
 
-	int Nele = analysisDataFormat.Nele;
+	int Nele = objects.eg.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.Bxel[ue];
+		int bx = objects.eg.bx[ue];
 		if (bx != 0 ) continue;
-		float eta = analysisDataFormat.Etael[ue];
+		float eta = objects.eg.eta[ue];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.Etel[ue];    // the rank of the electron
+		float rank = objects.eg.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= leg1threshold1_) {
 
 
 			// Now look for a tau that is not the same as this eg
-			int Nj = analysisDataFormat.Njet ;
+			int Nj = objects.jets.number ;
 			for (int uj=0; uj < Nj; uj++) {
-				bx = analysisDataFormat.Bxjet[uj];
+				bx = objects.jets.bx[uj];
 				if (bx != 0) continue;
-				bool isTauJet = analysisDataFormat.Taujet[uj];
+				bool isTauJet = objects.jets.tau[uj];
 				if (!isTauJet) continue;
-				float tauEta = analysisDataFormat.Etajet[uj];
+				float tauEta = objects.jets.eta[uj];
 				if (tauEta < leg2regionCut_ || tauEta > 21.-leg2regionCut_) continue;  // tauEta = 5 - 16
-				if (analysisDataFormat.Etajet[uj] == analysisDataFormat.Etael[ue] && analysisDataFormat.Phijet[uj] == analysisDataFormat.Phiel[ue] ) continue;
-				float rankt = analysisDataFormat.Etjet[uj];
-				float ptt = rankt; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[uj],rank*4.,theL1JetCorrection);
+				if (objects.jets.eta[uj] == objects.eg.eta[ue] && objects.jets.phi[uj] == objects.eg.phi[ue] ) continue;
+				float rankt = objects.jets.et[uj];
+				float ptt = rankt; //CorrectedL1JetPtByGCTregions(objects.jets.eta[uj],rank*4.,theL1JetCorrection);
 				if (ptt >= leg2threshold1_) ok = true;
 			}
 
@@ -149,30 +155,43 @@ const std::string l1menu::triggers::EG_Tau::name() const
 	return "L1_EG_Tau";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::EG_Tau>& l1menu::triggers::EG_Tau::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<EG_Tau> table={
+		{ "leg1threshold1", &EG_Tau::leg1threshold1_ },
+		{ "leg1regionCut", &EG_Tau::leg1regionCut_ },
+		{ "leg2threshold1", &EG_Tau::leg2threshold1_ },
+		{ "leg2regionCut", &EG_Tau::leg2regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::EG_Tau::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("leg2regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::EG_Tau::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::EG_Tau::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else throw std::logic_error( "Not a valid parameter name (\""+parameterName+"\")" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::EG_Tau::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else throw std::logic_error( "Not a valid parameter name (\""+parameterName+"\")" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::EG_Tau::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::EG_Tau::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,11 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
+#include "l1menu/ITightestThresholds.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +31,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<HTT>& parameterTable();
 			float threshold1_;
 		}; // end of the HTT base class
 
@@ -40,12 +47,16 @@ namespace l1menu
 		 * @author probably Brian Winer
 		 * @date sometime
 		 */
-		class HTT_v0 : public HTT
+		class HTT_v0 : public HTT, public l1menu::ITightestThresholds
 		{
 		public:
 			virtual unsigned int version() const;
 			virtual bool apply( const l1menu::L1TriggerDPGEvent& event ) const;
 			virtual bool thresholdsAreCorrelated() const;
+			virtual bool setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event );
+		private:
+			/** @brief Applies every cut in apply() except the threshold, and sets sum to the value compared to threshold1_. Returns false if the event fails. */
+			bool energySum( const l1menu::L1TriggerDPGEvent& event, float& sum ) const;
 		}; // end of version 0 class
 
 
@@ -80,21 +91,39 @@ namespace l1menu
 //----------------------------------------------------------------------------------------
 
 
-bool l1menu::triggers::HTT_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+bool l1menu::triggers::HTT_v0::energySum( const l1menu::L1TriggerDPGEvent& event, float& sum ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
-	float adc = analysisDataFormat.HTT ;
+	float adc = objects.sums.totalHt ;
 	float TheHTT = adc; // / 2. ;
 
+	sum=TheHTT;
+	return true;
+}
+
+bool l1menu::triggers::HTT_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float TheHTT;
+	if( !energySum( event, TheHTT ) ) return false;
+
 	if (TheHTT < threshold1_) return false;
 	return true;
 }
 
+bool l1menu::triggers::HTT_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	// The trigger passes as long as the threshold isn't above the value
+	float TheHTT;
+	if( !energySum( event, TheHTT ) ) return false;
+	threshold1_=TheHTT;
+	return true;
+}
+
 bool l1menu::triggers::HTT_v0::thresholdsAreCorrelated() const
 {
 	return false;
@@ -116,21 +145,40 @@ const std::string l1menu::triggers::HTT::name() const
 	return "L1_HTT";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::HTT>& l1menu::triggers::HTT::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<HTT> table={
+		{ "threshold1", &HTT::threshold1_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::HTT::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::HTT::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::HTT::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::HTT::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::HTT::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::HTT::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +30,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<isoTau_Tau>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float regionCut_;
@@ -85,7 +91,7 @@ namespace l1menu
 
 bool l1menu::triggers::isoTau_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];  // ZeroBias
@@ -93,17 +99,17 @@ bool l1menu::triggers::isoTau_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	int n1=0;
 	int n2=0;
-	int Nj = analysisDataFormat.Njet ;
+	int Nj = objects.jets.number ;
 	for (int ue=0; ue < Nj; ue++) {
-		int bx = analysisDataFormat.Bxjet[ue];
+		int bx = objects.jets.bx[ue];
 		if (bx != 0) continue;
-		bool isTauJet = analysisDataFormat.Taujet[ue];
+		bool isTauJet = objects.jets.tau[ue];
 		if (! isTauJet) continue;
-		float rank = analysisDataFormat.Etjet[ue];    // the rank of the electron
-		float pt = rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
-		float eta = analysisDataFormat.Etajet[ue];
+		float rank = objects.jets.et[ue];    // the rank of the electron
+		float pt = rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
+		float eta = objects.jets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		if (pt >= leg1threshold1_ && analysisDataFormat.isoTaujet[ue]) n1++;
+		if (pt >= leg1threshold1_ && objects.jets.isolatedTau[ue]) n1++;
 		if (pt >= leg2threshold1_) n2++;
 	}  // end loop over jets
 
@@ -132,27 +138,42 @@ const std::string l1menu::triggers::isoTau_Tau::name() const
 	return "L1_isoTau_Tau";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::isoTau_Tau>& l1menu::triggers::isoTau_Tau::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<isoTau_Tau> table={
+		{ "leg1threshold1", &isoTau_Tau::leg1threshold1_ },
+		{ "leg2threshold1", &isoTau_Tau::leg2threshold1_ },
+		{ "regionCut", &isoTau_Tau::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::isoTau_Tau::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::isoTau_Tau::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::isoTau_Tau::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::isoTau_Tau::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::isoTau_Tau::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::isoTau_Tau::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -4,7 +4,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -40,7 +40,7 @@ namespace l1menu
 
 bool l1menu::triggers::MultiJet_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -51,20 +51,20 @@ bool l1menu::triggers::MultiJet_v0::apply( const l1menu::L1TriggerDPGEvent& even
 	int n3=0;
 	int n4=0;
 
-	int Nj = analysisDataFormat.Njet ;
+	int Nj = objects.jets.number ;
 	for (int ue=0; ue < Nj; ue++) {
-		int bx = analysisDataFormat.Bxjet[ue];
+		int bx = objects.jets.bx[ue];
 		if (bx != 0) continue;
-		bool isFwdJet = analysisDataFormat.Fwdjet[ue];
+		bool isFwdJet = objects.jets.forward[ue];
 		if (isFwdJet) continue;
-		bool isTauJet = analysisDataFormat.Taujet[ue];
+		bool isTauJet = objects.jets.tau[ue];
 		if (isTauJet) continue;
 
-		float eta = analysisDataFormat.Etajet[ue];
+		float eta = objects.jets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;
 
-		float rank = analysisDataFormat.Etjet[ue];
-		float pt = rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
+		float rank = objects.jets.et[ue];
+		float pt = rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
 		if (pt >= threshold1_) n1++;
 		if (pt >= threshold2_) n2++;
 		if (pt >= threshold3_) n3++;
@@ -96,36 +96,45 @@ const std::string l1menu::triggers::MultiJet::name() const
 	return "L1_MultiJet";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::MultiJet>& l1menu::triggers::MultiJet::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<MultiJet> table={
+		{ "threshold1", &MultiJet::threshold1_ },
+		{ "threshold2", &MultiJet::threshold2_ },
+		{ "threshold3", &MultiJet::threshold3_ },
+		{ "threshold4", &MultiJet::threshold4_ },
+		{ "regionCut", &MultiJet::regionCut_ },
+		{ "numberOfJets", &MultiJet::numberOfJets_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::MultiJet::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("threshold2");
-	returnValue.push_back("threshold3");
-	returnValue.push_back("threshold4");
-	returnValue.push_back("regionCut");
-	returnValue.push_back("numberOfJets");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::MultiJet::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::MultiJet::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="threshold3" ) return threshold3_;
-	else if( parameterName=="threshold4" ) return threshold4_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="numberOfJets" ) return numberOfJets_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::MultiJet::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="threshold3" ) return threshold3_;
-	else if( parameterName=="threshold4" ) return threshold4_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="numberOfJets" ) return numberOfJets_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::MultiJet::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::MultiJet::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -4,7 +4,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -43,7 +43,7 @@ namespace l1menu
 
 bool l1menu::triggers::MultiTkJet_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -54,20 +54,20 @@ bool l1menu::triggers::MultiTkJet_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 	int n3=0;
 	int n4=0;
 
-	int Nj = analysisDataFormat.NTkjet ;
+	int Nj = objects.trackJets.number ;
 	for (int ue=0; ue < Nj; ue++) {
-		int bx = analysisDataFormat.BxTkjet[ue];
+		int bx = objects.trackJets.bx[ue];
 		if (bx != 0) continue;
-//		bool isFwdJet = analysisDataFormat.Fwdjet[ue];
+//		bool isFwdJet = objects.jets.forward[ue];
 //		if (isFwdJet) continue;
-//		bool isTauJet = analysisDataFormat.Taujet[ue];
+//		bool isTauJet = objects.jets.tau[ue];
 //		if (isTauJet) continue;
 
-		float eta = analysisDataFormat.EtaTkjet[ue];
+		float eta = objects.trackJets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;
 
-		float rank = analysisDataFormat.EtTkjet[ue];
-		float pt = rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
+		float rank = objects.trackJets.et[ue];
+		float pt = rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
 		if (pt >= threshold1_) n1++;
 		if (pt >= threshold2_) n2++;
 		if (pt >= threshold3_) n3++;
@@ -91,7 +91,7 @@ unsigned int l1menu::triggers::MultiTkJet_v0::version() const
 
 bool l1menu::triggers::MultiTkJet_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -99,7 +99,7 @@ bool l1menu::triggers::MultiTkJet_v1::apply( const l1menu::L1TriggerDPGEvent& ev
 
         bool ok = false;
 
-	int Nj = analysisDataFormat.NTkjet ;
+	int Nj = objects.trackJets.number ;
 	int ue = 0;
 	while (ue < Nj && !ok) {
 
@@ -108,20 +108,20 @@ bool l1menu::triggers::MultiTkJet_v1::apply( const l1menu::L1TriggerDPGEvent& ev
         	int n3=0;
         	int n4=0;
 
-		int bx = analysisDataFormat.BxTkjet[ue];
+		int bx = objects.trackJets.bx[ue];
 		if (bx != 0) {ue++; continue;}  //ugh...probably should clean this up
 
-		float eta = analysisDataFormat.EtaTkjet[ue];
+		float eta = objects.trackJets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) {ue++; continue;}
 
-		float pt = analysisDataFormat.EtTkjet[ue];		
+		float pt = objects.trackJets.et[ue];		
 		if (pt >= threshold1_) {
 		    n1++;
-		    float jet1Zvtx = analysisDataFormat.zVtxTkjet[ue];
+		    float jet1Zvtx = objects.trackJets.zVertex[ue];
 		    for(int uj=0; uj<Nj; uj++) {
-		      if(fabs(jet1Zvtx - analysisDataFormat.zVtxTkjet[uj]) < zVtxCut_)  {
-		        float pt2 = analysisDataFormat.EtTkjet[uj];
-			float eta2 =  analysisDataFormat.EtaTkjet[uj];
+		      if(fabs(jet1Zvtx - objects.trackJets.zVertex[uj]) < zVtxCut_)  {
+		        float pt2 = objects.trackJets.et[uj];
+			float eta2 =  objects.trackJets.eta[uj];
 			if (eta2 < regionCut_ || eta2 > 21.-regionCut_) continue;
 		        if (pt2 >= threshold2_) n2++;
 		        if (pt2 >= threshold3_) n3++;
@@ -161,39 +161,46 @@ const std::string l1menu::triggers::MultiTkJet::name() const
 	return "L1_MultiTkJet";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::MultiTkJet>& l1menu::triggers::MultiTkJet::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<MultiTkJet> table={
+		{ "threshold1", &MultiTkJet::threshold1_ },
+		{ "threshold2", &MultiTkJet::threshold2_ },
+		{ "threshold3", &MultiTkJet::threshold3_ },
+		{ "threshold4", &MultiTkJet::threshold4_ },
+		{ "regionCut", &MultiTkJet::regionCut_ },
+		{ "zVtxCut", &MultiTkJet::zVtxCut_ },
+		{ "numberOfJets", &MultiTkJet::numberOfJets_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::MultiTkJet::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("threshold2");
-	returnValue.push_back("threshold3");
-	returnValue.push_back("threshold4");
-	returnValue.push_back("regionCut");
-	returnValue.push_back("zVtxCut");
-	returnValue.push_back("numberOfJets");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::MultiTkJet::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::MultiTkJet::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="threshold3" ) return threshold3_;
-	else if( parameterName=="threshold4" ) return threshold4_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="numberOfJets" ) return numberOfJets_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::MultiTkJet::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="threshold2" ) return threshold2_;
-	else if( parameterName=="threshold3" ) return threshold3_;
-	else if( parameterName=="threshold4" ) return threshold4_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="numberOfJets" ) return numberOfJets_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::MultiTkJet::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::MultiTkJet::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 //
 // Forward declarations
@@ -33,9 +34,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<MultiTkJet>& parameterTable();
 			float threshold1_;
 			float threshold2_;
 			float threshold3_;
@@ -1,9 +1,10 @@
 #include "SingleEGEta.h"
 
 #include <stdexcept>
+#include <limits>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -42,27 +43,43 @@ namespace l1menu
 //----------------------------------------------------------------------------------------
 
 
-bool l1menu::triggers::SingleEGEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+bool l1menu::triggers::SingleEGEta_v0::highestSelectedPt( const l1menu::L1TriggerDPGEvent& event, float& highestPt ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
-	bool ok=false;
-	int Nele = analysisDataFormat.Nele;
+	highestPt=-std::numeric_limits<float>::infinity();
+	bool found=false;
+	int Nele = objects.eg.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.Bxel[ue];
+		int bx = objects.eg.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.Etael[ue];
+		float eta = objects.eg.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.Etel[ue];    // the rank of the electron
+		float rank = objects.eg.et[ue];    // the rank of the electron
 		float pt = rank ;
-		if (pt >= threshold1_) ok = true;
+		if (pt >= highestPt) { highestPt = pt; found = true; }
 	}  // end loop over EM objects
 
-	return ok;
+	return found;
+}
+
+bool l1menu::triggers::SingleEGEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	return highestPt>=threshold1_;
+}
+
+bool l1menu::triggers::SingleEGEta_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	threshold1_=highestPt;
+	return true;
 }
 
 bool l1menu::triggers::SingleEGEta_v0::thresholdsAreCorrelated() const
@@ -86,24 +103,41 @@ const std::string l1menu::triggers::SingleEGEta::name() const
 	return "L1_SingleEG";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleEGEta>& l1menu::triggers::SingleEGEta::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleEGEta> table={
+		{ "threshold1", &SingleEGEta::threshold1_ },
+		{ "regionCut", &SingleEGEta::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleEGEta::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleEGEta::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleEGEta::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleEGEta::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleEGEta::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleEGEta::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
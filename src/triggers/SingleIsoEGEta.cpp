@@ -1,9 +1,10 @@
 #include "SingleIsoEGEta.h"
 
 #include <stdexcept>
+#include <limits>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -34,29 +35,45 @@ namespace l1menu
 
 
 
-bool l1menu::triggers::SingleIsoEGEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+bool l1menu::triggers::SingleIsoEGEta_v0::highestSelectedPt( const l1menu::L1TriggerDPGEvent& event, float& highestPt ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
-	bool ok=false;
-	int Nele = analysisDataFormat.Nele;
+	highestPt=-std::numeric_limits<float>::infinity();
+	bool found=false;
+	int Nele = objects.eg.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.Bxel[ue];
+		int bx = objects.eg.bx[ue];
 		if (bx != 0) continue;
-		bool iso = analysisDataFormat.Isoel[ue];
+		bool iso = objects.eg.isolated[ue];
 		if (! iso) continue;
-		float eta = analysisDataFormat.Etael[ue];
+		float eta = objects.eg.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.Etel[ue];    // the rank of the electron
+		float rank = objects.eg.et[ue];    // the rank of the electron
 		float pt = rank ;
-		if (pt >= threshold1_) ok = true;
+		if (pt >= highestPt) { highestPt = pt; found = true; }
 	}  // end loop over EM objects
 
-	return ok;
+	return found;
+}
+
+bool l1menu::triggers::SingleIsoEGEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	return highestPt>=threshold1_;
+}
+
+bool l1menu::triggers::SingleIsoEGEta_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	threshold1_=highestPt;
+	return true;
 }
 
 bool l1menu::triggers::SingleIsoEGEta_v0::thresholdsAreCorrelated() const
@@ -80,24 +97,41 @@ const std::string l1menu::triggers::SingleIsoEGEta::name() const
 	return "L1_SingleIsoEG";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleIsoEGEta>& l1menu::triggers::SingleIsoEGEta::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleIsoEGEta> table={
+		{ "threshold1", &SingleIsoEGEta::threshold1_ },
+		{ "regionCut", &SingleIsoEGEta::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleIsoEGEta::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleIsoEGEta::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleIsoEGEta::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleIsoEGEta::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleIsoEGEta::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleIsoEGEta::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
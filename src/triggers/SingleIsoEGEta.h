@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
+#include "l1menu/ITightestThresholds.h"
 
 //
 // Forward declarations
@@ -33,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<SingleIsoEGEta>& parameterTable();
 			float threshold1_;
 			float regionCut_;
 		}; // end of the SingleIsoEGEta base class
@@ -45,12 +52,16 @@ namespace l1menu
 		 * @author probably Brian Winer
 		 * @date sometime
 		 */
-		class SingleIsoEGEta_v0 : public SingleIsoEGEta
+		class SingleIsoEGEta_v0 : public SingleIsoEGEta, public l1menu::ITightestThresholds
 		{
 		public:
 			virtual unsigned int version() const;
 			virtual bool apply( const l1menu::L1TriggerDPGEvent& event ) const;
 			virtual bool thresholdsAreCorrelated() const;
+			virtual bool setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event );
+		private:
+			/** @brief Applies every cut in apply() except the threshold, and sets highestPt to the highest pt of the objects that pass. Returns false if none do. */
+			bool highestSelectedPt( const l1menu::L1TriggerDPGEvent& event, float& highestPt ) const;
 		}; // end of version 0 class
 
 	} // end of namespace triggers
@@ -2,9 +2,12 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include <limits>
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
+#include "l1menu/ITightestThresholds.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +32,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<SingleIsoTauJet>& parameterTable();
 			float threshold1_;
 			float regionCut_;
 		}; // end of the SingleIsoTauJet base class
@@ -41,12 +49,16 @@ namespace l1menu
 		 * @author probably Brian Winer
 		 * @date sometime
 		 */
-		class SingleIsoTauJet_v0 : public SingleIsoTauJet
+		class SingleIsoTauJet_v0 : public SingleIsoTauJet, public l1menu::ITightestThresholds
 		{
 		public:
 			virtual unsigned int version() const;
 			virtual bool apply( const l1menu::L1TriggerDPGEvent& event ) const;
 			virtual bool thresholdsAreCorrelated() const;
+			virtual bool setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event );
+		private:
+			/** @brief Applies every cut in apply() except the threshold, and sets highestPt to the highest pt of the objects that pass. Returns false if none do. */
+			bool highestSelectedPt( const l1menu::L1TriggerDPGEvent& event, float& highestPt ) const;
 		}; // end of version 0 class
 
 
@@ -81,30 +93,45 @@ namespace l1menu
 //----------------------------------------------------------------------------------------
 
 
-bool l1menu::triggers::SingleIsoTauJet_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+bool l1menu::triggers::SingleIsoTauJet_v0::highestSelectedPt( const l1menu::L1TriggerDPGEvent& event, float& highestPt ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];  // ZeroBias
 	if (! raw) return false;
 
-	int n1=0;
-	int Nj = analysisDataFormat.Njet ;
+	highestPt=-std::numeric_limits<float>::infinity();
+	bool found=false;
+	int Nj = objects.jets.number ;
 	for (int ue=0; ue < Nj; ue++) {
-		int bx = analysisDataFormat.Bxjet[ue];
+		int bx = objects.jets.bx[ue];
 		if (bx != 0) continue;
-		bool isIsoTauJet = analysisDataFormat.isoTaujet[ue];
+		bool isIsoTauJet = objects.jets.isolatedTau[ue];
 		if (! isIsoTauJet) continue;
-		float rank = analysisDataFormat.Etjet[ue];    // the rank of the electron
-		float pt = rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
-		float eta = analysisDataFormat.Etajet[ue];
+		float rank = objects.jets.et[ue];    // the rank of the electron
+		float pt = rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
+		float eta = objects.jets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
-		if (pt >= threshold1_) n1++;
+		if (pt >= highestPt) { highestPt = pt; found = true; }
 	}  // end loop over jets
 
-	bool ok = ( n1 >=1 );
-	return ok;
+	return found;
+}
+
+bool l1menu::triggers::SingleIsoTauJet_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	return highestPt>=threshold1_;
+}
+
+bool l1menu::triggers::SingleIsoTauJet_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	threshold1_=highestPt;
+	return true;
 }
 
 bool l1menu::triggers::SingleIsoTauJet_v0::thresholdsAreCorrelated() const
@@ -128,24 +155,41 @@ const std::string l1menu::triggers::SingleIsoTauJet::name() const
 	return "L1_SingleIsoTau";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleIsoTauJet>& l1menu::triggers::SingleIsoTauJet::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleIsoTauJet> table={
+		{ "threshold1", &SingleIsoTauJet::threshold1_ },
+		{ "regionCut", &SingleIsoTauJet::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleIsoTauJet::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleIsoTauJet::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleIsoTauJet::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleIsoTauJet::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleIsoTauJet::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleIsoTauJet::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
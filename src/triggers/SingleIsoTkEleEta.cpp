@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -37,22 +37,22 @@ namespace l1menu
 
 bool l1menu::triggers::SingleIsoTkEleEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
 	bool ok=false;
-	int NTkele = analysisDataFormat.NTkele;
+	int NTkele = objects.trackElectrons.number;
 	for (int ue=0; ue < NTkele; ue++) {
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0) continue;
-		bool iso = analysisDataFormat.IsoTkel[ue];
+		bool iso = objects.trackElectrons.isolated[ue];
 		if (! iso) continue;		
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel[ue];    // the rank of the electron
+		float rank = objects.trackElectrons.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= threshold1_) ok = true;
 	}  // end loop over EM objects
@@ -72,22 +72,22 @@ unsigned int l1menu::triggers::SingleIsoTkEleEta_v0::version() const
 
 bool l1menu::triggers::SingleIsoTkEleEta_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
 	bool ok=false;
-	int NTkele = analysisDataFormat.NTkele;
+	int NTkele = objects.trackElectrons.number;
 	for (int ue=0; ue < NTkele; ue++) {
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float iso = analysisDataFormat.tIsoTkel[ue];
+		float iso = objects.trackElectrons.trackIsolation[ue];
 		if (iso > trkIsolCut_ ) continue;		
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel[ue];    // the rank of the electron
+		float rank = objects.trackElectrons.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= threshold1_) ok = true;
 	}  // end loop over EM objects
@@ -117,27 +117,42 @@ const std::string l1menu::triggers::SingleIsoTkEleEta::name() const
 	return "L1_SingleIsoTkEle";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleIsoTkEleEta>& l1menu::triggers::SingleIsoTkEleEta::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleIsoTkEleEta> table={
+		{ "threshold1", &SingleIsoTkEleEta::threshold1_ },
+		{ "regionCut", &SingleIsoTkEleEta::regionCut_ },
+		{ "trkIsolCut", &SingleIsoTkEleEta::trkIsolCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleIsoTkEleEta::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	returnValue.push_back("trkIsolCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleIsoTkEleEta::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleIsoTkEleEta::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleIsoTkEleEta::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleIsoTkEleEta::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleIsoTkEleEta::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -44,22 +44,22 @@ namespace l1menu
 
 bool l1menu::triggers::SingleIsoTkTauEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];  // ZeroBias
 	if (! raw) return false;
 
 	int n1=0;
-	int Nt = analysisDataFormat.NTktau ;
+	int Nt = objects.trackTaus.number ;
 	for (int ue=0; ue < Nt; ue++) {
-		int bx = analysisDataFormat.BxTktau[ue];
+		int bx = objects.trackTaus.bx[ue];
 		if (bx != 0) continue;
-		bool iso = analysisDataFormat.IsoTktau[ue];
+		bool iso = objects.trackTaus.isolated[ue];
 		if (! iso) continue;				
-		float rank = analysisDataFormat.EtTktau[ue];    // the rank of the electron
-		float pt = rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
-		float eta = analysisDataFormat.EtaTktau[ue];
+		float rank = objects.trackTaus.et[ue];    // the rank of the electron
+		float pt = rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
+		float eta = objects.trackTaus.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
 		if (pt >= threshold1_) n1++;
 	}  // end loop over jets
@@ -89,24 +89,41 @@ const std::string l1menu::triggers::SingleIsoTkTauEta::name() const
 	return "L1_SingleIsoTkTau";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleIsoTkTauEta>& l1menu::triggers::SingleIsoTkTauEta::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleIsoTkTauEta> table={
+		{ "threshold1", &SingleIsoTkTauEta::threshold1_ },
+		{ "regionCut", &SingleIsoTkTauEta::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleIsoTkTauEta::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleIsoTkTauEta::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleIsoTkTauEta::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleIsoTkTauEta::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleIsoTkTauEta::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleIsoTkTauEta::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
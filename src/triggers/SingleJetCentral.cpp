@@ -2,10 +2,11 @@
 
 
 #include <stdexcept>
+#include <limits>
 
 #include "l1menu/L1TriggerDPGEvent.h"
 #include "../implementation/RegisterTriggerMacro.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -44,33 +45,49 @@ namespace l1menu
 //----------------------------------------------------------------------------------------
 
 
-bool l1menu::triggers::SingleJetCentral_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+bool l1menu::triggers::SingleJetCentral_v0::highestSelectedPt( const l1menu::L1TriggerDPGEvent& event, float& highestPt ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];  // ZeroBias
 	if (! raw) return false;
 
-	bool ok=false;
-	int Nj = analysisDataFormat.Njet ;
+	highestPt=-std::numeric_limits<float>::infinity();
+	bool found=false;
+	int Nj = objects.jets.number ;
 	for (int ue=0; ue < Nj; ue++) {
-		int bx = analysisDataFormat.Bxjet[ue];
+		int bx = objects.jets.bx[ue];
 		if (bx != 0) continue;
-		bool isFwdJet = analysisDataFormat.Fwdjet[ue];
+		bool isFwdJet = objects.jets.forward[ue];
 		if (isFwdJet) continue;
-		bool isTauJet = analysisDataFormat.Taujet[ue];
+		bool isTauJet = objects.jets.tau[ue];
 		if (isTauJet) continue;
 
-		float eta = analysisDataFormat.Etajet[ue];
+		float eta = objects.jets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
 
-		float rank = analysisDataFormat.Etjet[ue];
-		float pt = rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
-		if (pt >= threshold1_) ok = true;
+		float rank = objects.jets.et[ue];
+		float pt = rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
+		if (pt >= highestPt) { highestPt = pt; found = true; }
 	}
 
-	return ok;
+	return found;
+}
+
+bool l1menu::triggers::SingleJetCentral_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	return highestPt>=threshold1_;
+}
+
+bool l1menu::triggers::SingleJetCentral_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	threshold1_=highestPt;
+	return true;
 }
 
 bool l1menu::triggers::SingleJetCentral_v0::thresholdsAreCorrelated() const
@@ -94,24 +111,41 @@ const std::string l1menu::triggers::SingleJetCentral::name() const
 	return "L1_SingleJetC";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleJetCentral>& l1menu::triggers::SingleJetCentral::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleJetCentral> table={
+		{ "threshold1", &SingleJetCentral::threshold1_ },
+		{ "regionCut", &SingleJetCentral::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleJetCentral::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleJetCentral::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleJetCentral::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleJetCentral::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleJetCentral::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleJetCentral::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
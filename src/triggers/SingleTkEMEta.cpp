@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -44,21 +44,21 @@ namespace l1menu
 
 bool l1menu::triggers::SingleTkEMEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
 	bool ok=false;
-	int NTkem = analysisDataFormat.NTkem;
+	int NTkem = objects.trackEMs.number;
 	for (int ue=0; ue < NTkem; ue++) {
-		int bx = analysisDataFormat.BxTkem[ue];
+		int bx = objects.trackEMs.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkem[ue];
+		float eta = objects.trackEMs.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float pt = analysisDataFormat.EtTkem[ue];    // the rank of the electron
-		float tkI= analysisDataFormat.tIsoTkem[ue];
+		float pt = objects.trackEMs.et[ue];    // the rank of the electron
+		float tkI= objects.trackEMs.trackIsolation[ue];
 		if (pt >= threshold1_ && tkI<tkIsoCut_) ok = true;
 	}  // end loop over EM objects
 
@@ -86,27 +86,42 @@ const std::string l1menu::triggers::SingleTkEMEta::name() const
 	return "L1_SingleTkEM";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleTkEMEta>& l1menu::triggers::SingleTkEMEta::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleTkEMEta> table={
+		{ "threshold1", &SingleTkEMEta::threshold1_ },
+		{ "regionCut", &SingleTkEMEta::regionCut_ },
+		{ "trkIsolCut", &SingleTkEMEta::tkIsoCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleTkEMEta::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	returnValue.push_back("trkIsolCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleTkEMEta::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleTkEMEta::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="trkIsolCut" ) return tkIsoCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleTkEMEta::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else if( parameterName=="trkIsolCut" ) return tkIsoCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleTkEMEta::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleTkEMEta::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -45,20 +45,20 @@ namespace l1menu
 
 bool l1menu::triggers::SingleTkEleEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
 	bool ok=false;
-	int NTkele = analysisDataFormat.NTkele;
+	int NTkele = objects.trackElectrons.number;
 	for (int ue=0; ue < NTkele; ue++) {
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel[ue];    // the rank of the electron
+		float rank = objects.trackElectrons.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= threshold1_) ok = true;
 	}  // end loop over EM objects
@@ -78,20 +78,20 @@ unsigned int l1menu::triggers::SingleTkEleEta_v0::version() const
 
 bool l1menu::triggers::SingleTkEleEta_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
 	bool ok=false;
-	int NTkele = analysisDataFormat.NTkele2;
+	int NTkele = objects.lowPtTrackElectrons.number;
 	for (int ue=0; ue < NTkele; ue++) {
-		int bx = analysisDataFormat.BxTkel2[ue];
+		int bx = objects.lowPtTrackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel2[ue];
+		float eta = objects.lowPtTrackElectrons.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel2[ue];    // the rank of the electron
+		float rank = objects.lowPtTrackElectrons.et[ue];    // the rank of the electron
 		float pt = rank ;
 		if (pt >= threshold1_) ok = true;
 	}  // end loop over EM objects
@@ -120,24 +120,41 @@ const std::string l1menu::triggers::SingleTkEleEta::name() const
 	return "L1_SingleTkEle";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleTkEleEta>& l1menu::triggers::SingleTkEleEta::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleTkEleEta> table={
+		{ "threshold1", &SingleTkEleEta::threshold1_ },
+		{ "regionCut", &SingleTkEleEta::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleTkEleEta::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleTkEleEta::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleTkEleEta::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleTkEleEta::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleTkEleEta::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleTkEleEta::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -5,7 +5,7 @@
 
 #include "l1menu/L1TriggerDPGEvent.h"
 #include "../implementation/RegisterTriggerMacro.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -46,22 +46,22 @@ namespace l1menu
 
 bool l1menu::triggers::SingleTkJet_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];  // ZeroBias
 	if (! raw) return false;
 
 	bool ok=false;
-	int Nj = analysisDataFormat.NTkjet ;
+	int Nj = objects.trackJets.number ;
 	for (int ue=0; ue < Nj; ue++) {
-		int bx = analysisDataFormat.BxTkjet[ue];
+		int bx = objects.trackJets.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkjet[ue];
+		float eta = objects.trackJets.eta[ue];
 		if (eta < regionCut_ || eta > 21.-regionCut_) continue;  // eta = 5 - 16
 
-		float rank = analysisDataFormat.EtTkjet[ue];
-		float pt = rank; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[ue],rank*4.,theL1JetCorrection);
+		float rank = objects.trackJets.et[ue];
+		float pt = rank; //CorrectedL1JetPtByGCTregions(objects.jets.eta[ue],rank*4.,theL1JetCorrection);
 		if (pt >= threshold1_) ok = true;
 	}
 
@@ -89,24 +89,41 @@ const std::string l1menu::triggers::SingleTkJet::name() const
 	return "L1_SingleTkJet";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleTkJet>& l1menu::triggers::SingleTkJet::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleTkJet> table={
+		{ "threshold1", &SingleTkJet::threshold1_ },
+		{ "regionCut", &SingleTkJet::regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleTkJet::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleTkJet::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleTkJet::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleTkJet::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="regionCut" ) return regionCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleTkJet::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleTkJet::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
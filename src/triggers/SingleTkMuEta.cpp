@@ -2,10 +2,11 @@
 
 #include <cmath>
 #include <stdexcept>
+#include <limits>
 
 #include "l1menu/L1TriggerDPGEvent.h"
 #include "../implementation/RegisterTriggerMacro.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -43,36 +44,51 @@ namespace l1menu
 //----------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------
 
-bool l1menu::triggers::SingleTkMuEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+bool l1menu::triggers::SingleTkMuEta_v0::highestSelectedPt( const l1menu::L1TriggerDPGEvent& event, float& highestPt ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
-	bool muon = false;
+	highestPt=-std::numeric_limits<float>::infinity();
+	bool found=false;
 
-	int Nmu = analysisDataFormat.NTkmu;
+	int Nmu = objects.trackMuons.number;
 	for (int imu=0; imu < Nmu; imu++) {
-		int bx = analysisDataFormat.BxTkmu.at(imu);
+		int bx = objects.trackMuons.bx[imu];
 		// This next comment line is copied from the original SingleIsoMuEta. It's commented out
 		// in that trigger which leaves SingleTkMuEta and SingleIsoMuEta the same. I've set up
 		// SingleIsoMuEta essentially as an alias for this trigger, but I'll leave this comment
 		// in for reference in case I ever have to add the functionality back. MG 05/Jun/2013.
-		//if (bx != 0 || !analysisDataFormat.Isomu.at(imu)) continue;
+		//if (bx != 0 || !objects.muons.isolated[imu]) continue;
 		if (bx != 0) continue;
-		float pt = analysisDataFormat.PtTkmu.at(imu);
-		int qual = analysisDataFormat.QualTkmu.at(imu);
+		float pt = objects.trackMuons.pt[imu];
+		int qual = objects.trackMuons.quality[imu];
 		if ( qual < muonQuality_) continue;
-		float eta = analysisDataFormat.EtaTkmu.at(imu);
+		float eta = objects.trackMuons.eta[imu];
 
 		if (std::fabs(eta) > etaCut_) continue;
-		if (pt >= threshold1_) muon = true;
+		if (pt >= highestPt) { highestPt = pt; found = true; }
 	}
 
-	bool ok = muon;
-	return ok;
+	return found;
+}
+
+bool l1menu::triggers::SingleTkMuEta_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	return highestPt>=threshold1_;
+}
+
+bool l1menu::triggers::SingleTkMuEta_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	float highestPt;
+	if( !highestSelectedPt( event, highestPt ) ) return false;
+	threshold1_=highestPt;
+	return true;
 }
 
 bool l1menu::triggers::SingleTkMuEta_v0::thresholdsAreCorrelated() const
@@ -96,27 +112,42 @@ const std::string l1menu::triggers::SingleTkMuEta::name() const
 	return "L1_SingleTkMu";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::SingleTkMuEta>& l1menu::triggers::SingleTkMuEta::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<SingleTkMuEta> table={
+		{ "threshold1", &SingleTkMuEta::threshold1_ },
+		{ "muonQuality", &SingleTkMuEta::muonQuality_ },
+		{ "etaCut", &SingleTkMuEta::etaCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::SingleTkMuEta::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	returnValue.push_back("muonQuality");
-	returnValue.push_back("etaCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::SingleTkMuEta::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::SingleTkMuEta::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="etaCut" ) return etaCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::SingleTkMuEta::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="etaCut" ) return etaCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::SingleTkMuEta::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::SingleTkMuEta::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -33,9 +34,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkEM_EG>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float leg1regionCut_;
@@ -92,7 +98,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkEM_EG_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -100,29 +106,29 @@ bool l1menu::triggers::TkEM_EG_v0::apply( const l1menu::L1TriggerDPGEvent& event
 
 	bool ok = false;
 
-	int Neg = analysisDataFormat.Nele;
+	int Neg = objects.eg.number;
 
-	int Nem = analysisDataFormat.NTkem;
+	int Nem = objects.trackEMs.number;
 	for (int ue=0; ue < Nem; ue++) {
-		int bx = analysisDataFormat.BxTkem[ue];
+		int bx = objects.trackEMs.bx[ue];
 		if (bx != 0 ) continue;
-		float eta = analysisDataFormat.EtaTkem[ue];
+		float eta = objects.trackEMs.eta[ue];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16
-		float pt = analysisDataFormat.EtTkem[ue];    // the rank of the electron
-		float tkI= analysisDataFormat.tIsoTkem[ue];
+		float pt = objects.trackEMs.et[ue];    // the rank of the electron
+		float tkI= objects.trackEMs.trackIsolation[ue];
 		if (pt >= leg1threshold1_ && tkI<tkIsoCut_){
 
                         
 			for (int uj=0; uj < Neg; uj++) {
-				int bxj = analysisDataFormat.Bxel[uj];
+				int bxj = objects.eg.bx[uj];
 				if (bxj != 0) continue;
-				float rankj = analysisDataFormat.Etel[uj];
-				float ptj = rankj; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[uj],rank*4.,theL1JetCorrection);
+				float rankj = objects.eg.et[uj];
+				float ptj = rankj; //CorrectedL1JetPtByGCTregions(objects.jets.eta[uj],rank*4.,theL1JetCorrection);
 
-				if (analysisDataFormat.Etael[uj] < leg2regionCut_ || analysisDataFormat.Etael[uj] > 21.-leg2regionCut_) continue;
+				if (objects.eg.eta[uj] < leg2regionCut_ || objects.eg.eta[uj] > 21.-leg2regionCut_) continue;
 				if (ptj >= leg2threshold1_ &&
-					!(analysisDataFormat.Etael[uj]==analysisDataFormat.EtaTkem[ue] &&
-					  analysisDataFormat.Phiel[uj]==analysisDataFormat.PhiTkem[ue]) ) ok = true;
+					!(objects.eg.eta[uj]==objects.trackEMs.eta[ue] &&
+					  objects.eg.phi[uj]==objects.trackEMs.phi[ue]) ) ok = true;
 			}
 
 		} // if good TkEle
@@ -154,33 +160,44 @@ const std::string l1menu::triggers::TkEM_EG::name() const
 	return "L1_TkEM_EG";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkEM_EG>& l1menu::triggers::TkEM_EG::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkEM_EG> table={
+		{ "leg1threshold1", &TkEM_EG::leg1threshold1_ },
+		{ "leg1regionCut", &TkEM_EG::leg1regionCut_ },
+		{ "leg2threshold1", &TkEM_EG::leg2threshold1_ },
+		{ "leg2regionCut", &TkEM_EG::leg2regionCut_ },
+		{ "trkIsolCut", &TkEM_EG::tkIsoCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkEM_EG::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("leg2regionCut");
-	returnValue.push_back("trkIsolCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkEM_EG::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkEM_EG::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="trkIsolCut" ) return tkIsoCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkEM_EG::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="trkIsolCut" ) return tkIsoCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkEM_EG::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkEM_EG::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -29,9 +30,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkETM>& parameterTable();
 			float threshold1_;
 		}; // end of the TkETM base class
 
@@ -82,16 +88,16 @@ namespace l1menu
 
 bool l1menu::triggers::TkETM_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0];   // ZeroBias
 	if( !raw ) return false;
 
-//	float adc=analysisDataFormat.tkMissingEt;
+//	float adc=objects.sums.trackMissingEt;
 //	float TheTkETM=adc; // / 2. ;
 
-	if( analysisDataFormat.TkETM < threshold1_ ) return false;
+	if( objects.sums.trackMissingEt < threshold1_ ) return false;
 	return true;
 }
 
@@ -116,21 +122,40 @@ const std::string l1menu::triggers::TkETM::name() const
 	return "L1_TkETM";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkETM>& l1menu::triggers::TkETM::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkETM> table={
+		{ "threshold1", &TkETM::threshold1_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkETM::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkETM::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkETM::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkETM::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkETM::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkETM::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
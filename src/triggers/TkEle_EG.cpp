@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -33,9 +34,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkEle_EG>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float leg1regionCut_;
@@ -106,7 +112,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkEle_EG_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -114,31 +120,31 @@ bool l1menu::triggers::TkEle_EG_v0::apply( const l1menu::L1TriggerDPGEvent& even
 
 	bool ok = false;
 
-	int Neg = analysisDataFormat.Nele;
+	int Neg = objects.eg.number;
 
-	int Nele = analysisDataFormat.NTkele;
+	int Nele = objects.trackElectrons.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0 ) continue;
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16
-		float rank = analysisDataFormat.EtTkel[ue];    // the rank of the electron
-		float tkI= analysisDataFormat.tIsoTkel[ue];
+		float rank = objects.trackElectrons.et[ue];    // the rank of the electron
+		float tkI= objects.trackElectrons.trackIsolation[ue];
 		if(tkI>trkIsolCut_) continue;
 		float pt = rank ;
 		if (pt >= leg1threshold1_){
 
                         
 			for (int uj=0; uj < Neg; uj++) {
-				int bxj = analysisDataFormat.Bxel[uj];
+				int bxj = objects.eg.bx[uj];
 				if (bxj != 0) continue;
-				float rankj = analysisDataFormat.Etel[uj];
-				float ptj = rankj; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[uj],rank*4.,theL1JetCorrection);
+				float rankj = objects.eg.et[uj];
+				float ptj = rankj; //CorrectedL1JetPtByGCTregions(objects.jets.eta[uj],rank*4.,theL1JetCorrection);
 
-				if (analysisDataFormat.Etael[uj] < leg2regionCut_ || analysisDataFormat.Etael[uj] > 21.-leg2regionCut_) continue;
+				if (objects.eg.eta[uj] < leg2regionCut_ || objects.eg.eta[uj] > 21.-leg2regionCut_) continue;
 				if (ptj >= leg2threshold1_ &&
-					!(analysisDataFormat.Etael[uj]==analysisDataFormat.EtaTkel[ue] &&
-					  analysisDataFormat.Phiel[uj]==analysisDataFormat.PhiTkel[ue]) ) ok = true;
+					!(objects.eg.eta[uj]==objects.trackElectrons.eta[ue] &&
+					  objects.eg.phi[uj]==objects.trackElectrons.phi[ue]) ) ok = true;
 			}
 
 	
@@ -163,7 +169,7 @@ unsigned int l1menu::triggers::TkEle_EG_v0::version() const
 
 bool l1menu::triggers::TkEle_EG_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -171,31 +177,31 @@ bool l1menu::triggers::TkEle_EG_v1::apply( const l1menu::L1TriggerDPGEvent& even
 
 	bool ok = false;
 
-	int Neg = analysisDataFormat.Nele;
+	int Neg = objects.eg.number;
 
-	int Nele = analysisDataFormat.NTkele2;
+	int Nele = objects.lowPtTrackElectrons.number;
 	for (int ue=0; ue < Nele; ue++) {
-		int bx = analysisDataFormat.BxTkel2[ue];
+		int bx = objects.lowPtTrackElectrons.bx[ue];
 		if (bx != 0 ) continue;
-		float eta = analysisDataFormat.EtaTkel2[ue];
+		float eta = objects.lowPtTrackElectrons.eta[ue];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16
-		float tkI= analysisDataFormat.tIsoTkel2[ue];
+		float tkI= objects.lowPtTrackElectrons.trackIsolation[ue];
 		if(tkI>trkIsolCut_) continue;
 		
-		float pt = analysisDataFormat.EtTkel2[ue];
+		float pt = objects.lowPtTrackElectrons.et[ue];
 		if (pt >= leg1threshold1_){
 
                         
 			for (int uj=0; uj < Neg; uj++) {
-				int bxj = analysisDataFormat.Bxel[uj];
+				int bxj = objects.eg.bx[uj];
 				if (bxj != 0) continue;
-				float rankj = analysisDataFormat.Etel[uj];
-				float ptj = rankj; //CorrectedL1JetPtByGCTregions(analysisDataFormat.Etajet[uj],rank*4.,theL1JetCorrection);
+				float rankj = objects.eg.et[uj];
+				float ptj = rankj; //CorrectedL1JetPtByGCTregions(objects.jets.eta[uj],rank*4.,theL1JetCorrection);
 
-				if (analysisDataFormat.Etael[uj] < leg2regionCut_ || analysisDataFormat.Etael[uj] > 21.-leg2regionCut_) continue;
+				if (objects.eg.eta[uj] < leg2regionCut_ || objects.eg.eta[uj] > 21.-leg2regionCut_) continue;
 				if (ptj >= leg2threshold1_ &&
-					!(analysisDataFormat.Etael[uj]==analysisDataFormat.EtaTkel2[ue] &&
-					  analysisDataFormat.Phiel[uj]==analysisDataFormat.PhiTkel2[ue]) ) ok = true;
+					!(objects.eg.eta[uj]==objects.lowPtTrackElectrons.eta[ue] &&
+					  objects.eg.phi[uj]==objects.lowPtTrackElectrons.phi[ue]) ) ok = true;
 			}
 
 		} // if good TkEle
@@ -228,33 +234,44 @@ const std::string l1menu::triggers::TkEle_EG::name() const
 	return "L1_TkEle_EG";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkEle_EG>& l1menu::triggers::TkEle_EG::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkEle_EG> table={
+		{ "leg1threshold1", &TkEle_EG::leg1threshold1_ },
+		{ "leg1regionCut", &TkEle_EG::leg1regionCut_ },
+		{ "leg2threshold1", &TkEle_EG::leg2threshold1_ },
+		{ "leg2regionCut", &TkEle_EG::leg2regionCut_ },
+		{ "trkIsolCut", &TkEle_EG::trkIsolCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkEle_EG::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("leg2regionCut");
-	returnValue.push_back("trkIsolCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkEle_EG::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkEle_EG::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkEle_EG::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkEle_EG::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkEle_EG::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -3,9 +3,10 @@
 #include <TMath.h>
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -34,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkEle_Tau>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float leg1regionCut_;
@@ -107,7 +113,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkEle_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -115,34 +121,34 @@ bool l1menu::triggers::TkEle_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& eve
 
 	bool ok = false;
 
-	int NTkele=analysisDataFormat.NTkele;
-	int Nj=analysisDataFormat.Njet;
+	int NTkele=objects.trackElectrons.number;
+	int Nj=objects.jets.number;
 	
 	for( int ie=0; ie<NTkele; ie++ )
 	{
 
-		int bx=analysisDataFormat.BxTkel.at( ie );
+		int bx=objects.trackElectrons.bx[ ie ];
 		if( bx!=0 ) continue;
-		float pt = analysisDataFormat.EtTkel.at( ie );
-		float eta = analysisDataFormat.EtaTkel[ie];
+		float pt = objects.trackElectrons.et[ ie ];
+		float eta = objects.trackElectrons.eta[ie];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
-		float tkI= analysisDataFormat.tIsoTkel[ie];
+		float tkI= objects.trackElectrons.trackIsolation[ie];
 		if(tkI>trkIsolCut_) continue;
 
 		if( pt>=leg1threshold1_ ) {
 
 			for (int ut=0; ut < Nj; ut++) {
-				int bx = analysisDataFormat.Bxjet[ut];
+				int bx = objects.jets.bx[ut];
 				if (bx != 0) continue;
-				bool isTauJet = analysisDataFormat.Taujet[ut];
+				bool isTauJet = objects.jets.tau[ut];
 				if (! isTauJet) continue;
-				float pt2 = analysisDataFormat.Etjet[ut];    // the rank of the electron
-				float eta2 = analysisDataFormat.Etajet[ut];
+				float pt2 = objects.jets.et[ut];    // the rank of the electron
+				float eta2 = objects.jets.eta[ut];
 				if (eta2 < leg2regionCut_ || eta2 > 21.-leg2regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
 
                                 //remove overlap with simple delta R for now.
-                                float delEta = fabs(analysisDataFormat.Etajet[ut]-analysisDataFormat.EtaTkel[ie]);
-				float delPhi = fabs(analysisDataFormat.Phijet[ut]-analysisDataFormat.PhiTkel[ie]);
+                                float delEta = fabs(objects.jets.eta[ut]-objects.trackElectrons.eta[ie]);
+				float delPhi = fabs(objects.jets.phi[ut]-objects.trackElectrons.phi[ie]);
 				if(delPhi>TMath::Pi()) delPhi = TMath::TwoPi() - delPhi;
 				float delR = sqrt(delEta*delEta + delPhi*delPhi);
 
@@ -170,7 +176,7 @@ unsigned int l1menu::triggers::TkEle_Tau_v0::version() const
 
 bool l1menu::triggers::TkEle_Tau_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -178,35 +184,35 @@ bool l1menu::triggers::TkEle_Tau_v1::apply( const l1menu::L1TriggerDPGEvent& eve
 
 	bool ok = false;
 
-	int NTkele=analysisDataFormat.NTkele2;
-	int Nj=analysisDataFormat.Njet;
+	int NTkele=objects.lowPtTrackElectrons.number;
+	int Nj=objects.jets.number;
 	
 	for( int ie=0; ie<NTkele; ie++ )
 	{
 
-		int bx=analysisDataFormat.BxTkel2.at( ie );
+		int bx=objects.lowPtTrackElectrons.bx[ ie ];
 		if( bx!=0 ) continue;
-		float pt = analysisDataFormat.EtTkel2.at( ie );
-		float eta = analysisDataFormat.EtaTkel2[ie];
+		float pt = objects.lowPtTrackElectrons.et[ ie ];
+		float eta = objects.lowPtTrackElectrons.eta[ie];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
-		float tkI= analysisDataFormat.tIsoTkel2[ie];
+		float tkI= objects.lowPtTrackElectrons.trackIsolation[ie];
 		if(tkI>trkIsolCut_) continue;
 
 		if( pt>=leg1threshold1_ ) {
 		  
 
 			for (int ut=0; ut < Nj; ut++) {
-				int bx = analysisDataFormat.Bxjet[ut];
+				int bx = objects.jets.bx[ut];
 				if (bx != 0) continue;
-				bool isTauJet = analysisDataFormat.Taujet[ut];
+				bool isTauJet = objects.jets.tau[ut];
 				if (! isTauJet) continue;
-				float pt2 = analysisDataFormat.Etjet[ut];    // the rank of the electron
-				float eta2 = analysisDataFormat.Etajet[ut];
+				float pt2 = objects.jets.et[ut];    // the rank of the electron
+				float eta2 = objects.jets.eta[ut];
 				if (eta2 < leg2regionCut_ || eta2 > 21.-leg2regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
 
                                 //remove overlap with simple delta R for now.
-                                float delEta = fabs(analysisDataFormat.Etajet[ut]-analysisDataFormat.EtaTkel2[ie]);
-				float delPhi = fabs(analysisDataFormat.Phijet[ut]-analysisDataFormat.PhiTkel2[ie]);
+                                float delEta = fabs(objects.jets.eta[ut]-objects.lowPtTrackElectrons.eta[ie]);
+				float delPhi = fabs(objects.jets.phi[ut]-objects.lowPtTrackElectrons.phi[ie]);
 				if(delPhi>TMath::Pi()) delPhi = TMath::TwoPi() - delPhi;
 				float delR = sqrt(delEta*delEta + delPhi*delPhi);
 
@@ -245,33 +251,44 @@ const std::string l1menu::triggers::TkEle_Tau::name() const
 	return "L1_TkEle_Tau";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkEle_Tau>& l1menu::triggers::TkEle_Tau::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkEle_Tau> table={
+		{ "leg1threshold1", &TkEle_Tau::leg1threshold1_ },
+		{ "leg2threshold1", &TkEle_Tau::leg2threshold1_ },
+		{ "leg1regionCut", &TkEle_Tau::leg1regionCut_ },
+		{ "leg2regionCut", &TkEle_Tau::leg2regionCut_ },
+		{ "trkIsolCut", &TkEle_Tau::trkIsolCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkEle_Tau::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2regionCut");
-	returnValue.push_back("trkIsolCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkEle_Tau::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkEle_Tau::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkEle_Tau::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkEle_Tau::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkEle_Tau::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
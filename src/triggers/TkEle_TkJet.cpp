@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -34,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkEle_TkJet>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float leg1regionCut_;
@@ -106,7 +112,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkEle_TkJet_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -114,31 +120,31 @@ bool l1menu::triggers::TkEle_TkJet_v1::apply( const l1menu::L1TriggerDPGEvent& e
 
 	bool ok = false;
 
-	int Nj = analysisDataFormat.NTkjet ;
+	int Nj = objects.trackJets.number ;
 
-	int NTkele = analysisDataFormat.NTkele;
+	int NTkele = objects.trackElectrons.number;
 	for (int ue=0; ue < NTkele; ue++) {
 
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16
-		float pt = analysisDataFormat.EtTkel[ue];    // the rank of the electron
+		float pt = objects.trackElectrons.et[ue];    // the rank of the electron
 		if (pt >= leg1threshold1_){
 
 			
-                        float eleZvtx = analysisDataFormat.zVtxTkel[ue];
+                        float eleZvtx = objects.trackElectrons.zVertex[ue];
 			 
 			for (int uj=0; uj < Nj; uj++) {
-			   if(fabs(eleZvtx - analysisDataFormat.zVtxTkjet[uj]) < zVtxCut_)  {
-				int bxj = analysisDataFormat.BxTkjet[uj];
+			   if(fabs(eleZvtx - objects.trackJets.zVertex[uj]) < zVtxCut_)  {
+				int bxj = objects.trackJets.bx[uj];
 				if (bxj != 0) continue;
-				float ptj = analysisDataFormat.EtTkjet[uj];
+				float ptj = objects.trackJets.et[uj];
 
-				if (analysisDataFormat.EtaTkjet[uj] < leg2regionCut_ || analysisDataFormat.EtaTkjet[uj] > 21.-leg2regionCut_) continue;
+				if (objects.trackJets.eta[uj] < leg2regionCut_ || objects.trackJets.eta[uj] > 21.-leg2regionCut_) continue;
 				if (ptj >= leg2threshold1_ &&
-					!(analysisDataFormat.EtaTkjet[uj]==analysisDataFormat.EtaTkel[ue] &&
-					  analysisDataFormat.PhiTkjet[uj]==analysisDataFormat.PhiTkel[ue]) ) ok = true;
+					!(objects.trackJets.eta[uj]==objects.trackElectrons.eta[ue] &&
+					  objects.trackJets.phi[uj]==objects.trackElectrons.phi[ue]) ) ok = true;
 			   } //end z-vtx cut
 			}
 
@@ -164,7 +170,7 @@ unsigned int l1menu::triggers::TkEle_TkJet_v1::version() const
 
 bool l1menu::triggers::TkEle_TkJet_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -172,27 +178,27 @@ bool l1menu::triggers::TkEle_TkJet_v0::apply( const l1menu::L1TriggerDPGEvent& e
 
 	bool ok = false;
 
-	int Nj = analysisDataFormat.NTkjet ;
+	int Nj = objects.trackJets.number ;
 
-	int NTkele = analysisDataFormat.NTkele;
+	int NTkele = objects.trackElectrons.number;
 	for (int ue=0; ue < NTkele; ue++) {
-		int bx = analysisDataFormat.BxTkel[ue];
+		int bx = objects.trackElectrons.bx[ue];
 		if (bx != 0) continue;
-		float eta = analysisDataFormat.EtaTkel[ue];
+		float eta = objects.trackElectrons.eta[ue];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16
-		float pt = analysisDataFormat.EtTkel[ue];    // the rank of the electron
+		float pt = objects.trackElectrons.et[ue];    // the rank of the electron
 		if (pt >= leg1threshold1_){
 
 
 			for (int uj=0; uj < Nj; uj++) {
-				int bxj = analysisDataFormat.BxTkjet[uj];
+				int bxj = objects.trackJets.bx[uj];
 				if (bxj != 0) continue;
-				float ptj = analysisDataFormat.EtTkjet[uj];
+				float ptj = objects.trackJets.et[uj];
 
-				if (analysisDataFormat.EtaTkjet[uj] < leg2regionCut_ || analysisDataFormat.EtaTkjet[uj] > 21.-leg2regionCut_) continue;
+				if (objects.trackJets.eta[uj] < leg2regionCut_ || objects.trackJets.eta[uj] > 21.-leg2regionCut_) continue;
 				if (ptj >= leg2threshold1_ &&
-					!(analysisDataFormat.EtaTkjet[uj]==analysisDataFormat.EtaTkel[ue] &&
-					  analysisDataFormat.PhiTkjet[uj]==analysisDataFormat.PhiTkel[ue]) ) ok = true;
+					!(objects.trackJets.eta[uj]==objects.trackElectrons.eta[ue] &&
+					  objects.trackJets.phi[uj]==objects.trackElectrons.phi[ue]) ) ok = true;
 			}
 
 			
@@ -225,33 +231,44 @@ const std::string l1menu::triggers::TkEle_TkJet::name() const
 	return "L1_TkEle_TkJet";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkEle_TkJet>& l1menu::triggers::TkEle_TkJet::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkEle_TkJet> table={
+		{ "leg1threshold1", &TkEle_TkJet::leg1threshold1_ },
+		{ "leg1regionCut", &TkEle_TkJet::leg1regionCut_ },
+		{ "leg2threshold1", &TkEle_TkJet::leg2threshold1_ },
+		{ "leg2regionCut", &TkEle_TkJet::leg2regionCut_ },
+		{ "zVtxCut", &TkEle_TkJet::zVtxCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkEle_TkJet::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("leg2regionCut");
-	returnValue.push_back("zVtxCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkEle_TkJet::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkEle_TkJet::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkEle_TkJet::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkEle_TkJet::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkEle_TkJet::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
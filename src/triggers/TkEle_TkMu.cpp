@@ -3,9 +3,10 @@
 #include <TMath.h>
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -34,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkEle_TkMu>& parameterTable();
 			float leg1threshold1_;
 			float leg1regionCut_;
 			float leg2threshold1_;
@@ -134,7 +140,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkEle_TkMu_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -142,18 +148,18 @@ bool l1menu::triggers::TkEle_TkMu_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	bool ok = false;
 
-	int NTkele=analysisDataFormat.NTkele;
-	int NTkmu=analysisDataFormat.NTkmu;
+	int NTkele=objects.trackElectrons.number;
+	int NTkmu=objects.trackMuons.number;
 	
 	for( int ie=0; ie<NTkele; ie++ )
 	{
 
-		int bx=analysisDataFormat.BxTkel.at( ie );
+		int bx=objects.trackElectrons.bx[ ie ];
 		if( bx!=0 ) continue;
-		float pt = analysisDataFormat.EtTkel.at( ie );
-		float eta = analysisDataFormat.EtaTkel[ie];
+		float pt = objects.trackElectrons.et[ ie ];
+		float eta = objects.trackElectrons.eta[ie];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
-		float tkI= analysisDataFormat.tIsoTkel[ie];
+		float tkI= objects.trackElectrons.trackIsolation[ie];
 		if(tkI>trkIsolCut_) continue;
 
 		if( pt>=leg1threshold1_ ) {
@@ -161,12 +167,12 @@ bool l1menu::triggers::TkEle_TkMu_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 		     for( int imu=0; imu<NTkmu; imu++ )
 		     {
-			     int bx2=analysisDataFormat.BxTkmu.at( imu );
+			     int bx2=objects.trackMuons.bx[ imu ];
 			     if( bx2!=0 ) continue;
-			     float pt2=analysisDataFormat.PtTkmu.at( imu );
-			     float eta2=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
+			     float pt2=objects.trackMuons.pt[ imu ];
+			     float eta2=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
 			     if (std::fabs(eta2) > etaCut_) continue;
-			     int qual=analysisDataFormat.QualTkmu.at( imu );
+			     int qual=objects.trackMuons.quality[ imu ];
 			     if( qual<muonQuality_ ) continue;
 			     
 
@@ -195,7 +201,7 @@ unsigned int l1menu::triggers::TkEle_TkMu_v0::version() const
 
 bool l1menu::triggers::TkEle_TkMu_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -203,33 +209,33 @@ bool l1menu::triggers::TkEle_TkMu_v1::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	bool ok = false;
 
-	int NTkele=analysisDataFormat.NTkele;
-	int NTkmu=analysisDataFormat.NTkmu;
+	int NTkele=objects.trackElectrons.number;
+	int NTkmu=objects.trackMuons.number;
 	
 	for( int ie=0; ie<NTkele; ie++ )
 	{
 
-		int bx=analysisDataFormat.BxTkel.at( ie );
+		int bx=objects.trackElectrons.bx[ ie ];
 		if( bx!=0 ) continue;
-		float pt = analysisDataFormat.EtTkel.at( ie );
-		float eta = analysisDataFormat.EtaTkel[ie];
+		float pt = objects.trackElectrons.et[ ie ];
+		float eta = objects.trackElectrons.eta[ie];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
-		float tkI= analysisDataFormat.tIsoTkel[ie];
+		float tkI= objects.trackElectrons.trackIsolation[ie];
 		if(tkI>trkIsolCut_) continue;
 
 		if( pt>=leg1threshold1_ ) {
 		   
-		     float eleZvtx = analysisDataFormat.zVtxTkel[ie];
+		     float eleZvtx = objects.trackElectrons.zVertex[ie];
 
 		     for( int imu=0; imu<NTkmu; imu++ )
 		     {
-		        if(fabs(eleZvtx - analysisDataFormat.zVtxTkmu[imu]) < zVtxCut_)  {
-			     int bx2=analysisDataFormat.BxTkmu.at( imu );
+		        if(fabs(eleZvtx - objects.trackMuons.zVertex[imu]) < zVtxCut_)  {
+			     int bx2=objects.trackMuons.bx[ imu ];
 			     if( bx2!=0 ) continue;
-			     float pt2=analysisDataFormat.PtTkmu.at( imu );
-			     float eta2=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
+			     float pt2=objects.trackMuons.pt[ imu ];
+			     float eta2=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
 			     if (std::fabs(eta2) > etaCut_) continue;
-			     int qual=analysisDataFormat.QualTkmu.at( imu );
+			     int qual=objects.trackMuons.quality[ imu ];
 			     if( qual<muonQuality_ ) continue;
 			     
 
@@ -259,7 +265,7 @@ unsigned int l1menu::triggers::TkEle_TkMu_v1::version() const
 
 bool l1menu::triggers::TkEle_TkMu_v2::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -267,33 +273,33 @@ bool l1menu::triggers::TkEle_TkMu_v2::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	bool ok = false;
 
-	int NTkele=analysisDataFormat.NTkele2;
-	int NTkmu=analysisDataFormat.NTkmu;
+	int NTkele=objects.lowPtTrackElectrons.number;
+	int NTkmu=objects.trackMuons.number;
 	
 	for( int ie=0; ie<NTkele; ie++ )
 	{
 
-		int bx=analysisDataFormat.BxTkel2.at( ie );
+		int bx=objects.lowPtTrackElectrons.bx[ ie ];
 		if( bx!=0 ) continue;
-		float pt = analysisDataFormat.EtTkel2.at( ie );
-		float eta = analysisDataFormat.EtaTkel2[ie];
+		float pt = objects.lowPtTrackElectrons.et[ ie ];
+		float eta = objects.lowPtTrackElectrons.eta[ie];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
-		float tkI= analysisDataFormat.tIsoTkel2[ie];
+		float tkI= objects.lowPtTrackElectrons.trackIsolation[ie];
 		if(tkI>trkIsolCut_) continue;
 
 		if( pt>=leg1threshold1_ ) {
 		   
-		     float eleZvtx = analysisDataFormat.zVtxTkel2[ie];
+		     float eleZvtx = objects.lowPtTrackElectrons.zVertex[ie];
 
 		     for( int imu=0; imu<NTkmu; imu++ )
 		     {
-		        if(fabs(eleZvtx - analysisDataFormat.zVtxTkmu[imu]) < zVtxCut_)  {
-			     int bx2=analysisDataFormat.BxTkmu.at( imu );
+		        if(fabs(eleZvtx - objects.trackMuons.zVertex[imu]) < zVtxCut_)  {
+			     int bx2=objects.trackMuons.bx[ imu ];
 			     if( bx2!=0 ) continue;
-			     float pt2=analysisDataFormat.PtTkmu.at( imu );
-			     float eta2=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
+			     float pt2=objects.trackMuons.pt[ imu ];
+			     float eta2=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
 			     if (std::fabs(eta2) > etaCut_) continue;
-			     int qual=analysisDataFormat.QualTkmu.at( imu );
+			     int qual=objects.trackMuons.quality[ imu ];
 			     if( qual<muonQuality_ ) continue;
 			     
 
@@ -332,40 +338,46 @@ const std::string l1menu::triggers::TkEle_TkMu::name() const
 	return "L1_TkEle_TkMu";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkEle_TkMu>& l1menu::triggers::TkEle_TkMu::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkEle_TkMu> table={
+		{ "leg1threshold1", &TkEle_TkMu::leg1threshold1_ },
+		{ "leg1regionCut", &TkEle_TkMu::leg1regionCut_ },
+		{ "leg2threshold1", &TkEle_TkMu::leg2threshold1_ },
+		{ "etaCut", &TkEle_TkMu::etaCut_ },
+		{ "muonQuality", &TkEle_TkMu::muonQuality_ },
+		{ "zVtxCut", &TkEle_TkMu::zVtxCut_ },
+		{ "trkIsolCut", &TkEle_TkMu::trkIsolCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkEle_TkMu::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2threshold1");	
-	returnValue.push_back("etaCut");
-	returnValue.push_back("muonQuality");
-        returnValue.push_back("zVtxCut");
-	returnValue.push_back("trkIsolCut");
-	 
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkEle_TkMu::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkEle_TkMu::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="etaCut" ) return etaCut_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkEle_TkMu::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="etaCut" ) return etaCut_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else if( parameterName=="trkIsolCut" ) return trkIsolCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkEle_TkMu::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkEle_TkMu::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include "../implementation/RegisterTriggerMacro.h"
 #include "l1menu/L1TriggerDPGEvent.h"
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 
 namespace l1menu
@@ -41,21 +41,39 @@ namespace l1menu
 //----------------------------------------------------------------------------------------
 
 
-bool l1menu::triggers::TkHTM_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+bool l1menu::triggers::TkHTM_v0::energySum( const l1menu::L1TriggerDPGEvent& event, float& sum ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
 	if (! raw) return false;
 
-	float adc = analysisDataFormat.TkHTM ;
+	float adc = objects.sums.trackMissingHt ;
 	float TheTkHTM = adc; // / 2. ;
 
+	sum=TheTkHTM;
+	return true;
+}
+
+bool l1menu::triggers::TkHTM_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
+{
+	float TheTkHTM;
+	if( !energySum( event, TheTkHTM ) ) return false;
+
 	if (TheTkHTM < threshold1_) return false;
 	return true;
 }
 
+bool l1menu::triggers::TkHTM_v0::setThresholdsAsTightAsPossible( const l1menu::L1TriggerDPGEvent& event )
+{
+	// The trigger passes as long as the threshold isn't above the value
+	float TheTkHTM;
+	if( !energySum( event, TheTkHTM ) ) return false;
+	threshold1_=TheTkHTM;
+	return true;
+}
+
 bool l1menu::triggers::TkHTM_v0::thresholdsAreCorrelated() const
 {
 	return false;
@@ -77,21 +95,40 @@ const std::string l1menu::triggers::TkHTM::name() const
 	return "L1_TkHTM";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkHTM>& l1menu::triggers::TkHTM::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkHTM> table={
+		{ "threshold1", &TkHTM::threshold1_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkHTM::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("threshold1");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkHTM::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkHTM::parameter( const std::string& parameterName )
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkHTM::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="threshold1" ) return threshold1_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkHTM::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkHTM::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -3,9 +3,10 @@
 #include <TMath.h>
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -34,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkMu_Mu>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float muonQuality_;
@@ -91,7 +97,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkMu_Mu_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -99,33 +105,33 @@ bool l1menu::triggers::TkMu_Mu_v0::apply( const l1menu::L1TriggerDPGEvent& event
 
 	bool ok = false;
 
-	int NTkmu=analysisDataFormat.NTkmu;
-	int Nmu=analysisDataFormat.Nmu;
+	int NTkmu=objects.trackMuons.number;
+	int Nmu=objects.muons.number;
 	
 	for( int imu=0; imu<NTkmu; imu++ )
 	{
-		int bx=analysisDataFormat.BxTkmu.at( imu );
+		int bx=objects.trackMuons.bx[ imu ];
 		if( bx!=0 ) continue;
-		float pt=analysisDataFormat.PtTkmu.at( imu );
-		//float eta=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
-		int qual=analysisDataFormat.QualTkmu.at( imu );
+		float pt=objects.trackMuons.pt[ imu ];
+		//float eta=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
+		int qual=objects.trackMuons.quality[ imu ];
 		if( qual<muonQuality_ ) continue;
 
 		if( pt>=leg1threshold1_ ) {
 		  
 
 			for (int uj=0; uj < Nmu; uj++) {
-				int bxj = analysisDataFormat.Bxmu[uj];
+				int bxj = objects.muons.bx[uj];
 				if (bxj != 0) continue;
 
-				float pt2=analysisDataFormat.Ptmu.at( uj );
-				//float eta=analysisDataFormat.Etamu.at( uj ); // Commented out to stop unused variable compile warning
-				int qual=analysisDataFormat.Qualmu.at( uj );
+				float pt2=objects.muons.pt[ uj ];
+				//float eta=objects.muons.eta[ uj ]; // Commented out to stop unused variable compile warning
+				int qual=objects.muons.quality[ uj ];
 				if( qual<muonQuality_ ) continue;
 
                                 //remove overlap with simple delta R for now.
-                                float delEta = fabs(analysisDataFormat.Etamu[uj]-analysisDataFormat.EtaTkmu[imu]);
-				float delPhi = fabs(analysisDataFormat.Phimu[uj]-analysisDataFormat.PhiTkmu[imu]);
+                                float delEta = fabs(objects.muons.eta[uj]-objects.trackMuons.eta[imu]);
+				float delPhi = fabs(objects.muons.phi[uj]-objects.trackMuons.phi[imu]);
 				if(delPhi>TMath::Pi()) delPhi = TMath::TwoPi() - delPhi;
 				float delR = sqrt(delEta*delEta + delPhi*delPhi);
 
@@ -162,27 +168,42 @@ const std::string l1menu::triggers::TkMu_Mu::name() const
 	return "L1_TkMu_Mu";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkMu_Mu>& l1menu::triggers::TkMu_Mu::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkMu_Mu> table={
+		{ "leg1threshold1", &TkMu_Mu::leg1threshold1_ },
+		{ "leg2threshold1", &TkMu_Mu::leg2threshold1_ },
+		{ "muonQuality", &TkMu_Mu::muonQuality_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkMu_Mu::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("muonQuality");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkMu_Mu::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkMu_Mu::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkMu_Mu::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkMu_Mu::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkMu_Mu::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -2,9 +2,10 @@
 #include "l1menu/L1TriggerDPGEvent.h"
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -34,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkMu_TkJet>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float leg1etaCut_;
@@ -108,7 +114,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkMu_TkJet_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
         
 	//printf("Cuts: MuPt %f  JetPt  %f  MuEta %f JetEta %f\n",leg1threshold1_,leg2threshold1_,leg1etaCut_,leg2regionCut_);
@@ -118,30 +124,30 @@ bool l1menu::triggers::TkMu_TkJet_v1::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	bool ok = false;
 
-	int Nj = analysisDataFormat.NTkjet ;
+	int Nj = objects.trackJets.number ;
 
-	int NTkmu = analysisDataFormat.NTkmu;
+	int NTkmu = objects.trackMuons.number;
 	for (int imu=0; imu < NTkmu; imu++) {
 
-		int bx = analysisDataFormat.BxTkmu.at(imu);
+		int bx = objects.trackMuons.bx[imu];
 		if (bx != 0) continue;
-		float pt = analysisDataFormat.PtTkmu.at(imu);
-		int qual = analysisDataFormat.QualTkmu.at(imu);
+		float pt = objects.trackMuons.pt[imu];
+		int qual = objects.trackMuons.quality[imu];
 		if ( qual < muonQuality_) continue;
-		float eta = analysisDataFormat.EtaTkmu.at(imu);
+		float eta = objects.trackMuons.eta[imu];
 		if (std::fabs(eta) > leg1etaCut_) continue;
 		
 		if (pt >= leg1threshold1_){
 
-                        float muZvtx = analysisDataFormat.zVtxTkmu[imu];
+                        float muZvtx = objects.trackMuons.zVertex[imu];
 			 
 			for (int uj=0; uj < Nj; uj++) {
-			   if(fabs(muZvtx - analysisDataFormat.zVtxTkjet[uj]) < zVtxCut_)  {
-				int bxj = analysisDataFormat.BxTkjet[uj];
+			   if(fabs(muZvtx - objects.trackJets.zVertex[uj]) < zVtxCut_)  {
+				int bxj = objects.trackJets.bx[uj];
 				if (bxj != 0) continue;
-				float ptj = analysisDataFormat.EtTkjet[uj];
+				float ptj = objects.trackJets.et[uj];
 
-				if (analysisDataFormat.EtaTkjet[uj] < leg2regionCut_ || analysisDataFormat.EtaTkjet[uj] > 21.-leg2regionCut_) continue;
+				if (objects.trackJets.eta[uj] < leg2regionCut_ || objects.trackJets.eta[uj] > 21.-leg2regionCut_) continue;
 				if (ptj >= leg2threshold1_  ) ok = true;
 			   } //end z-vtx cut
 			}
@@ -168,7 +174,7 @@ unsigned int l1menu::triggers::TkMu_TkJet_v1::version() const
 
 bool l1menu::triggers::TkMu_TkJet_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw = PhysicsBits[0];   // ZeroBias
@@ -176,17 +182,17 @@ bool l1menu::triggers::TkMu_TkJet_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	bool ok = false;
 
-	int Nj = analysisDataFormat.NTkjet ;
+	int Nj = objects.trackJets.number ;
 
-	int NTkmu = analysisDataFormat.NTkmu;
+	int NTkmu = objects.trackMuons.number;
 	for (int imu=0; imu < NTkmu; imu++) {
 
-		int bx = analysisDataFormat.BxTkmu.at(imu);
+		int bx = objects.trackMuons.bx[imu];
 		if (bx != 0) continue;
-		float pt = analysisDataFormat.PtTkmu.at(imu);
-		int qual = analysisDataFormat.QualTkmu.at(imu);
+		float pt = objects.trackMuons.pt[imu];
+		int qual = objects.trackMuons.quality[imu];
 		if ( qual < muonQuality_) continue;
-		float eta = analysisDataFormat.EtaTkmu.at(imu);
+		float eta = objects.trackMuons.eta[imu];
 		if (std::fabs(eta) > leg1etaCut_) continue;
 		
 		if (pt >= leg1threshold1_){
@@ -194,11 +200,11 @@ bool l1menu::triggers::TkMu_TkJet_v0::apply( const l1menu::L1TriggerDPGEvent& ev
                      
 			 
 			for (int uj=0; uj < Nj; uj++) {
-				int bxj = analysisDataFormat.BxTkjet[uj];
+				int bxj = objects.trackJets.bx[uj];
 				if (bxj != 0) continue;
-				float ptj = analysisDataFormat.EtTkjet[uj];
+				float ptj = objects.trackJets.et[uj];
 
-				if (analysisDataFormat.EtaTkjet[uj] < leg2regionCut_ || analysisDataFormat.EtaTkjet[uj] > 21.-leg2regionCut_) continue;
+				if (objects.trackJets.eta[uj] < leg2regionCut_ || objects.trackJets.eta[uj] > 21.-leg2regionCut_) continue;
 				if (ptj >= leg2threshold1_  ) ok = true;
 			}
 
@@ -231,36 +237,45 @@ const std::string l1menu::triggers::TkMu_TkJet::name() const
 	return "L1_TkMu_TkJet";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkMu_TkJet>& l1menu::triggers::TkMu_TkJet::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkMu_TkJet> table={
+		{ "leg1threshold1", &TkMu_TkJet::leg1threshold1_ },
+		{ "leg1etaCut", &TkMu_TkJet::leg1etaCut_ },
+		{ "leg2threshold1", &TkMu_TkJet::leg2threshold1_ },
+		{ "leg2regionCut", &TkMu_TkJet::leg2regionCut_ },
+		{ "zVtxCut", &TkMu_TkJet::zVtxCut_ },
+		{ "muonQuality", &TkMu_TkJet::muonQuality_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkMu_TkJet::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg1etaCut");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("leg2regionCut");
-	returnValue.push_back("zVtxCut");
-	returnValue.push_back("muonQuality");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkMu_TkJet::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkMu_TkJet::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1etaCut" ) return leg1etaCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkMu_TkJet::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg1etaCut" ) return leg1etaCut_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;	
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkMu_TkJet::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkMu_TkJet::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
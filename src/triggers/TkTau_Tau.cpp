@@ -3,9 +3,10 @@
 #include <TMath.h>
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -34,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkTau_Tau>& parameterTable();
 			float leg1threshold1_;
 			float leg2threshold1_;
 			float leg1regionCut_;
@@ -92,7 +98,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkTau_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -100,31 +106,31 @@ bool l1menu::triggers::TkTau_Tau_v0::apply( const l1menu::L1TriggerDPGEvent& eve
 
 	bool ok = false;
 
-	int NTktau=analysisDataFormat.NTktau;
-	int Nj=analysisDataFormat.Njet;
+	int NTktau=objects.trackTaus.number;
+	int Nj=objects.jets.number;
 	
 	for( int itau=0; itau<NTktau; itau++ )
 	{
-		int bx=analysisDataFormat.BxTktau.at( itau );
+		int bx=objects.trackTaus.bx[ itau ];
 		if( bx!=0 ) continue;
-		float pt=analysisDataFormat.EtTktau.at( itau );
-		float eta = analysisDataFormat.EtaTktau[itau];
+		float pt=objects.trackTaus.et[ itau ];
+		float eta = objects.trackTaus.eta[itau];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
 
 		if( pt>=leg1threshold1_ ) {
 
 			for (int ut=0; ut < Nj; ut++) {
-				int bx = analysisDataFormat.Bxjet[ut];
+				int bx = objects.jets.bx[ut];
 				if (bx != 0) continue;
-				bool isTauJet = analysisDataFormat.Taujet[ut];
+				bool isTauJet = objects.jets.tau[ut];
 				if (! isTauJet) continue;
-				float pt2 = analysisDataFormat.Etjet[ut];    // the rank of the electron
-				float eta2 = analysisDataFormat.Etajet[ut];
+				float pt2 = objects.jets.et[ut];    // the rank of the electron
+				float eta2 = objects.jets.eta[ut];
 				if (eta2 < leg2regionCut_ || eta2 > 21.-leg2regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
 
                                 //remove overlap with simple delta R for now.
-                                float delEta = fabs(analysisDataFormat.Etajet[ut]-analysisDataFormat.EtaTktau[itau]);
-				float delPhi = fabs(analysisDataFormat.Phijet[ut]-analysisDataFormat.PhiTktau[itau]);
+                                float delEta = fabs(objects.jets.eta[ut]-objects.trackTaus.eta[itau]);
+				float delPhi = fabs(objects.jets.phi[ut]-objects.trackTaus.phi[itau]);
 				if(delPhi>TMath::Pi()) delPhi = TMath::TwoPi() - delPhi;
 				float delR = sqrt(delEta*delEta + delPhi*delPhi);
 
@@ -161,30 +167,43 @@ const std::string l1menu::triggers::TkTau_Tau::name() const
 	return "L1_TkTau_Tau";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkTau_Tau>& l1menu::triggers::TkTau_Tau::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkTau_Tau> table={
+		{ "leg1threshold1", &TkTau_Tau::leg1threshold1_ },
+		{ "leg2threshold1", &TkTau_Tau::leg2threshold1_ },
+		{ "leg1regionCut", &TkTau_Tau::leg1regionCut_ },
+		{ "leg2regionCut", &TkTau_Tau::leg2regionCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkTau_Tau::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg2threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2regionCut");
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkTau_Tau::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkTau_Tau::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkTau_Tau::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="leg2regionCut" ) return leg2regionCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkTau_Tau::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkTau_Tau::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
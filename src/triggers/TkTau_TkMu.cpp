@@ -3,9 +3,10 @@
 #include <TMath.h>
 
 #include <stdexcept>
-#include "UserCode/L1TriggerUpgrade/interface/L1AnalysisDataFormat.h"
+#include "l1menu/L1TriggerObjects.h"
 
 #include "l1menu/ITrigger.h"
+#include "../implementation/ParameterTable.h"
 
 #include <string>
 #include <vector>
@@ -34,9 +35,14 @@ namespace l1menu
 
 			virtual const std::string name() const;
 			virtual const std::vector<std::string> parameterNames() const;
+			virtual size_t parameterIndex( const std::string& parameterName ) const;
 			virtual float& parameter( const std::string& parameterName );
 			virtual const float& parameter( const std::string& parameterName ) const;
+			virtual float& parameterAt( size_t parameterIndex );
+			virtual const float& parameterAt( size_t parameterIndex ) const;
 		protected:
+			/// Static description of the parameters, in the same order as parameterNames()
+			static const l1menu::implementation::ParameterTable<TkTau_TkMu>& parameterTable();
 			float leg1threshold1_;
 			float leg1regionCut_;
 			float leg2threshold1_;
@@ -108,7 +114,7 @@ namespace l1menu
 
 bool l1menu::triggers::TkTau_TkMu_v0::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -116,15 +122,15 @@ bool l1menu::triggers::TkTau_TkMu_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	bool ok = false;
 
-	int NTktau=analysisDataFormat.NTktau;
-	int NTkmu=analysisDataFormat.NTkmu;
+	int NTktau=objects.trackTaus.number;
+	int NTkmu=objects.trackMuons.number;
 	
 	for( int itau=0; itau<NTktau; itau++ )
 	{
-		int bx=analysisDataFormat.BxTktau.at( itau );
+		int bx=objects.trackTaus.bx[ itau ];
 		if( bx!=0 ) continue;
-		float pt=analysisDataFormat.EtTktau.at( itau );
-		float eta = analysisDataFormat.EtaTktau[itau];
+		float pt=objects.trackTaus.et[ itau ];
+		float eta = objects.trackTaus.eta[itau];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
 
 		if( pt>=leg1threshold1_ ) {
@@ -132,12 +138,12 @@ bool l1menu::triggers::TkTau_TkMu_v0::apply( const l1menu::L1TriggerDPGEvent& ev
 
 		     for( int imu=0; imu<NTkmu; imu++ )
 		     {
-			     int bx2=analysisDataFormat.BxTkmu.at( imu );
+			     int bx2=objects.trackMuons.bx[ imu ];
 			     if( bx2!=0 ) continue;
-			     float pt2=analysisDataFormat.PtTkmu.at( imu );
-			     float eta2=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
+			     float pt2=objects.trackMuons.pt[ imu ];
+			     float eta2=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
 			     if (std::fabs(eta2) > etaCut_) continue;
-			     int qual=analysisDataFormat.QualTkmu.at( imu );
+			     int qual=objects.trackMuons.quality[ imu ];
 			     if( qual<muonQuality_ ) continue;
 			     
 
@@ -166,7 +172,7 @@ unsigned int l1menu::triggers::TkTau_TkMu_v0::version() const
 
 bool l1menu::triggers::TkTau_TkMu_v1::apply( const l1menu::L1TriggerDPGEvent& event ) const
 {
-	const L1Analysis::L1AnalysisDataFormat& analysisDataFormat=event.rawEvent();
+	const l1menu::L1TriggerObjects& objects=event.triggerObjects();
 	const bool* PhysicsBits=event.physicsBits();
 
 	bool raw=PhysicsBits[0]; // ZeroBias
@@ -174,30 +180,30 @@ bool l1menu::triggers::TkTau_TkMu_v1::apply( const l1menu::L1TriggerDPGEvent& ev
 
 	bool ok = false;
 
-	int NTktau=analysisDataFormat.NTktau;
-	int NTkmu=analysisDataFormat.NTkmu;
+	int NTktau=objects.trackTaus.number;
+	int NTkmu=objects.trackMuons.number;
 	
 	for( int itau=0; itau<NTktau; itau++ )
 	{
-		int bx=analysisDataFormat.BxTktau.at( itau );
+		int bx=objects.trackTaus.bx[ itau ];
 		if( bx!=0 ) continue;
-		float pt=analysisDataFormat.EtTktau.at( itau );
-		float eta = analysisDataFormat.EtaTktau[itau];
+		float pt=objects.trackTaus.et[ itau ];
+		float eta = objects.trackTaus.eta[itau];
 		if (eta < leg1regionCut_ || eta > 21.-leg1regionCut_) continue;  // eta = 5 - 16  // eta = 5 - 16
 
 		if( pt>=leg1threshold1_ ) {
 		   
-		     float tauZvtx = analysisDataFormat.zVtxTktau[itau];
+		     float tauZvtx = objects.trackTaus.zVertex[itau];
 
 		     for( int imu=0; imu<NTkmu; imu++ )
 		     {
-		        if(fabs(tauZvtx - analysisDataFormat.zVtxTkmu[imu]) < zVtxCut_)  {
-			     int bx2=analysisDataFormat.BxTkmu.at( imu );
+		        if(fabs(tauZvtx - objects.trackMuons.zVertex[imu]) < zVtxCut_)  {
+			     int bx2=objects.trackMuons.bx[ imu ];
 			     if( bx2!=0 ) continue;
-			     float pt2=analysisDataFormat.PtTkmu.at( imu );
-			     float eta2=analysisDataFormat.Etamu.at( imu ); // Commented out to stop unused variable compile warning
+			     float pt2=objects.trackMuons.pt[ imu ];
+			     float eta2=objects.muons.eta[ imu ]; // Commented out to stop unused variable compile warning
 			     if (std::fabs(eta2) > etaCut_) continue;
-			     int qual=analysisDataFormat.QualTkmu.at( imu );
+			     int qual=objects.trackMuons.quality[ imu ];
 			     if( qual<muonQuality_ ) continue;
 			     
 
@@ -236,37 +242,45 @@ const std::string l1menu::triggers::TkTau_TkMu::name() const
 	return "L1_TkTau_TkMu";
 }
 
+const l1menu::implementation::ParameterTable<l1menu::triggers::TkTau_TkMu>& l1menu::triggers::TkTau_TkMu::parameterTable()
+{
+	static const l1menu::implementation::ParameterTable<TkTau_TkMu> table={
+		{ "leg1threshold1", &TkTau_TkMu::leg1threshold1_ },
+		{ "leg1regionCut", &TkTau_TkMu::leg1regionCut_ },
+		{ "leg2threshold1", &TkTau_TkMu::leg2threshold1_ },
+		{ "etaCut", &TkTau_TkMu::etaCut_ },
+		{ "muonQuality", &TkTau_TkMu::muonQuality_ },
+		{ "zVtxCut", &TkTau_TkMu::zVtxCut_ }
+	};
+	return table;
+}
+
 const std::vector<std::string> l1menu::triggers::TkTau_TkMu::parameterNames() const
 {
-	std::vector<std::string> returnValue;
-	returnValue.push_back("leg1threshold1");
-	returnValue.push_back("leg1regionCut");
-	returnValue.push_back("leg2threshold1");	
-	returnValue.push_back("etaCut");
-	returnValue.push_back("muonQuality");
-        returnValue.push_back("zVtxCut");
-	 
-	return returnValue;
+	return parameterTable().names();
+}
+
+size_t l1menu::triggers::TkTau_TkMu::parameterIndex( const std::string& parameterName ) const
+{
+	return parameterTable().index( parameterName );
 }
 
 float& l1menu::triggers::TkTau_TkMu::parameter( const std::string& parameterName )
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="etaCut" ) return etaCut_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
 }
 
 const float& l1menu::triggers::TkTau_TkMu::parameter( const std::string& parameterName ) const
 {
-	if( parameterName=="leg1threshold1" ) return leg1threshold1_;
-	else if( parameterName=="leg2threshold1" ) return leg2threshold1_;
-	else if( parameterName=="leg1regionCut" ) return leg1regionCut_;
-	else if( parameterName=="etaCut" ) return etaCut_;
-	else if( parameterName=="muonQuality" ) return muonQuality_;
-	else if( parameterName=="zVtxCut" ) return zVtxCut_;		
-	else throw std::logic_error( "Not a valid parameter name" );
+	return parameterTable().parameter( *this, parameterTable().index(parameterName) );
+}
+
+float& l1menu::triggers::TkTau_TkMu::parameterAt( size_t parameterIndex )
+{
+	return parameterTable().parameter( *this, parameterIndex );
+}
+
+const float& l1menu::triggers::TkTau_TkMu::parameterAt( size_t parameterIndex ) const
+{
+	return parameterTable().parameter( *this, parameterIndex );
 }
@@ -0,0 +1,330 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+
+//
+// Forward definitions
+//
+namespace l1menu
+{
+	class ReducedSample;
+	class TriggerMenu;
+}
+
+/** @brief A cppunit TestFixture to check that the different ways of calculating menu rates and rate plots agree.
+ *
+ * ReducedSample::rate() and MenuRatePlots::addSample() are the reference. Running them on a different
+ * number of threads, splitting them between processes with PartialMenuRate and PartialMenuRatePlots,
+ * or using IncrementalMenuRate should all give exactly the same numbers, not just close ones.
+ */
+class MenuRateUnitTestSuite : public CPPUNIT_NS::TestFixture
+{
+	CPPUNIT_TEST_SUITE(MenuRateUnitTestSuite);
+	CPPUNIT_TEST(testDifferentThreads);
+	CPPUNIT_TEST(testIncrementalMenuRate);
+	CPPUNIT_TEST(testChildProcesses);
+	CPPUNIT_TEST(testChunkCoverage);
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	std::ostream* pVerboseOutput_;
+	std::unique_ptr<l1menu::ReducedSample> pSample_;
+	std::unique_ptr<l1menu::TriggerMenu> pTriggerMenu_;
+public:
+	MenuRateUnitTestSuite();
+	void setUp();
+	void tearDown();
+
+protected:
+	void testDifferentThreads();
+	void testIncrementalMenuRate();
+	void testChildProcesses();
+	void testChunkCoverage();
+
+	/** @brief The test sample added to itself until it has at least the requested number of chunks, for the tests that split it up. */
+	std::unique_ptr<l1menu::ReducedSample> sampleWithChunks( size_t minimumNumberOfChunks );
+};
+
+
+
+
+
+#include <cppunit/config/SourcePrefix.h>
+#include <stdexcept>
+#include <sstream>
+#include "l1menu/ISample.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/TriggerMenu.h"
+#include "l1menu/ITrigger.h"
+#include "l1menu/IMenuRate.h"
+#include "l1menu/ITriggerRate.h"
+#include "l1menu/ITriggerDescriptionWithErrors.h"
+#include "l1menu/IncrementalMenuRate.h"
+#include "l1menu/PartialMenuRate.h"
+#include "l1menu/PartialMenuRatePlots.h"
+#include "l1menu/MenuRatePlots.h"
+#include "l1menu/TriggerRatePlot.h"
+#include "l1menu/tools/miscellaneous.h"
+#include "l1menu/tools/fileIO.h"
+#include "l1menu/tools/ThreadPool.h"
+#include "TestParameters.h"
+#include <TH1.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MenuRateUnitTestSuite);
+
+namespace // Use the unnamed namespace for things only used in this file
+{
+	/** @brief Asserts that every number in the two rates is exactly the same. */
+	void checkRatesIdentical( const l1menu::IMenuRate& expected, const l1menu::IMenuRate& actual )
+	{
+		CPPUNIT_ASSERT_EQUAL( expected.totalFraction(), actual.totalFraction() );
+		CPPUNIT_ASSERT_EQUAL( expected.totalFractionError(), actual.totalFractionError() );
+		CPPUNIT_ASSERT_EQUAL( expected.totalRate(), actual.totalRate() );
+		CPPUNIT_ASSERT_EQUAL( expected.totalRateError(), actual.totalRateError() );
+		CPPUNIT_ASSERT_EQUAL( expected.triggerRates().size(), actual.triggerRates().size() );
+
+		for( size_t triggerNumber=0; triggerNumber<expected.triggerRates().size(); ++triggerNumber )
+		{
+			const l1menu::ITriggerRate& expectedRate=*expected.triggerRates()[triggerNumber];
+			const l1menu::ITriggerRate& actualRate=*actual.triggerRates()[triggerNumber];
+			CPPUNIT_ASSERT_EQUAL( expectedRate.trigger().name(), actualRate.trigger().name() );
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( expectedRate.trigger().name(), expectedRate.fraction(), actualRate.fraction() );
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( expectedRate.trigger().name(), expectedRate.fractionError(), actualRate.fractionError() );
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( expectedRate.trigger().name(), expectedRate.rate(), actualRate.rate() );
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( expectedRate.trigger().name(), expectedRate.rateError(), actualRate.rateError() );
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( expectedRate.trigger().name(), expectedRate.pureFraction(), actualRate.pureFraction() );
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( expectedRate.trigger().name(), expectedRate.pureRate(), actualRate.pureRate() );
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( expectedRate.trigger().name(), expectedRate.pureRateError(), actualRate.pureRateError() );
+		}
+	}
+
+	/** @brief Asserts that every bin, including underflow and overflow, of every plot is exactly the same. */
+	void checkPlotsIdentical( const l1menu::MenuRatePlots& expected, const l1menu::MenuRatePlots& actual )
+	{
+		CPPUNIT_ASSERT_EQUAL( expected.triggerRatePlots().size(), actual.triggerRatePlots().size() );
+
+		for( size_t plotNumber=0; plotNumber<expected.triggerRatePlots().size(); ++plotNumber )
+		{
+			const TH1* pExpectedPlot=expected.triggerRatePlots()[plotNumber].getPlot();
+			const TH1* pActualPlot=actual.triggerRatePlots()[plotNumber].getPlot();
+			const std::string message=std::string("Plot that fails has the title ")+pExpectedPlot->GetTitle();
+
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( message, pExpectedPlot->GetNbinsX(), pActualPlot->GetNbinsX() );
+			for( int binNumber=0; binNumber<=pExpectedPlot->GetNbinsX()+1; ++binNumber )
+			{
+				CPPUNIT_ASSERT_EQUAL_MESSAGE( message, pExpectedPlot->GetBinContent(binNumber), pActualPlot->GetBinContent(binNumber) );
+				CPPUNIT_ASSERT_EQUAL_MESSAGE( message, pExpectedPlot->GetBinError(binNumber), pActualPlot->GetBinError(binNumber) );
+			}
+		}
+	}
+
+	std::string serialise( const l1menu::PartialMenuRate& partialRate )
+	{
+		std::ostringstream output;
+		partialRate.serialise( output );
+		return output.str();
+	}
+
+	std::string serialise( const l1menu::PartialMenuRatePlots& partialRatePlots )
+	{
+		std::ostringstream output;
+		partialRatePlots.serialise( output );
+		return output.str();
+	}
+
+} // end of the unnamed namespace
+
+MenuRateUnitTestSuite::MenuRateUnitTestSuite()
+{
+	pVerboseOutput_=nullptr;
+	//pVerboseOutput_=&std::cout;
+}
+
+void MenuRateUnitTestSuite::setUp()
+{
+	std::string inputSampleFilename=TestParameters<std::string>::instance().getParameter( "TEST_SAMPLE_FILENAME" );
+
+	// Add a newline, because cppunit starts this function with half a line already written
+	if( pVerboseOutput_!=nullptr ) *pVerboseOutput_ << "\n";
+
+	if( pVerboseOutput_!=nullptr ) *pVerboseOutput_ << "Loading sample from file " << inputSampleFilename << std::endl;
+	std::unique_ptr<l1menu::ISample> pSample;
+	CPPUNIT_ASSERT_NO_THROW( pSample=l1menu::tools::loadSample( inputSampleFilename ) );
+	l1menu::ReducedSample* pReducedSample=dynamic_cast<l1menu::ReducedSample*>( pSample.get() );
+	CPPUNIT_ASSERT_MESSAGE( "The test sample needs to be a ReducedSample for these tests", pReducedSample!=nullptr );
+	pSample.release();
+	pSample_.reset( pReducedSample );
+	CPPUNIT_ASSERT_MESSAGE( "The test sample needs at least one event for these tests", pSample_->numberOfEvents()>0 );
+
+	// Use the menu the sample was made with, so that every trigger is guaranteed to be in the sample
+	pTriggerMenu_.reset( new l1menu::TriggerMenu( pSample_->getTriggerMenu() ) );
+	CPPUNIT_ASSERT_MESSAGE( "The test sample needs at least two triggers for these tests", pTriggerMenu_->numberOfTriggers()>=2 );
+}
+
+void MenuRateUnitTestSuite::tearDown()
+{
+	// Put the thread pool back to the default in case a test failed part way through
+	l1menu::tools::ThreadPool::instance().setNumberOfThreads( 0 );
+}
+
+std::unique_ptr<l1menu::ReducedSample> MenuRateUnitTestSuite::sampleWithChunks( size_t minimumNumberOfChunks )
+{
+	std::unique_ptr<l1menu::ReducedSample> pLargerSample( new l1menu::ReducedSample( *pTriggerMenu_ ) );
+	while( l1menu::PartialMenuRate::numberOfChunks(*pLargerSample)<minimumNumberOfChunks ) pLargerSample->addSample( *pSample_ );
+	pLargerSample->setEventRate( pSample_->eventRate() );
+	return pLargerSample;
+}
+
+void MenuRateUnitTestSuite::testDifferentThreads()
+{
+	l1menu::tools::ThreadPool& threadPool=l1menu::tools::ThreadPool::instance();
+
+	threadPool.setNumberOfThreads( 1 );
+	std::shared_ptr<const l1menu::IMenuRate> pSerialRate=pSample_->rate( *pTriggerMenu_ );
+	l1menu::MenuRatePlots serialPlots( *pTriggerMenu_ );
+	serialPlots.addSample( *pSample_ );
+
+	threadPool.setNumberOfThreads( 4 );
+	std::shared_ptr<const l1menu::IMenuRate> pParallelRate=pSample_->rate( *pTriggerMenu_ );
+	l1menu::MenuRatePlots parallelPlots( *pTriggerMenu_ );
+	parallelPlots.addSample( *pSample_ );
+
+	checkRatesIdentical( *pSerialRate, *pParallelRate );
+	checkPlotsIdentical( serialPlots, parallelPlots );
+}
+
+void MenuRateUnitTestSuite::testIncrementalMenuRate()
+{
+	l1menu::IncrementalMenuRate incrementalRate( *pSample_, *pTriggerMenu_ );
+	checkRatesIdentical( *pSample_->rate(*pTriggerMenu_), *incrementalRate.rate() );
+
+	//
+	// Tighten the main threshold of the first and last triggers, one at a time, and make sure the
+	// rates follow what a full recalculation of the changed menu gives.
+	//
+	l1menu::TriggerMenu changedMenu( *pTriggerMenu_ );
+	for( const size_t triggerNumber : { size_t(0), pTriggerMenu_->numberOfTriggers()-1 } )
+	{
+		l1menu::ITrigger& trigger=changedMenu.getTrigger(triggerNumber);
+		const std::vector<std::string> thresholdNames=l1menu::tools::getThresholdNames( trigger );
+		if( thresholdNames.empty() ) continue;
+
+		const float newThreshold=trigger.parameter( thresholdNames.front() )+5;
+		trigger.parameter( thresholdNames.front() )=newThreshold;
+		incrementalRate.setTriggerParameter( triggerNumber, thresholdNames.front(), newThreshold );
+		checkRatesIdentical( *pSample_->rate(changedMenu), *incrementalRate.rate() );
+	}
+
+	//
+	// Disabling a trigger should be the same as taking it out of the menu
+	//
+	incrementalRate.setTriggerEnabled( 0, false );
+	CPPUNIT_ASSERT( !incrementalRate.triggerIsEnabled( 0 ) );
+	l1menu::TriggerMenu reducedMenu;
+	for( size_t triggerNumber=1; triggerNumber<changedMenu.numberOfTriggers(); ++triggerNumber ) reducedMenu.addTrigger( changedMenu.getTrigger(triggerNumber) );
+	checkRatesIdentical( *pSample_->rate(reducedMenu), *incrementalRate.rate() );
+
+	incrementalRate.setTriggerEnabled( 0, true );
+	checkRatesIdentical( *pSample_->rate(changedMenu), *incrementalRate.rate() );
+
+	// Putting everything back should give the original rates again
+	incrementalRate.setTriggerParameters( 0, pTriggerMenu_->getTrigger(0) );
+	incrementalRate.setTriggerParameters( pTriggerMenu_->numberOfTriggers()-1, pTriggerMenu_->getTrigger(pTriggerMenu_->numberOfTriggers()-1) );
+	checkRatesIdentical( *pSample_->rate(*pTriggerMenu_), *incrementalRate.rate() );
+}
+
+void MenuRateUnitTestSuite::testChildProcesses()
+{
+	std::unique_ptr<l1menu::ReducedSample> pLargerSample=sampleWithChunks( 3 );
+	const size_t numberOfChunks=l1menu::PartialMenuRate::numberOfChunks( *pLargerSample );
+	const size_t numberOfProcesses=3;
+
+	std::shared_ptr<const l1menu::IMenuRate> pExpectedRate=pLargerSample->rate( *pTriggerMenu_ );
+	l1menu::MenuRatePlots expectedPlots( *pTriggerMenu_ );
+	expectedPlots.addSample( *pLargerSample );
+
+	// Worker threads can't be forked, so everything has to be serial from here on
+	l1menu::tools::ThreadPool::instance().setNumberOfThreads( 1 );
+
+	std::vector<std::string> results;
+	CPPUNIT_ASSERT_NO_THROW( results=l1menu::tools::runInChildProcesses( numberOfProcesses, [&]( size_t processNumber )
+	{
+		l1menu::PartialMenuRate partialRate( *pTriggerMenu_ );
+		partialRate.addSample( *pLargerSample, numberOfChunks*processNumber/numberOfProcesses, numberOfChunks*(processNumber+1)/numberOfProcesses );
+		return serialise( partialRate );
+	} ) );
+	CPPUNIT_ASSERT_EQUAL( numberOfProcesses, results.size() );
+
+	l1menu::PartialMenuRate mergedRate( *pTriggerMenu_ );
+	for( const auto& result : results )
+	{
+		std::istringstream input( result );
+		mergedRate.merge( l1menu::PartialMenuRate( *pTriggerMenu_, input ) );
+	}
+	CPPUNIT_ASSERT_EQUAL( numberOfChunks, mergedRate.numberOfChunks() );
+	checkRatesIdentical( *pExpectedRate, *mergedRate.rate( pLargerSample->eventRate() ) );
+
+	l1menu::MenuRatePlots actualPlots( *pTriggerMenu_ );
+	CPPUNIT_ASSERT_NO_THROW( results=l1menu::tools::runInChildProcesses( numberOfProcesses, [&]( size_t processNumber )
+	{
+		l1menu::PartialMenuRatePlots partialPlots( actualPlots );
+		partialPlots.addSample( *pLargerSample, numberOfChunks*processNumber/numberOfProcesses, numberOfChunks*(processNumber+1)/numberOfProcesses );
+		return serialise( partialPlots );
+	} ) );
+	CPPUNIT_ASSERT_EQUAL( numberOfProcesses, results.size() );
+
+	l1menu::PartialMenuRatePlots mergedPlots( actualPlots );
+	for( const auto& result : results )
+	{
+		std::istringstream input( result );
+		mergedPlots.merge( l1menu::PartialMenuRatePlots( actualPlots, input ) );
+	}
+	mergedPlots.addTo( actualPlots );
+	checkPlotsIdentical( expectedPlots, actualPlots );
+
+	// An exception in one of the processes should come back as an exception here
+	CPPUNIT_ASSERT_THROW( l1menu::tools::runInChildProcesses( 2, []( size_t processNumber ) -> std::string
+	{
+		if( processNumber==1 ) throw std::runtime_error( "Deliberate failure to test error handling" );
+		return std::string();
+	} ), std::runtime_error );
+}
+
+void MenuRateUnitTestSuite::testChunkCoverage()
+{
+	std::unique_ptr<l1menu::ReducedSample> pLargerSample=sampleWithChunks( 3 );
+	const size_t numberOfChunks=l1menu::PartialMenuRate::numberOfChunks( *pLargerSample );
+	const float eventRate=pLargerSample->eventRate();
+
+	l1menu::PartialMenuRate firstChunks( *pTriggerMenu_ );
+	firstChunks.addSample( *pLargerSample, 0, 1 );
+	// Not every chunk has been added yet
+	CPPUNIT_ASSERT_THROW( firstChunks.rate( eventRate ), std::runtime_error );
+	// Leaving a gap
+	CPPUNIT_ASSERT_THROW( firstChunks.addSample( *pLargerSample, 2, numberOfChunks ), std::runtime_error );
+	// Overlapping the chunk already there
+	CPPUNIT_ASSERT_THROW( firstChunks.addSample( *pLargerSample, 0, numberOfChunks ), std::runtime_error );
+	// Past the end of the sample
+	CPPUNIT_ASSERT_THROW( firstChunks.addSample( *pLargerSample, 1, numberOfChunks+1 ), std::runtime_error );
+	// None of those should have changed anything
+	CPPUNIT_ASSERT_EQUAL( size_t(1), firstChunks.numberOfChunks() );
+
+	l1menu::PartialMenuRate lastChunks( *pTriggerMenu_ );
+	lastChunks.addSample( *pLargerSample, 1, numberOfChunks );
+	// Merging out of order
+	CPPUNIT_ASSERT_THROW( lastChunks.merge( firstChunks ), std::runtime_error );
+	// Merging the same chunks twice
+	CPPUNIT_ASSERT_THROW( lastChunks.merge( lastChunks ), std::runtime_error );
+
+	// Serialising shouldn't lose track of which chunks are which
+	std::istringstream input( serialise( lastChunks ) );
+	firstChunks.merge( l1menu::PartialMenuRate( *pTriggerMenu_, input ) );
+	checkRatesIdentical( *pLargerSample->rate( *pTriggerMenu_ ), *firstChunks.rate( eventRate ) );
+
+	// The rate plots should check the same way
+	l1menu::MenuRatePlots ratePlots( *pTriggerMenu_ );
+	l1menu::PartialMenuRatePlots partialPlots( ratePlots );
+	partialPlots.addSample( *pLargerSample, 0, 1 );
+	CPPUNIT_ASSERT_THROW( partialPlots.addTo( ratePlots ), std::runtime_error );
+	CPPUNIT_ASSERT_THROW( partialPlots.addSample( *pLargerSample, 2, numberOfChunks ), std::runtime_error );
+	CPPUNIT_ASSERT_THROW( partialPlots.addSample( *pLargerSample, 0, numberOfChunks ), std::runtime_error );
+}
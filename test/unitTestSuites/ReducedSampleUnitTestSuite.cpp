@@ -0,0 +1,275 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+
+//
+// Forward definitions
+//
+namespace l1menu
+{
+	class ReducedSample;
+}
+
+/** @brief A cppunit TestFixture to test saving, loading, sharding and merging ReducedSample objects.
+ *
+ * Everything here checks that the events come out exactly the same, bit for bit, rather than
+ * just close. Whatever the file format, the number of threads or the way the sample was split
+ * up, the events should be identical.
+ */
+class ReducedSampleUnitTestSuite : public CPPUNIT_NS::TestFixture
+{
+	CPPUNIT_TEST_SUITE(ReducedSampleUnitTestSuite);
+	CPPUNIT_TEST(testFileFormatRoundTrips);
+	CPPUNIT_TEST(testLoadingWithDifferentThreads);
+	CPPUNIT_TEST(testAddingWithDifferentThreads);
+	CPPUNIT_TEST(testShardAndMerge);
+	CPPUNIT_TEST_SUITE_END();
+
+protected:
+	std::ostream* pVerboseOutput_;
+	std::unique_ptr<l1menu::ReducedSample> pSample_;
+public:
+	ReducedSampleUnitTestSuite();
+	void setUp();
+	void tearDown();
+
+protected:
+	void testFileFormatRoundTrips();
+	void testLoadingWithDifferentThreads();
+	void testAddingWithDifferentThreads();
+	void testShardAndMerge();
+};
+
+
+
+
+
+#include <cppunit/config/SourcePrefix.h>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include "l1menu/ISample.h"
+#include "l1menu/ReducedSample.h"
+#include "l1menu/ReducedEventBlock.h"
+#include "l1menu/TriggerMenu.h"
+#include "l1menu/ITrigger.h"
+#include "l1menu/tools/fileIO.h"
+#include "l1menu/tools/ThreadPool.h"
+#include "TestParameters.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ReducedSampleUnitTestSuite);
+
+namespace // Use the unnamed namespace for things only used in this file
+{
+	/** @brief Creates a uniquely named empty file to save samples to, and deletes it when it goes out of scope. */
+	class TemporaryFile
+	{
+	public:
+		TemporaryFile()
+		{
+			char filename[]="/tmp/ReducedSampleUnitTestSuite_XXXXXX";
+			int fileDescriptor=::mkstemp( filename );
+			if( fileDescriptor==-1 ) throw std::runtime_error( "TemporaryFile - unable to create a temporary file" );
+			::close( fileDescriptor );
+			filename_=filename;
+		}
+		~TemporaryFile() { std::remove( filename_.c_str() ); }
+		const std::string& filename() const { return filename_; }
+	private:
+		TemporaryFile( const TemporaryFile& otherTemporaryFile ) = delete;
+		TemporaryFile& operator=( const TemporaryFile& otherTemporaryFile ) = delete;
+		std::string filename_;
+	};
+
+	/** @brief Exact comparison, except that two NaNs are counted as the same. */
+	bool identical( float first, float second )
+	{
+		if( std::isnan(first) && std::isnan(second) ) return true;
+		return first==second;
+	}
+
+	/** @brief Asserts that the two samples have the same triggers, and exactly the same events in the same blocks.
+	 *
+	 * The columns are matched up by parameter name rather than number, so the samples can have been made
+	 * in different ways as long as the menus match.
+	 */
+	void checkSamplesIdentical( const l1menu::ReducedSample& expected, const l1menu::ReducedSample& actual )
+	{
+		CPPUNIT_ASSERT_EQUAL( expected.numberOfEvents(), actual.numberOfEvents() );
+		CPPUNIT_ASSERT_EQUAL( expected.numberOfEventBlocks(), actual.numberOfEventBlocks() );
+		CPPUNIT_ASSERT_EQUAL( expected.sumOfWeights(), actual.sumOfWeights() );
+
+		const l1menu::TriggerMenu& expectedMenu=expected.getTriggerMenu();
+		CPPUNIT_ASSERT_EQUAL( expectedMenu.numberOfTriggers(), actual.getTriggerMenu().numberOfTriggers() );
+
+		// Pairs of the column in the expected sample and the column in the actual sample
+		std::vector< std::pair<size_t,size_t> > columns;
+		for( size_t triggerNumber=0; triggerNumber<expectedMenu.numberOfTriggers(); ++triggerNumber )
+		{
+			const l1menu::ITrigger& trigger=expectedMenu.getTrigger(triggerNumber);
+			CPPUNIT_ASSERT_MESSAGE( "Sample is missing the trigger "+trigger.name(), actual.containsTrigger( trigger ) );
+
+			const auto actualIdentifiers=actual.getTriggerParameterIdentifiers( trigger );
+			for( const auto& identifier : expected.getTriggerParameterIdentifiers( trigger ) )
+			{
+				const auto iFindResult=actualIdentifiers.find( identifier.first );
+				CPPUNIT_ASSERT_MESSAGE( "Sample is missing "+trigger.name()+" parameter "+identifier.first, iFindResult!=actualIdentifiers.end() );
+				columns.push_back( std::make_pair( identifier.second, iFindResult->second ) );
+			}
+		}
+
+		for( size_t blockNumber=0; blockNumber<expected.numberOfEventBlocks(); ++blockNumber )
+		{
+			const l1menu::ReducedEventBlock& expectedBlock=expected.eventBlock(blockNumber);
+			const l1menu::ReducedEventBlock& actualBlock=actual.eventBlock(blockNumber);
+			CPPUNIT_ASSERT_EQUAL( expectedBlock.numberOfEvents(), actualBlock.numberOfEvents() );
+
+			for( size_t eventNumber=0; eventNumber<expectedBlock.numberOfEvents(); ++eventNumber )
+			{
+				CPPUNIT_ASSERT( identical( expectedBlock.weights()[eventNumber], actualBlock.weights()[eventNumber] ) );
+			}
+
+			for( const auto& column : columns )
+			{
+				const float* pExpectedValues=expectedBlock.parameterValues( column.first );
+				const float* pActualValues=actualBlock.parameterValues( column.second );
+				for( size_t eventNumber=0; eventNumber<expectedBlock.numberOfEvents(); ++eventNumber )
+				{
+					CPPUNIT_ASSERT( identical( pExpectedValues[eventNumber], pActualValues[eventNumber] ) );
+				}
+			}
+		}
+	}
+
+} // end of the unnamed namespace
+
+ReducedSampleUnitTestSuite::ReducedSampleUnitTestSuite()
+{
+	pVerboseOutput_=nullptr;
+	//pVerboseOutput_=&std::cout;
+}
+
+void ReducedSampleUnitTestSuite::setUp()
+{
+	std::string inputSampleFilename=TestParameters<std::string>::instance().getParameter( "TEST_SAMPLE_FILENAME" );
+
+	// Add a newline, because cppunit starts this function with half a line already written
+	if( pVerboseOutput_!=nullptr ) *pVerboseOutput_ << "\n";
+
+	if( pVerboseOutput_!=nullptr ) *pVerboseOutput_ << "Loading sample from file " << inputSampleFilename << std::endl;
+	std::unique_ptr<l1menu::ISample> pSample;
+	CPPUNIT_ASSERT_NO_THROW( pSample=l1menu::tools::loadSample( inputSampleFilename ) );
+	l1menu::ReducedSample* pReducedSample=dynamic_cast<l1menu::ReducedSample*>( pSample.get() );
+	CPPUNIT_ASSERT_MESSAGE( "The test sample needs to be a ReducedSample for these tests", pReducedSample!=nullptr );
+	pSample.release();
+	pSample_.reset( pReducedSample );
+	CPPUNIT_ASSERT_MESSAGE( "The test sample needs at least one event for these tests", pSample_->numberOfEvents()>0 );
+}
+
+void ReducedSampleUnitTestSuite::tearDown()
+{
+	// Put the thread pool back to the default in case a test failed part way through
+	l1menu::tools::ThreadPool::instance().setNumberOfThreads( 0 );
+}
+
+void ReducedSampleUnitTestSuite::testFileFormatRoundTrips()
+{
+	// Version 3 is tried both with and without the thresholds quantised
+	const std::vector< std::pair<unsigned int,bool> > formats={ {1,false}, {2,false}, {3,false}, {3,true} };
+
+	for( const auto& format : formats )
+	{
+		if( pVerboseOutput_!=nullptr ) *pVerboseOutput_ << "Checking file format version " << format.first << (format.second ? " quantised" : "") << std::endl;
+		// The file has to outlive the sample, because version 2 files are memory mapped
+		TemporaryFile file;
+		CPPUNIT_ASSERT_NO_THROW( pSample_->saveToFile( file.filename(), format.first, format.second ) );
+
+		l1menu::ReducedSample loadedSample( file.filename() );
+		checkSamplesIdentical( *pSample_, loadedSample );
+
+		// A file loaded from another file format should save and load exactly the same too
+		TemporaryFile secondFile;
+		CPPUNIT_ASSERT_NO_THROW( loadedSample.saveToFile( secondFile.filename(), format.first, format.second ) );
+		l1menu::ReducedSample reloadedSample( secondFile.filename() );
+		checkSamplesIdentical( *pSample_, reloadedSample );
+	}
+
+	// Unknown versions shouldn't write anything
+	TemporaryFile file;
+	CPPUNIT_ASSERT_THROW( pSample_->saveToFile( file.filename(), 0 ), std::runtime_error );
+	CPPUNIT_ASSERT_THROW( pSample_->saveToFile( file.filename(), 99 ), std::runtime_error );
+	// Quantising only applies to version 3
+	CPPUNIT_ASSERT_THROW( pSample_->saveToFile( file.filename(), 1, true ), std::runtime_error );
+	CPPUNIT_ASSERT_THROW( pSample_->saveToFile( file.filename(), 2, true ), std::runtime_error );
+}
+
+void ReducedSampleUnitTestSuite::testLoadingWithDifferentThreads()
+{
+	l1menu::tools::ThreadPool& threadPool=l1menu::tools::ThreadPool::instance();
+
+	for( const bool quantise : { false, true } )
+	{
+		TemporaryFile file;
+		pSample_->saveToFile( file.filename(), 3, quantise );
+
+		threadPool.setNumberOfThreads( 1 );
+		l1menu::ReducedSample serialSample( file.filename() );
+		threadPool.setNumberOfThreads( 4 );
+		l1menu::ReducedSample parallelSample( file.filename() );
+
+		checkSamplesIdentical( serialSample, parallelSample );
+		checkSamplesIdentical( *pSample_, parallelSample );
+	}
+}
+
+void ReducedSampleUnitTestSuite::testAddingWithDifferentThreads()
+{
+	l1menu::tools::ThreadPool& threadPool=l1menu::tools::ThreadPool::instance();
+
+	threadPool.setNumberOfThreads( 1 );
+	l1menu::ReducedSample serialSample( pSample_->getTriggerMenu() );
+	serialSample.addSample( *pSample_ );
+	serialSample.addSample( *pSample_ );
+
+	threadPool.setNumberOfThreads( 4 );
+	l1menu::ReducedSample parallelSample( pSample_->getTriggerMenu() );
+	parallelSample.addSample( *pSample_ );
+	parallelSample.addSample( *pSample_ );
+
+	checkSamplesIdentical( serialSample, parallelSample );
+	CPPUNIT_ASSERT_EQUAL( 2*pSample_->numberOfEvents(), parallelSample.numberOfEvents() );
+}
+
+void ReducedSampleUnitTestSuite::testShardAndMerge()
+{
+	//
+	// Split the sample into shards at boundaries that don't line up with the blocks, save each
+	// one to disk and load it back in, the same way l1menuMergeReducedSamples does. Merging
+	// them in order should give back exactly the same blocks as the original.
+	//
+	const size_t numberOfEvents=pSample_->numberOfEvents();
+	const std::vector<size_t> boundaries={ 0, numberOfEvents/3+7, numberOfEvents/3+7, 2*numberOfEvents/3, numberOfEvents };
+
+	l1menu::ReducedSample mergedSample( pSample_->getTriggerMenu() );
+	for( size_t shardNumber=0; shardNumber+1<boundaries.size(); ++shardNumber )
+	{
+		const size_t firstEvent=std::min( boundaries[shardNumber], numberOfEvents );
+		const size_t lastEvent=std::min( std::max( boundaries[shardNumber+1], firstEvent ), numberOfEvents );
+
+		l1menu::ReducedSample shard( pSample_->getTriggerMenu() );
+		shard.addSample( *pSample_, firstEvent, lastEvent );
+		CPPUNIT_ASSERT_EQUAL( lastEvent-firstEvent, shard.numberOfEvents() );
+
+		TemporaryFile file;
+		shard.saveToFile( file.filename(), 3 );
+		l1menu::ReducedSample loadedShard( file.filename() );
+		mergedSample.addSample( loadedShard );
+	}
+
+	checkSamplesIdentical( *pSample_, mergedSample );
+
+	// Asking for events past the end should fail rather than read garbage
+	l1menu::ReducedSample badShard( pSample_->getTriggerMenu() );
+	CPPUNIT_ASSERT_THROW( badShard.addSample( *pSample_, 0, numberOfEvents+1 ), std::runtime_error );
+}
@@ -11,6 +11,8 @@ class ToolsUnitTestSuite : public CPPUNIT_NS::TestFixture
 	CPPUNIT_TEST_SUITE(ToolsUnitTestSuite);
 	CPPUNIT_TEST(testLinearFitInputCheck);
 	CPPUNIT_TEST(testLinearFitResult);
+	CPPUNIT_TEST(testTightestThresholds);
+	CPPUNIT_TEST(testValueTupleSet);
 	CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -21,6 +23,10 @@ public:
 protected:
 	void testLinearFitInputCheck();
 	void testLinearFitResult();
+	/** @brief Checks the thresholds from every ITightestThresholds trigger are the tightest, and agree with bisection. */
+	void testTightestThresholds();
+	/** @brief Checks ValueTupleSet finds the same duplicate and matching objects as comparing every pair with ==. */
+	void testValueTupleSet();
 };
 
 
@@ -30,7 +36,19 @@ protected:
 #include <cppunit/config/SourcePrefix.h>
 #include <iostream>
 #include <stdexcept>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <array>
 #include "l1menu/tools/miscellaneous.h"
+#include "l1menu/tools/ValueTupleSet.h"
+#include "l1menu/TriggerTable.h"
+#include "l1menu/TriggerMenu.h"
+#include "l1menu/ITrigger.h"
+#include "l1menu/ITightestThresholds.h"
+#include "l1menu/L1TriggerDPGEvent.h"
+#include "l1menu/L1TriggerObjects.h"
+#include "l1menu/ReducedSample.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ToolsUnitTestSuite);
 
@@ -79,3 +97,217 @@ void ToolsUnitTestSuite::testLinearFitResult()
 	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0, slopeInterceptPair.first, delta );
 	CPPUNIT_ASSERT_DOUBLES_EQUAL( 30966.3, slopeInterceptPair.second, delta );
 }
+
+void ToolsUnitTestSuite::testTightestThresholds()
+{
+	// There aren't any full sample ntuples in the test data, so make up a sample of events with a fixed
+	// seed. The events need a parent sample but nothing is taken from it, so an empty one will do.
+	const l1menu::ReducedSample parentSample( (l1menu::TriggerMenu()) );
+	std::mt19937 randomGenerator( 20131017 );
+	// Mostly continuous values, with some on half GeV steps like the muon pt scale
+	auto randomEnergy=[&]()->float
+	{
+		if( randomGenerator()%4==0 ) return (randomGenerator()%200)*0.5f;
+		return std::uniform_real_distribution<float>( 0, 100 )( randomGenerator );
+	};
+	auto randomNumberOfObjects=[&]()->int { return randomGenerator()%5; };
+
+	std::vector<l1menu::L1TriggerDPGEvent> events;
+	for( size_t eventNumber=0; eventNumber<2000; ++eventNumber )
+	{
+		l1menu::L1TriggerDPGEvent event( parentSample );
+		event.physicsBits()[0]=( randomGenerator()%20!=0 );
+		l1menu::L1TriggerObjects& objects=event.triggerObjects();
+
+		objects.muons.number=randomNumberOfObjects();
+		for( int index=0; index<objects.muons.number; ++index )
+		{
+			objects.muons.bx[index]=( randomGenerator()%6==0 );
+			objects.muons.quality[index]=randomGenerator()%8;
+			objects.muons.pt[index]=randomEnergy();
+			objects.muons.eta[index]=std::uniform_real_distribution<float>( -3, 3 )( randomGenerator );
+		}
+		objects.trackMuons.number=randomNumberOfObjects();
+		for( int index=0; index<objects.trackMuons.number; ++index )
+		{
+			objects.trackMuons.bx[index]=( randomGenerator()%6==0 );
+			objects.trackMuons.quality[index]=randomGenerator()%8;
+			objects.trackMuons.pt[index]=randomEnergy();
+			objects.trackMuons.eta[index]=std::uniform_real_distribution<float>( -3, 3 )( randomGenerator );
+		}
+		objects.eg.number=randomNumberOfObjects();
+		for( int index=0; index<objects.eg.number; ++index )
+		{
+			objects.eg.bx[index]=( randomGenerator()%6==0 );
+			objects.eg.isolated[index]=randomGenerator()%2;
+			objects.eg.eta[index]=randomGenerator()%22;
+			objects.eg.et[index]=randomEnergy();
+		}
+		objects.jets.number=randomNumberOfObjects();
+		for( int index=0; index<objects.jets.number; ++index )
+		{
+			objects.jets.bx[index]=( randomGenerator()%6==0 );
+			objects.jets.tau[index]=randomGenerator()%2;
+			objects.jets.isolatedTau[index]=randomGenerator()%2;
+			objects.jets.forward[index]=( randomGenerator()%3==0 );
+			objects.jets.eta[index]=randomGenerator()%22;
+			objects.jets.et[index]=randomEnergy();
+		}
+		objects.sums.missingEt=randomEnergy();
+		objects.sums.missingHt=randomEnergy();
+		objects.sums.totalHt=randomEnergy();
+		objects.sums.trackMissingHt=randomEnergy();
+		objects.sums.trackTotalHt=randomEnergy();
+
+		events.push_back( event );
+	}
+
+	const float tolerance=0.001;
+	const float infinity=std::numeric_limits<float>::infinity();
+	l1menu::TriggerTable& triggerTable=l1menu::TriggerTable::instance();
+	size_t numberOfTriggersTested=0;
+
+	for( const auto& triggerDetails : triggerTable.listTriggers() )
+	{
+		std::unique_ptr<l1menu::ITrigger> pOriginalTrigger=triggerTable.getTrigger( triggerDetails );
+		if( dynamic_cast<l1menu::ITightestThresholds*>( pOriginalTrigger.get() )==nullptr ) continue;
+		++numberOfTriggersTested;
+
+		const std::string message="Trigger "+triggerDetails.name+" version "+std::to_string(triggerDetails.version);
+		const std::vector<std::string> thresholdNames=l1menu::tools::getThresholdNames( *pOriginalTrigger );
+		CPPUNIT_ASSERT_MESSAGE( message, !thresholdNames.empty() );
+
+		// Correlated thresholds are all moved together, keeping the ratios to the first one. Otherwise
+		// each threshold is independent.
+		std::vector<float> thresholdRatios;
+		for( const auto& thresholdName : thresholdNames ) thresholdRatios.push_back( pOriginalTrigger->parameter(thresholdName)/pOriginalTrigger->parameter(thresholdNames.front()) );
+
+		for( const auto& event : events )
+		{
+			std::unique_ptr<l1menu::ITrigger> pTrigger=triggerTable.copyTrigger( *pOriginalTrigger );
+			const bool canPass=dynamic_cast<l1menu::ITightestThresholds&>( *pTrigger ).setThresholdsAsTightAsPossible( event );
+
+			std::unique_ptr<l1menu::ITrigger> pBisectedTrigger=triggerTable.copyTrigger( *pOriginalTrigger );
+			bool bisectionPassed=true;
+			try{ l1menu::tools::setTriggerThresholdsByBisection( event, *pBisectedTrigger, tolerance ); }
+			catch( std::runtime_error& error ) { bisectionPassed=false; }
+
+			CPPUNIT_ASSERT_EQUAL_MESSAGE( message, bisectionPassed, canPass );
+			if( !canPass ) continue;
+
+			// The event has to pass with the thresholds given...
+			CPPUNIT_ASSERT_MESSAGE( message, pTrigger->apply(event) );
+
+			// ...but fail if they're raised by the smallest amount possible
+			if( pTrigger->thresholdsAreCorrelated() )
+			{
+				std::vector<float> tightestThresholds;
+				for( const auto& thresholdName : thresholdNames ) tightestThresholds.push_back( pTrigger->parameter(thresholdName) );
+
+				const float raisedThreshold=std::nextafter( tightestThresholds.front(), infinity );
+				for( size_t index=0; index<thresholdNames.size(); ++index ) pTrigger->parameter(thresholdNames[index])=thresholdRatios[index]*raisedThreshold;
+				CPPUNIT_ASSERT_MESSAGE( message, !pTrigger->apply(event) );
+
+				// Bisection stops on a threshold that fails, within the tolerance above the tightest one.
+				// The other thresholds are scaled from that, so the tolerance is scaled too.
+				for( size_t index=0; index<thresholdNames.size(); ++index )
+				{
+					CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE( message+" "+thresholdNames[index], pBisectedTrigger->parameter(thresholdNames[index]), tightestThresholds[index], tolerance*std::max( 1.0f, std::fabs(thresholdRatios[index]) ) );
+				}
+			}
+			else
+			{
+				for( const auto& thresholdName : thresholdNames )
+				{
+					float& threshold=pTrigger->parameter(thresholdName);
+					const float tightestThreshold=threshold;
+					threshold=std::nextafter( tightestThreshold, infinity );
+					CPPUNIT_ASSERT_MESSAGE( message+" "+thresholdName, !pTrigger->apply(event) );
+					threshold=tightestThreshold;
+
+					// Bisection stops on a threshold that fails, within the tolerance above the tightest one
+					CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE( message+" "+thresholdName, pBisectedTrigger->parameter(thresholdName), tightestThreshold, tolerance );
+				}
+			}
+		} // end of loop over events
+	} // end of loop over triggers
+
+	CPPUNIT_ASSERT( numberOfTriggersTested>0 );
+}
+
+void ToolsUnitTestSuite::testValueTupleSet()
+{
+	// Draw the values from a small pool so that there are plenty of duplicates, including 0 against -0 (which
+	// compare equal) and NaN (which doesn't equal anything, not even itself).
+	const double pool[]={ 0, -0.0, std::numeric_limits<double>::quiet_NaN(), 1.5, -2, 3 };
+	const size_t poolSize=sizeof(pool)/sizeof(pool[0]);
+	std::mt19937 randomGenerator( 20131017 );
+	auto randomTuples=[&]( size_t maximumNumber )->std::vector< std::array<double,2> >
+	{
+		std::vector< std::array<double,2> > tuples( randomGenerator()%(maximumNumber+1) );
+		for( auto& tuple : tuples )
+		{
+			for( auto& value : tuple ) value=pool[randomGenerator()%poolSize];
+		}
+		return tuples;
+	};
+
+	// Same set reused for every collection, like in FullSample. A one byte generation number wraps around every
+	// 256 calls to clear(), which the default type would take over 2^32 calls to do.
+	l1menu::tools::ValueTupleSet<2> set;
+	l1menu::tools::ValueTupleSet<2,unsigned char> smallGenerationSet;
+	for( size_t collectionNumber=0; collectionNumber<2000; ++collectionNumber )
+	{
+		// Duplicates, the way fillDataStructure skips them
+		const std::vector< std::array<double,2> > objects=randomTuples( 20 );
+		set.clear( objects.size() );
+		smallGenerationSet.clear( objects.size() );
+		for( size_t index=0; index<objects.size(); ++index )
+		{
+			bool isDuplicate=false;
+			for( size_t previousIndex=0; previousIndex<index; ++previousIndex )
+			{
+				if( objects[previousIndex][0]==objects[index][0] && objects[previousIndex][1]==objects[index][1] ) isDuplicate=true;
+			}
+			CPPUNIT_ASSERT_EQUAL( isDuplicate, !set.insert( objects[index] ) );
+			CPPUNIT_ASSERT_EQUAL( isDuplicate, !smallGenerationSet.insert( objects[index] ) );
+		}
+
+		// Matching against the isolated list
+		const std::vector< std::array<double,2> > isolatedObjects=randomTuples( 10 );
+		set.clear( isolatedObjects.size() );
+		smallGenerationSet.clear( isolatedObjects.size() );
+		for( const auto& isolatedObject : isolatedObjects )
+		{
+			set.insert( isolatedObject );
+			smallGenerationSet.insert( isolatedObject );
+		}
+		for( const auto& object : objects )
+		{
+			bool isIsolated=false;
+			for( const auto& isolatedObject : isolatedObjects )
+			{
+				if( isolatedObject[0]==object[0] && isolatedObject[1]==object[1] ) isIsolated=true;
+			}
+			CPPUNIT_ASSERT_EQUAL( isIsolated, set.contains( object ) );
+			CPPUNIT_ASSERT_EQUAL( isIsolated, smallGenerationSet.contains( object ) );
+		}
+	}
+
+	// A tuple left in the table must not come back when the generation number gets round to the same value again
+	const std::array<double,2> tuple={{ 1.5, -2 }};
+	smallGenerationSet.clear( 1 );
+	smallGenerationSet.insert( tuple );
+	for( size_t clearNumber=0; clearNumber<256; ++clearNumber )
+	{
+		smallGenerationSet.clear( 1 );
+		CPPUNIT_ASSERT( !smallGenerationSet.contains( tuple ) );
+	}
+
+	// Going over the size given to clear() is a programming error
+	set.clear( 1 );
+	CPPUNIT_ASSERT( set.insert( tuple ) );
+	CPPUNIT_ASSERT( !set.insert( tuple ) );
+	const std::array<double,2> otherTuple={{ 3, 0 }};
+	CPPUNIT_ASSERT_THROW( set.insert( otherTuple ), std::logic_error );
+}
@@ -11,6 +11,7 @@ class TriggerTableUnitTestSuite : public CPPUNIT_NS::TestFixture
 {
 	CPPUNIT_TEST_SUITE(TriggerTableUnitTestSuite);
 	CPPUNIT_TEST(testGettingAndSettingAllTriggerParameters);
+	CPPUNIT_TEST(testThresholdNames);
 	//CPPUNIT_TEST(dumpTriggerTable); // Commented this out because it's pointless and messy
 	CPPUNIT_TEST_SUITE_END();
 
@@ -21,6 +22,8 @@ public:
 
 protected:
 	void testGettingAndSettingAllTriggerParameters();
+	/** @brief Checks the threshold names cached when triggers are registered are the same as asking the trigger for each possible name. */
+	void testThresholdNames();
 	/** @brief Not really a test as such, just prints out all the triggers for the
 	 * user to see what triggers are registered. */
 	void dumpTriggerTable();
@@ -33,9 +36,45 @@ protected:
 #include <cppunit/config/SourcePrefix.h>
 #include "l1menu/TriggerTable.h"
 #include "l1menu/ITrigger.h"
+#include "l1menu/tools/miscellaneous.h"
 #include <stdexcept>
 #include <cmath>
 #include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+namespace // Use the unnamed namespace for things only used in this file
+{
+	/** @brief Finds the threshold names the way l1menu::tools::getThresholdNames used to before they were cached,
+	 * by asking the trigger for every possible name until it throws an exception. */
+	std::vector<std::string> probeThresholdNames( const l1menu::ITriggerDescription& trigger )
+	{
+		std::vector<std::string> returnValue;
+
+		for( size_t legNumber=0; true; ++legNumber )
+		{
+			size_t thresholdNumber;
+			try
+			{
+				for( thresholdNumber=1; true; ++thresholdNumber )
+				{
+					std::stringstream name;
+					if( legNumber!=0 ) name << "leg" << legNumber;
+					name << "threshold" << thresholdNumber;
+
+					trigger.parameter( name.str() );
+					returnValue.push_back( name.str() );
+				}
+			}
+			catch( std::exception& error )
+			{
+				if( thresholdNumber==1 && legNumber!=0 ) break;
+			}
+		}
+
+		return returnValue;
+	}
+}
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TriggerTableUnitTestSuite);
 
@@ -74,6 +113,39 @@ void TriggerTableUnitTestSuite::testGettingAndSettingAllTriggerParameters()
 	}
 }
 
+void TriggerTableUnitTestSuite::testThresholdNames()
+{
+	l1menu::TriggerTable& table=l1menu::TriggerTable::instance();
+
+	for( const auto& triggerDetails : table.listTriggers() )
+	{
+		std::unique_ptr<l1menu::ITrigger> pTrigger=table.getTrigger( triggerDetails );
+		CPPUNIT_ASSERT( pTrigger!=nullptr );
+
+		const std::vector<std::string> parameterNames=pTrigger->parameterNames();
+		const std::vector<std::string> probedThresholdNames=probeThresholdNames( *pTrigger );
+		std::vector<std::string> probedNonThresholdNames;
+		for( const auto& parameterName : parameterNames )
+		{
+			CPPUNIT_ASSERT_NO_THROW( pTrigger->parameter(parameterName) );
+			if( std::find( probedThresholdNames.begin(), probedThresholdNames.end(), parameterName )==probedThresholdNames.end() ) probedNonThresholdNames.push_back( parameterName );
+		}
+
+		const std::vector<std::string> thresholdNames=l1menu::tools::getThresholdNames( *pTrigger );
+		const std::vector<std::string> nonThresholdNames=l1menu::tools::getNonThresholdParameterNames( *pTrigger );
+		CPPUNIT_ASSERT_MESSAGE( triggerDetails.name, thresholdNames==probedThresholdNames );
+		CPPUNIT_ASSERT_MESSAGE( triggerDetails.name, nonThresholdNames==probedNonThresholdNames );
+
+		// Between them the two lists should have every parameter exactly once
+		std::vector<std::string> allNames( thresholdNames );
+		allNames.insert( allNames.end(), nonThresholdNames.begin(), nonThresholdNames.end() );
+		std::vector<std::string> sortedParameterNames( parameterNames );
+		std::sort( allNames.begin(), allNames.end() );
+		std::sort( sortedParameterNames.begin(), sortedParameterNames.end() );
+		CPPUNIT_ASSERT_MESSAGE( triggerDetails.name, allNames==sortedParameterNames );
+	}
+}
+
 void TriggerTableUnitTestSuite::dumpTriggerTable()
 {
 	// No tests performed with this one, just prints out the available triggers